@@ -33,11 +33,15 @@
 #include <QStandardPaths>
 #include <QDir>
 #include <QFile>
+#include <QSet>
+#include <QTimer>
 
 #include <QDebug>
 
 #include <QtTest>
 
+#include <algorithm>
+
 class AllAlbumsModelTests: public QObject
 {
     Q_OBJECT
@@ -170,8 +174,8 @@ private Q_SLOTS:
         QCOMPARE(dataChangedSpy.wait(150), false);
 
         QCOMPARE(albumsModel.rowCount(), 4);
-        QCOMPARE(beginInsertRowsSpy.count(), 4);
-        QCOMPARE(endInsertRowsSpy.count(), 4);
+        QCOMPARE(beginInsertRowsSpy.count(), 1);
+        QCOMPARE(endInsertRowsSpy.count(), 1);
         QCOMPARE(beginRemoveRowsSpy.count(), 0);
         QCOMPARE(endRemoveRowsSpy.count(), 0);
         QCOMPARE(dataChangedSpy.count(), 0);
@@ -187,8 +191,8 @@ private Q_SLOTS:
         QCOMPARE(dataChangedSpy.wait(150), true);
 
         QCOMPARE(albumsModel.rowCount(), 4);
-        QCOMPARE(beginInsertRowsSpy.count(), 4);
-        QCOMPARE(endInsertRowsSpy.count(), 4);
+        QCOMPARE(beginInsertRowsSpy.count(), 1);
+        QCOMPARE(endInsertRowsSpy.count(), 1);
         QCOMPARE(beginRemoveRowsSpy.count(), 0);
         QCOMPARE(endRemoveRowsSpy.count(), 0);
         QCOMPARE(dataChangedSpy.count(), 1);
@@ -223,15 +227,15 @@ private Q_SLOTS:
 
         musicDb.insertTracksList(mNewTracks, mNewCovers, QStringLiteral("autoTest"));
 
-        while(beginInsertRowsSpy.count() < 4) {
+        while(beginInsertRowsSpy.count() < 1) {
             QCOMPARE(beginInsertRowsSpy.wait(150), true);
         }
-        while(endInsertRowsSpy.count() < 4) {
+        while(endInsertRowsSpy.count() < 1) {
             QCOMPARE(endInsertRowsSpy.wait(150), true);
         }
 
-        QCOMPARE(beginInsertRowsSpy.count(), 4);
-        QCOMPARE(endInsertRowsSpy.count(), 4);
+        QCOMPARE(beginInsertRowsSpy.count(), 1);
+        QCOMPARE(endInsertRowsSpy.count(), 1);
         QCOMPARE(beginRemoveRowsSpy.count(), 0);
         QCOMPARE(endRemoveRowsSpy.count(), 0);
         QCOMPARE(dataChangedSpy.count(), 0);
@@ -258,8 +262,8 @@ private Q_SLOTS:
             QCOMPARE(endRemoveRowsSpy.wait(150), true);
         }
 
-        QCOMPARE(beginInsertRowsSpy.count(), 4);
-        QCOMPARE(endInsertRowsSpy.count(), 4);
+        QCOMPARE(beginInsertRowsSpy.count(), 1);
+        QCOMPARE(endInsertRowsSpy.count(), 1);
         QCOMPARE(beginRemoveRowsSpy.count(), 1);
         QCOMPARE(endRemoveRowsSpy.count(), 1);
         QCOMPARE(dataChangedSpy.count(), 0);
@@ -294,15 +298,15 @@ private Q_SLOTS:
 
         musicDb.insertTracksList(mNewTracks, mNewCovers, QStringLiteral("autoTest"));
 
-        while(beginInsertRowsSpy.count() < 4) {
+        while(beginInsertRowsSpy.count() < 1) {
             QCOMPARE(beginInsertRowsSpy.wait(150), true);
         }
-        while(endInsertRowsSpy.count() < 4) {
+        while(endInsertRowsSpy.count() < 1) {
             QCOMPARE(endInsertRowsSpy.wait(150), true);
         }
 
-        QCOMPARE(beginInsertRowsSpy.count(), 4);
-        QCOMPARE(endInsertRowsSpy.count(), 4);
+        QCOMPARE(beginInsertRowsSpy.count(), 1);
+        QCOMPARE(endInsertRowsSpy.count(), 1);
         QCOMPARE(beginRemoveRowsSpy.count(), 0);
         QCOMPARE(endRemoveRowsSpy.count(), 0);
         QCOMPARE(dataChangedSpy.count(), 0);
@@ -319,8 +323,8 @@ private Q_SLOTS:
             QCOMPARE(dataChangedSpy.wait(150), true);
         }
 
-        QCOMPARE(beginInsertRowsSpy.count(), 4);
-        QCOMPARE(endInsertRowsSpy.count(), 4);
+        QCOMPARE(beginInsertRowsSpy.count(), 1);
+        QCOMPARE(endInsertRowsSpy.count(), 1);
         QCOMPARE(beginRemoveRowsSpy.count(), 0);
         QCOMPARE(endRemoveRowsSpy.count(), 0);
         QCOMPARE(dataChangedSpy.count(), 1);
@@ -361,15 +365,15 @@ private Q_SLOTS:
 
         musicDb.insertTracksList(mNewTracks, mNewCovers, QStringLiteral("autoTest"));
 
-        while(beginInsertRowsSpy.count() < 4) {
+        while(beginInsertRowsSpy.count() < 1) {
             QCOMPARE(beginInsertRowsSpy.wait(150), true);
         }
-        while(endInsertRowsSpy.count() < 4) {
+        while(endInsertRowsSpy.count() < 1) {
             QCOMPARE(endInsertRowsSpy.wait(150), true);
         }
 
-        QCOMPARE(beginInsertRowsSpy.count(), 4);
-        QCOMPARE(endInsertRowsSpy.count(), 4);
+        QCOMPARE(beginInsertRowsSpy.count(), 1);
+        QCOMPARE(endInsertRowsSpy.count(), 1);
         QCOMPARE(beginRemoveRowsSpy.count(), 0);
         QCOMPARE(endRemoveRowsSpy.count(), 0);
         QCOMPARE(dataChangedSpy.count(), 0);
@@ -391,19 +395,189 @@ private Q_SLOTS:
 
         musicDb.insertTracksList(newTracks, newCovers, QStringLiteral("autoTest"));
 
-        while(beginInsertRowsSpy.count() < 5) {
+        while(beginInsertRowsSpy.count() < 2) {
             QCOMPARE(beginInsertRowsSpy.wait(150), true);
         }
-        while(endInsertRowsSpy.count() < 5) {
+        while(endInsertRowsSpy.count() < 2) {
             QCOMPARE(endInsertRowsSpy.wait(150), true);
         }
 
-        QCOMPARE(beginInsertRowsSpy.count(), 5);
-        QCOMPARE(endInsertRowsSpy.count(), 5);
+        QCOMPARE(beginInsertRowsSpy.count(), 2);
+        QCOMPARE(endInsertRowsSpy.count(), 2);
         QCOMPARE(beginRemoveRowsSpy.count(), 0);
         QCOMPARE(endRemoveRowsSpy.count(), 0);
         QCOMPARE(dataChangedSpy.count(), 0);
     }
+
+    void stressBatchedUpdatesWithViewReads()
+    {
+        const int batchesCount = 200;
+        const int batchSize = 25;
+
+        AllAlbumsModel albumsModel;
+        ModelTest testModel(&albumsModel);
+
+        QSignalSpy endInsertRowsSpy(&albumsModel, &AllAlbumsModel::rowsInserted);
+
+        auto buildAlbum = [] (int albumId, bool isSingleDiscAlbum) {
+            auto oneAlbum = MusicAlbum();
+            oneAlbum.setValid(true);
+            oneAlbum.setDatabaseId(static_cast<qulonglong>(albumId));
+            oneAlbum.setId(QString::number(albumId));
+            oneAlbum.setTitle(QStringLiteral("album") + QString::number(albumId));
+            oneAlbum.setArtist(QStringLiteral("artist1"));
+            oneAlbum.setIsSingleDiscAlbum(isSingleDiscAlbum);
+            return oneAlbum;
+        };
+
+        auto inconsistentReads = 0;
+        auto readRows = [&albumsModel, &inconsistentReads] (int first, int last) {
+            for (int row = first; row <= last && row < albumsModel.rowCount(); ++row) {
+                const auto &rowIndex = albumsModel.index(row, 0);
+                const auto albumId = albumsModel.data(rowIndex, AllAlbumsModel::AlbumDatabaseIdRole).toULongLong();
+                const auto title = albumsModel.data(rowIndex, AllAlbumsModel::TitleRole).toString();
+
+                if (albumId == 0 || title != QStringLiteral("album") + QString::number(albumId)) {
+                    ++inconsistentReads;
+                }
+            }
+        };
+
+        connect(&albumsModel, &AllAlbumsModel::rowsInserted, this, [&readRows] (const QModelIndex &, int first, int last) {
+            readRows(first, last);
+        });
+
+        auto viewOffset = 0;
+        QTimer simulatedView;
+        simulatedView.setInterval(0);
+        connect(&simulatedView, &QTimer::timeout, this, [&] () {
+            const auto rowsCount = albumsModel.rowCount();
+            if (rowsCount == 0) {
+                return;
+            }
+            viewOffset = (viewOffset + 7) % rowsCount;
+            readRows(viewOffset, viewOffset + 30);
+        });
+        simulatedView.start();
+
+        auto removedIds = QSet<qulonglong>();
+        auto modifiedIds = QSet<qulonglong>();
+
+        for (int batchIndex = 0; batchIndex < batchesCount; ++batchIndex) {
+            auto newAlbums = QList<MusicAlbum>();
+            for (int albumIndex = 0; albumIndex < batchSize; ++albumIndex) {
+                newAlbums.push_back(buildAlbum(batchIndex * batchSize + albumIndex + 1, false));
+            }
+
+            albumsModel.albumsAdded(newAlbums);
+
+            const auto previousBatchFirstId = (batchIndex - 1) * batchSize + 1;
+
+            if (batchIndex % 4 == 1) {
+                auto modifiedAlbums = QList<MusicAlbum>();
+                for (int albumId = previousBatchFirstId; albumId < previousBatchFirstId + 10; ++albumId) {
+                    modifiedAlbums.push_back(buildAlbum(albumId, true));
+                    modifiedIds.insert(static_cast<qulonglong>(albumId));
+                }
+
+                albumsModel.albumsModified(modifiedAlbums);
+            }
+
+            if (batchIndex % 4 == 3) {
+                auto removedAlbums = QList<MusicAlbum>();
+                for (int albumId = previousBatchFirstId; albumId < previousBatchFirstId + 5; ++albumId) {
+                    removedAlbums.push_back(buildAlbum(albumId, false));
+                    removedIds.insert(static_cast<qulonglong>(albumId));
+                }
+
+                albumsModel.albumsRemoved(removedAlbums);
+            }
+
+            if (batchIndex % 10 == 0) {
+                QCoreApplication::processEvents();
+            }
+        }
+
+        const auto expectedCount = batchesCount * batchSize - removedIds.size();
+
+        QTRY_COMPARE_WITH_TIMEOUT(albumsModel.albumCount(), expectedCount, 10000);
+        QTest::qWait(50);
+
+        simulatedView.stop();
+
+        QCOMPARE(albumsModel.albumCount(), expectedCount);
+        QCOMPARE(endInsertRowsSpy.count(), batchesCount);
+        QCOMPARE(inconsistentReads, 0);
+
+        auto seenIds = QSet<qulonglong>();
+        for (int row = 0; row < albumsModel.rowCount(); ++row) {
+            const auto &rowIndex = albumsModel.index(row, 0);
+            const auto albumId = albumsModel.data(rowIndex, AllAlbumsModel::AlbumDatabaseIdRole).toULongLong();
+
+            QVERIFY(!seenIds.contains(albumId));
+            QVERIFY(!removedIds.contains(albumId));
+            seenIds.insert(albumId);
+
+            QCOMPARE(albumsModel.data(rowIndex, AllAlbumsModel::IsSingleDiscAlbumRole).toBool(), modifiedIds.contains(albumId));
+        }
+    }
+
+    void albumRowsOfArtistMatchesExactNames()
+    {
+        AllAlbumsModel albumsModel;
+        ModelTest testModel(&albumsModel);
+
+        auto buildAlbum = [] (int albumId, const QString &albumArtist, const QString &trackArtist) {
+            auto oneTrack = MusicAudioTrack();
+            oneTrack.setValid(true);
+            oneTrack.setDatabaseId(static_cast<qulonglong>(albumId));
+            oneTrack.setArtist(trackArtist);
+
+            auto oneAlbum = MusicAlbum();
+            oneAlbum.setValid(true);
+            oneAlbum.setDatabaseId(static_cast<qulonglong>(albumId));
+            oneAlbum.setId(QString::number(albumId));
+            oneAlbum.setTitle(QStringLiteral("album") + QString::number(albumId));
+            oneAlbum.setArtist(albumArtist);
+            oneAlbum.setTracks({oneTrack});
+            return oneAlbum;
+        };
+
+        auto rowsIds = [&albumsModel] (const QString &artist) {
+            auto result = QList<qulonglong>();
+            const auto artistRows = albumsModel.albumRowsOfArtist(artist);
+            for (auto oneRow : artistRows) {
+                result.push_back(albumsModel.data(albumsModel.index(oneRow, 0), AllAlbumsModel::AlbumDatabaseIdRole).toULongLong());
+            }
+            std::sort(result.begin(), result.end());
+            return result;
+        };
+
+        albumsModel.albumsAdded({buildAlbum(1, QStringLiteral("Prince"), QStringLiteral("Prince")),
+                                 buildAlbum(2, QStringLiteral("Prince Buster"), QStringLiteral("Prince Buster")),
+                                 buildAlbum(3, QStringLiteral("Various Artists"), QStringLiteral("Prince")),
+                                 buildAlbum(4, QStringLiteral("artist1"), QStringLiteral("artist1"))});
+
+        QTRY_COMPARE(albumsModel.albumCount(), 4);
+
+        QCOMPARE(rowsIds(QStringLiteral("Prince")), QList<qulonglong>({1, 3}));
+        QCOMPARE(rowsIds(QStringLiteral("Prince Buster")), QList<qulonglong>({2}));
+        QCOMPARE(rowsIds(QStringLiteral("Various Artists")), QList<qulonglong>({3}));
+        QCOMPARE(rowsIds(QStringLiteral("Princ")), QList<qulonglong>());
+
+        albumsModel.albumsModified({buildAlbum(3, QStringLiteral("Various Artists"), QStringLiteral("Prince Buster"))});
+
+        QTRY_COMPARE(rowsIds(QStringLiteral("Prince")), QList<qulonglong>({1}));
+        QCOMPARE(rowsIds(QStringLiteral("Prince Buster")), QList<qulonglong>({2, 3}));
+
+        albumsModel.albumsRemoved({buildAlbum(1, QStringLiteral("Prince"), QStringLiteral("Prince"))});
+
+        QTRY_COMPARE(albumsModel.albumCount(), 3);
+
+        QCOMPARE(rowsIds(QStringLiteral("Prince")), QList<qulonglong>());
+        QCOMPARE(rowsIds(QStringLiteral("Prince Buster")), QList<qulonglong>({2, 3}));
+        QCOMPARE(rowsIds(QStringLiteral("artist1")), QList<qulonglong>({4}));
+    }
 };
 
 QTEST_GUILESS_MAIN(AllAlbumsModelTests)
@@ -38,12 +38,27 @@
 
 #include <QtTest>
 
+#include <algorithm>
+
 class AllTracksModelTests: public QObject
 {
     Q_OBJECT
 
 private:
 
+    static MusicAudioTrack syntheticTrack(int trackId, int albumIndex)
+    {
+        const auto trackIdString = QString::number(trackId);
+
+        auto oneTrack = MusicAudioTrack{true, trackIdString, QStringLiteral("0"), QStringLiteral("track") + trackIdString,
+                QStringLiteral("artist1"), QStringLiteral("album") + QString::number(albumIndex), QStringLiteral("artist1"),
+                trackId, 1, QTime::fromMSecsSinceStartOfDay(trackId), {QUrl::fromLocalFile(QStringLiteral("/") + trackIdString)},
+                {}, 1, true};
+        oneTrack.setDatabaseId(static_cast<qulonglong>(trackId));
+
+        return oneTrack;
+    }
+
     QList<MusicAudioTrack> mNewTracks = {
         {true, QStringLiteral("$1"), QStringLiteral("0"), QStringLiteral("track1"),
          QStringLiteral("artist1"), QStringLiteral("album1"), QStringLiteral("Various Artists"),
@@ -504,6 +519,310 @@ private Q_SLOTS:
 
         QCOMPARE(tracksModel.rowCount(), 0);
     }
+
+    void removeAndModifyTracksInBatch()
+    {
+        AllTracksModel tracksModel;
+        ModelTest testModel(&tracksModel);
+
+        auto newTracks = QList<MusicAudioTrack>();
+        for (int trackId = 1; trackId <= 10; ++trackId) {
+            newTracks.push_back(syntheticTrack(trackId, 0));
+        }
+
+        tracksModel.tracksAdded(newTracks);
+
+        QCOMPARE(tracksModel.rowCount(), 10);
+
+        QSignalSpy beginRemoveRowsSpy(&tracksModel, &AllTracksModel::rowsAboutToBeRemoved);
+        QSignalSpy endRemoveRowsSpy(&tracksModel, &AllTracksModel::rowsRemoved);
+        QSignalSpy dataChangedSpy(&tracksModel, &AllTracksModel::dataChanged);
+
+        tracksModel.tracksRemoved({8, 3, 2, 42, 4, 7});
+
+        QCOMPARE(beginRemoveRowsSpy.count(), 2);
+        QCOMPARE(endRemoveRowsSpy.count(), 2);
+        QCOMPARE(beginRemoveRowsSpy.at(0).at(1).toInt(), 6);
+        QCOMPARE(beginRemoveRowsSpy.at(0).at(2).toInt(), 7);
+        QCOMPARE(beginRemoveRowsSpy.at(1).at(1).toInt(), 1);
+        QCOMPARE(beginRemoveRowsSpy.at(1).at(2).toInt(), 3);
+
+        QCOMPARE(tracksModel.rowCount(), 5);
+
+        const auto remainingIds = QList<qulonglong>{1, 5, 6, 9, 10};
+        for (int row = 0; row < remainingIds.size(); ++row) {
+            QCOMPARE(tracksModel.data(tracksModel.index(row, 0), AllTracksModel::DatabaseIdRole).toULongLong(), remainingIds.at(row));
+        }
+
+        auto modifiedTracks = QList<MusicAudioTrack>();
+        for (auto trackId : {5, 6, 10, 3}) {
+            modifiedTracks.push_back(syntheticTrack(trackId, 0));
+            modifiedTracks.last().setRating(5);
+        }
+
+        tracksModel.tracksModified(modifiedTracks);
+
+        QCOMPARE(dataChangedSpy.count(), 2);
+        QCOMPARE(dataChangedSpy.at(0).at(0).toModelIndex().row(), 1);
+        QCOMPARE(dataChangedSpy.at(0).at(1).toModelIndex().row(), 2);
+        QCOMPARE(dataChangedSpy.at(1).at(0).toModelIndex().row(), 4);
+        QCOMPARE(dataChangedSpy.at(1).at(1).toModelIndex().row(), 4);
+
+        QCOMPARE(tracksModel.data(tracksModel.index(2, 0), AllTracksModel::RatingRole).toInt(), 5);
+        QCOMPARE(tracksModel.data(tracksModel.index(3, 0), AllTracksModel::RatingRole).toInt(), 1);
+
+        tracksModel.trackRemoved(9);
+
+        QCOMPARE(tracksModel.rowCount(), 4);
+        QCOMPARE(tracksModel.data(tracksModel.index(3, 0), AllTracksModel::DatabaseIdRole).toULongLong(), qulonglong(10));
+    }
+
+    void benchmarkAddManyTracks()
+    {
+        /* the full size benchmark only runs when ELISA_BENCHMARKS is set */
+        const int tracksCount = (qEnvironmentVariableIsSet("ELISA_BENCHMARKS") ? 500000 : 5000);
+        const int batchSize = 50;
+
+        auto allBatches = QList<QList<MusicAudioTrack>>();
+        allBatches.reserve(tracksCount / batchSize);
+
+        for (int batchIndex = 0; batchIndex < tracksCount / batchSize; ++batchIndex) {
+            auto oneBatch = QList<MusicAudioTrack>();
+            oneBatch.reserve(batchSize);
+
+            for (int trackIndex = 0; trackIndex < batchSize; ++trackIndex) {
+                oneBatch.push_back(syntheticTrack(batchIndex * batchSize + trackIndex + 1, batchIndex));
+            }
+
+            allBatches.push_back(oneBatch);
+        }
+
+        AllTracksModel tracksModel;
+
+        QSignalSpy endInsertRowsSpy(&tracksModel, &AllTracksModel::rowsInserted);
+
+        QBENCHMARK_ONCE {
+            for (const auto &oneBatch : allBatches) {
+                tracksModel.tracksAdded(oneBatch);
+            }
+        }
+
+        QCOMPARE(endInsertRowsSpy.count(), tracksCount / batchSize);
+        QCOMPARE(tracksModel.rowCount(), tracksCount);
+
+        QCOMPARE(tracksModel.data(tracksModel.index(0, 0), AllTracksModel::DatabaseIdRole).toULongLong(), qulonglong(1));
+        QCOMPARE(tracksModel.data(tracksModel.index(tracksCount - 1, 0), AllTracksModel::DatabaseIdRole).toULongLong(), qulonglong(tracksCount));
+
+        tracksModel.trackRemoved(1);
+
+        QCOMPARE(tracksModel.rowCount(), tracksCount - 1);
+        QCOMPARE(tracksModel.data(tracksModel.index(0, 0), AllTracksModel::DatabaseIdRole).toULongLong(), qulonglong(2));
+
+        auto modifiedTrack = allBatches.last().last();
+        modifiedTrack.setRating(5);
+        tracksModel.trackModified(modifiedTrack);
+
+        QCOMPARE(tracksModel.data(tracksModel.index(tracksCount - 2, 0), AllTracksModel::RatingRole).toInt(), 5);
+    }
+
+    void displayTextOfModifiedTrack()
+    {
+        AllTracksModel tracksModel;
+
+        auto firstTrack = syntheticTrack(1, 1);
+        firstTrack.setDuration(QTime(1, 2, 3));
+        auto secondTrack = syntheticTrack(2, 1);
+        secondTrack.setDuration(QTime(0, 3, 25));
+
+        tracksModel.tracksAdded({firstTrack, secondTrack});
+
+        QCOMPARE(tracksModel.data(tracksModel.index(0, 0), AllTracksModel::DurationRole).toString(), QStringLiteral("01:02:03"));
+        QCOMPARE(tracksModel.data(tracksModel.index(0, 0), AllTracksModel::SecondaryTextRole).toString(), QStringLiteral("<b>1 - track1</b>"));
+        QCOMPARE(tracksModel.data(tracksModel.index(1, 0), AllTracksModel::DurationRole).toString(), QStringLiteral("03:25"));
+        QCOMPARE(tracksModel.data(tracksModel.index(1, 0), AllTracksModel::SecondaryTextRole).toString(), QStringLiteral("<b>2 - track2</b>"));
+
+        auto modifiedTrack = secondTrack;
+        modifiedTrack.setTitle(QStringLiteral("50% off"));
+        modifiedTrack.setArtist(QStringLiteral("artist2"));
+        modifiedTrack.setDuration(QTime(0, 0, 7));
+
+        QSignalSpy dataChangedSpy(&tracksModel, &AllTracksModel::dataChanged);
+
+        tracksModel.trackModified(modifiedTrack);
+
+        QCOMPARE(dataChangedSpy.count(), 1);
+        QCOMPARE(tracksModel.data(tracksModel.index(1, 0), AllTracksModel::DurationRole).toString(), QStringLiteral("00:07"));
+        QCOMPARE(tracksModel.data(tracksModel.index(1, 0), AllTracksModel::SecondaryTextRole).toString(),
+                 QStringLiteral("<b>2 - 50% off</b> - <i>artist2</i>"));
+
+        tracksModel.trackRemoved(1);
+
+        QCOMPARE(tracksModel.data(tracksModel.index(0, 0), AllTracksModel::DurationRole).toString(), QStringLiteral("00:07"));
+    }
+
+    void pagedModelLoadsAndEvictsPages()
+    {
+        const int tracksCount = 3000;
+        const int pageSize = 200;
+
+        AllTracksModel tracksModel;
+
+        tracksModel.setPaged(true);
+
+        QSignalSpy requestTracksPageSpy(&tracksModel, &AllTracksModel::requestTracksPage);
+        QSignalSpy dataChangedSpy(&tracksModel, &AllTracksModel::dataChanged);
+
+        auto largestSkippedCount = 0;
+
+        /* answers the pending requests the way the database does, rows are tracks sorted on their ids */
+        auto sendRequestedPages = [&tracksModel, &requestTracksPageSpy, &largestSkippedCount, tracksCount] () {
+            QCoreApplication::processEvents();
+
+            while (!requestTracksPageSpy.isEmpty()) {
+                const auto oneRequest = requestTracksPageSpy.takeFirst();
+                const auto offset = oneRequest.at(0).toInt();
+                const auto count = oneRequest.at(1).toInt();
+                const auto afterId = oneRequest.at(2).toULongLong();
+                const auto skippedCount = oneRequest.at(3).toInt();
+
+                /* the track of row n has the id n + 1 */
+                QCOMPARE(afterId + skippedCount, qulonglong(offset));
+
+                largestSkippedCount = std::max(largestSkippedCount, skippedCount);
+
+                auto pageTracks = QList<MusicAudioTrack>();
+                for (int row = offset; row < std::min(offset + count, tracksCount); ++row) {
+                    pageTracks.push_back(syntheticTrack(row + 1, 0));
+                }
+
+                tracksModel.setTracksPage(offset, pageTracks);
+            }
+        };
+
+        tracksModel.setTracksCount(tracksCount);
+
+        QCOMPARE(tracksModel.rowCount(), 0);
+        QVERIFY(tracksModel.canFetchMore({}));
+
+        tracksModel.fetchMore({});
+
+        QCOMPARE(tracksModel.rowCount(), pageSize);
+        QVERIFY(!tracksModel.data(tracksModel.index(10, 0), AllTracksModel::TitleRole).isValid());
+
+        QCoreApplication::processEvents();
+
+        QCOMPARE(requestTracksPageSpy.count(), 1);
+        QCOMPARE(requestTracksPageSpy.at(0).at(0).toInt(), 0);
+        QCOMPARE(requestTracksPageSpy.at(0).at(1).toInt(), pageSize);
+
+        sendRequestedPages();
+
+        QCOMPARE(dataChangedSpy.count(), 1);
+        QCOMPARE(tracksModel.data(tracksModel.index(10, 0), AllTracksModel::TitleRole).toString(), QStringLiteral("track11"));
+        QCOMPARE(tracksModel.data(tracksModel.index(10, 0), AllTracksModel::DurationRole).toString(), QStringLiteral("00:00"));
+
+        while (tracksModel.canFetchMore({})) {
+            tracksModel.fetchMore({});
+        }
+
+        QCOMPARE(tracksModel.rowCount(), tracksCount);
+
+        /* scrolling to the end reads each page once and only keeps the last ones */
+        for (int row = 0; row < tracksCount; row += pageSize / 2) {
+            tracksModel.data(tracksModel.index(row, 0), AllTracksModel::TitleRole);
+
+            sendRequestedPages();
+
+            QCOMPARE(tracksModel.data(tracksModel.index(row, 0), AllTracksModel::DatabaseIdRole).toULongLong(), qulonglong(row + 1));
+        }
+
+        /* each page is read after the last row of a page read before it, never from the first row */
+        QVERIFY(largestSkippedCount <= pageSize);
+
+        QCOMPARE(tracksModel.data(tracksModel.index(tracksCount - 1, 0), AllTracksModel::TitleRole).toString(), QStringLiteral("track3000"));
+        QVERIFY(!tracksModel.data(tracksModel.index(10, 0), AllTracksModel::TitleRole).isValid());
+
+        QCoreApplication::processEvents();
+
+        QVERIFY(!requestTracksPageSpy.isEmpty());
+        QCOMPARE(requestTracksPageSpy.at(0).at(0).toInt(), 0);
+
+        sendRequestedPages();
+
+        QCOMPARE(tracksModel.data(tracksModel.index(10, 0), AllTracksModel::TitleRole).toString(), QStringLiteral("track11"));
+
+        /* a modified track is only updated when its page is loaded */
+        auto modifiedTrack = syntheticTrack(11, 0);
+        modifiedTrack.setRating(5);
+
+        dataChangedSpy.clear();
+
+        tracksModel.trackModified(modifiedTrack);
+
+        QCOMPARE(dataChangedSpy.count(), 1);
+        QCOMPARE(tracksModel.data(tracksModel.index(10, 0), AllTracksModel::RatingRole).toInt(), 5);
+
+        /* all rows are fetched, a new track is shown at once after them */
+        QSignalSpy rowsInsertedSpy(&tracksModel, &AllTracksModel::rowsInserted);
+
+        tracksModel.tracksAdded({syntheticTrack(tracksCount + 1, 0)});
+
+        QCOMPARE(rowsInsertedSpy.count(), 1);
+        QCOMPARE(tracksModel.rowCount(), tracksCount + 1);
+
+        QSignalSpy modelResetSpy(&tracksModel, &AllTracksModel::modelReset);
+
+        tracksModel.tracksRemoved({1, 2});
+
+        QCOMPARE(modelResetSpy.count(), 1);
+        QCOMPARE(tracksModel.rowCount(), tracksCount - 1);
+        QVERIFY(!tracksModel.data(tracksModel.index(10, 0), AllTracksModel::TitleRole).isValid());
+    }
+
+    void benchmarkScrollManyTracks()
+    {
+        /* the full size benchmark only runs when ELISA_BENCHMARKS is set */
+        const int tracksCount = (qEnvironmentVariableIsSet("ELISA_BENCHMARKS") ? 100000 : 3000);
+        const int batchSize = 500;
+        const int visibleRowsCount = 30;
+
+        AllTracksModel tracksModel;
+
+        for (int firstTrackId = 1; firstTrackId <= tracksCount; firstTrackId += batchSize) {
+            auto oneBatch = QList<MusicAudioTrack>();
+            oneBatch.reserve(batchSize);
+
+            for (int trackId = firstTrackId; trackId < firstTrackId + batchSize; ++trackId) {
+                oneBatch.push_back(syntheticTrack(trackId, trackId / 12));
+            }
+
+            tracksModel.tracksAdded(oneBatch);
+        }
+
+        const auto delegateRoles = QVector<int>{AllTracksModel::TitleRole, AllTracksModel::DurationRole,
+                AllTracksModel::ArtistRole, AllTracksModel::AlbumRole, AllTracksModel::RatingRole,
+                AllTracksModel::SecondaryTextRole, AllTracksModel::ImageUrlRole, AllTracksModel::ShadowForImageRole,
+                AllTracksModel::IsSingleDiscAlbumRole, AllTracksModel::DatabaseIdRole};
+
+        /* a view scrolling from top to bottom twice, five rows at a time, asks again for each visible row */
+        QBENCHMARK {
+            auto textLength = 0;
+
+            for (int pass = 0; pass < 2; ++pass) {
+                for (int firstVisibleRow = 0; firstVisibleRow + visibleRowsCount <= tracksCount; firstVisibleRow += 5) {
+                    for (int row = firstVisibleRow; row < firstVisibleRow + visibleRowsCount; ++row) {
+                        const auto rowIndex = tracksModel.index(row, 0);
+
+                        for (auto oneRole : delegateRoles) {
+                            textLength += tracksModel.data(rowIndex, oneRole).toString().size();
+                        }
+                    }
+                }
+            }
+
+            QVERIFY(textLength > 0);
+        }
+    }
 };
 
 QTEST_GUILESS_MAIN(AllTracksModelTests)
@@ -0,0 +1,420 @@
+/*
+ * Copyright 2018 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "musicaudiotrack.h"
+#include "models/alltracksmodel.h"
+#include "models/alltracksproxymodel.h"
+#include "models/searchkeymatcher.h"
+#include "models/sortkeybuilder.h"
+
+#include <QObject>
+#include <QUrl>
+#include <QString>
+#include <QList>
+
+#include <QtTest>
+
+#include <memory>
+
+class AllTracksProxyModelTests: public QObject
+{
+    Q_OBJECT
+
+private:
+
+    static MusicAudioTrack syntheticTrack(int trackId, const QString &title, const QString &artist, int rating)
+    {
+        const auto trackIdString = QString::number(trackId);
+
+        auto oneTrack = MusicAudioTrack{true, trackIdString, QStringLiteral("0"), title,
+                artist, QStringLiteral("album1"), artist,
+                1, 1, QTime::fromMSecsSinceStartOfDay(trackId), {QUrl::fromLocalFile(QStringLiteral("/") + trackIdString)},
+                {}, rating, true};
+        oneTrack.setDatabaseId(static_cast<qulonglong>(trackId));
+
+        return oneTrack;
+    }
+
+    static bool applyFilterText(AllTracksProxyModel &proxyModel, const QString &filterText)
+    {
+        if (proxyModel.filterText() == filterText) {
+            return true;
+        }
+
+        QSignalSpy filterAppliedSpy(&proxyModel, &AllTracksProxyModel::filterApplied);
+
+        proxyModel.setFilterText(filterText);
+
+        return filterAppliedSpy.wait();
+    }
+
+    static bool applyFilterRating(AllTracksProxyModel &proxyModel, int filterRating)
+    {
+        QSignalSpy filterAppliedSpy(&proxyModel, &AllTracksProxyModel::filterApplied);
+
+        proxyModel.setFilterRating(filterRating);
+
+        return filterAppliedSpy.wait();
+    }
+
+    static QList<qulonglong> rowsDatabaseIds(const AllTracksProxyModel &proxyModel)
+    {
+        auto result = QList<qulonglong>();
+
+        for (int row = 0; row < proxyModel.rowCount(); ++row) {
+            result.push_back(proxyModel.data(proxyModel.index(row, 0), AllTracksModel::DatabaseIdRole).toULongLong());
+        }
+
+        return result;
+    }
+
+    std::unique_ptr<AllTracksModel> mManyTracksModel;
+
+    std::unique_ptr<AllTracksModel> mManySortedTracksModel;
+
+public:
+
+    explicit AllTracksProxyModelTests(QObject *parent = nullptr) : QObject(parent)
+    {
+    }
+
+private Q_SLOTS:
+
+    void initTestCase()
+    {
+        qRegisterMetaType<QList<MusicAudioTrack>>("QList<MusicAudioTrack>");
+        qRegisterMetaType<QList<qulonglong>>("QList<qulonglong>");
+        qRegisterMetaType<ElisaUtils::PlayListEnqueueMode>("ElisaUtils::PlayListEnqueueMode");
+        qRegisterMetaType<ElisaUtils::PlayListEnqueueTriggerPlay>("ElisaUtils::PlayListEnqueueTriggerPlay");
+    }
+
+    void foldSearchKeys()
+    {
+        QCOMPARE(SearchKeyMatcher::foldText(QStringLiteral("Beyoncé")), QStringLiteral("beyonce"));
+        QCOMPARE(SearchKeyMatcher::foldText(QStringLiteral("SIGUR RÓS")), QStringLiteral("sigur ros"));
+
+        SearchKeyMatcher matcher(QStringLiteral("Cafe"));
+
+        QCOMPARE(matcher.matches(SearchKeyMatcher::searchKey({QStringLiteral("Café del Mar"), QStringLiteral("artist")})), true);
+        QCOMPARE(matcher.matches(SearchKeyMatcher::searchKey({QStringLiteral("Ca"), QStringLiteral("fe")})), false);
+        QCOMPARE(SearchKeyMatcher().matches(QStringLiteral("anything")), true);
+    }
+
+    void filterOnTitleArtistAndRating()
+    {
+        AllTracksModel tracksModel;
+        AllTracksProxyModel proxyModel;
+        proxyModel.setSourceModel(&tracksModel);
+
+        tracksModel.tracksAdded({syntheticTrack(1, QStringLiteral("Café del Mar"), QStringLiteral("Energy 52"), 2),
+                                 syntheticTrack(2, QStringLiteral("Crazy in Love"), QStringLiteral("Beyoncé"), 4),
+                                 syntheticTrack(3, QStringLiteral("Hoppípolla"), QStringLiteral("Sigur Rós"), 5)});
+
+        QCOMPARE(proxyModel.rowCount(), 3);
+
+        QVERIFY(applyFilterText(proxyModel, QStringLiteral("cafe")));
+        QCOMPARE(proxyModel.rowCount(), 1);
+        QCOMPARE(proxyModel.data(proxyModel.index(0, 0), AllTracksModel::DatabaseIdRole).toULongLong(), qulonglong(1));
+
+        QVERIFY(applyFilterText(proxyModel, QStringLiteral("BEYONCE")));
+        QCOMPARE(proxyModel.rowCount(), 1);
+        QCOMPARE(proxyModel.data(proxyModel.index(0, 0), AllTracksModel::DatabaseIdRole).toULongLong(), qulonglong(2));
+
+        QVERIFY(applyFilterText(proxyModel, QStringLiteral("r")));
+        QCOMPARE(proxyModel.rowCount(), 3);
+
+        QVERIFY(applyFilterRating(proxyModel, 4));
+        QCOMPARE(proxyModel.rowCount(), 2);
+
+        tracksModel.trackModified(syntheticTrack(2, QStringLiteral("Halo"), QStringLiteral("Beyonce"), 4));
+        QVERIFY(applyFilterText(proxyModel, QStringLiteral("halo")));
+        QCOMPARE(proxyModel.rowCount(), 1);
+
+        tracksModel.trackRemoved(2);
+        QCOMPARE(proxyModel.rowCount(), 0);
+
+        QVERIFY(applyFilterText(proxyModel, QString()));
+        QVERIFY(applyFilterRating(proxyModel, 0));
+        QCOMPARE(proxyModel.rowCount(), 2);
+    }
+
+    void benchmarkFilterKeystrokes_data()
+    {
+        QTest::addColumn<QString>("previousFilter");
+        QTest::addColumn<QString>("filter");
+
+        QTest::newRow("s") << QString() << QStringLiteral("s");
+        QTest::newRow("si") << QStringLiteral("s") << QStringLiteral("si");
+        QTest::newRow("sig") << QStringLiteral("si") << QStringLiteral("sig");
+        QTest::newRow("sigu") << QStringLiteral("sig") << QStringLiteral("sigu");
+        QTest::newRow("sigur r") << QStringLiteral("sigu") << QStringLiteral("sigur r");
+        QTest::newRow("sigur ros 42") << QStringLiteral("sigur r") << QStringLiteral("sigur ros 42");
+        QTest::newRow("clear") << QStringLiteral("sigur ros 42") << QString();
+    }
+
+    void benchmarkFilterKeystrokes()
+    {
+        QFETCH(QString, previousFilter);
+        QFETCH(QString, filter);
+
+        /* the full size benchmark only runs when ELISA_BENCHMARKS is set */
+        const int tracksCount = (qEnvironmentVariableIsSet("ELISA_BENCHMARKS") ? 300000 : 3000);
+        const int batchSize = 500;
+
+        if (!mManyTracksModel) {
+            mManyTracksModel = std::make_unique<AllTracksModel>();
+
+            for (int firstTrackId = 1; firstTrackId <= tracksCount; firstTrackId += batchSize) {
+                auto oneBatch = QList<MusicAudioTrack>();
+                oneBatch.reserve(batchSize);
+
+                for (int trackId = firstTrackId; trackId < firstTrackId + batchSize; ++trackId) {
+                    oneBatch.push_back(syntheticTrack(trackId, QStringLiteral("Track %1").arg(trackId),
+                                                      QStringLiteral("Sigur Rós %1").arg(trackId % 1000), trackId % 6));
+                }
+
+                mManyTracksModel->tracksAdded(oneBatch);
+            }
+        }
+
+        QCOMPARE(mManyTracksModel->rowCount(), tracksCount);
+
+        AllTracksProxyModel proxyModel;
+        proxyModel.setSourceModel(mManyTracksModel.get());
+        QVERIFY(applyFilterText(proxyModel, previousFilter));
+
+        QBENCHMARK_ONCE {
+            QVERIFY(applyFilterText(proxyModel, filter));
+        }
+
+        QVERIFY(proxyModel.rowCount() > 0);
+    }
+
+    void ignoreLeadingArticles()
+    {
+        SortKeyBuilder sortKeyBuilder({QStringLiteral("The"), QStringLiteral("A")});
+
+        QCOMPARE(sortKeyBuilder.sortText(QStringLiteral("The Beatles")), QStringLiteral("Beatles"));
+        QCOMPARE(sortKeyBuilder.sortText(QStringLiteral("  the  Doors")), QStringLiteral("Doors"));
+        QCOMPARE(sortKeyBuilder.sortText(QStringLiteral("A Tribe Called Quest")), QStringLiteral("Tribe Called Quest"));
+        QCOMPARE(sortKeyBuilder.sortText(QStringLiteral("Theatre of Tragedy")), QStringLiteral("Theatre of Tragedy"));
+        QCOMPARE(sortKeyBuilder.sortText(QStringLiteral("The")), QStringLiteral("The"));
+        QCOMPARE(SortKeyBuilder().sortText(QStringLiteral("The Beatles")), QStringLiteral("The Beatles"));
+    }
+
+    void sortOnEachCriterion()
+    {
+        AllTracksModel tracksModel;
+        AllTracksProxyModel proxyModel;
+        proxyModel.setSourceModel(&tracksModel);
+
+        auto firstTrack = syntheticTrack(1, QStringLiteral("Zebra"), QStringLiteral("Abba"), 0);
+        firstTrack.setYear(1990);
+        firstTrack.setDuration(QTime::fromMSecsSinceStartOfDay(300000));
+        auto secondTrack = syntheticTrack(2, QStringLiteral("The Apple"), QStringLiteral("Coldplay"), 0);
+        secondTrack.setYear(1980);
+        secondTrack.setDuration(QTime::fromMSecsSinceStartOfDay(100000));
+        auto thirdTrack = syntheticTrack(3, QStringLiteral("Banana"), QStringLiteral("Bach"), 0);
+        thirdTrack.setYear(2000);
+        thirdTrack.setDuration(QTime::fromMSecsSinceStartOfDay(200000));
+
+        tracksModel.tracksAdded({firstTrack, secondTrack, thirdTrack});
+
+        QCOMPARE(proxyModel.sortCriterion(), AllTracksProxyModel::SortByTitle);
+        QCOMPARE(rowsDatabaseIds(proxyModel), (QList<qulonglong>{3, 2, 1}));
+
+        tracksModel.setIgnoredSortArticles({QStringLiteral("The")});
+        QCOMPARE(rowsDatabaseIds(proxyModel), (QList<qulonglong>{2, 3, 1}));
+
+        proxyModel.setSortCriterion(AllTracksProxyModel::SortByArtist);
+        QCOMPARE(rowsDatabaseIds(proxyModel), (QList<qulonglong>{1, 3, 2}));
+
+        proxyModel.setSortCriterion(AllTracksProxyModel::SortByYear);
+        QCOMPARE(rowsDatabaseIds(proxyModel), (QList<qulonglong>{2, 1, 3}));
+
+        proxyModel.setSortCriterion(AllTracksProxyModel::SortByDuration);
+        QCOMPARE(rowsDatabaseIds(proxyModel), (QList<qulonglong>{2, 3, 1}));
+
+        proxyModel.setSortCriterion(AllTracksProxyModel::SortByDateAdded);
+        QCOMPARE(rowsDatabaseIds(proxyModel), (QList<qulonglong>{1, 2, 3}));
+
+        proxyModel.sort(0, Qt::DescendingOrder);
+        QCOMPARE(rowsDatabaseIds(proxyModel), (QList<qulonglong>{3, 2, 1}));
+
+        proxyModel.sort(0, Qt::AscendingOrder);
+        proxyModel.setSortCriterion(AllTracksProxyModel::SortByTitle);
+
+        tracksModel.tracksAdded({syntheticTrack(4, QStringLiteral("Cherry"), QStringLiteral("Abba"), 0)});
+        QCOMPARE(rowsDatabaseIds(proxyModel), (QList<qulonglong>{2, 3, 4, 1}));
+
+        tracksModel.trackModified(syntheticTrack(1, QStringLiteral("Avocado"), QStringLiteral("Abba"), 0));
+        QCOMPARE(rowsDatabaseIds(proxyModel), (QList<qulonglong>{2, 1, 3, 4}));
+    }
+
+    void benchmarkSortTracks_data()
+    {
+        QTest::addColumn<int>("sortCriterion");
+
+        QTest::newRow("artist") << static_cast<int>(AllTracksProxyModel::SortByArtist);
+        QTest::newRow("year") << static_cast<int>(AllTracksProxyModel::SortByYear);
+        QTest::newRow("date added") << static_cast<int>(AllTracksProxyModel::SortByDateAdded);
+        QTest::newRow("duration") << static_cast<int>(AllTracksProxyModel::SortByDuration);
+        QTest::newRow("title") << static_cast<int>(AllTracksProxyModel::SortByTitle);
+    }
+
+    void benchmarkSortTracks()
+    {
+        QFETCH(int, sortCriterion);
+
+        /* the full size benchmark only runs when ELISA_BENCHMARKS is set */
+        const int tracksCount = (qEnvironmentVariableIsSet("ELISA_BENCHMARKS") ? 300000 : 3000);
+        const int batchSize = 500;
+
+        if (!mManySortedTracksModel) {
+            mManySortedTracksModel = std::make_unique<AllTracksModel>();
+            mManySortedTracksModel->setIgnoredSortArticles({QStringLiteral("The")});
+
+            for (int firstTrackId = 1; firstTrackId <= tracksCount; firstTrackId += batchSize) {
+                auto oneBatch = QList<MusicAudioTrack>();
+                oneBatch.reserve(batchSize);
+
+                for (int trackId = firstTrackId; trackId < firstTrackId + batchSize; ++trackId) {
+                    auto oneTrack = syntheticTrack(trackId, QStringLiteral("The Track %1").arg((trackId * 7919) % tracksCount),
+                                                   QStringLiteral("Artist %1").arg(trackId % 1000), 0);
+                    oneTrack.setYear(1950 + trackId % 70);
+                    oneBatch.push_back(oneTrack);
+                }
+
+                mManySortedTracksModel->tracksAdded(oneBatch);
+            }
+        }
+
+        AllTracksProxyModel proxyModel;
+        proxyModel.setSourceModel(mManySortedTracksModel.get());
+
+        QCOMPARE(proxyModel.rowCount(), tracksCount);
+
+        /* a new proxy is already sorted on the title */
+        if (sortCriterion == AllTracksProxyModel::SortByTitle) {
+            proxyModel.setSortCriterion(AllTracksProxyModel::SortByDateAdded);
+        }
+
+        QBENCHMARK_ONCE {
+            proxyModel.setSortCriterion(static_cast<AllTracksProxyModel::SortCriterion>(sortCriterion));
+        }
+
+        QCOMPARE(proxyModel.rowCount(), tracksCount);
+    }
+
+    void narrowAndWidenFilter()
+    {
+        AllTracksModel tracksModel;
+        AllTracksProxyModel proxyModel;
+        proxyModel.setSourceModel(&tracksModel);
+
+        tracksModel.tracksAdded({syntheticTrack(1, QStringLiteral("Svefn-g-englar"), QStringLiteral("Sigur Rós"), 3),
+                                 syntheticTrack(2, QStringLiteral("Signal"), QStringLiteral("Unknown"), 3),
+                                 syntheticTrack(3, QStringLiteral("Sunday"), QStringLiteral("Unknown"), 3),
+                                 syntheticTrack(4, QStringLiteral("Glósóli"), QStringLiteral("Sigur Rós"), 1)});
+
+        QVERIFY(applyFilterText(proxyModel, QStringLiteral("s")));
+        QCOMPARE(proxyModel.rowCount(), 4);
+
+        QVERIFY(applyFilterText(proxyModel, QStringLiteral("sig")));
+        QCOMPARE(proxyModel.rowCount(), 3);
+
+        QVERIFY(applyFilterText(proxyModel, QStringLiteral("sigu")));
+        QCOMPARE(proxyModel.rowCount(), 2);
+
+        QVERIFY(applyFilterRating(proxyModel, 2));
+        QCOMPARE(proxyModel.rowCount(), 1);
+
+        QVERIFY(applyFilterRating(proxyModel, 0));
+        QCOMPARE(proxyModel.rowCount(), 2);
+
+        QVERIFY(applyFilterText(proxyModel, QStringLiteral("s")));
+        QCOMPARE(proxyModel.rowCount(), 4);
+
+        tracksModel.tracksAdded({syntheticTrack(5, QStringLiteral("Saeglopur"), QStringLiteral("Sigur Rós"), 4)});
+        QCOMPARE(proxyModel.rowCount(), 5);
+
+        QVERIFY(applyFilterText(proxyModel, QStringLiteral("sigur")));
+        QCOMPARE(proxyModel.rowCount(), 3);
+    }
+
+    void coalesceFilterKeystrokes()
+    {
+        AllTracksModel tracksModel;
+        AllTracksProxyModel proxyModel;
+        proxyModel.setSourceModel(&tracksModel);
+
+        tracksModel.tracksAdded({syntheticTrack(1, QStringLiteral("Café del Mar"), QStringLiteral("Energy 52"), 2),
+                                 syntheticTrack(2, QStringLiteral("Crazy in Love"), QStringLiteral("Beyoncé"), 4)});
+
+        QSignalSpy filterAppliedSpy(&proxyModel, &AllTracksProxyModel::filterApplied);
+
+        proxyModel.setFilterText(QStringLiteral("c"));
+        proxyModel.setFilterText(QStringLiteral("ca"));
+        proxyModel.setFilterText(QStringLiteral("caf"));
+
+        QCOMPARE(proxyModel.rowCount(), 2);
+
+        QVERIFY(filterAppliedSpy.wait());
+        QCOMPARE(filterAppliedSpy.count(), 1);
+        QCOMPARE(proxyModel.rowCount(), 1);
+    }
+
+    void enqueuePagedModelFromDatabaseIds()
+    {
+        AllTracksModel tracksModel;
+        tracksModel.setPaged(true);
+
+        AllTracksProxyModel proxyModel;
+        proxyModel.setSourceModel(&tracksModel);
+
+        tracksModel.setTracksCount(1000);
+
+        QSignalSpy requestAllTracksIdsSpy(&tracksModel, &AllTracksModel::requestAllTracksIds);
+        QSignalSpy trackToEnqueueSpy(&proxyModel, &AllTracksProxyModel::trackToEnqueue);
+        QSignalSpy trackIdsToEnqueueSpy(&proxyModel, &AllTracksProxyModel::trackIdsToEnqueue);
+
+        /* no page is loaded, the whole list comes from the database */
+        proxyModel.enqueueToPlayList();
+        proxyModel.replaceAndPlayOfPlayList();
+
+        QCOMPARE(requestAllTracksIdsSpy.count(), 2);
+
+        tracksModel.setAllTracksIds({1, 2, 3});
+        tracksModel.setAllTracksIds({4, 5});
+
+        QCOMPARE(trackToEnqueueSpy.count(), 0);
+        QCOMPARE(trackIdsToEnqueueSpy.count(), 2);
+        QCOMPARE(trackIdsToEnqueueSpy.at(0).at(0).value<QList<qulonglong>>(), (QList<qulonglong>{1, 2, 3}));
+        QCOMPARE(trackIdsToEnqueueSpy.at(0).at(1).value<ElisaUtils::PlayListEnqueueMode>(), ElisaUtils::AppendPlayList);
+        QCOMPARE(trackIdsToEnqueueSpy.at(0).at(2).value<ElisaUtils::PlayListEnqueueTriggerPlay>(), ElisaUtils::DoNotTriggerPlay);
+        QCOMPARE(trackIdsToEnqueueSpy.at(1).at(0).value<QList<qulonglong>>(), (QList<qulonglong>{4, 5}));
+        QCOMPARE(trackIdsToEnqueueSpy.at(1).at(1).value<ElisaUtils::PlayListEnqueueMode>(), ElisaUtils::ReplacePlayList);
+        QCOMPARE(trackIdsToEnqueueSpy.at(1).at(2).value<ElisaUtils::PlayListEnqueueTriggerPlay>(), ElisaUtils::TriggerPlay);
+    }
+};
+
+QTEST_GUILESS_MAIN(AllTracksProxyModelTests)
+
+
+#include "alltracksproxymodeltest.moc"
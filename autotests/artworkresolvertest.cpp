@@ -0,0 +1,129 @@
+/*
+ * Copyright 2017 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "abstractfile/artworkresolver.h"
+
+#include <QObject>
+#include <QString>
+#include <QUrl>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <QtTest>
+
+class ArtworkResolverTests: public QObject
+{
+    Q_OBJECT
+
+public:
+
+    ArtworkResolverTests(QObject *parent = nullptr) : QObject(parent)
+    {
+    }
+
+private:
+
+    static bool writeFile(const QString &fileName, const QByteArray &content)
+    {
+        QFile newFile(fileName);
+
+        return newFile.open(QIODevice::WriteOnly) && newFile.write(content) == content.size();
+    }
+
+private Q_SLOTS:
+
+    void preferredCoverName()
+    {
+        QTemporaryDir rootDirectory;
+        QVERIFY(rootDirectory.isValid());
+
+        const auto albumPath = rootDirectory.path() + QStringLiteral("/album");
+        QVERIFY(QDir().mkpath(albumPath));
+
+        QVERIFY(writeFile(albumPath + QStringLiteral("/front.jpg"), QByteArrayLiteral("front")));
+        QVERIFY(writeFile(albumPath + QStringLiteral("/Folder.PNG"), QByteArrayLiteral("folder")));
+        QVERIFY(writeFile(albumPath + QStringLiteral("/booklet.jpg"), QByteArrayLiteral("booklet")));
+
+        ArtworkResolver myResolver(rootDirectory.path() + QStringLiteral("/cache"));
+
+        const auto firstCover = myResolver.coverForTrack(QUrl::fromLocalFile(albumPath + QStringLiteral("/01.ogg")), QStringLiteral("album"));
+        const auto secondCover = myResolver.coverForTrack(QUrl::fromLocalFile(albumPath + QStringLiteral("/02.ogg")), QStringLiteral("album"));
+
+        QCOMPARE(firstCover, QUrl::fromLocalFile(albumPath + QStringLiteral("/Folder.PNG")));
+        QCOMPARE(secondCover, firstCover);
+    }
+
+    void identicalCoversAreShared()
+    {
+        QTemporaryDir rootDirectory;
+        QVERIFY(rootDirectory.isValid());
+
+        const auto firstAlbumPath = rootDirectory.path() + QStringLiteral("/disc1");
+        const auto secondAlbumPath = rootDirectory.path() + QStringLiteral("/disc2");
+        QVERIFY(QDir().mkpath(firstAlbumPath));
+        QVERIFY(QDir().mkpath(secondAlbumPath));
+
+        QVERIFY(writeFile(firstAlbumPath + QStringLiteral("/cover.jpg"), QByteArrayLiteral("same image")));
+        QVERIFY(writeFile(secondAlbumPath + QStringLiteral("/cover.jpg"), QByteArrayLiteral("same image")));
+
+        ArtworkResolver myResolver(rootDirectory.path() + QStringLiteral("/cache"));
+
+        const auto firstCover = myResolver.coverForTrack(QUrl::fromLocalFile(firstAlbumPath + QStringLiteral("/01.ogg")), QStringLiteral("album"));
+        const auto secondCover = myResolver.coverForTrack(QUrl::fromLocalFile(secondAlbumPath + QStringLiteral("/01.ogg")), QStringLiteral("album"));
+
+        QCOMPARE(firstCover, QUrl::fromLocalFile(firstAlbumPath + QStringLiteral("/cover.jpg")));
+        QCOMPARE(secondCover, firstCover);
+
+        QVERIFY(writeFile(secondAlbumPath + QStringLiteral("/cover.jpg"), QByteArrayLiteral("other image")));
+        myResolver.forgetDirectory(secondAlbumPath);
+
+        const auto modifiedCover = myResolver.coverForTrack(QUrl::fromLocalFile(secondAlbumPath + QStringLiteral("/01.ogg")), QStringLiteral("album"));
+
+        QCOMPARE(modifiedCover, QUrl::fromLocalFile(secondAlbumPath + QStringLiteral("/cover.jpg")));
+    }
+
+    void directoryListedOnce()
+    {
+        QTemporaryDir rootDirectory;
+        QVERIFY(rootDirectory.isValid());
+
+        const auto albumPath = rootDirectory.path() + QStringLiteral("/album");
+        QVERIFY(QDir().mkpath(albumPath));
+
+        ArtworkResolver myResolver(rootDirectory.path() + QStringLiteral("/cache"));
+
+        const auto trackFile = QUrl::fromLocalFile(albumPath + QStringLiteral("/01.ogg"));
+
+        QCOMPARE(myResolver.coverForTrack(trackFile, QStringLiteral("album")).isValid(), false);
+
+        QVERIFY(writeFile(albumPath + QStringLiteral("/cover.png"), QByteArrayLiteral("cover")));
+
+        QCOMPARE(myResolver.coverForTrack(trackFile, QStringLiteral("album")).isValid(), false);
+
+        myResolver.forgetDirectory(albumPath);
+
+        QCOMPARE(myResolver.coverForTrack(trackFile, QStringLiteral("album")), QUrl::fromLocalFile(albumPath + QStringLiteral("/cover.png")));
+    }
+};
+
+QTEST_GUILESS_MAIN(ArtworkResolverTests)
+
+
+#include "artworkresolvertest.moc"
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2017 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "coverthumbnailprovider.h"
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+#include <QSize>
+#include <QImage>
+#include <QColor>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QTemporaryDir>
+
+#include <QtTest>
+
+#include <utime.h>
+
+class CoverThumbnailProviderTests: public QObject
+{
+    Q_OBJECT
+
+public:
+
+    CoverThumbnailProviderTests(QObject *parent = nullptr) : QObject(parent)
+    {
+    }
+
+private:
+
+    static bool writeCover(const QString &fileName, const QSize &size, const QColor &color)
+    {
+        QImage cover(size, QImage::Format_RGB32);
+        cover.fill(color);
+
+        return cover.save(fileName, "PNG");
+    }
+
+private Q_SLOTS:
+
+    void bucketSizes()
+    {
+        QCOMPARE(CoverThumbnailProvider::bucketSize({}), 512);
+        QCOMPARE(CoverThumbnailProvider::bucketSize({32, 32}), 32);
+        QCOMPARE(CoverThumbnailProvider::bucketSize({20, 33}), 64);
+        QCOMPARE(CoverThumbnailProvider::bucketSize({180, 0}), 256);
+        QCOMPARE(CoverThumbnailProvider::bucketSize({512, 512}), 512);
+        QCOMPARE(CoverThumbnailProvider::bucketSize({1920, 0}), 0);
+    }
+
+    void scaledThumbnailIsStored()
+    {
+        QTemporaryDir rootDirectory;
+        QVERIFY(rootDirectory.isValid());
+
+        const auto coverFileName = rootDirectory.path() + QStringLiteral("/cover.png");
+        QVERIFY(writeCover(coverFileName, {1000, 800}, Qt::red));
+
+        CoverThumbnailProvider myProvider(rootDirectory.path() + QStringLiteral("/cache"));
+
+        const auto thumbnail = myProvider.thumbnail(QUrl::fromLocalFile(coverFileName), {180, 180});
+
+        QCOMPARE(thumbnail.size(), QSize(256, 204));
+
+        const auto thumbnailFileName = myProvider.thumbnailFileName(coverFileName, 256);
+        QVERIFY(thumbnailFileName.startsWith(rootDirectory.path() + QStringLiteral("/cache/256/")));
+        QVERIFY(QFile::exists(thumbnailFileName));
+        QCOMPARE(QImage(thumbnailFileName).size(), QSize(256, 204));
+
+        CoverThumbnailProvider otherProvider(rootDirectory.path() + QStringLiteral("/cache"));
+
+        QVERIFY(QFile::remove(coverFileName));
+        QVERIFY(writeCover(coverFileName, {1000, 800}, Qt::blue));
+        const auto modificationTime = QFileInfo(thumbnailFileName).lastModified().addSecs(10).toSecsSinceEpoch();
+        const struct utimbuf coverTimes = {static_cast<time_t>(modificationTime), static_cast<time_t>(modificationTime)};
+        QCOMPARE(utime(QFile::encodeName(coverFileName).constData(), &coverTimes), 0);
+
+        const auto modifiedThumbnailFileName = otherProvider.thumbnailFileName(coverFileName, 256);
+        QVERIFY(modifiedThumbnailFileName != thumbnailFileName);
+
+        const auto modifiedThumbnail = otherProvider.thumbnail(QUrl::fromLocalFile(coverFileName), {180, 180});
+
+        QCOMPARE(modifiedThumbnail.size(), QSize(256, 204));
+        QCOMPARE(QColor(modifiedThumbnail.pixel(128, 100)).blue(), 255);
+    }
+
+    void smallCoversAreNotEnlarged()
+    {
+        QTemporaryDir rootDirectory;
+        QVERIFY(rootDirectory.isValid());
+
+        const auto coverFileName = rootDirectory.path() + QStringLiteral("/cover.png");
+        QVERIFY(writeCover(coverFileName, {100, 100}, Qt::green));
+
+        CoverThumbnailProvider myProvider(rootDirectory.path() + QStringLiteral("/cache"));
+
+        QCOMPARE(myProvider.thumbnail(QUrl::fromLocalFile(coverFileName), {180, 180}).size(), QSize(100, 100));
+        QCOMPARE(myProvider.thumbnail(QUrl::fromLocalFile(coverFileName), {32, 32}).size(), QSize(32, 32));
+    }
+
+    void diskCacheIsBounded()
+    {
+        QTemporaryDir rootDirectory;
+        QVERIFY(rootDirectory.isValid());
+
+        const auto cacheDirectory = rootDirectory.path() + QStringLiteral("/cache");
+
+        auto coverFileNames = QStringList();
+        for (int i = 0; i < 4; ++i) {
+            coverFileNames.push_back(rootDirectory.path() + QStringLiteral("/cover") + QString::number(i) + QStringLiteral(".png"));
+            QVERIFY(writeCover(coverFileNames.last(), {1000, 1000}, Qt::red));
+        }
+
+        CoverThumbnailProvider sizeProvider(rootDirectory.path() + QStringLiteral("/sizeCache"));
+        QVERIFY(!sizeProvider.thumbnail(QUrl::fromLocalFile(coverFileNames.first()), {512, 512}).isNull());
+        const auto thumbnailSize = QFileInfo(sizeProvider.thumbnailFileName(coverFileNames.first(), 512)).size();
+        QVERIFY(thumbnailSize > 0);
+
+        const auto diskCacheMaximumSize = 3 * thumbnailSize + thumbnailSize / 2;
+        CoverThumbnailProvider myProvider(cacheDirectory, diskCacheMaximumSize);
+
+        for (const auto &oneCoverFileName : coverFileNames) {
+            QCOMPARE(myProvider.thumbnail(QUrl::fromLocalFile(oneCoverFileName), {512, 512}).size(), QSize(512, 512));
+        }
+
+        auto storedThumbnailsCount = 0;
+        auto storedThumbnailsSize = qint64(0);
+        for (const auto &oneCoverFileName : coverFileNames) {
+            const auto thumbnailInformation = QFileInfo(myProvider.thumbnailFileName(oneCoverFileName, 512));
+            if (thumbnailInformation.exists()) {
+                ++storedThumbnailsCount;
+                storedThumbnailsSize += thumbnailInformation.size();
+            }
+        }
+
+        QCOMPARE(storedThumbnailsCount, 2);
+        QVERIFY(storedThumbnailsSize <= diskCacheMaximumSize);
+
+        for (const auto &oneCoverFileName : coverFileNames) {
+            QCOMPARE(myProvider.thumbnail(QUrl::fromLocalFile(oneCoverFileName), {512, 512}).size(), QSize(512, 512));
+        }
+    }
+
+    void missingCover()
+    {
+        QTemporaryDir rootDirectory;
+        QVERIFY(rootDirectory.isValid());
+
+        CoverThumbnailProvider myProvider(rootDirectory.path() + QStringLiteral("/cache"));
+
+        const auto missingCoverFileName = rootDirectory.path() + QStringLiteral("/missing.png");
+
+        QVERIFY(myProvider.thumbnail(QUrl::fromLocalFile(missingCoverFileName), {180, 180}).isNull());
+        QVERIFY(myProvider.thumbnailFileName(missingCoverFileName, 256).isEmpty());
+        QVERIFY(!QDir(rootDirectory.path() + QStringLiteral("/cache")).exists());
+    }
+};
+
+QTEST_GUILESS_MAIN(CoverThumbnailProviderTests)
+
+
+#include "coverthumbnailprovidertest.moc"
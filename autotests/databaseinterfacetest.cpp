@@ -131,6 +131,9 @@ private Q_SLOTS:
         qRegisterMetaType<QVector<qlonglong>>("QVector<qlonglong>");
         qRegisterMetaType<QHash<qlonglong,int>>("QHash<qlonglong,int>");
         qRegisterMetaType<MusicArtist>("MusicArtist");
+        qRegisterMetaType<QList<MusicAlbum>>("QList<MusicAlbum>");
+        qRegisterMetaType<QList<MusicArtist>>("QList<MusicArtist>");
+        qRegisterMetaType<QList<qulonglong>>("QList<qulonglong>");
     }
 
     void avoidCrashInTrackIdFromTitleAlbumArtist()
@@ -659,6 +662,296 @@ private Q_SLOTS:
         }
     }
 
+    void readPagedCollectionWithDatabaseFile()
+    {
+        QTemporaryFile myTempDatabase;
+        myTempDatabase.open();
+
+        {
+            DatabaseInterface musicDb;
+
+            QSignalSpy musicDbTrackAddedSpy(&musicDb, &DatabaseInterface::trackAdded);
+
+            musicDb.init(QStringLiteral("testDb1"), myTempDatabase.fileName());
+
+            musicDb.insertTracksList(mNewTracks, mNewCovers, QStringLiteral("autoTest"));
+
+            musicDbTrackAddedSpy.wait(300);
+        }
+
+        {
+            DatabaseInterface musicDb;
+
+            QSignalSpy musicDbArtistAddedSpy(&musicDb, &DatabaseInterface::artistAdded);
+            QSignalSpy musicDbAlbumsAddedSpy(&musicDb, &DatabaseInterface::albumsAdded);
+            QSignalSpy musicDbTracksAddedSpy(&musicDb, &DatabaseInterface::tracksAdded);
+            QSignalSpy musicDbTracksCountSpy(&musicDb, &DatabaseInterface::sentTracksCount);
+            QSignalSpy musicDbAlbumsCountSpy(&musicDb, &DatabaseInterface::sentAlbumsCount);
+            QSignalSpy musicDbArtistsCountSpy(&musicDb, &DatabaseInterface::sentArtistsCount);
+            QSignalSpy musicDbTracksPageSpy(&musicDb, &DatabaseInterface::sentTracksPage);
+            QSignalSpy musicDbAlbumsPageSpy(&musicDb, &DatabaseInterface::sentAlbumsPage);
+            QSignalSpy musicDbArtistsPageSpy(&musicDb, &DatabaseInterface::sentArtistsPage);
+            QSignalSpy musicDbDatabaseErrorSpy(&musicDb, &DatabaseInterface::databaseError);
+
+            musicDb.init(QStringLiteral("testDb2"), myTempDatabase.fileName(), true);
+
+            const auto allTracks = musicDb.allTracks();
+            const auto allAlbums = musicDb.allAlbums();
+            const auto allArtists = musicDb.allArtists();
+
+            QCOMPARE(musicDbArtistAddedSpy.count(), 0);
+            QCOMPARE(musicDbAlbumsAddedSpy.count(), 0);
+            QCOMPARE(musicDbTracksAddedSpy.count(), 0);
+            QCOMPARE(musicDbTracksCountSpy.count(), 1);
+            QCOMPARE(musicDbTracksCountSpy.at(0).at(0).toInt(), allTracks.count());
+            QCOMPARE(musicDbAlbumsCountSpy.count(), 1);
+            QCOMPARE(musicDbAlbumsCountSpy.at(0).at(0).toInt(), allAlbums.count());
+            QCOMPARE(musicDbArtistsCountSpy.count(), 1);
+            QCOMPARE(musicDbArtistsCountSpy.at(0).at(0).toInt(), allArtists.count());
+
+            musicDb.getTracksPage(0, 2, 0, 0);
+
+            QCOMPARE(musicDbTracksPageSpy.count(), 1);
+
+            const auto firstTracksPage = musicDbTracksPageSpy.at(0).at(1).value<QList<MusicAudioTrack>>();
+
+            QCOMPARE(firstTracksPage.count(), 2);
+
+            musicDb.getTracksPage(2, 100, firstTracksPage.last().databaseId(), 0);
+
+            /* the same page read without knowing the previous one */
+            musicDb.getTracksPage(2, 100, 0, 2);
+
+            QCOMPARE(musicDbTracksPageSpy.count(), 3);
+            QCOMPARE(musicDbTracksPageSpy.at(0).at(0).toInt(), 0);
+            QCOMPARE(musicDbTracksPageSpy.at(1).at(0).toInt(), 2);
+            QCOMPARE(musicDbTracksPageSpy.at(2).at(0).toInt(), 2);
+
+            const auto secondTracksPage = musicDbTracksPageSpy.at(1).at(1).value<QList<MusicAudioTrack>>();
+
+            QCOMPARE(firstTracksPage.count() + secondTracksPage.count(), allTracks.count());
+            QVERIFY(firstTracksPage.at(0).databaseId() < firstTracksPage.at(1).databaseId());
+            QVERIFY(firstTracksPage.at(1).databaseId() < secondTracksPage.at(0).databaseId());
+
+            const auto skippedTracksPage = musicDbTracksPageSpy.at(2).at(1).value<QList<MusicAudioTrack>>();
+
+            QCOMPARE(skippedTracksPage.count(), secondTracksPage.count());
+            for (int trackIndex = 0; trackIndex < secondTracksPage.count(); ++trackIndex) {
+                QCOMPARE(skippedTracksPage.at(trackIndex).databaseId(), secondTracksPage.at(trackIndex).databaseId());
+            }
+
+            /* a page after the last row is empty */
+            musicDb.getTracksPage(allTracks.count(), 100, 0, allTracks.count());
+
+            QCOMPARE(musicDbTracksPageSpy.count(), 4);
+            QCOMPARE(musicDbTracksPageSpy.at(3).at(1).value<QList<MusicAudioTrack>>().isEmpty(), true);
+
+            musicDb.getAlbumsPage(0, 100, 0, 0);
+
+            QCOMPARE(musicDbAlbumsPageSpy.count(), 1);
+
+            const auto albumsPage = musicDbAlbumsPageSpy.at(0).at(1).value<QList<MusicAlbum>>();
+
+            QCOMPARE(albumsPage.count(), allAlbums.count());
+            for (const auto &oneAlbum : albumsPage) {
+                const auto storedAlbum = musicDb.albumFromTitleAndArtist(oneAlbum.title(), oneAlbum.artist());
+
+                QCOMPARE(oneAlbum.tracksCount(), storedAlbum.tracksCount());
+                for (int trackIndex = 0; trackIndex < oneAlbum.tracksCount(); ++trackIndex) {
+                    QCOMPARE(oneAlbum.trackFromIndex(trackIndex).databaseId(), storedAlbum.trackFromIndex(trackIndex).databaseId());
+                }
+            }
+
+            musicDb.getArtistsPage(0, 100, 0, 0);
+
+            QCOMPARE(musicDbArtistsPageSpy.count(), 1);
+
+            const auto artistsPage = musicDbArtistsPageSpy.at(0).at(1).value<QList<MusicArtist>>();
+
+            QCOMPARE(artistsPage.count(), allArtists.count());
+            for (const auto &oneArtist : artistsPage) {
+                const auto itArtist = std::find_if(allArtists.begin(), allArtists.end(), [&oneArtist] (const MusicArtist &otherArtist) {
+                    return otherArtist.databaseId() == oneArtist.databaseId();
+                });
+
+                QVERIFY(itArtist != allArtists.end());
+                QCOMPARE(oneArtist.name(), itArtist->name());
+                QCOMPARE(oneArtist.albumsCount(), itArtist->albumsCount());
+            }
+
+            /* enqueuing a paged view reads all its rows in page order */
+            QSignalSpy musicDbAllTracksIdsSpy(&musicDb, &DatabaseInterface::sentAllTracksIds);
+            QSignalSpy musicDbAllAlbumsTracksIdsSpy(&musicDb, &DatabaseInterface::sentAllAlbumsTracksIds);
+            QSignalSpy musicDbAllArtistsNamesSpy(&musicDb, &DatabaseInterface::sentAllArtistsNames);
+            QSignalSpy musicDbAlbumsFromArtistSpy(&musicDb, &DatabaseInterface::sentAlbumsFromArtist);
+
+            musicDb.getAllTracksIds();
+
+            QCOMPARE(musicDbAllTracksIdsSpy.count(), 1);
+
+            const auto allTracksIds = musicDbAllTracksIdsSpy.at(0).at(0).value<QList<qulonglong>>();
+
+            QCOMPARE(allTracksIds.count(), allTracks.count());
+            QCOMPARE(allTracksIds.at(0), firstTracksPage.at(0).databaseId());
+            QCOMPARE(allTracksIds.at(2), secondTracksPage.at(0).databaseId());
+
+            musicDb.getAllAlbumsTracksIds();
+
+            QCOMPARE(musicDbAllAlbumsTracksIdsSpy.count(), 1);
+
+            const auto allAlbumsTracksIds = musicDbAllAlbumsTracksIdsSpy.at(0).at(0).value<QList<qulonglong>>();
+
+            QCOMPARE(allAlbumsTracksIds.toSet(), allTracksIds.toSet());
+            QCOMPARE(allAlbumsTracksIds.at(0), albumsPage.at(0).trackFromIndex(0).databaseId());
+
+            musicDb.getAllArtistsNames();
+
+            QCOMPARE(musicDbAllArtistsNamesSpy.count(), 1);
+
+            const auto allArtistsNames = musicDbAllArtistsNamesSpy.at(0).at(0).toStringList();
+
+            QCOMPARE(allArtistsNames.count(), artistsPage.count());
+            QCOMPARE(allArtistsNames.at(0), artistsPage.at(0).name());
+
+            musicDb.getAlbumsFromArtist(QStringLiteral("artist2"));
+
+            QCOMPARE(musicDbAlbumsFromArtistSpy.count(), 1);
+
+            const auto artistAlbums = musicDbAlbumsFromArtistSpy.at(0).at(0).value<QList<MusicAlbum>>();
+
+            QVERIFY(!artistAlbums.isEmpty());
+            for (const auto &oneAlbum : artistAlbums) {
+                QVERIFY(oneAlbum.artist() == QStringLiteral("artist2") || oneAlbum.allArtists().contains(QStringLiteral("artist2")));
+            }
+
+            QCOMPARE(musicDbDatabaseErrorSpy.count(), 0);
+        }
+    }
+
+    void storePlayListEntriesWithDatabaseFile()
+    {
+        QTemporaryFile myTempDatabase;
+        myTempDatabase.open();
+
+        auto newEntry = [](qulonglong databaseId, const QString &title, const QUrl &fileName) {
+            auto result = MusicAudioTrack();
+            result.setDatabaseId(databaseId);
+            result.setTitle(title);
+            result.setArtist(QStringLiteral("artist1"));
+            result.setAlbumName(QStringLiteral("album1"));
+            result.setTrackNumber(1);
+            result.setDiscNumber(1);
+            result.setResourceURI(fileName);
+            return result;
+        };
+
+        {
+            DatabaseInterface musicDb;
+
+            QSignalSpy musicDbDatabaseErrorSpy(&musicDb, &DatabaseInterface::databaseError);
+
+            musicDb.init(QStringLiteral("testDb1"), myTempDatabase.fileName());
+
+            musicDb.insertPlayListEntries(QStringLiteral("current"), 0, {newEntry(1, QStringLiteral("a"), {}),
+                                                                         newEntry(2, QStringLiteral("b"), {}),
+                                                                         newEntry(3, QStringLiteral("c"), {})});
+            musicDb.insertPlayListEntries(QStringLiteral("current"), 1, {newEntry(4, QStringLiteral("d"), {}),
+                                                                         newEntry(5, QStringLiteral("e"), {})});
+            musicDb.insertPlayListEntries(QStringLiteral("other"), 0, {newEntry(6, QStringLiteral("f"), {})});
+
+            musicDb.movePlayListEntries(QStringLiteral("current"), 1, 2, 5);
+            musicDb.removePlayListEntries(QStringLiteral("current"), 0, 1);
+            musicDb.updatePlayListEntry(QStringLiteral("current"), 2, newEntry(0, QStringLiteral("x"), QUrl::fromLocalFile(QStringLiteral("/x.ogg"))));
+            musicDb.movePlayListEntries(QStringLiteral("current"), 2, 1, 0);
+
+            QCOMPARE(musicDbDatabaseErrorSpy.count(), 0);
+        }
+
+        {
+            DatabaseInterface musicDb;
+
+            QSignalSpy musicDbPlayListEntriesSpy(&musicDb, &DatabaseInterface::sentPlayListEntries);
+            QSignalSpy musicDbDatabaseErrorSpy(&musicDb, &DatabaseInterface::databaseError);
+
+            musicDb.init(QStringLiteral("testDb2"), myTempDatabase.fileName());
+
+            musicDb.getPlayListEntries(QStringLiteral("current"));
+
+            QCOMPARE(musicDbPlayListEntriesSpy.count(), 1);
+            QCOMPARE(musicDbPlayListEntriesSpy.at(0).at(0).toString(), QStringLiteral("current"));
+
+            const auto storedEntries = musicDbPlayListEntriesSpy.at(0).at(1).value<QList<MusicAudioTrack>>();
+
+            QCOMPARE(storedEntries.count(), 4);
+            QCOMPARE(storedEntries.at(0).title(), QStringLiteral("x"));
+            QCOMPARE(storedEntries.at(0).databaseId(), qulonglong(0));
+            QCOMPARE(storedEntries.at(0).resourceURI(), QUrl::fromLocalFile(QStringLiteral("/x.ogg")));
+            QCOMPARE(storedEntries.at(1).title(), QStringLiteral("b"));
+            QCOMPARE(storedEntries.at(1).databaseId(), qulonglong(2));
+            QCOMPARE(storedEntries.at(1).resourceURI().isValid(), false);
+            QCOMPARE(storedEntries.at(1).artist(), QStringLiteral("artist1"));
+            QCOMPARE(storedEntries.at(1).albumName(), QStringLiteral("album1"));
+            QCOMPARE(storedEntries.at(1).trackNumber(), 1);
+            QCOMPARE(storedEntries.at(1).discNumber(), 1);
+            QCOMPARE(storedEntries.at(2).title(), QStringLiteral("c"));
+            QCOMPARE(storedEntries.at(3).title(), QStringLiteral("e"));
+
+            musicDb.clearPlayListEntries(QStringLiteral("current"));
+
+            musicDb.getPlayListEntries(QStringLiteral("current"));
+            musicDb.getPlayListEntries(QStringLiteral("other"));
+
+            QCOMPARE(musicDbPlayListEntriesSpy.count(), 3);
+            QCOMPARE(musicDbPlayListEntriesSpy.at(1).at(1).value<QList<MusicAudioTrack>>().count(), 0);
+            QCOMPARE(musicDbPlayListEntriesSpy.at(2).at(1).value<QList<MusicAudioTrack>>().count(), 1);
+            QCOMPARE(musicDbPlayListEntriesSpy.at(2).at(1).value<QList<MusicAudioTrack>>().at(0).title(), QStringLiteral("f"));
+
+            QCOMPARE(musicDbDatabaseErrorSpy.count(), 0);
+        }
+    }
+
+    void storePlayListEntriesInsertedAtOneRow()
+    {
+        DatabaseInterface musicDb;
+
+        QSignalSpy musicDbPlayListEntriesSpy(&musicDb, &DatabaseInterface::sentPlayListEntries);
+        QSignalSpy musicDbDatabaseErrorSpy(&musicDb, &DatabaseInterface::databaseError);
+
+        musicDb.init(QStringLiteral("testDb"));
+
+        auto newEntry = [](const QString &title) {
+            auto result = MusicAudioTrack();
+            result.setTitle(title);
+            return result;
+        };
+
+        musicDb.insertPlayListEntries(QStringLiteral("current"), 0, {newEntry(QStringLiteral("first")), newEntry(QStringLiteral("last"))});
+
+        /* more insertions than the gap between two entries holds, the positions are spread again on the way */
+        const int insertedCount = 40;
+        for (int entryIndex = 0; entryIndex < insertedCount; ++entryIndex) {
+            musicDb.insertPlayListEntries(QStringLiteral("current"), 1, {newEntry(QString::number(entryIndex))});
+        }
+
+        musicDb.movePlayListEntries(QStringLiteral("current"), 0, 1, insertedCount + 1);
+        musicDb.removePlayListEntries(QStringLiteral("current"), 0, 1);
+
+        musicDb.getPlayListEntries(QStringLiteral("current"));
+
+        QCOMPARE(musicDbPlayListEntriesSpy.count(), 1);
+
+        const auto storedEntries = musicDbPlayListEntriesSpy.at(0).at(1).value<QList<MusicAudioTrack>>();
+
+        QCOMPARE(storedEntries.count(), insertedCount + 1);
+        for (int entryIndex = 0; entryIndex < insertedCount - 1; ++entryIndex) {
+            QCOMPARE(storedEntries.at(entryIndex).title(), QString::number(insertedCount - 2 - entryIndex));
+        }
+        QCOMPARE(storedEntries.at(insertedCount - 1).title(), QStringLiteral("first"));
+        QCOMPARE(storedEntries.at(insertedCount).title(), QStringLiteral("last"));
+
+        QCOMPARE(musicDbDatabaseErrorSpy.count(), 0);
+    }
+
     void restoreModifiedTracksWidthDatabaseFile()
     {
         QTemporaryFile myTempDatabase;
@@ -2813,6 +3106,112 @@ private Q_SLOTS:
         QCOMPARE(track.trackNumber(), 5);
     }
 
+    void renameOneTrack()
+    {
+        DatabaseInterface musicDb;
+
+        musicDb.init(QStringLiteral("testDb"));
+
+        QSignalSpy musicDbTrackAddedSpy(&musicDb, &DatabaseInterface::trackAdded);
+        QSignalSpy musicDbTrackRemovedSpy(&musicDb, &DatabaseInterface::trackRemoved);
+        QSignalSpy musicDbTrackModifiedSpy(&musicDb, &DatabaseInterface::trackModified);
+        QSignalSpy musicDbDatabaseErrorSpy(&musicDb, &DatabaseInterface::databaseError);
+
+        musicDb.insertTracksList(mNewTracks, mNewCovers, QStringLiteral("autoTest"));
+
+        musicDbTrackAddedSpy.wait(300);
+
+        QCOMPARE(musicDbTrackAddedSpy.count(), 13);
+
+        const auto previousFileName = QUrl::fromLocalFile(QStringLiteral("/$3"));
+        const auto newFileName = QUrl::fromLocalFile(QStringLiteral("/renamed/$3"));
+
+        auto trackId = musicDb.trackIdFromFileName(previousFileName);
+        QCOMPARE(trackId != 0, true);
+
+        const auto trackModifiedCount = musicDbTrackModifiedSpy.count();
+
+        musicDb.renameTracksList({{previousFileName, newFileName}});
+
+        QCOMPARE(musicDbTrackAddedSpy.count(), 13);
+        QCOMPARE(musicDbTrackRemovedSpy.count(), 0);
+        QCOMPARE(musicDbTrackModifiedSpy.count(), trackModifiedCount + 1);
+        QCOMPARE(musicDbDatabaseErrorSpy.count(), 0);
+
+        QCOMPARE(musicDb.trackIdFromFileName(previousFileName), qulonglong(0));
+        QCOMPARE(musicDb.trackIdFromFileName(newFileName), trackId);
+
+        auto track = musicDb.trackFromDatabaseId(trackId);
+
+        QCOMPARE(track.isValid(), true);
+        QCOMPARE(track.resourceURI(), newFileName);
+
+        auto modifiedTrack = musicDbTrackModifiedSpy.last().at(0).value<MusicAudioTrack>();
+        QCOMPARE(modifiedTrack.databaseId(), trackId);
+        QCOMPARE(modifiedTrack.resourceURI(), newFileName);
+    }
+
+    void restoreKnownTracksWithFileState()
+    {
+        DatabaseInterface musicDb;
+
+        musicDb.init(QStringLiteral("testDb"));
+
+        QSignalSpy musicDbTrackAddedSpy(&musicDb, &DatabaseInterface::trackAdded);
+        QSignalSpy musicDbDatabaseErrorSpy(&musicDb, &DatabaseInterface::databaseError);
+
+        auto newTracks = mNewTracks;
+        newTracks.first().setFileSize(1000);
+        newTracks.first().setFileModificationTime(2000);
+
+        musicDb.insertTracksList(newTracks, mNewCovers, QStringLiteral("autoTest"));
+
+        musicDbTrackAddedSpy.wait(300);
+
+        QCOMPARE(musicDbTrackAddedSpy.count(), 13);
+
+        const auto findKnownTrack = [](const QList<MusicAudioTrack> &knownTracks, const QUrl &fileName) {
+            return std::find_if(knownTracks.begin(), knownTracks.end(), [&fileName](const MusicAudioTrack &oneTrack) {
+                return oneTrack.resourceURI() == fileName;
+            });
+        };
+
+        const auto previousFileName = newTracks.first().resourceURI();
+        const auto newFileName = QUrl::fromLocalFile(QStringLiteral("/renamed/known"));
+
+        auto knownTracks = musicDb.restoreKnownTracks(QStringLiteral("autoTest"));
+
+        auto knownTrack = findKnownTrack(knownTracks, previousFileName);
+        QVERIFY(knownTrack != knownTracks.end());
+        QCOMPARE(knownTrack->fileSize(), qint64(1000));
+        QCOMPARE(knownTrack->fileModificationTime(), qint64(2000));
+
+        auto otherKnownTrack = findKnownTrack(knownTracks, newTracks.last().resourceURI());
+        QVERIFY(otherKnownTrack != knownTracks.end());
+        QCOMPARE(otherKnownTrack->fileSize(), qint64(-1));
+        QCOMPARE(otherKnownTrack->fileModificationTime(), qint64(-1));
+
+        musicDb.renameTracksList({{previousFileName, newFileName}});
+
+        knownTracks = musicDb.restoreKnownTracks(QStringLiteral("autoTest"));
+
+        QVERIFY(findKnownTrack(knownTracks, previousFileName) == knownTracks.end());
+        knownTrack = findKnownTrack(knownTracks, newFileName);
+        QVERIFY(knownTrack != knownTracks.end());
+        QCOMPARE(knownTrack->fileSize(), qint64(1000));
+
+        musicDb.removeTracksList({newFileName});
+        musicDb.insertTracksList({mNewTracks.first()}, mNewCovers, QStringLiteral("autoTest"));
+
+        knownTracks = musicDb.restoreKnownTracks(QStringLiteral("autoTest"));
+
+        knownTrack = findKnownTrack(knownTracks, previousFileName);
+        QVERIFY(knownTrack != knownTracks.end());
+        QCOMPARE(knownTrack->fileSize(), qint64(-1));
+
+        QCOMPARE(musicDbDatabaseErrorSpy.count(), 0);
+    }
+
     void addOneAlbum()
     {
         DatabaseInterface musicDb;
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2017 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "abstractfile/indexerfilter.h"
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+#include <QtTest>
+
+class IndexerFilterTests: public QObject
+{
+    Q_OBJECT
+
+public:
+
+    IndexerFilterTests(QObject *parent = nullptr) : QObject(parent)
+    {
+    }
+
+private Q_SLOTS:
+
+    void emptyFilter()
+    {
+        IndexerFilter myFilter;
+
+        QVERIFY(myFilter.isEmpty());
+        QVERIFY(!myFilter.isExcludedEntry(QStringLiteral("music"), QStringLiteral("/home/user/music")));
+        QVERIFY(!myFilter.isExcludedPath(QStringLiteral("/home/user/music/track.ogg"), QStringLiteral("/home/user/music")));
+        QVERIFY(!myFilter.isTooSmall(0));
+        QCOMPARE(myFilter.matchingPattern(QStringLiteral("music"), QStringLiteral("/home/user/music")), -1);
+    }
+
+    void namePatterns()
+    {
+        IndexerFilter myFilter({QStringLiteral("@eaDir"), QStringLiteral("*.wav"), QStringLiteral("stem?")}, 0);
+
+        QVERIFY(!myFilter.isEmpty());
+
+        QVERIFY(myFilter.isExcludedEntry(QStringLiteral("@eaDir"), QStringLiteral("/music/album/@eaDir")));
+        QVERIFY(myFilter.isExcludedEntry(QStringLiteral("kick.wav"), QStringLiteral("/music/samples/kick.wav")));
+        QVERIFY(myFilter.isExcludedEntry(QStringLiteral("stems"), QStringLiteral("/music/project/stems")));
+        QVERIFY(!myFilter.isExcludedEntry(QStringLiteral("stems.ogg"), QStringLiteral("/music/project/stems.ogg")));
+        QVERIFY(!myFilter.isExcludedEntry(QStringLiteral("track.ogg"), QStringLiteral("/music/album/track.ogg")));
+
+        QCOMPARE(myFilter.matchingPattern(QStringLiteral("@eaDir"), QStringLiteral("/music/album/@eaDir")), 0);
+        QCOMPARE(myFilter.matchingPattern(QStringLiteral("kick.wav"), QStringLiteral("/music/samples/kick.wav")), 1);
+        QCOMPARE(myFilter.matchingPattern(QStringLiteral("stems"), QStringLiteral("/music/project/stems")), 2);
+        QCOMPARE(myFilter.matchingPattern(QStringLiteral("track.ogg"), QStringLiteral("/music/album/track.ogg")), -1);
+    }
+
+    void pathPatterns()
+    {
+        IndexerFilter myFilter({QStringLiteral("/mnt/backup"), QStringLiteral("Samples/*"), QStringLiteral("/data/**/snapshot")}, 0);
+
+        QVERIFY(myFilter.isExcludedEntry(QStringLiteral("backup"), QStringLiteral("/mnt/backup")));
+        QVERIFY(!myFilter.isExcludedEntry(QStringLiteral("backup"), QStringLiteral("/home/backup")));
+        QVERIFY(myFilter.isExcludedEntry(QStringLiteral("drums"), QStringLiteral("/home/user/Samples/drums")));
+        QVERIFY(!myFilter.isExcludedEntry(QStringLiteral("Samples"), QStringLiteral("/home/user/Samples")));
+        QVERIFY(myFilter.isExcludedEntry(QStringLiteral("snapshot"), QStringLiteral("/data/a/b/snapshot")));
+
+        QVERIFY(myFilter.isExcludedPath(QStringLiteral("/mnt/backup/album/track.ogg"), {}));
+        QVERIFY(myFilter.isExcludedPath(QStringLiteral("/home/user/Samples/drums/kick.ogg"), QStringLiteral("/home/user")));
+        QVERIFY(!myFilter.isExcludedPath(QStringLiteral("/home/user/music/album/track.ogg"), QStringLiteral("/home/user/music")));
+    }
+
+    void pathBelowRoot()
+    {
+        IndexerFilter myFilter({QStringLiteral("music"), QStringLiteral("/data")}, 0);
+
+        QVERIFY(!myFilter.isExcludedPath(QStringLiteral("/home/user/music/album/track.ogg"), QStringLiteral("/home/user/music")));
+        QVERIFY(!myFilter.isExcludedPath(QStringLiteral("/home/user/music/album/track.ogg"), QStringLiteral("/home/user/music/")));
+        QVERIFY(!myFilter.isExcludedPath(QStringLiteral("/data/album/track.ogg"), QStringLiteral("/data")));
+        QVERIFY(myFilter.isExcludedPath(QStringLiteral("/home/user/library/music/track.ogg"), QStringLiteral("/home/user/library")));
+        QVERIFY(myFilter.isExcludedPath(QStringLiteral("/home/user/music/album/track.ogg"), QStringLiteral("/home/user/musical")));
+        QVERIFY(myFilter.isExcludedPath(QStringLiteral("/home/user/music/album/track.ogg"), {}));
+    }
+
+    void minimumFileSize()
+    {
+        IndexerFilter myFilter({}, 1024);
+
+        QVERIFY(!myFilter.isEmpty());
+        QVERIFY(myFilter.isTooSmall(1023));
+        QVERIFY(!myFilter.isTooSmall(1024));
+        QVERIFY(!myFilter.isExcludedPath(QStringLiteral("/home/user/music/album/track.ogg"), QStringLiteral("/home/user/music")));
+    }
+};
+
+QTEST_GUILESS_MAIN(IndexerFilterTests)
+
+
+#include "indexerfiltertest.moc"
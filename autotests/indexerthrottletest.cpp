@@ -0,0 +1,107 @@
+/*
+ * Copyright 2017 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "abstractfile/indexerthrottle.h"
+
+#include <QObject>
+#include <QElapsedTimer>
+
+#include <QtTest>
+
+class IndexerThrottleTests: public QObject
+{
+    Q_OBJECT
+
+public:
+
+    IndexerThrottleTests(QObject *parent = nullptr) : QObject(parent)
+    {
+    }
+
+private:
+
+    static void paceDuring(IndexerThrottle &throttle, qint64 duration)
+    {
+        QElapsedTimer runningTime;
+        runningTime.start();
+
+        while (runningTime.elapsed() < duration) {
+            throttle.pace();
+        }
+    }
+
+private Q_SLOTS:
+
+    void noPauseWithoutPlayback()
+    {
+        IndexerThrottle myThrottle;
+
+        QCOMPARE(myThrottle.playbackState(), IndexerThrottle::PlaybackState::Stopped);
+
+        paceDuring(myThrottle, 120);
+
+        QCOMPARE(myThrottle.throttledTime(), qint64(0));
+    }
+
+    void pausesDuringPlayback()
+    {
+        IndexerThrottle myThrottle;
+
+        myThrottle.setPlaybackState(IndexerThrottle::PlaybackState::Playing);
+
+        paceDuring(myThrottle, 200);
+
+        const auto playingThrottledTime = myThrottle.throttledTime();
+        QVERIFY(playingThrottledTime > 0);
+
+        myThrottle.resetStatistics();
+        QCOMPARE(myThrottle.throttledTime(), qint64(0));
+
+        myThrottle.setPlaybackState(IndexerThrottle::PlaybackState::Buffering);
+
+        paceDuring(myThrottle, 200);
+
+        QVERIFY(myThrottle.throttledTime() > playingThrottledTime);
+    }
+
+    void countBufferUnderruns()
+    {
+        IndexerThrottle myThrottle;
+
+        myThrottle.setPlaybackState(IndexerThrottle::PlaybackState::Buffering);
+        QCOMPARE(myThrottle.bufferUnderrunsCount(), 0);
+
+        myThrottle.setPlaybackState(IndexerThrottle::PlaybackState::Playing);
+        myThrottle.setPlaybackState(IndexerThrottle::PlaybackState::Buffering);
+        myThrottle.setPlaybackState(IndexerThrottle::PlaybackState::Buffering);
+        QCOMPARE(myThrottle.bufferUnderrunsCount(), 1);
+
+        myThrottle.setPlaybackState(IndexerThrottle::PlaybackState::Playing);
+        myThrottle.setPlaybackState(IndexerThrottle::PlaybackState::Buffering);
+        QCOMPARE(myThrottle.bufferUnderrunsCount(), 2);
+
+        myThrottle.resetStatistics();
+        QCOMPARE(myThrottle.bufferUnderrunsCount(), 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(IndexerThrottleTests)
+
+
+#include "indexerthrottletest.moc"
@@ -18,6 +18,7 @@
  */
 
 #include "file/localfilelisting.h"
+#include "databaseinterface.h"
 #include "musicaudiotrack.h"
 
 #include "config-upnp-qt.h"
@@ -32,6 +33,8 @@
 #include <QStandardPaths>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QTemporaryFile>
 
 #include <QDebug>
 
@@ -62,6 +65,7 @@ private Q_SLOTS:
         qRegisterMetaType<QVector<qlonglong>>("QVector<qlonglong>");
         qRegisterMetaType<QHash<qlonglong,int>>("QHash<qlonglong,int>");
         qRegisterMetaType<QList<QUrl>>("QList<QUrl>");
+        qRegisterMetaType<QHash<QUrl,QUrl>>("QHash<QUrl,QUrl>");
     }
 
     void initialTestWithNoTrack()
@@ -133,12 +137,245 @@ private Q_SLOTS:
 
         auto firstNewTracksSignal = tracksListSpy.at(0);
         auto firstNewTracks = firstNewTracksSignal.at(0).value<QList<MusicAudioTrack>>();
+        auto firstNewCovers = firstNewTracksSignal.at(1).value<QHash<QString, QUrl>>();
         auto secondNewTracksSignal = tracksListSpy.at(1);
         auto secondNewTracks = secondNewTracksSignal.at(0).value<QList<MusicAudioTrack>>();
-        auto newCovers = secondNewTracksSignal.at(1).value<QHash<QString, QUrl>>();
+        auto secondNewCovers = secondNewTracksSignal.at(1).value<QHash<QString, QUrl>>();
 
         QCOMPARE(firstNewTracks.count() + secondNewTracks.count(), 3);
-        QCOMPARE(newCovers.count(), 3);
+        QCOMPARE(firstNewCovers.count(), firstNewTracks.count());
+        QCOMPARE(secondNewCovers.count(), secondNewTracks.count());
+
+        const auto expectedCover = QUrl::fromLocalFile(musicPath + QStringLiteral("/cover.jpg"));
+        for (const auto &oneTrack : firstNewTracks + secondNewTracks) {
+            const auto &allCovers = (firstNewCovers.contains(oneTrack.resourceURI().toString()) ? firstNewCovers : secondNewCovers);
+            QCOMPARE(allCovers.value(oneTrack.resourceURI().toString()), expectedCover);
+        }
+    }
+
+    void initialTestWithExcludedTracks()
+    {
+        LocalFileListing myListing;
+
+        QString musicPath = QStringLiteral(LOCAL_FILE_TESTS_SAMPLE_FILES_PATH) + QStringLiteral("/music");
+
+        QSignalSpy tracksListSpy(&myListing, &LocalFileListing::tracksList);
+        QSignalSpy removedTracksListSpy(&myListing, &LocalFileListing::removedTracksList);
+
+        myListing.init();
+
+        myListing.setIndexerFilter(IndexerFilter({QStringLiteral("*.mp3")}, 0));
+        myListing.setRootPath(musicPath);
+
+        myListing.refreshContent();
+
+        QCOMPARE(removedTracksListSpy.count(), 0);
+
+        auto allNewTracks = QList<MusicAudioTrack>();
+        for (const auto &oneNewTracksSignal : tracksListSpy) {
+            allNewTracks += oneNewTracksSignal.at(0).value<QList<MusicAudioTrack>>();
+        }
+
+        QCOMPARE(allNewTracks.count(), 2);
+
+        for (const auto &oneTrack : allNewTracks) {
+            QVERIFY(!oneTrack.resourceURI().toLocalFile().endsWith(QStringLiteral(".mp3")));
+        }
+
+        LocalFileListing otherListing;
+
+        QSignalSpy otherTracksListSpy(&otherListing, &LocalFileListing::tracksList);
+
+        otherListing.init();
+
+        otherListing.setIndexerFilter(IndexerFilter({QStringLiteral("music")}, 0));
+        otherListing.setRootPath(QStringLiteral(LOCAL_FILE_TESTS_SAMPLE_FILES_PATH));
+
+        otherListing.refreshContent();
+
+        QCOMPARE(otherTracksListSpy.count(), 0);
+    }
+
+    void incrementalImportWithExtractionJobs()
+    {
+        QString musicPath = QStringLiteral(LOCAL_FILE_TESTS_SAMPLE_FILES_PATH) + QStringLiteral("/music");
+
+        LocalFileListing myListing;
+
+        QSignalSpy tracksListSpy(&myListing, &LocalFileListing::tracksList);
+
+        myListing.init();
+        myListing.setExtractionJobs(2);
+        myListing.setRootPath(musicPath);
+
+        myListing.refreshContent();
+
+        auto allTracks = QList<MusicAudioTrack>();
+        for (const auto &oneNewTracksSignal : tracksListSpy) {
+            allTracks += oneNewTracksSignal.at(0).value<QList<MusicAudioTrack>>();
+        }
+
+        QCOMPARE(allTracks.count(), 3);
+        QCOMPARE(myListing.skippedKnownFilesCount(), 0);
+        QVERIFY(myListing.extractedBytes() > 0);
+
+        for (const auto &oneTrack : allTracks) {
+            QCOMPARE(oneTrack.fileSize(), QFileInfo(oneTrack.resourceURI().toLocalFile()).size());
+            QVERIFY(oneTrack.fileModificationTime() > 0);
+        }
+
+        const auto knownTrack = allTracks.first().resourceURI();
+
+        auto modifiedTrack = allTracks.at(1);
+        modifiedTrack.setFileModificationTime(modifiedTrack.fileModificationTime() - 1);
+
+        auto vanishedTrack = MusicAudioTrack();
+        vanishedTrack.setResourceURI(QUrl::fromLocalFile(musicPath + QStringLiteral("/vanished.ogg")));
+
+        LocalFileListing incrementalListing;
+
+        QSignalSpy incrementalTracksListSpy(&incrementalListing, &LocalFileListing::tracksList);
+        QSignalSpy incrementalRemovedTracksListSpy(&incrementalListing, &LocalFileListing::removedTracksList);
+
+        incrementalListing.init();
+        incrementalListing.setExtractionJobs(2);
+        incrementalListing.setRootPath(musicPath);
+        incrementalListing.setKnownFiles({allTracks.first(), modifiedTrack, vanishedTrack});
+
+        incrementalListing.refreshContent();
+
+        auto newTracks = QList<MusicAudioTrack>();
+        for (const auto &oneNewTracksSignal : incrementalTracksListSpy) {
+            newTracks += oneNewTracksSignal.at(0).value<QList<MusicAudioTrack>>();
+        }
+
+        QCOMPARE(newTracks.count(), 2);
+        auto hasModifiedTrack = false;
+        for (const auto &oneTrack : newTracks) {
+            QVERIFY(oneTrack.resourceURI() != knownTrack);
+            hasModifiedTrack = hasModifiedTrack || oneTrack.resourceURI() == modifiedTrack.resourceURI();
+        }
+        QVERIFY(hasModifiedTrack);
+
+        QCOMPARE(incrementalListing.skippedKnownFilesCount(), 1);
+        QCOMPARE(incrementalRemovedTracksListSpy.count(), 1);
+        QCOMPARE(incrementalRemovedTracksListSpy.at(0).at(0).value<QList<QUrl>>(), QList<QUrl>({vanishedTrack.resourceURI()}));
+    }
+
+    void resumeInterruptedImport()
+    {
+        QString musicOriginPath = QStringLiteral(LOCAL_FILE_TESTS_SAMPLE_FILES_PATH) + QStringLiteral("/music");
+
+        QString musicParentPath = QStringLiteral(LOCAL_FILE_TESTS_WORKING_PATH) + QStringLiteral("/music3");
+        QDir musicParentDirectory(musicParentPath);
+        QDir rootDirectory(QStringLiteral(LOCAL_FILE_TESTS_WORKING_PATH));
+
+        musicParentDirectory.removeRecursively();
+
+        const auto allTrackFiles = QStringList{QStringLiteral("test.ogg"), QStringLiteral("test.mp3"), QStringLiteral("test.m4a")};
+        auto allTracks = QList<QUrl>();
+        for (int i = 0; i < allTrackFiles.size(); ++i) {
+            const auto directoryName = QStringLiteral("music3/album") + QString::number(i);
+            QCOMPARE(rootDirectory.mkpath(directoryName), true);
+
+            const auto trackPath = rootDirectory.absoluteFilePath(directoryName + QStringLiteral("/") + allTrackFiles[i]);
+            QCOMPARE(QFile::copy(musicOriginPath + QStringLiteral("/") + allTrackFiles[i], trackPath), true);
+            allTracks.push_back(QUrl::fromLocalFile(trackPath));
+        }
+
+        QTemporaryFile databaseFile;
+        databaseFile.open();
+
+        auto completedDirectory = QUrl();
+
+        {
+            DatabaseInterface musicDb;
+            musicDb.init(QStringLiteral("firstImportDb"), databaseFile.fileName());
+
+            LocalFileListing myListing;
+
+            connect(&myListing, &LocalFileListing::tracksList, &musicDb, &DatabaseInterface::insertTracksList);
+            connect(&myListing, &LocalFileListing::scanProgressChanged, &musicDb, &DatabaseInterface::updateScanProgress);
+            connect(&myListing, &LocalFileListing::scanProgressCompleted, &musicDb, &DatabaseInterface::clearScanProgress);
+            connect(&myListing, &LocalFileListing::tracksList, &myListing, &LocalFileListing::applicationAboutToQuit);
+
+            QSignalSpy scanProgressChangedSpy(&myListing, &LocalFileListing::scanProgressChanged);
+            QSignalSpy scanProgressCompletedSpy(&myListing, &LocalFileListing::scanProgressCompleted);
+
+            myListing.init();
+            myListing.setRootPath(musicParentPath);
+            myListing.refreshContent();
+
+            QCOMPARE(scanProgressChangedSpy.count(), 1);
+            QCOMPARE(scanProgressCompletedSpy.count(), 0);
+
+            const auto completedDirectories = scanProgressChangedSpy.at(0).at(1).value<QList<QUrl>>();
+
+            QCOMPARE(completedDirectories.count(), 1);
+            QCOMPARE(completedDirectories.contains(QUrl::fromLocalFile(musicParentPath)), false);
+
+            completedDirectory = completedDirectories.first();
+        }
+
+        DatabaseInterface musicDb;
+        musicDb.init(QStringLiteral("secondImportDb"), databaseFile.fileName());
+
+        QSignalSpy sentScanProgressSpy(&musicDb, &DatabaseInterface::sentScanProgress);
+
+        musicDb.getScanProgress(musicParentPath);
+
+        QCOMPARE(sentScanProgressSpy.count(), 1);
+        QCOMPARE(sentScanProgressSpy.at(0).at(0).toString(), musicParentPath);
+
+        const auto restoredDirectories = sentScanProgressSpy.at(0).at(1).value<QList<QUrl>>();
+
+        QCOMPARE(restoredDirectories, QList<QUrl>{completedDirectory});
+
+        LocalFileListing myListing;
+
+        connect(&myListing, &LocalFileListing::tracksList, &musicDb, &DatabaseInterface::insertTracksList);
+        connect(&myListing, &LocalFileListing::scanProgressChanged, &musicDb, &DatabaseInterface::updateScanProgress);
+        connect(&myListing, &LocalFileListing::scanProgressCompleted, &musicDb, &DatabaseInterface::clearScanProgress);
+
+        QSignalSpy tracksListSpy(&myListing, &LocalFileListing::tracksList);
+        QSignalSpy scanProgressCompletedSpy(&myListing, &LocalFileListing::scanProgressCompleted);
+
+        myListing.init();
+        myListing.setCompletedDirectories(restoredDirectories);
+        myListing.setRootPath(musicParentPath);
+        myListing.refreshContent();
+
+        QCOMPARE(scanProgressCompletedSpy.count(), 1);
+
+        auto allNewTracks = QList<MusicAudioTrack>();
+        for (const auto &oneNewTracksSignal : tracksListSpy) {
+            allNewTracks += oneNewTracksSignal.at(0).value<QList<MusicAudioTrack>>();
+        }
+
+        QCOMPARE(allNewTracks.count(), 2);
+
+        for (const auto &oneTrack : allNewTracks) {
+            QVERIFY(!oneTrack.resourceURI().toString().startsWith(completedDirectory.toString() + QStringLiteral("/")));
+        }
+
+        musicDb.cleanInvalidTracks();
+
+        for (const auto &oneTrack : allTracks) {
+            QVERIFY(musicDb.trackIdFromFileName(oneTrack) != 0);
+        }
+
+        QCOMPARE(musicDb.restoreScanProgress(musicParentPath).isEmpty(), true);
+
+        /* the completed directory is watched again, only the new file is read */
+        const auto newTrackPath = completedDirectory.toLocalFile() + QStringLiteral("/added.ogg");
+        QCOMPARE(QFile::copy(musicOriginPath + QStringLiteral("/test.ogg"), newTrackPath), true);
+
+        QCOMPARE(tracksListSpy.wait(), true);
+
+        const auto addedTracks = tracksListSpy.last().at(0).value<QList<MusicAudioTrack>>();
+
+        QCOMPARE(addedTracks.count(), 1);
+        QCOMPARE(addedTracks.first().resourceURI(), QUrl::fromLocalFile(newTrackPath));
     }
 
     void addAndRemoveTracks()
@@ -439,6 +676,90 @@ private Q_SLOTS:
         QCOMPARE(newTracksLast.count(), 1);
         QCOMPARE(newCoversLast.count(), 1);
     }
+
+    void moveTracksInsideRootDirectory()
+    {
+        LocalFileListing myListing;
+
+        QString musicOriginPath = QStringLiteral(LOCAL_FILE_TESTS_SAMPLE_FILES_PATH) + QStringLiteral("/music");
+
+        QString musicParentPath = QStringLiteral(LOCAL_FILE_TESTS_WORKING_PATH) + QStringLiteral("/music4");
+        QDir musicParentDirectory(musicParentPath);
+
+        QString musicPath = musicParentPath + QStringLiteral("/data/innerData");
+        QString movedMusicPath = musicParentPath + QStringLiteral("/movedData");
+
+        musicParentDirectory.removeRecursively();
+        QCOMPARE(musicParentDirectory.mkpath(musicPath), true);
+
+        QCOMPARE(QFile::copy(musicOriginPath + QStringLiteral("/test.ogg"), musicPath + QStringLiteral("/test.ogg")), true);
+
+        QSignalSpy tracksListSpy(&myListing, &LocalFileListing::tracksList);
+        QSignalSpy removedTracksListSpy(&myListing, &LocalFileListing::removedTracksList);
+        QSignalSpy renamedTracksListSpy(&myListing, &LocalFileListing::renamedTracksList);
+
+        myListing.init();
+        myListing.setRootPath(musicParentPath);
+        myListing.refreshContent();
+
+        QCOMPARE(tracksListSpy.count(), 1);
+        QCOMPARE(removedTracksListSpy.count(), 0);
+        QCOMPARE(renamedTracksListSpy.count(), 0);
+
+        QCOMPARE(QDir().rename(musicPath, movedMusicPath), true);
+
+        QCOMPARE(renamedTracksListSpy.wait(), true);
+
+        QCOMPARE(tracksListSpy.count(), 1);
+        QCOMPARE(renamedTracksListSpy.count(), 1);
+
+        auto renamedTracks = renamedTracksListSpy.at(0).at(0).value<QHash<QUrl, QUrl>>();
+
+        QCOMPARE(renamedTracks.count(), 1);
+        QCOMPARE(renamedTracks.begin().key(), QUrl::fromLocalFile(musicPath + QStringLiteral("/test.ogg")));
+        QCOMPARE(renamedTracks.begin().value(), QUrl::fromLocalFile(movedMusicPath + QStringLiteral("/test.ogg")));
+
+        QCOMPARE(removedTracksListSpy.wait(1000), false);
+
+        QCOMPARE(tracksListSpy.count(), 1);
+        QCOMPARE(removedTracksListSpy.count(), 0);
+    }
+
+    void linkedFileImportedOnce()
+    {
+        LocalFileListing myListing;
+
+        QString musicOriginPath = QStringLiteral(LOCAL_FILE_TESTS_SAMPLE_FILES_PATH) + QStringLiteral("/music");
+
+        QString musicParentPath = QStringLiteral(LOCAL_FILE_TESTS_WORKING_PATH) + QStringLiteral("/music7");
+        QString targetPath = musicParentPath + QStringLiteral("/target");
+        QString linksPath = musicParentPath + QStringLiteral("/links");
+        QDir musicParentDirectory(musicParentPath);
+        QDir rootDirectory(QStringLiteral(LOCAL_FILE_TESTS_WORKING_PATH));
+
+        musicParentDirectory.removeRecursively();
+        rootDirectory.mkpath(QStringLiteral("music7/target"));
+        rootDirectory.mkpath(QStringLiteral("music7/links"));
+
+        QCOMPARE(QFile::copy(musicOriginPath + QStringLiteral("/test.ogg"), targetPath + QStringLiteral("/test.ogg")), true);
+        QCOMPARE(QFile::link(targetPath + QStringLiteral("/test.ogg"), linksPath + QStringLiteral("/first.ogg")), true);
+        QCOMPARE(QFile::link(targetPath + QStringLiteral("/test.ogg"), linksPath + QStringLiteral("/second.ogg")), true);
+
+        QSignalSpy tracksListSpy(&myListing, &LocalFileListing::tracksList);
+
+        myListing.init();
+        myListing.setRootPath(linksPath);
+        myListing.refreshContent();
+
+        /* both links are listed under their target */
+        auto importedTracks = QList<MusicAudioTrack>();
+        for (const auto &oneSignal : tracksListSpy) {
+            importedTracks += oneSignal.at(0).value<QList<MusicAudioTrack>>();
+        }
+
+        QCOMPARE(importedTracks.count(), 1);
+        QCOMPARE(importedTracks.first().resourceURI(), QUrl::fromLocalFile(QFileInfo(targetPath + QStringLiteral("/test.ogg")).canonicalFilePath()));
+    }
 };
 
 QTEST_GUILESS_MAIN(LocalFileListingTests)
@@ -140,6 +140,9 @@ void MediaPlayListTest::initTestCase()
     qRegisterMetaType<QHash<QString,QVector<MusicAudioTrack>>>("QHash<QString,QVector<MusicAudioTrack>>");
     qRegisterMetaType<QVector<qlonglong>>("QVector<qlonglong>");
     qRegisterMetaType<QHash<qlonglong,int>>("QHash<qlonglong,int>");
+    qRegisterMetaType<MusicAudioTrack>("MusicAudioTrack");
+    qRegisterMetaType<QList<MusicAudioTrack>>("QList<MusicAudioTrack>");
+    qRegisterMetaType<QList<qulonglong>>("QList<qulonglong>");
 }
 
 void MediaPlayListTest::simpleInitialCase()
@@ -267,6 +270,7 @@ void MediaPlayListTest::enqueueAlbumCase()
     QSignalSpy persistentStateChangedSpy(&myPlayList, &MediaPlayList::persistentStateChanged);
     QSignalSpy dataChangedSpy(&myPlayList, &MediaPlayList::dataChanged);
     QSignalSpy newTrackByIdInListSpy(&myPlayList, &MediaPlayList::newTrackByIdInList);
+    QSignalSpy newTracksByIdInListSpy(&myPlayList, &MediaPlayList::newTracksByIdInList);
     QSignalSpy newTrackByNameInListSpy(&myPlayList, &MediaPlayList::newTrackByNameInList);
     QSignalSpy newTrackByFileNameInListSpy(&myPlayList, &MediaPlayList::newTrackByFileNameInList);
     QSignalSpy newArtistInListSpy(&myPlayList, &MediaPlayList::newArtistInList);
@@ -328,17 +332,18 @@ void MediaPlayListTest::enqueueAlbumCase()
 
     QCOMPARE(rowsAboutToBeRemovedSpy.count(), 0);
     QCOMPARE(rowsAboutToBeMovedSpy.count(), 0);
-    QCOMPARE(rowsAboutToBeInsertedSpy.count(), 6);
+    QCOMPARE(rowsAboutToBeInsertedSpy.count(), 1);
     QCOMPARE(rowsRemovedSpy.count(), 0);
     QCOMPARE(rowsMovedSpy.count(), 0);
-    QCOMPARE(rowsInsertedSpy.count(), 6);
-    QCOMPARE(trackHasBeenAddedSpy.count(), 6);
-    QCOMPARE(persistentStateChangedSpy.count(), 6);
+    QCOMPARE(rowsInsertedSpy.count(), 1);
+    QCOMPARE(trackHasBeenAddedSpy.count(), 1);
+    QCOMPARE(persistentStateChangedSpy.count(), 1);
     QCOMPARE(dataChangedSpy.count(), 0);
-    QCOMPARE(newTrackByIdInListSpy.count(), 6);
+    QCOMPARE(newTrackByIdInListSpy.count(), 0);
     QCOMPARE(newTrackByNameInListSpy.count(), 0);
     QCOMPARE(newTrackByFileNameInListSpy.count(), 0);
     QCOMPARE(newArtistInListSpy.count(), 0);
+    QCOMPARE(newTracksByIdInListSpy.count(), 1);
 
     QCOMPARE(myPlayList.rowCount(), 6);
 
@@ -606,14 +611,14 @@ void MediaPlayListTest::removeFirstTrackOfAlbum()
 
     QCOMPARE(rowsAboutToBeRemovedSpy.count(), 0);
     QCOMPARE(rowsAboutToBeMovedSpy.count(), 0);
-    QCOMPARE(rowsAboutToBeInsertedSpy.count(), 6);
+    QCOMPARE(rowsAboutToBeInsertedSpy.count(), 1);
     QCOMPARE(rowsRemovedSpy.count(), 0);
     QCOMPARE(rowsMovedSpy.count(), 0);
-    QCOMPARE(rowsInsertedSpy.count(), 6);
-    QCOMPARE(trackHasBeenAddedSpy.count(), 6);
-    QCOMPARE(persistentStateChangedSpy.count(), 6);
+    QCOMPARE(rowsInsertedSpy.count(), 1);
+    QCOMPARE(trackHasBeenAddedSpy.count(), 1);
+    QCOMPARE(persistentStateChangedSpy.count(), 1);
     QCOMPARE(dataChangedSpy.count(), 0);
-    QCOMPARE(newTrackByIdInListSpy.count(), 6);
+    QCOMPARE(newTrackByIdInListSpy.count(), 0);
     QCOMPARE(newTrackByNameInListSpy.count(), 0);
     QCOMPARE(newTrackByFileNameInListSpy.count(), 0);
     QCOMPARE(newArtistInListSpy.count(), 0);
@@ -629,14 +634,14 @@ void MediaPlayListTest::removeFirstTrackOfAlbum()
 
     QCOMPARE(rowsAboutToBeRemovedSpy.count(), 1);
     QCOMPARE(rowsAboutToBeMovedSpy.count(), 0);
-    QCOMPARE(rowsAboutToBeInsertedSpy.count(), 6);
+    QCOMPARE(rowsAboutToBeInsertedSpy.count(), 1);
     QCOMPARE(rowsRemovedSpy.count(), 1);
     QCOMPARE(rowsMovedSpy.count(), 0);
-    QCOMPARE(rowsInsertedSpy.count(), 6);
-    QCOMPARE(trackHasBeenAddedSpy.count(), 6);
-    QCOMPARE(persistentStateChangedSpy.count(), 7);
+    QCOMPARE(rowsInsertedSpy.count(), 1);
+    QCOMPARE(trackHasBeenAddedSpy.count(), 1);
+    QCOMPARE(persistentStateChangedSpy.count(), 2);
     QCOMPARE(dataChangedSpy.count(), 1);
-    QCOMPARE(newTrackByIdInListSpy.count(), 6);
+    QCOMPARE(newTrackByIdInListSpy.count(), 0);
     QCOMPARE(newTrackByNameInListSpy.count(), 0);
     QCOMPARE(newTrackByFileNameInListSpy.count(), 0);
     QCOMPARE(newArtistInListSpy.count(), 0);
@@ -3504,6 +3509,7 @@ void MediaPlayListTest::testSavePersistentState()
     QSignalSpy persistentStateChangedSpyRead(&myPlayListRead, &MediaPlayList::persistentStateChanged);
     QSignalSpy dataChangedSpyRead(&myPlayListRead, &MediaPlayList::dataChanged);
     QSignalSpy newTrackByIdInListSpyRead(&myPlayListRead, &MediaPlayList::newTrackByIdInList);
+    QSignalSpy newTracksByIdInListSpyRead(&myPlayListRead, &MediaPlayList::newTracksByIdInList);
     QSignalSpy newTrackByNameInListSpyRead(&myPlayListRead, &MediaPlayList::newTrackByNameInList);
     QSignalSpy newTrackByFileNameInListSpyRead(&myPlayListRead, &MediaPlayList::newTrackByFileNameInList);
     QSignalSpy newArtistInListSpyRead(&myPlayListRead, &MediaPlayList::newArtistInList);
@@ -3564,6 +3570,12 @@ void MediaPlayListTest::testSavePersistentState()
     connect(&myPlayListRead, &MediaPlayList::newTrackByIdInList,
             &myListenerRead, &TracksListener::trackByIdInList,
             Qt::QueuedConnection);
+    connect(&myPlayListRead, &MediaPlayList::newTracksByIdInList,
+            &myListenerRead, &TracksListener::tracksByIdInList,
+            Qt::QueuedConnection);
+    connect(&myListenerRead, &TracksListener::trackHasBeenRemoved,
+            &myPlayListRead, &MediaPlayList::trackRemoved,
+            Qt::QueuedConnection);
     connect(&myPlayListRead, &MediaPlayList::newTrackByNameInList,
             &myListenerRead, &TracksListener::trackByNameInList,
             Qt::QueuedConnection);
@@ -3834,15 +3846,16 @@ void MediaPlayListTest::testSavePersistentState()
     QCOMPARE(newArtistInListSpySave.count(), 0);
     QCOMPARE(rowsAboutToBeRemovedSpyRead.count(), 0);
     QCOMPARE(rowsAboutToBeMovedSpyRead.count(), 0);
-    QCOMPARE(rowsAboutToBeInsertedSpyRead.count(), 3);
+    QCOMPARE(rowsAboutToBeInsertedSpyRead.count(), 1);
     QCOMPARE(rowsRemovedSpyRead.count(), 0);
     QCOMPARE(rowsMovedSpyRead.count(), 0);
-    QCOMPARE(rowsInsertedSpyRead.count(), 3);
-    QCOMPARE(trackHasBeenAddedSpyRead.count(), 3);
-    QCOMPARE(persistentStateChangedSpyRead.count(), 4);
-    QCOMPARE(dataChangedSpyRead.count(), 6);
+    QCOMPARE(rowsInsertedSpyRead.count(), 1);
+    QCOMPARE(trackHasBeenAddedSpyRead.count(), 1);
+    QCOMPARE(persistentStateChangedSpyRead.count(), 2);
+    QCOMPARE(dataChangedSpyRead.count(), 3);
     QCOMPARE(newTrackByIdInListSpyRead.count(), 0);
-    QCOMPARE(newTrackByNameInListSpyRead.count(), 3);
+    QCOMPARE(newTracksByIdInListSpyRead.count(), 1);
+    QCOMPARE(newTrackByNameInListSpyRead.count(), 0);
     QCOMPARE(newArtistInListSpyRead.count(), 0);
 
     QCOMPARE(myPlayListRead.tracksCount(), 3);
@@ -4813,14 +4826,14 @@ void MediaPlayListTest::testRemoveSelection()
 
     myPlayList.removeSelection({2, 4, 5});
 
-    QCOMPARE(rowsAboutToBeRemovedSpy.count(), 3);
+    QCOMPARE(rowsAboutToBeRemovedSpy.count(), 2);
     QCOMPARE(rowsAboutToBeMovedSpy.count(), 0);
     QCOMPARE(rowsAboutToBeInsertedSpy.count(), 2);
-    QCOMPARE(rowsRemovedSpy.count(), 3);
+    QCOMPARE(rowsRemovedSpy.count(), 2);
     QCOMPARE(rowsMovedSpy.count(), 0);
     QCOMPARE(rowsInsertedSpy.count(), 2);
     QCOMPARE(trackHasBeenAddedSpy.count(), 0);
-    QCOMPARE(persistentStateChangedSpy.count(), 5);
+    QCOMPARE(persistentStateChangedSpy.count(), 3);
     QCOMPARE(dataChangedSpy.count(), 1);
     QCOMPARE(newTrackByIdInListSpy.count(), 0);
     QCOMPARE(newTrackByNameInListSpy.count(), 0);
@@ -4852,6 +4865,107 @@ void MediaPlayListTest::testRemoveSelection()
     QCOMPARE(myPlayList.data(myPlayList.index(2, 0), MediaPlayList::ColumnsRoles::DiscNumberRole).toInt(), 1);
 }
 
+void MediaPlayListTest::testMoveAndRemoveSelectionRanges()
+{
+    MediaPlayList myPlayList;
+    ModelTest testModel(&myPlayList);
+
+    QSignalSpy rowsMovedSpy(&myPlayList, &MediaPlayList::rowsMoved);
+    QSignalSpy rowsRemovedSpy(&myPlayList, &MediaPlayList::rowsRemoved);
+    QSignalSpy persistentStateChangedSpy(&myPlayList, &MediaPlayList::persistentStateChanged);
+
+    for (int trackIndex = 0; trackIndex < 8; ++trackIndex) {
+        myPlayList.enqueue({QStringLiteral("track") + QString::number(trackIndex), QStringLiteral("artist1"), QStringLiteral("album1"), trackIndex + 1, 1});
+    }
+
+    auto titles = [&myPlayList] () {
+        auto result = QStringList();
+        for (int row = 0; row < myPlayList.rowCount(); ++row) {
+            result.push_back(myPlayList.data(myPlayList.index(row, 0), MediaPlayList::ColumnsRoles::TitleRole).toString());
+        }
+        return result;
+    };
+
+    QCOMPARE(persistentStateChangedSpy.count(), 8);
+
+    myPlayList.moveSelection({7, 1, 5, 2}, 4);
+
+    QCOMPARE(rowsMovedSpy.count(), 3);
+    QCOMPARE(persistentStateChangedSpy.count(), 9);
+    QCOMPARE(titles(), QStringList({QStringLiteral("track0"), QStringLiteral("track3"), QStringLiteral("track1"), QStringLiteral("track2"),
+                                    QStringLiteral("track5"), QStringLiteral("track7"), QStringLiteral("track4"), QStringLiteral("track6")}));
+
+    myPlayList.removeSelection({5, 0, 4, 1, 4});
+
+    QCOMPARE(rowsRemovedSpy.count(), 2);
+    QCOMPARE(persistentStateChangedSpy.count(), 10);
+    QCOMPARE(titles(), QStringList({QStringLiteral("track1"), QStringLiteral("track2"), QStringLiteral("track4"), QStringLiteral("track6")}));
+}
+
+void MediaPlayListTest::testTrackChangedAfterRowsMoved()
+{
+    MediaPlayList myPlayList;
+    ModelTest testModel(&myPlayList);
+
+    QSignalSpy dataChangedSpy(&myPlayList, &MediaPlayList::dataChanged);
+
+    auto newTrack = [] (int trackIndex) {
+        auto result = MusicAudioTrack();
+        result.setValid(true);
+        result.setDatabaseId(100 + trackIndex);
+        result.setTitle(QStringLiteral("track") + QString::number(trackIndex));
+        result.setArtist(QStringLiteral("artist1"));
+        result.setAlbumName(QStringLiteral("album1"));
+        result.setTrackNumber(trackIndex + 1);
+        result.setDiscNumber(1);
+        return result;
+    };
+
+    for (int trackIndex = 0; trackIndex < 6; ++trackIndex) {
+        myPlayList.enqueue({QStringLiteral("track") + QString::number(trackIndex), QStringLiteral("artist1"), QStringLiteral("album1"), trackIndex + 1, 1});
+    }
+
+    myPlayList.trackChanged(newTrack(2));
+
+    QCOMPARE(dataChangedSpy.count(), 1);
+    QCOMPARE(myPlayList.data(myPlayList.index(2, 0), MediaPlayList::ColumnsRoles::IsValidRole).toBool(), true);
+
+    myPlayList.moveSelection({0, 1}, 6);
+
+    QCOMPARE(myPlayList.data(myPlayList.index(4, 0), MediaPlayList::ColumnsRoles::TitleRole).toString(), QStringLiteral("track0"));
+
+    dataChangedSpy.clear();
+    myPlayList.trackChanged(newTrack(0));
+
+    QCOMPARE(dataChangedSpy.count(), 1);
+    QCOMPARE(dataChangedSpy.at(0).at(0).toModelIndex().row(), 4);
+    QCOMPARE(myPlayList.data(myPlayList.index(4, 0), MediaPlayList::ColumnsRoles::IsValidRole).toBool(), true);
+    QCOMPARE(myPlayList.data(myPlayList.index(5, 0), MediaPlayList::ColumnsRoles::IsValidRole).toBool(), false);
+
+    myPlayList.removeSelection({0, 1});
+
+    QCOMPARE(myPlayList.data(myPlayList.index(2, 0), MediaPlayList::ColumnsRoles::TitleRole).toString(), QStringLiteral("track0"));
+    QCOMPARE(myPlayList.data(myPlayList.index(2, 0), MediaPlayList::ColumnsRoles::IsValidRole).toBool(), true);
+
+    dataChangedSpy.clear();
+    myPlayList.trackRemoved(100);
+
+    QCOMPARE(dataChangedSpy.count(), 1);
+    QCOMPARE(dataChangedSpy.at(0).at(0).toModelIndex().row(), 2);
+    QCOMPARE(myPlayList.data(myPlayList.index(2, 0), MediaPlayList::ColumnsRoles::IsValidRole).toBool(), false);
+
+    dataChangedSpy.clear();
+    myPlayList.trackRemoved(102);
+
+    QCOMPARE(dataChangedSpy.count(), 0);
+
+    myPlayList.trackChanged(newTrack(1));
+
+    QCOMPARE(dataChangedSpy.count(), 1);
+    QCOMPARE(dataChangedSpy.at(0).at(0).toModelIndex().row(), 3);
+    QCOMPARE(myPlayList.data(myPlayList.index(3, 0), MediaPlayList::ColumnsRoles::IsValidRole).toBool(), true);
+}
+
 void MediaPlayListTest::testTrackBeenRemoved()
 {
     MediaPlayList myPlayList;
@@ -6589,6 +6703,414 @@ void MediaPlayListTest::testSaveAndRestoreSettings()
     QCOMPARE(myPlayListRestore.currentTrack(), QPersistentModelIndex(myPlayListRestore.index(3, 0)));
 }
 
+void MediaPlayListTest::restoreUnknownIdsByName()
+{
+    MediaPlayList myPlayList;
+    ModelTest testModel(&myPlayList);
+    DatabaseInterface myDatabaseContent;
+    TracksListener myListener(&myDatabaseContent);
+
+    QSignalSpy newTracksByIdInListSpy(&myPlayList, &MediaPlayList::newTracksByIdInList);
+    QSignalSpy newTrackByNameInListSpy(&myPlayList, &MediaPlayList::newTrackByNameInList);
+
+    myDatabaseContent.init(QStringLiteral("testDbDirectContent"));
+
+    connect(&myListener, &TracksListener::trackHasChanged,
+            &myPlayList, &MediaPlayList::trackChanged,
+            Qt::QueuedConnection);
+    connect(&myListener, &TracksListener::trackHasBeenRemoved,
+            &myPlayList, &MediaPlayList::trackRemoved,
+            Qt::QueuedConnection);
+    connect(&myPlayList, &MediaPlayList::newTracksByIdInList,
+            &myListener, &TracksListener::tracksByIdInList,
+            Qt::QueuedConnection);
+    connect(&myPlayList, &MediaPlayList::newTrackByNameInList,
+            &myListener, &TracksListener::trackByNameInList,
+            Qt::QueuedConnection);
+    connect(&myDatabaseContent, &DatabaseInterface::tracksAdded,
+            &myListener, &TracksListener::tracksAdded);
+
+    myDatabaseContent.insertTracksList(mNewTracks, mNewCovers, QStringLiteral("autoTest"));
+
+    auto otherTrackId = myDatabaseContent.trackIdFromTitleAlbumTrackDiscNumber(QStringLiteral("track2"), QStringLiteral("artist2"),
+                                                                               QStringLiteral("album3"), 2, 1);
+
+    /* one id is unknown, the other one now belongs to a different track */
+    auto playListData = QByteArray();
+    QDataStream playListStream(&playListData, QIODevice::WriteOnly);
+    playListStream.setVersion(QDataStream::Qt_5_9);
+    playListStream << quint32(1) << quint32(2);
+    playListStream << quint64(9999) << QUrl() << QStringLiteral("track1") << QStringLiteral("artist2")
+                   << QStringLiteral("album3") << qint32(1) << qint32(1);
+    playListStream << quint64(otherTrackId) << QUrl() << QStringLiteral("track1") << QStringLiteral("artist1")
+                   << QStringLiteral("album1") << qint32(1) << qint32(1);
+
+    myPlayList.setPersistentState({{QStringLiteral("playList"), playListData}});
+
+    QCOMPARE(myPlayList.tracksCount(), 2);
+    QCOMPARE(newTracksByIdInListSpy.count(), 1);
+
+    QTRY_COMPARE(newTrackByNameInListSpy.count(), 2);
+
+    QTRY_VERIFY(myPlayList.data(myPlayList.index(0, 0), MediaPlayList::ColumnsRoles::IsValidRole).toBool() &&
+                myPlayList.data(myPlayList.index(1, 0), MediaPlayList::ColumnsRoles::IsValidRole).toBool());
+
+    QCOMPARE(myPlayList.data(myPlayList.index(0, 0), MediaPlayList::ColumnsRoles::TitleRole).toString(), QStringLiteral("track1"));
+    QCOMPARE(myPlayList.data(myPlayList.index(0, 0), MediaPlayList::ColumnsRoles::AlbumRole).toString(), QStringLiteral("album3"));
+    QCOMPARE(myPlayList.data(myPlayList.index(1, 0), MediaPlayList::ColumnsRoles::TitleRole).toString(), QStringLiteral("track1"));
+    QCOMPARE(myPlayList.data(myPlayList.index(1, 0), MediaPlayList::ColumnsRoles::AlbumRole).toString(), QStringLiteral("album1"));
+}
+
+void MediaPlayListTest::restoreLargePlayListWhileImporting()
+{
+    MediaPlayList myPlayList;
+    DatabaseInterface myDatabaseContent;
+    TracksListener myListener(&myDatabaseContent);
+
+    myDatabaseContent.init(QStringLiteral("testDbDirectContent"));
+
+    connect(&myListener, &TracksListener::trackHasChanged,
+            &myPlayList, &MediaPlayList::trackChanged,
+            Qt::QueuedConnection);
+    connect(&myPlayList, &MediaPlayList::newTrackByNameInList,
+            &myListener, &TracksListener::trackByNameInList,
+            Qt::QueuedConnection);
+    connect(&myDatabaseContent, &DatabaseInterface::tracksAdded,
+            &myListener, &TracksListener::tracksAdded);
+
+    /* the full size playlist is only restored when ELISA_BENCHMARKS is set */
+    const int albumsCount = (qEnvironmentVariableIsSet("ELISA_BENCHMARKS") ? 100 : 4);
+    const int tracksPerAlbum = 500;
+
+    auto newTracks = QList<MusicAudioTrack>();
+    auto playListState = QVariantList();
+
+    for (int albumIndex = 0; albumIndex < albumsCount; ++albumIndex) {
+        const auto albumName = QStringLiteral("album") + QString::number(albumIndex);
+
+        for (int trackIndex = 0; trackIndex < tracksPerAlbum; ++trackIndex) {
+            const auto trackId = QString::number(albumIndex * tracksPerAlbum + trackIndex);
+            const auto trackTitle = QStringLiteral("track") + QString::number(trackIndex);
+
+            newTracks.push_back({true, QStringLiteral("$") + trackId, QStringLiteral("0"), trackTitle,
+                                 QStringLiteral("artist1"), albumName, QStringLiteral("artist1"),
+                                 trackIndex + 1, 1, QTime::fromMSecsSinceStartOfDay(1000), {QUrl::fromLocalFile(QStringLiteral("/$") + trackId)},
+                                 {QUrl::fromLocalFile(QStringLiteral("file://image$") + trackId)}, 1, true});
+
+            playListState.push_back(QStringList({trackTitle, QStringLiteral("artist1"), albumName,
+                                                 QString::number(trackIndex + 1), QStringLiteral("1")}));
+        }
+    }
+
+    myPlayList.setPersistentState({{QStringLiteral("playList"), playListState}});
+
+    QCOMPARE(myPlayList.rowCount(), albumsCount * tracksPerAlbum);
+
+    /* every entry is now waiting for its track */
+    QCoreApplication::processEvents();
+
+    const int tracksPerImport = 5000;
+    for (int firstTrack = 0; firstTrack < newTracks.size(); firstTrack += tracksPerImport) {
+        myDatabaseContent.insertTracksList(newTracks.mid(firstTrack, tracksPerImport), mNewCovers, QStringLiteral("autoTest"));
+    }
+
+    auto validRowsCount = [&myPlayList] () {
+        auto result = 0;
+        for (int row = 0; row < myPlayList.rowCount(); ++row) {
+            if (myPlayList.data(myPlayList.index(row, 0), MediaPlayList::ColumnsRoles::IsValidRole).toBool()) {
+                ++result;
+            }
+        }
+        return result;
+    };
+
+    QTRY_COMPARE_WITH_TIMEOUT(validRowsCount(), albumsCount * tracksPerAlbum, 60000);
+
+    QCOMPARE(myPlayList.data(myPlayList.index(tracksPerAlbum + 2, 0), MediaPlayList::ColumnsRoles::AlbumRole).toString(), QStringLiteral("album1"));
+    QCOMPARE(myPlayList.data(myPlayList.index(tracksPerAlbum + 2, 0), MediaPlayList::ColumnsRoles::TitleRole).toString(), QStringLiteral("track2"));
+}
+
+void MediaPlayListTest::benchmarkEditFrontOfLargePlayList()
+{
+    MediaPlayList myPlayList;
+
+    /* the full size benchmark only runs when ELISA_BENCHMARKS is set */
+    const int entriesCount = (qEnvironmentVariableIsSet("ELISA_BENCHMARKS") ? 100000 : 2000);
+    const int editsCount = (qEnvironmentVariableIsSet("ELISA_BENCHMARKS") ? 2000 : 200);
+
+    auto playListState = QVariantList();
+    playListState.reserve(entriesCount);
+
+    for (int entryIndex = 0; entryIndex < entriesCount; ++entryIndex) {
+        playListState.push_back(QStringList({QStringLiteral("track") + QString::number(entryIndex), QStringLiteral("artist1"),
+                                             QStringLiteral("album") + QString::number(entryIndex / 100),
+                                             QString::number(entryIndex % 100 + 1), QStringLiteral("1")}));
+    }
+
+    myPlayList.setPersistentState({{QStringLiteral("playList"), playListState}});
+
+    QCOMPARE(myPlayList.rowCount(), entriesCount);
+
+    auto entryTrack = [] (int entryIndex) {
+        auto result = MusicAudioTrack();
+
+        result.setValid(true);
+        result.setDatabaseId(entryIndex + 1);
+        result.setTitle(QStringLiteral("track") + QString::number(entryIndex));
+        result.setArtist(QStringLiteral("artist1"));
+        result.setAlbumName(QStringLiteral("album") + QString::number(entryIndex / 100));
+        result.setTrackNumber(entryIndex % 100 + 1);
+        result.setDiscNumber(1);
+        result.setDuration(QTime::fromMSecsSinceStartOfDay(1000));
+        result.setResourceURI(QUrl::fromLocalFile(QStringLiteral("/$") + QString::number(entryIndex)));
+
+        return result;
+    };
+
+    /* each edit near the front is followed by a notification resolving an entry at the end */
+    QBENCHMARK_ONCE {
+        for (int editIndex = 0; editIndex < editsCount; ++editIndex) {
+            myPlayList.removeRows(0, 1);
+            myPlayList.moveRows({}, 1, 1, {}, 0);
+            myPlayList.trackChanged(entryTrack(entriesCount - 1 - editIndex));
+        }
+    }
+
+    QCOMPARE(myPlayList.rowCount(), entriesCount - editsCount);
+
+    for (int editIndex = 0; editIndex < editsCount; ++editIndex) {
+        const auto row = myPlayList.rowCount() - 1 - editIndex;
+
+        QCOMPARE(myPlayList.data(myPlayList.index(row, 0), MediaPlayList::ColumnsRoles::IsValidRole).toBool(), true);
+        QCOMPARE(myPlayList.data(myPlayList.index(row, 0), MediaPlayList::ColumnsRoles::TitleRole).toString(),
+                 QStringLiteral("track") + QString::number(entriesCount - 1 - editIndex));
+    }
+
+    QCOMPARE(myPlayList.data(myPlayList.index(myPlayList.rowCount() - editsCount - 1, 0), MediaPlayList::ColumnsRoles::IsValidRole).toBool(), false);
+
+    /* a resolved entry removed by the database goes back to waiting for its track */
+    myPlayList.trackRemoved(entriesCount);
+
+    QCOMPARE(myPlayList.data(myPlayList.index(myPlayList.rowCount() - 1, 0), MediaPlayList::ColumnsRoles::IsValidRole).toBool(), false);
+}
+
+void MediaPlayListTest::storedPlayListEdits()
+{
+    MediaPlayList myPlayList;
+    ModelTest testModel(&myPlayList);
+    DatabaseInterface myDatabaseContent;
+    TracksListener myListener(&myDatabaseContent);
+
+    QSignalSpy storedEntriesInsertedSpy(&myPlayList, &MediaPlayList::storedEntriesInserted);
+    QSignalSpy storedEntriesRemovedSpy(&myPlayList, &MediaPlayList::storedEntriesRemoved);
+    QSignalSpy storedEntriesMovedSpy(&myPlayList, &MediaPlayList::storedEntriesMoved);
+    QSignalSpy storedEntryChangedSpy(&myPlayList, &MediaPlayList::storedEntryChanged);
+    QSignalSpy storedEntriesClearedSpy(&myPlayList, &MediaPlayList::storedEntriesCleared);
+
+    myDatabaseContent.init(QStringLiteral("testDbDirectContent"));
+
+    connect(&myListener, &TracksListener::trackHasChanged,
+            &myPlayList, &MediaPlayList::trackChanged,
+            Qt::QueuedConnection);
+    connect(&myPlayList, &MediaPlayList::newTrackByIdInList,
+            &myListener, &TracksListener::trackByIdInList,
+            Qt::QueuedConnection);
+    connect(&myPlayList, &MediaPlayList::newTracksByIdInList,
+            &myListener, &TracksListener::tracksByIdInList,
+            Qt::QueuedConnection);
+    connect(&myPlayList, &MediaPlayList::newTrackByNameInList,
+            &myListener, &TracksListener::trackByNameInList,
+            Qt::QueuedConnection);
+    connect(&myDatabaseContent, &DatabaseInterface::tracksAdded,
+            &myListener, &TracksListener::tracksAdded);
+
+    myDatabaseContent.insertTracksList(mNewTracks, mNewCovers, QStringLiteral("autoTest"));
+
+    auto firstTrackId = myDatabaseContent.trackIdFromTitleAlbumTrackDiscNumber(QStringLiteral("track1"), QStringLiteral("artist1"),
+                                                                               QStringLiteral("album1"), 1, 1);
+    auto secondTrackId = myDatabaseContent.trackIdFromTitleAlbumTrackDiscNumber(QStringLiteral("track2"), QStringLiteral("artist2"),
+                                                                                QStringLiteral("album1"), 2, 2);
+    auto thirdTrackId = myDatabaseContent.trackIdFromTitleAlbumTrackDiscNumber(QStringLiteral("track3"), QStringLiteral("artist3"),
+                                                                               QStringLiteral("album1"), 3, 3);
+    auto fourthTrackId = myDatabaseContent.trackIdFromTitleAlbumTrackDiscNumber(QStringLiteral("track4"), QStringLiteral("artist4"),
+                                                                                QStringLiteral("album1"), 4, 4);
+    auto otherTrackId = myDatabaseContent.trackIdFromTitleAlbumTrackDiscNumber(QStringLiteral("track2"), QStringLiteral("artist1"),
+                                                                               QStringLiteral("album2"), 2, 1);
+
+    myPlayList.setStoredPlayListName(QStringLiteral("current"));
+
+    /* edits made before the stored entries are loaded are not written yet */
+    myPlayList.enqueue({QStringLiteral("track1"), QStringLiteral("artist1"), QStringLiteral("album1"), 1, 1});
+
+    QTRY_COMPARE(myPlayList.data(myPlayList.index(0, 0), MediaPlayList::ColumnsRoles::IsValidRole).toBool(), true);
+
+    QCOMPARE(storedEntriesInsertedSpy.count(), 0);
+    QCOMPARE(storedEntryChangedSpy.count(), 0);
+    QCOMPARE(storedEntriesClearedSpy.count(), 0);
+
+    auto firstStoredEntry = MusicAudioTrack();
+    firstStoredEntry.setDatabaseId(secondTrackId);
+    firstStoredEntry.setTitle(QStringLiteral("track2"));
+    firstStoredEntry.setArtist(QStringLiteral("artist2"));
+    firstStoredEntry.setAlbumName(QStringLiteral("album1"));
+    firstStoredEntry.setTrackNumber(2);
+    firstStoredEntry.setDiscNumber(2);
+
+    auto secondStoredEntry = MusicAudioTrack();
+    secondStoredEntry.setDatabaseId(thirdTrackId);
+    secondStoredEntry.setTitle(QStringLiteral("track3"));
+    secondStoredEntry.setArtist(QStringLiteral("artist3"));
+    secondStoredEntry.setAlbumName(QStringLiteral("album1"));
+    secondStoredEntry.setTrackNumber(3);
+    secondStoredEntry.setDiscNumber(3);
+
+    /* the stored entries come first, the whole merged playlist is then written again */
+    myPlayList.storedEntriesLoaded(QStringLiteral("current"), {firstStoredEntry, secondStoredEntry});
+
+    QCOMPARE(myPlayList.rowCount(), 3);
+    QCOMPARE(storedEntriesMovedSpy.count(), 0);
+    QCOMPARE(storedEntriesClearedSpy.count(), 1);
+    QCOMPARE(storedEntriesClearedSpy.at(0).at(0).toString(), QStringLiteral("current"));
+    QCOMPARE(storedEntriesInsertedSpy.count(), 1);
+    QCOMPARE(storedEntriesInsertedSpy.at(0).at(0).toString(), QStringLiteral("current"));
+    QCOMPARE(storedEntriesInsertedSpy.at(0).at(1).toInt(), 0);
+
+    auto insertedEntries = storedEntriesInsertedSpy.at(0).at(2).value<QList<MusicAudioTrack>>();
+
+    QCOMPARE(insertedEntries.size(), 3);
+    QCOMPARE(insertedEntries.at(0).databaseId(), secondTrackId);
+    QCOMPARE(insertedEntries.at(0).title(), QStringLiteral("track2"));
+    QCOMPARE(insertedEntries.at(1).databaseId(), thirdTrackId);
+    QCOMPARE(insertedEntries.at(1).title(), QStringLiteral("track3"));
+    QCOMPARE(insertedEntries.at(2).databaseId(), firstTrackId);
+    QCOMPARE(insertedEntries.at(2).title(), QStringLiteral("track1"));
+
+    QTRY_COMPARE(myPlayList.data(myPlayList.index(0, 0), MediaPlayList::ColumnsRoles::TitleRole).toString(), QStringLiteral("track2"));
+    QTRY_COMPARE(myPlayList.data(myPlayList.index(1, 0), MediaPlayList::ColumnsRoles::TitleRole).toString(), QStringLiteral("track3"));
+    QCOMPARE(myPlayList.data(myPlayList.index(2, 0), MediaPlayList::ColumnsRoles::TitleRole).toString(), QStringLiteral("track1"));
+
+    /* the stored entries already had their names */
+    QCOMPARE(storedEntryChangedSpy.count(), 0);
+
+    /* an entry enqueued by its id is written again with the name of its track */
+    myPlayList.enqueue(fourthTrackId);
+
+    QCOMPARE(storedEntriesInsertedSpy.count(), 2);
+    QCOMPARE(storedEntriesInsertedSpy.at(1).at(1).toInt(), 3);
+
+    insertedEntries = storedEntriesInsertedSpy.at(1).at(2).value<QList<MusicAudioTrack>>();
+
+    QCOMPARE(insertedEntries.size(), 1);
+    QCOMPARE(insertedEntries.at(0).databaseId(), fourthTrackId);
+    QCOMPARE(insertedEntries.at(0).title(), QString());
+
+    QTRY_COMPARE(storedEntryChangedSpy.count(), 1);
+    QCOMPARE(storedEntryChangedSpy.at(0).at(0).toString(), QStringLiteral("current"));
+    QCOMPARE(storedEntryChangedSpy.at(0).at(1).toInt(), 3);
+    QCOMPARE(storedEntryChangedSpy.at(0).at(2).value<MusicAudioTrack>().databaseId(), fourthTrackId);
+    QCOMPARE(storedEntryChangedSpy.at(0).at(2).value<MusicAudioTrack>().title(), QStringLiteral("track4"));
+
+    /* an entry enqueued by its name is written again with the id of its track */
+    myPlayList.enqueue({QStringLiteral("track2"), QStringLiteral("artist1"), QStringLiteral("album2"), 2, 1});
+
+    QCOMPARE(storedEntriesInsertedSpy.count(), 3);
+    QCOMPARE(storedEntriesInsertedSpy.at(2).at(1).toInt(), 4);
+
+    insertedEntries = storedEntriesInsertedSpy.at(2).at(2).value<QList<MusicAudioTrack>>();
+
+    QCOMPARE(insertedEntries.size(), 1);
+    QCOMPARE(insertedEntries.at(0).databaseId(), qulonglong(0));
+    QCOMPARE(insertedEntries.at(0).title(), QStringLiteral("track2"));
+
+    QTRY_COMPARE(storedEntryChangedSpy.count(), 2);
+    QCOMPARE(storedEntryChangedSpy.at(1).at(1).toInt(), 4);
+    QCOMPARE(storedEntryChangedSpy.at(1).at(2).value<MusicAudioTrack>().databaseId(), otherTrackId);
+
+    myPlayList.moveRows({}, 4, 1, {}, 0);
+
+    QCOMPARE(storedEntriesMovedSpy.count(), 1);
+    QCOMPARE(storedEntriesMovedSpy.at(0).at(0).toString(), QStringLiteral("current"));
+    QCOMPARE(storedEntriesMovedSpy.at(0).at(1).toInt(), 4);
+    QCOMPARE(storedEntriesMovedSpy.at(0).at(2).toInt(), 1);
+    QCOMPARE(storedEntriesMovedSpy.at(0).at(3).toInt(), 0);
+
+    myPlayList.removeRows(1, 2);
+
+    QCOMPARE(storedEntriesRemovedSpy.count(), 1);
+    QCOMPARE(storedEntriesRemovedSpy.at(0).at(0).toString(), QStringLiteral("current"));
+    QCOMPARE(storedEntriesRemovedSpy.at(0).at(1).toInt(), 1);
+    QCOMPARE(storedEntriesRemovedSpy.at(0).at(2).toInt(), 2);
+
+    myPlayList.clearPlayList();
+
+    QCOMPARE(storedEntriesClearedSpy.count(), 2);
+    QCOMPARE(storedEntriesInsertedSpy.count(), 3);
+    QCOMPARE(storedEntriesMovedSpy.count(), 1);
+    QCOMPARE(storedEntriesRemovedSpy.count(), 1);
+    QCOMPARE(storedEntryChangedSpy.count(), 2);
+}
+
+void MediaPlayListTest::pagedTracksReleaseFarRows()
+{
+    MediaPlayList myPlayList;
+
+    QSignalSpy newTracksByIdInListSpy(&myPlayList, &MediaPlayList::newTracksByIdInList);
+
+    myPlayList.setPaged(true);
+
+    QCOMPARE(myPlayList.isPaged(), true);
+
+    const int tracksCount = 2500;
+
+    auto newTracks = QList<MusicAudioTrack>();
+    for (int trackIndex = 0; trackIndex < tracksCount; ++trackIndex) {
+        auto oneTrack = mNewTracks.at(trackIndex % mNewTracks.size());
+        oneTrack.setDatabaseId(trackIndex + 1);
+        oneTrack.setGenre(QStringLiteral("genre1"));
+        newTracks.push_back(oneTrack);
+    }
+
+    /* no view shows the playlist yet, every row keeps only its name, album and file */
+    myPlayList.enqueue(newTracks, ElisaUtils::AppendPlayList, ElisaUtils::DoNotTriggerPlay);
+
+    QCOMPARE(myPlayList.rowCount(), tracksCount);
+    QCOMPARE(newTracksByIdInListSpy.count(), 1);
+
+    /* reading the rows does not ask for their tracks */
+    for (int row = 0; row < tracksCount; ++row) {
+        QCOMPARE(myPlayList.data(myPlayList.index(row, 0), MediaPlayList::ColumnsRoles::IsValidRole).toBool(), true);
+    }
+
+    myPlayList.setVisibleRows(2000, 2005);
+
+    QCOMPARE(myPlayList.data(myPlayList.index(2000, 0), MediaPlayList::ColumnsRoles::TitleRole).toString(), newTracks.at(2000).title());
+    QCOMPARE(myPlayList.data(myPlayList.index(2000, 0), MediaPlayList::ColumnsRoles::AlbumRole).toString(), newTracks.at(2000).albumName());
+    QCOMPARE(myPlayList.data(myPlayList.index(2000, 0), MediaPlayList::ColumnsRoles::ResourceRole).toUrl(), newTracks.at(2000).resourceURI());
+    QCOMPARE(myPlayList.data(myPlayList.index(2000, 0), MediaPlayList::ColumnsRoles::GenreRole).toString(), QString());
+
+    /* the pages of the current track and of the shown rows are asked to the database together */
+    QTRY_COMPARE(newTracksByIdInListSpy.count(), 2);
+
+    const auto requestedIds = newTracksByIdInListSpy.at(1).at(0).value<QList<qulonglong>>();
+
+    QCOMPARE(myPlayList.currentTrackRow(), 0);
+    QCOMPARE(requestedIds.size(), 200);
+    QVERIFY(requestedIds.contains(1));
+    QVERIFY(requestedIds.contains(100));
+    QVERIFY(!requestedIds.contains(101));
+    QVERIFY(requestedIds.contains(2001));
+    QVERIFY(requestedIds.contains(2100));
+
+    myPlayList.trackChanged(newTracks.at(2000));
+
+    QCOMPARE(myPlayList.data(myPlayList.index(2000, 0), MediaPlayList::ColumnsRoles::GenreRole).toString(), QStringLiteral("genre1"));
+
+    /* the rows still waiting for their track are not asked again */
+    QCoreApplication::processEvents();
+
+    QCOMPARE(newTracksByIdInListSpy.count(), 2);
+}
+
 void MediaPlayListTest::removeBeforeCurrentTrack()
 {
     MediaPlayList myPlayList;
@@ -7197,13 +7719,13 @@ void MediaPlayListTest::testEnqueueFiles()
 
     QCOMPARE(rowsAboutToBeRemovedSpy.count(), 0);
     QCOMPARE(rowsAboutToBeMovedSpy.count(), 0);
-    QCOMPARE(rowsAboutToBeInsertedSpy.count(), 2);
+    QCOMPARE(rowsAboutToBeInsertedSpy.count(), 1);
     QCOMPARE(rowsRemovedSpy.count(), 0);
     QCOMPARE(rowsMovedSpy.count(), 0);
-    QCOMPARE(rowsInsertedSpy.count(), 2);
-    QCOMPARE(trackHasBeenAddedSpy.count(), 2);
-    QCOMPARE(persistentStateChangedSpy.count(), 2);
-    QCOMPARE(dataChangedSpy.count(), 2);
+    QCOMPARE(rowsInsertedSpy.count(), 1);
+    QCOMPARE(trackHasBeenAddedSpy.count(), 1);
+    QCOMPARE(persistentStateChangedSpy.count(), 1);
+    QCOMPARE(dataChangedSpy.count(), 1);
     QCOMPARE(newTrackByIdInListSpy.count(), 0);
     QCOMPARE(newTrackByNameInListSpy.count(), 0);
     QCOMPARE(newTrackByFileNameInListSpy.count(), 2);
@@ -7215,13 +7737,13 @@ void MediaPlayListTest::testEnqueueFiles()
 
     QCOMPARE(rowsAboutToBeRemovedSpy.count(), 0);
     QCOMPARE(rowsAboutToBeMovedSpy.count(), 0);
-    QCOMPARE(rowsAboutToBeInsertedSpy.count(), 2);
+    QCOMPARE(rowsAboutToBeInsertedSpy.count(), 1);
     QCOMPARE(rowsRemovedSpy.count(), 0);
     QCOMPARE(rowsMovedSpy.count(), 0);
-    QCOMPARE(rowsInsertedSpy.count(), 2);
-    QCOMPARE(trackHasBeenAddedSpy.count(), 2);
-    QCOMPARE(persistentStateChangedSpy.count(), 2);
-    QCOMPARE(dataChangedSpy.count(), 4);
+    QCOMPARE(rowsInsertedSpy.count(), 1);
+    QCOMPARE(trackHasBeenAddedSpy.count(), 1);
+    QCOMPARE(persistentStateChangedSpy.count(), 1);
+    QCOMPARE(dataChangedSpy.count(), 3);
     QCOMPARE(newTrackByIdInListSpy.count(), 0);
     QCOMPARE(newTrackByNameInListSpy.count(), 0);
     QCOMPARE(newTrackByFileNameInListSpy.count(), 2);
@@ -7320,13 +7842,13 @@ void MediaPlayListTest::testEnqueueSampleFiles()
 
     QCOMPARE(rowsAboutToBeRemovedSpy.count(), 0);
     QCOMPARE(rowsAboutToBeMovedSpy.count(), 0);
-    QCOMPARE(rowsAboutToBeInsertedSpy.count(), 2);
+    QCOMPARE(rowsAboutToBeInsertedSpy.count(), 1);
     QCOMPARE(rowsRemovedSpy.count(), 0);
     QCOMPARE(rowsMovedSpy.count(), 0);
-    QCOMPARE(rowsInsertedSpy.count(), 2);
-    QCOMPARE(trackHasBeenAddedSpy.count(), 2);
-    QCOMPARE(persistentStateChangedSpy.count(), 2);
-    QCOMPARE(dataChangedSpy.count(), 2);
+    QCOMPARE(rowsInsertedSpy.count(), 1);
+    QCOMPARE(trackHasBeenAddedSpy.count(), 1);
+    QCOMPARE(persistentStateChangedSpy.count(), 1);
+    QCOMPARE(dataChangedSpy.count(), 1);
     QCOMPARE(newTrackByIdInListSpy.count(), 0);
     QCOMPARE(newTrackByNameInListSpy.count(), 0);
     QCOMPARE(newTrackByFileNameInListSpy.count(), 2);
@@ -7338,13 +7860,13 @@ void MediaPlayListTest::testEnqueueSampleFiles()
 
     QCOMPARE(rowsAboutToBeRemovedSpy.count(), 0);
     QCOMPARE(rowsAboutToBeMovedSpy.count(), 0);
-    QCOMPARE(rowsAboutToBeInsertedSpy.count(), 2);
+    QCOMPARE(rowsAboutToBeInsertedSpy.count(), 1);
     QCOMPARE(rowsRemovedSpy.count(), 0);
     QCOMPARE(rowsMovedSpy.count(), 0);
-    QCOMPARE(rowsInsertedSpy.count(), 2);
-    QCOMPARE(trackHasBeenAddedSpy.count(), 2);
-    QCOMPARE(persistentStateChangedSpy.count(), 2);
-    QCOMPARE(dataChangedSpy.count(), 4);
+    QCOMPARE(rowsInsertedSpy.count(), 1);
+    QCOMPARE(trackHasBeenAddedSpy.count(), 1);
+    QCOMPARE(persistentStateChangedSpy.count(), 1);
+    QCOMPARE(dataChangedSpy.count(), 3);
     QCOMPARE(newTrackByIdInListSpy.count(), 0);
     QCOMPARE(newTrackByNameInListSpy.count(), 0);
     QCOMPARE(newTrackByFileNameInListSpy.count(), 2);
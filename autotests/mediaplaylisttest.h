@@ -87,6 +87,10 @@ private Q_SLOTS:
 
     void testRemoveSelection();
 
+    void testMoveAndRemoveSelectionRanges();
+
+    void testTrackChangedAfterRowsMoved();
+
     void testTrackBeenRemoved();
 
     void testBringUpCase();
@@ -119,6 +123,16 @@ private Q_SLOTS:
 
     void testRestoreSettings();
 
+    void restoreUnknownIdsByName();
+
+    void restoreLargePlayListWhileImporting();
+
+    void benchmarkEditFrontOfLargePlayList();
+
+    void storedPlayListEdits();
+
+    void pagedTracksReleaseFarRows();
+
     void removeBeforeCurrentTrack();
 
     void switchToTrackTest();
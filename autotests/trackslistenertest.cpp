@@ -547,6 +547,49 @@ private Q_SLOTS:
         QCOMPARE(myPlayList.data(myPlayList.index(0, 0), MediaPlayList::ColumnsRoles::TrackNumberRole).toInt(), -1);
         QCOMPARE(myPlayList.data(myPlayList.index(0, 0), MediaPlayList::ColumnsRoles::DiscNumberRole).toInt(), 0);
     }
+
+    void testEnqueueTracksByIdInOneRequest()
+    {
+        MediaPlayList myPlayList;
+        DatabaseInterface myDatabaseContent;
+        TracksListener myListener(&myDatabaseContent);
+
+        QSignalSpy trackHasChangedSpy(&myListener, &TracksListener::trackHasChanged);
+        QSignalSpy rowsInsertedSpy(&myPlayList, &MediaPlayList::rowsInserted);
+        QSignalSpy persistentStateChangedSpy(&myPlayList, &MediaPlayList::persistentStateChanged);
+        QSignalSpy newTrackByIdInListSpy(&myPlayList, &MediaPlayList::newTrackByIdInList);
+        QSignalSpy newTracksByIdInListSpy(&myPlayList, &MediaPlayList::newTracksByIdInList);
+
+        myDatabaseContent.init(QStringLiteral("testDbDirectContent"));
+
+        connect(&myListener, &TracksListener::trackHasChanged, &myPlayList, &MediaPlayList::trackChanged);
+        connect(&myPlayList, &MediaPlayList::newTrackByIdInList, &myListener, &TracksListener::trackByIdInList);
+        connect(&myPlayList, &MediaPlayList::newTracksByIdInList, &myListener, &TracksListener::tracksByIdInList);
+
+        myDatabaseContent.insertTracksList(mNewTracks, mNewCovers, QStringLiteral("autoTest"));
+
+        auto newTrackIds = QList<qulonglong>();
+        for (int trackIndex = 0; trackIndex < 3; ++trackIndex) {
+            const auto &oneTrack = mNewTracks.at(trackIndex);
+            newTrackIds.push_back(myDatabaseContent.trackIdFromTitleAlbumTrackDiscNumber(oneTrack.title(), oneTrack.artist(), oneTrack.albumName(),
+                                                                                         oneTrack.trackNumber(), oneTrack.discNumber()));
+        }
+
+        myPlayList.enqueue(newTrackIds);
+
+        QCOMPARE(rowsInsertedSpy.count(), 1);
+        QCOMPARE(persistentStateChangedSpy.count(), 1);
+        QCOMPARE(newTrackByIdInListSpy.count(), 0);
+        QCOMPARE(newTracksByIdInListSpy.count(), 1);
+        QCOMPARE(trackHasChangedSpy.count(), 3);
+
+        QCOMPARE(myPlayList.tracksCount(), 3);
+
+        for (int trackIndex = 0; trackIndex < 3; ++trackIndex) {
+            QCOMPARE(myPlayList.data(myPlayList.index(trackIndex, 0), MediaPlayList::ColumnsRoles::TitleRole).toString(), mNewTracks.at(trackIndex).title());
+            QCOMPARE(myPlayList.data(myPlayList.index(trackIndex, 0), MediaPlayList::ColumnsRoles::AlbumRole).toString(), mNewTracks.at(trackIndex).albumName());
+        }
+    }
 };
 
 QTEST_GUILESS_MAIN(TracksListenerTests)
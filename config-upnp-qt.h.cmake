@@ -18,6 +18,8 @@
 
 #cmakedefine01 KF5KCMUtils_FOUND
 
+#cmakedefine01 HAVE_KFILEMETADATA_EMBEDDEDIMAGEDATA
+
 #define LOCAL_FILE_TESTS_SAMPLE_FILES_PATH "@CMAKE_CURRENT_SOURCE_DIR@/autotests/data"
 
 #define LOCAL_FILE_TESTS_WORKING_PATH "@CMAKE_CURRENT_BINARY_DIR@/autotests/data"
@@ -37,6 +37,8 @@ public:
 
     AbstractFileListing *mFileListing = nullptr;
 
+    DatabaseInterface *mDatabaseInterface = nullptr;
+
 };
 
 AbstractFileListener::AbstractFileListener(QObject *parent)
@@ -52,16 +54,23 @@ AbstractFileListener::~AbstractFileListener()
 
 DatabaseInterface *AbstractFileListener::databaseInterface() const
 {
-    return nullptr;
+    return d->mDatabaseInterface;
 }
 
 void AbstractFileListener::setDatabaseInterface(DatabaseInterface *model)
 {
+    d->mDatabaseInterface = model;
+
     if (model) {
         connect(this, &AbstractFileListener::newTrackFile, d->mFileListing, &AbstractFileListing::newTrackFile);
         connect(d->mFileListing, &AbstractFileListing::tracksList, model, &DatabaseInterface::insertTracksList);
         connect(d->mFileListing, &AbstractFileListing::removedTracksList, model, &DatabaseInterface::removeTracksList);
+        connect(d->mFileListing, &AbstractFileListing::renamedTracksList, model, &DatabaseInterface::renameTracksList);
         connect(d->mFileListing, &AbstractFileListing::modifyTracksList, model, &DatabaseInterface::modifyTracksList);
+        connect(d->mFileListing, &AbstractFileListing::scanProgressChanged, model, &DatabaseInterface::updateScanProgress);
+        connect(d->mFileListing, &AbstractFileListing::scanProgressCompleted, model, &DatabaseInterface::clearScanProgress);
+        connect(this, &AbstractFileListener::scanProgressRequest, model, &DatabaseInterface::getScanProgress);
+        connect(model, &DatabaseInterface::sentScanProgress, this, &AbstractFileListener::restoreScanProgress);
 
         QMetaObject::invokeMethod(d->mFileListing, "init", Qt::QueuedConnection);
     }
@@ -122,6 +131,23 @@ int AbstractFileListener::importedTracksCount() const
 
 void AbstractFileListener::performInitialScan()
 {
+    if (d->mDatabaseInterface) {
+        /* the scan starts when the database replies with the directories of an interrupted import */
+        Q_EMIT scanProgressRequest(d->mFileListing->sourceName());
+
+        return;
+    }
+
+    d->mFileListing->refreshContent();
+}
+
+void AbstractFileListener::restoreScanProgress(const QString &musicSource, const QList<QUrl> &completedDirectories)
+{
+    if (musicSource != d->mFileListing->sourceName()) {
+        return;
+    }
+
+    d->mFileListing->setCompletedDirectories(completedDirectories);
     d->mFileListing->refreshContent();
 }
 
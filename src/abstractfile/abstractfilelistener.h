@@ -77,6 +77,8 @@ Q_SIGNALS:
 
     void closeNotification(QString notificationId);
 
+    void scanProgressRequest(const QString &musicSource);
+
 public Q_SLOTS:
 
     void performInitialScan();
@@ -89,6 +91,8 @@ public Q_SLOTS:
 
     void resetImportedTracksCounter();
 
+    void restoreScanProgress(const QString &musicSource, const QList<QUrl> &completedDirectories);
+
 protected:
 
     void setFileListing(AbstractFileListing *fileIndexer);
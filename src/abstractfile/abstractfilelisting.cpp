@@ -19,6 +19,8 @@
 
 #include "abstractfilelisting.h"
 
+#include "artworkresolver.h"
+#include "indexerthrottle.h"
 #include "musicaudiotrack.h"
 #include "notificationitem.h"
 #include "elisautils.h"
@@ -38,12 +40,70 @@
 #include <QSet>
 #include <QPair>
 #include <QAtomicInt>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTimer>
+#include <QThreadPool>
+#include <QThreadStorage>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QFuture>
+#include <QtConcurrentRun>
 
 #include <QtGlobal>
 
 #include <algorithm>
 #include <utility>
 
+#if defined Q_OS_UNIX
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <stdlib.h>
+#endif
+
+struct FileIdentity
+{
+    quint64 mDevice = 0;
+
+    quint64 mInode = 0;
+
+    qint64 mSize = 0;
+
+    qint64 mModificationTime = 0;
+};
+
+static bool operator==(const FileIdentity &first, const FileIdentity &second)
+{
+    return first.mDevice == second.mDevice && first.mInode == second.mInode &&
+            first.mSize == second.mSize && first.mModificationTime == second.mModificationTime;
+}
+
+static uint qHash(const FileIdentity &identity, uint seed = 0)
+{
+    return ::qHash(identity.mInode, seed) ^ ::qHash(identity.mSize, seed) ^ ::qHash(identity.mModificationTime, seed);
+}
+
+/* an entry read from a directory, with the identity of a file when it was read at the same time */
+struct DirectoryEntry
+{
+    bool mIsFile = false;
+
+    bool mHasIdentity = false;
+
+    FileIdentity mIdentity;
+};
+
+struct PendingTrackFile
+{
+    QUrl mFileName;
+
+    FileIdentity mIdentity;
+
+    bool mHasIdentity = false;
+};
+
 class AbstractFileListingPrivate
 {
 public:
@@ -54,7 +114,11 @@ public:
 
     QFileSystemWatcher mFileSystemWatcher;
 
-    QHash<QString, QUrl> mAllAlbumCover;
+    ArtworkResolver mArtworkResolver;
+
+    QHash<QString, QUrl> mTrackCovers;
+
+    QHash<QString, QUrl> takeCovers(const QList<MusicAudioTrack> &tracks);
 
     QHash<QUrl, QSet<QPair<QUrl, bool>>> mDiscoveredFiles;
 
@@ -62,6 +126,8 @@ public:
 
     bool mHandleNewFiles = true;
 
+    bool mWatchTrackFiles = true;
+
     KFileMetaData::ExtractorCollection mExtractors;
 
     QAtomicInt mStopRequest = 0;
@@ -74,14 +140,372 @@ public:
 
     int mNewFilesEmitInterval = 1;
 
+    IndexerFilter mIndexerFilter;
+
+    IndexerFilter mConfiguredIndexerFilter;
+
+    QMutex mConfiguredIndexerFilterMutex;
+
+    void updateIndexerFilter();
+
+#if defined Q_OS_UNIX
+    QSet<QPair<quint64, quint64>> mVisitedDirectories;
+#else
+    QSet<QString> mVisitedDirectories;
+#endif
+
+    enum class DirectoryState {
+        Missing,
+        AlreadyVisited,
+        Listed,
+    };
+
+    /* files already discovered in this directory are not read again with stat */
+    DirectoryState listDirectory(const QUrl &directory, QHash<QUrl, DirectoryEntry> &entries);
+
+    bool mIsResumableScan = false;
+
+    QSet<QUrl> mCompletedDirectories;
+
+    /* inside a directory completed by a previous run: files are listed and watched, their tags are not read */
+    bool mListingOnly = false;
+
+    QList<QUrl> mNewlyCompletedDirectories;
+
+    QHash<QUrl, FileIdentity> mFileIdentities;
+
+    QHash<FileIdentity, QUrl> mKnownFiles;
+
+    QHash<FileIdentity, QUrl> mPendingRemovedIdentities;
+
+    QSet<QUrl> mPendingRemovedFiles;
+
+    QHash<QUrl, QUrl> mRenamedFiles;
+
+    QTimer *mPendingRemovalTimer = nullptr;
+
+    static bool readFileIdentity(const QString &fileName, FileIdentity &identity);
+
+#if defined Q_OS_UNIX
+    static void fillFileIdentity(const struct stat &fileStat, FileIdentity &identity);
+#endif
+
+    void rememberFile(const QUrl &fileName, const FileIdentity &identity);
+
+    bool forgetFile(const QUrl &fileName, FileIdentity &identity);
+
+    QUrl movedFileOrigin(const QUrl &newFileName, const FileIdentity &identity);
+
+    /* only the size and the modification time of the known files are used */
+    QHash<QUrl, FileIdentity> mKnownTrackFiles;
+
+    int mSkippedKnownFilesCount = 0;
+
+    int mExtractionJobs = 1;
+
+    QThreadPool mExtractionThreadPool;
+
+    qint64 mExtractedBytes = 0;
+
+    qint64 mExtractionTime = 0;
+
+    IndexerThrottle *mIndexerThrottle = nullptr;
+
+    QStringList mRootPaths;
+
+    static MusicAudioTrack extractTrack(const QUrl &fileName, IndexerThrottle *throttle);
+
 };
 
+MusicAudioTrack AbstractFileListingPrivate::extractTrack(const QUrl &fileName, IndexerThrottle *throttle)
+{
+    if (throttle) {
+        IndexerThrottle::lowerCurrentThreadPriority();
+        throttle->pace();
+    }
+
+    struct ExtractionContext
+    {
+        QMimeDatabase mMimeDb;
+
+        KFileMetaData::ExtractorCollection mExtractors;
+    };
+
+    /* each worker thread gets its own extractors, they are not meant to be shared between threads */
+    static QThreadStorage<ExtractionContext*> extractionContexts;
+
+    if (!extractionContexts.hasLocalData()) {
+        extractionContexts.setLocalData(new ExtractionContext);
+    }
+
+    const auto context = extractionContexts.localData();
+
+    return ElisaUtils::scanOneFile(fileName, context->mMimeDb, context->mExtractors);
+}
+
+bool AbstractFileListingPrivate::readFileIdentity(const QString &fileName, FileIdentity &identity)
+{
+#if defined Q_OS_UNIX
+    struct stat fileStat;
+    if (stat(QFile::encodeName(fileName).constData(), &fileStat) != 0) {
+        return false;
+    }
+
+    fillFileIdentity(fileStat, identity);
+#else
+    QFileInfo fileInfo(fileName);
+    if (!fileInfo.exists()) {
+        return false;
+    }
+
+    identity.mSize = fileInfo.size();
+    identity.mModificationTime = fileInfo.lastModified().toMSecsSinceEpoch();
+#endif
+
+    return true;
+}
+
+#if defined Q_OS_UNIX
+void AbstractFileListingPrivate::fillFileIdentity(const struct stat &fileStat, FileIdentity &identity)
+{
+    identity.mDevice = static_cast<quint64>(fileStat.st_dev);
+    identity.mInode = static_cast<quint64>(fileStat.st_ino);
+    identity.mSize = static_cast<qint64>(fileStat.st_size);
+#if defined Q_OS_LINUX
+    identity.mModificationTime = static_cast<qint64>(fileStat.st_mtim.tv_sec) * 1000000000 + fileStat.st_mtim.tv_nsec;
+#else
+    identity.mModificationTime = static_cast<qint64>(fileStat.st_mtime);
+#endif
+}
+#endif
+
+void AbstractFileListingPrivate::rememberFile(const QUrl &fileName, const FileIdentity &identity)
+{
+    mFileIdentities[fileName] = identity;
+    mKnownFiles[identity] = fileName;
+}
+
+bool AbstractFileListingPrivate::forgetFile(const QUrl &fileName, FileIdentity &identity)
+{
+    const auto itIdentity = mFileIdentities.find(fileName);
+    if (itIdentity == mFileIdentities.end()) {
+        return false;
+    }
+
+    identity = itIdentity.value();
+    mFileIdentities.erase(itIdentity);
+
+    const auto itKnownFile = mKnownFiles.find(identity);
+    if (itKnownFile != mKnownFiles.end() && itKnownFile.value() == fileName) {
+        mKnownFiles.erase(itKnownFile);
+    }
+
+    return true;
+}
+
+QUrl AbstractFileListingPrivate::movedFileOrigin(const QUrl &newFileName, const FileIdentity &identity)
+{
+    const auto itPendingRemoval = mPendingRemovedIdentities.find(identity);
+    if (itPendingRemoval != mPendingRemovedIdentities.end()) {
+        const auto previousFileName = itPendingRemoval.value();
+
+        mPendingRemovedIdentities.erase(itPendingRemoval);
+        mPendingRemovedFiles.remove(previousFileName);
+
+        return previousFileName;
+    }
+
+    const auto itKnownFile = mKnownFiles.find(identity);
+    if (itKnownFile != mKnownFiles.end() && itKnownFile.value() != newFileName &&
+            !QFileInfo::exists(itKnownFile.value().toLocalFile())) {
+        return itKnownFile.value();
+    }
+
+    return {};
+}
+
+QHash<QString, QUrl> AbstractFileListingPrivate::takeCovers(const QList<MusicAudioTrack> &tracks)
+{
+    auto covers = QHash<QString, QUrl>();
+
+    for (const auto &oneTrack : tracks) {
+        const auto trackKey = oneTrack.resourceURI().toString();
+
+        auto cover = mTrackCovers.take(trackKey);
+        if (!cover.isValid()) {
+            cover = mArtworkResolver.coverForTrack(oneTrack.resourceURI(), oneTrack.albumName());
+        }
+
+        if (cover.isValid()) {
+            covers[trackKey] = cover;
+        }
+    }
+
+    return covers;
+}
+
+void AbstractFileListingPrivate::updateIndexerFilter()
+{
+    QMutexLocker lock(&mConfiguredIndexerFilterMutex);
+    mIndexerFilter = mConfiguredIndexerFilter;
+}
+
+AbstractFileListingPrivate::DirectoryState AbstractFileListingPrivate::listDirectory(const QUrl &directory, QHash<QUrl, DirectoryEntry> &entries)
+{
+    const auto directoryPath = directory.toLocalFile();
+    const auto itDiscoveredFiles = mDiscoveredFiles.constFind(directory);
+    const auto hasDiscoveredFiles = itDiscoveredFiles != mDiscoveredFiles.constEnd();
+
+    auto prefix = directoryPath;
+    if (!prefix.endsWith(QLatin1Char('/'))) {
+        prefix += QLatin1Char('/');
+    }
+
+#if defined Q_OS_UNIX
+    const auto encodedPrefix = QFile::encodeName(prefix);
+
+    auto directoryHandle = opendir(encodedPrefix.constData());
+    if (!directoryHandle) {
+        return DirectoryState::Missing;
+    }
+
+    struct stat directoryStat;
+    if (fstat(dirfd(directoryHandle), &directoryStat) == 0) {
+        const auto directoryIdentity = qMakePair(static_cast<quint64>(directoryStat.st_dev), static_cast<quint64>(directoryStat.st_ino));
+        if (mVisitedDirectories.contains(directoryIdentity)) {
+            closedir(directoryHandle);
+            return DirectoryState::AlreadyVisited;
+        }
+        mVisitedDirectories.insert(directoryIdentity);
+    }
+
+    while (auto oneEntry = readdir(directoryHandle)) {
+        if (oneEntry->d_name[0] == '.') {
+            continue;
+        }
+
+        const auto entryName = QFile::decodeName(oneEntry->d_name);
+        const auto entryPath = prefix + entryName;
+
+        if (mIndexerFilter.isExcludedEntry(entryName, entryPath)) {
+            continue;
+        }
+
+        const auto encodedEntryPath = encodedPrefix + QByteArray(oneEntry->d_name);
+        auto entryUrl = QUrl::fromLocalFile(entryPath);
+
+        auto isFile = false;
+        auto isDirectory = false;
+        auto hasEntryStat = false;
+        struct stat entryStat;
+
+        switch (oneEntry->d_type)
+        {
+        case DT_REG:
+            isFile = true;
+            break;
+        case DT_DIR:
+            isDirectory = true;
+            break;
+        case DT_LNK:
+        case DT_UNKNOWN:
+            if (stat(encodedEntryPath.constData(), &entryStat) == 0) {
+                hasEntryStat = true;
+                isFile = S_ISREG(entryStat.st_mode);
+                isDirectory = S_ISDIR(entryStat.st_mode);
+
+                /* a link is listed under its target, a file reached through two links is imported once */
+                if (auto resolvedPath = realpath(encodedEntryPath.constData(), nullptr)) {
+                    entryUrl = QUrl::fromLocalFile(QFile::decodeName(resolvedPath));
+                    free(resolvedPath);
+                }
+            }
+            break;
+        default:
+            break;
+        }
+
+        if (!isFile && !isDirectory) {
+            continue;
+        }
+
+        auto newEntry = DirectoryEntry();
+        newEntry.mIsFile = isFile;
+
+        /* a new file is read once here, for the size filter and for its identity */
+        if (isFile && (!hasDiscoveredFiles || !itDiscoveredFiles->contains({entryUrl, true}))) {
+            if (!hasEntryStat && stat(encodedEntryPath.constData(), &entryStat) != 0) {
+                continue;
+            }
+
+            if (mIndexerFilter.isTooSmall(entryStat.st_size)) {
+                continue;
+            }
+
+            fillFileIdentity(entryStat, newEntry.mIdentity);
+            newEntry.mHasIdentity = true;
+        }
+
+        entries.insert(entryUrl, newEntry);
+    }
+
+    closedir(directoryHandle);
+#else
+    Q_UNUSED(hasDiscoveredFiles);
+
+    QDir rootDirectory(directoryPath);
+    if (!rootDirectory.exists()) {
+        return DirectoryState::Missing;
+    }
+
+    const auto directoryIdentity = rootDirectory.canonicalPath();
+    if (mVisitedDirectories.contains(directoryIdentity)) {
+        return DirectoryState::AlreadyVisited;
+    }
+    mVisitedDirectories.insert(directoryIdentity);
+
+    const auto entryList = rootDirectory.entryInfoList(QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs);
+    for (const auto &oneEntry : entryList) {
+        const auto entryPath = prefix + oneEntry.fileName();
+
+        if (mIndexerFilter.isExcludedEntry(oneEntry.fileName(), entryPath)) {
+            continue;
+        }
+
+        if (oneEntry.isFile() && mIndexerFilter.isTooSmall(oneEntry.size())) {
+            continue;
+        }
+
+        if (oneEntry.isDir() || oneEntry.isFile()) {
+            auto newEntry = DirectoryEntry();
+            newEntry.mIsFile = oneEntry.isFile();
+
+            if (newEntry.mIsFile) {
+                newEntry.mIdentity.mSize = oneEntry.size();
+                newEntry.mIdentity.mModificationTime = oneEntry.lastModified().toMSecsSinceEpoch();
+                newEntry.mHasIdentity = true;
+            }
+
+            entries.insert(QUrl::fromLocalFile(oneEntry.isSymLink() ? oneEntry.canonicalFilePath() : entryPath), newEntry);
+        }
+    }
+#endif
+
+    return DirectoryState::Listed;
+}
+
 AbstractFileListing::AbstractFileListing(const QString &sourceName, QObject *parent) : QObject(parent), d(std::make_unique<AbstractFileListingPrivate>(sourceName))
 {
     connect(&d->mFileSystemWatcher, &QFileSystemWatcher::directoryChanged,
             this, &AbstractFileListing::directoryChanged);
     connect(&d->mFileSystemWatcher, &QFileSystemWatcher::fileChanged,
             this, &AbstractFileListing::fileChanged);
+
+    d->mPendingRemovalTimer = new QTimer(this);
+    d->mPendingRemovalTimer->setSingleShot(true);
+    d->mPendingRemovalTimer->setInterval(500);
+    connect(d->mPendingRemovalTimer, &QTimer::timeout,
+            this, &AbstractFileListing::emitRemovedFiles);
 }
 
 AbstractFileListing::~AbstractFileListing()
@@ -97,10 +521,64 @@ void AbstractFileListing::newTrackFile(const MusicAudioTrack &partialTrack)
     const auto &newTrack = scanOneFile(partialTrack.resourceURI());
 
     if (newTrack.isValid() && newTrack != partialTrack) {
-        Q_EMIT modifyTracksList({newTrack}, d->mAllAlbumCover, d->mSourceName);
+        Q_EMIT modifyTracksList({newTrack}, d->takeCovers({newTrack}), d->mSourceName);
+    }
+}
+
+void AbstractFileListing::setIndexerFilter(const IndexerFilter &filter)
+{
+    QMutexLocker lock(&d->mConfiguredIndexerFilterMutex);
+    d->mConfiguredIndexerFilter = filter;
+}
+
+void AbstractFileListing::setCompletedDirectories(const QList<QUrl> &completedDirectories)
+{
+    d->mCompletedDirectories = completedDirectories.toSet();
+}
+
+void AbstractFileListing::setKnownFiles(const QList<MusicAudioTrack> &knownFiles)
+{
+    d->mKnownTrackFiles.clear();
+    d->mKnownTrackFiles.reserve(knownFiles.size());
+
+    for (const auto &oneKnownFile : knownFiles) {
+        auto &knownIdentity = d->mKnownTrackFiles[oneKnownFile.resourceURI()];
+        knownIdentity.mSize = oneKnownFile.fileSize();
+        knownIdentity.mModificationTime = oneKnownFile.fileModificationTime();
     }
 }
 
+void AbstractFileListing::setExtractionJobs(int jobs)
+{
+    d->mExtractionJobs = std::max(1, jobs);
+    d->mExtractionThreadPool.setMaxThreadCount(d->mExtractionJobs);
+}
+
+void AbstractFileListing::setIndexerThrottle(IndexerThrottle *throttle)
+{
+    d->mIndexerThrottle = throttle;
+}
+
+int AbstractFileListing::skippedKnownFilesCount() const
+{
+    return d->mSkippedKnownFilesCount;
+}
+
+qint64 AbstractFileListing::extractedBytes() const
+{
+    return d->mExtractedBytes;
+}
+
+qint64 AbstractFileListing::extractionTime() const
+{
+    return d->mExtractionTime;
+}
+
+void AbstractFileListing::addExtractionTime(qint64 extractionTime)
+{
+    d->mExtractionTime += extractionTime;
+}
+
 void AbstractFileListing::resetImportedTracksCounter()
 {
     d->mImportedTracksCount = 0;
@@ -117,32 +595,42 @@ void AbstractFileListing::scanDirectory(QList<MusicAudioTrack> &newFiles, const
         return;
     }
 
-    QDir rootDirectory(path.toLocalFile());
-    rootDirectory.refresh();
+    if (d->mListingOnly || (d->mIsResumableScan && d->mCompletedDirectories.contains(path))) {
+        const auto wasListingOnly = d->mListingOnly;
 
-    if (rootDirectory.exists()) {
-        watchPath(path.toLocalFile());
+        d->mListingOnly = true;
+        scanDirectoryContent(newFiles, path);
+        d->mListingOnly = wasListingOnly;
+
+        return;
     }
 
-    auto &currentDirectoryListingFiles = d->mDiscoveredFiles[path];
+    scanDirectoryContent(newFiles, path);
 
-    auto currentFilesList = QSet<QUrl>();
+    if (d->mIsResumableScan && d->mStopRequest == 0) {
+        d->mNewlyCompletedDirectories.push_back(path);
+    }
+}
 
-    rootDirectory.refresh();
-    const auto entryList = rootDirectory.entryInfoList(QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs);
-    for (const auto &oneEntry : entryList) {
-        auto newFilePath = QUrl::fromLocalFile(oneEntry.canonicalFilePath());
+void AbstractFileListing::scanDirectoryContent(QList<MusicAudioTrack> &newFiles, const QUrl &path)
+{
+    auto currentFilesList = QHash<QUrl, DirectoryEntry>();
 
-        if (oneEntry.isDir() || oneEntry.isFile()) {
-            currentFilesList.insert(newFilePath);
-        }
+    const auto directoryState = d->listDirectory(path, currentFilesList);
+
+    if (directoryState == AbstractFileListingPrivate::DirectoryState::AlreadyVisited) {
+        return;
+    }
+
+    if (directoryState == AbstractFileListingPrivate::DirectoryState::Listed) {
+        watchPath(path.toLocalFile());
     }
 
+    auto &currentDirectoryListingFiles = d->mDiscoveredFiles[path];
+
     auto removedTracks = QVector<QPair<QUrl, bool>>();
     for (const auto &removedFilePath : currentDirectoryListingFiles) {
-        auto itFilePath = std::find(currentFilesList.begin(), currentFilesList.end(), removedFilePath.first);
-
-        if (itFilePath != currentFilesList.end()) {
+        if (currentFilesList.contains(removedFilePath.first)) {
             continue;
         }
 
@@ -159,28 +647,30 @@ void AbstractFileListing::scanDirectory(QList<MusicAudioTrack> &newFiles, const
     }
     for (const auto &oneRemovedTrack : removedTracks) {
         currentDirectoryListingFiles.remove(oneRemovedTrack);
-        currentDirectoryListingFiles.remove(oneRemovedTrack);
     }
 
     if (!allRemovedTracks.isEmpty()) {
-        Q_EMIT removedTracksList(allRemovedTracks);
+        deferRemovedFiles(allRemovedTracks);
     }
 
     if (!d->mHandleNewFiles) {
         return;
     }
 
-    for (const auto &newFilePath : currentFilesList) {
-        QFileInfo oneEntry(newFilePath.toLocalFile());
+    /* without extraction threads, each file is scanned as soon as it is found */
+    const auto extractionBatchSize = (d->mExtractionJobs > 1 ? 4 * d->mExtractionJobs : 1);
+    auto pendingFiles = QVector<PendingTrackFile>();
 
-        auto itFilePath = std::find(currentDirectoryListingFiles.begin(), currentDirectoryListingFiles.end(), QPair<QUrl, bool>{newFilePath, oneEntry.isFile()});
+    for (auto itEntry = currentFilesList.cbegin(); itEntry != currentFilesList.cend(); ++itEntry) {
+        const auto &newFilePath = itEntry.key();
+        const auto isFile = itEntry->mIsFile;
 
-        if (itFilePath != currentDirectoryListingFiles.end()) {
+        if (d->mDiscoveredFiles[path].contains({newFilePath, isFile})) {
             continue;
         }
 
-        if (oneEntry.isDir()) {
-            addFileInDirectory(newFilePath, path);
+        if (!isFile) {
+            addFileInDirectory(newFilePath, path, false);
             scanDirectory(newFiles, newFilePath);
 
             if (d->mStopRequest == 1) {
@@ -189,18 +679,126 @@ void AbstractFileListing::scanDirectory(QList<MusicAudioTrack> &newFiles, const
 
             continue;
         }
-        if (!oneEntry.isFile()) {
+
+        auto pendingFile = PendingTrackFile();
+        pendingFile.mFileName = newFilePath;
+        pendingFile.mHasIdentity = itEntry->mHasIdentity;
+        pendingFile.mIdentity = itEntry->mIdentity;
+
+        if (pendingFile.mHasIdentity) {
+            const auto previousFilePath = d->movedFileOrigin(newFilePath, pendingFile.mIdentity);
+
+            if (previousFilePath.isValid()) {
+                renameFile(previousFilePath, newFilePath);
+                continue;
+            }
+        }
+
+        /* a known file whose size or modification time changed is read again */
+        auto isKnownFile = false;
+        const auto itKnownFile = d->mKnownTrackFiles.find(newFilePath);
+        if (itKnownFile != d->mKnownTrackFiles.end()) {
+            isKnownFile = pendingFile.mHasIdentity &&
+                    itKnownFile->mSize == pendingFile.mIdentity.mSize &&
+                    itKnownFile->mModificationTime == pendingFile.mIdentity.mModificationTime;
+
+            d->mKnownTrackFiles.erase(itKnownFile);
+        }
+
+        if (isKnownFile || d->mListingOnly) {
+            addFileInDirectory(newFilePath, path, true);
+
+            if (pendingFile.mHasIdentity) {
+                d->rememberFile(newFilePath, pendingFile.mIdentity);
+            }
+
+            /* without the database content, the type of the file tells whether it was imported as a track */
+            if (d->mWatchTrackFiles && (isKnownFile ||
+                                        d->mMimeDb.mimeTypeForFile(newFilePath.toLocalFile(), QMimeDatabase::MatchExtension).name().startsWith(QStringLiteral("audio/")))) {
+                watchPath(newFilePath.toLocalFile());
+            }
+
+            ++d->mSkippedKnownFilesCount;
             continue;
         }
 
-        auto newTrack = scanOneFile(newFilePath);
+        pendingFiles.push_back(pendingFile);
+
+        if (pendingFiles.size() >= extractionBatchSize) {
+            scanPendingFiles(newFiles, path, pendingFiles);
+        }
+
+        if (d->mStopRequest == 1) {
+            break;
+        }
+    }
+
+    if (d->mStopRequest == 0) {
+        scanPendingFiles(newFiles, path, pendingFiles);
+    }
+}
+
+void AbstractFileListing::scanPendingFiles(QList<MusicAudioTrack> &newFiles, const QUrl &path, QVector<PendingTrackFile> &pendingFiles)
+{
+    if (pendingFiles.isEmpty()) {
+        return;
+    }
+
+    auto scannedTracks = QVector<MusicAudioTrack>();
+    scannedTracks.reserve(pendingFiles.size());
+
+    QElapsedTimer extractionTimer;
+    extractionTimer.start();
+
+    if (d->mExtractionJobs > 1 && pendingFiles.size() > 1) {
+        auto extractions = QVector<QFuture<MusicAudioTrack>>();
+        extractions.reserve(pendingFiles.size());
+
+        for (const auto &onePendingFile : qAsConst(pendingFiles)) {
+            extractions.push_back(QtConcurrent::run(&d->mExtractionThreadPool, &AbstractFileListingPrivate::extractTrack,
+                                                   onePendingFile.mFileName, d->mIndexerThrottle));
+        }
+
+        for (auto &oneExtraction : extractions) {
+            scannedTracks.push_back(oneExtraction.result());
+
+            if (scannedTracks.last().isValid() && d->mWatchTrackFiles) {
+                watchPath(scannedTracks.last().resourceURI().toLocalFile());
+            }
+        }
+    } else {
+        for (const auto &onePendingFile : qAsConst(pendingFiles)) {
+            if (d->mIndexerThrottle) {
+                d->mIndexerThrottle->pace();
+            }
+
+            scannedTracks.push_back(scanOneFile(onePendingFile.mFileName));
+        }
+    }
+
+    d->mExtractionTime += extractionTimer.nsecsElapsed();
+
+    for (int i = 0; i < pendingFiles.size(); ++i) {
+        const auto &onePendingFile = pendingFiles[i];
+        auto &newTrack = scannedTracks[i];
+
+        if (onePendingFile.mHasIdentity) {
+            d->mExtractedBytes += onePendingFile.mIdentity.mSize;
+
+            newTrack.setFileSize(onePendingFile.mIdentity.mSize);
+            newTrack.setFileModificationTime(onePendingFile.mIdentity.mModificationTime);
+        }
 
         if (newTrack.isValid() && d->mStopRequest == 0) {
             addCover(newTrack);
 
-            addFileInDirectory(newTrack.resourceURI(), path);
+            addFileInDirectory(newTrack.resourceURI(), path, true);
             newFiles.push_back(newTrack);
 
+            if (onePendingFile.mHasIdentity) {
+                d->rememberFile(newTrack.resourceURI(), onePendingFile.mIdentity);
+            }
+
             ++d->mImportedTracksCount;
             if (d->mImportedTracksCount % d->mNotificationUpdateInterval == 0) {
                 d->mNotificationUpdateInterval = std::min(50, 1 + d->mNotificationUpdateInterval * 2);
@@ -220,6 +818,8 @@ void AbstractFileListing::scanDirectory(QList<MusicAudioTrack> &newFiles, const
             break;
         }
     }
+
+    pendingFiles.clear();
 }
 
 const QString &AbstractFileListing::sourceName() const
@@ -232,6 +832,11 @@ int AbstractFileListing::importedTracksCount() const
     return d->mImportedTracksCount;
 }
 
+const IndexerFilter &AbstractFileListing::indexerFilter() const
+{
+    return d->mIndexerFilter;
+}
+
 void AbstractFileListing::directoryChanged(const QString &path)
 {
     const auto directoryEntry = d->mDiscoveredFiles.find(QUrl::fromLocalFile(path));
@@ -241,6 +846,10 @@ void AbstractFileListing::directoryChanged(const QString &path)
 
     Q_EMIT indexingStarted();
 
+    d->updateIndexerFilter();
+
+    d->mArtworkResolver.forgetDirectory(path);
+
     scanDirectoryTree(path);
 
     Q_EMIT indexingFinished(d->mImportedTracksCount);
@@ -253,7 +862,7 @@ void AbstractFileListing::fileChanged(const QString &modifiedFileName)
     auto modifiedTrack = scanOneFile(modifiedFile);
 
     if (modifiedTrack.isValid()) {
-        Q_EMIT modifyTracksList({modifiedTrack}, d->mAllAlbumCover, d->mSourceName);
+        Q_EMIT modifyTracksList({modifiedTrack}, d->takeCovers({modifiedTrack}), d->mSourceName);
     }
 }
 
@@ -264,6 +873,14 @@ void AbstractFileListing::executeInit()
 void AbstractFileListing::triggerRefreshOfContent()
 {
     d->mImportedTracksCount = 0;
+
+    d->updateIndexerFilter();
+
+    d->mArtworkResolver.clear();
+
+    if (d->mIndexerThrottle) {
+        IndexerThrottle::lowerCurrentThreadPriority();
+    }
 }
 
 void AbstractFileListing::refreshContent()
@@ -277,11 +894,8 @@ MusicAudioTrack AbstractFileListing::scanOneFile(const QUrl &scanFile)
 
     newTrack = ElisaUtils::scanOneFile(scanFile, d->mMimeDb, d->mExtractors);
 
-    if (newTrack.isValid()) {
-        QFileInfo scanFileInfo(scanFile.toLocalFile());
-        if (scanFileInfo.exists()) {
-            watchPath(scanFile.toLocalFile());
-        }
+    if (newTrack.isValid() && d->mWatchTrackFiles) {
+        watchPath(scanFile.toLocalFile());
     }
 
     return newTrack;
@@ -292,7 +906,7 @@ void AbstractFileListing::watchPath(const QString &pathName)
     d->mFileSystemWatcher.addPath(pathName);
 }
 
-void AbstractFileListing::addFileInDirectory(const QUrl &newFile, const QUrl &directoryName)
+void AbstractFileListing::addFileInDirectory(const QUrl &newFile, const QUrl &directoryName, bool isFile)
 {
     const auto directoryEntry = d->mDiscoveredFiles.find(directoryName);
     if (directoryEntry == d->mDiscoveredFiles.end()) {
@@ -314,20 +928,62 @@ void AbstractFileListing::addFileInDirectory(const QUrl &newFile, const QUrl &di
     }
     auto &currentDirectoryListingFiles = d->mDiscoveredFiles[directoryName];
 
-    QFileInfo isAFile(newFile.toLocalFile());
-    currentDirectoryListingFiles.insert({newFile, isAFile.isFile()});
+    currentDirectoryListingFiles.insert({newFile, isFile});
 }
 
 void AbstractFileListing::scanDirectoryTree(const QString &path)
 {
     auto newFiles = QList<MusicAudioTrack>();
 
+    d->mVisitedDirectories.clear();
+
     scanDirectory(newFiles, QUrl::fromLocalFile(path));
 
     if (!newFiles.isEmpty() && d->mStopRequest == 0) {
         Q_EMIT importedTracksCountChanged();
         emitNewFiles(newFiles);
     }
+
+    emitRenamedFiles();
+}
+
+void AbstractFileListing::importDirectoryTree(const QString &path)
+{
+    d->mIsResumableScan = true;
+    d->mSkippedKnownFilesCount = 0;
+
+    scanDirectoryTree(path);
+
+    if (d->mStopRequest == 0) {
+        removeVanishedKnownFiles();
+    }
+
+    d->mIsResumableScan = false;
+    d->mKnownTrackFiles.clear();
+    d->mCompletedDirectories.clear();
+    d->mNewlyCompletedDirectories.clear();
+
+    if (d->mStopRequest == 0) {
+        Q_EMIT scanProgressCompleted(d->mSourceName);
+    }
+}
+
+void AbstractFileListing::removeVanishedKnownFiles()
+{
+    auto removedFiles = QList<QUrl>();
+
+    /* known files the walk did not meet are gone, excluded or reached through another path */
+    for (auto itKnownFile = d->mKnownTrackFiles.cbegin(); itKnownFile != d->mKnownTrackFiles.cend(); ++itKnownFile) {
+        const auto knownFileName = itKnownFile.key().toLocalFile();
+
+        if (!QFileInfo::exists(knownFileName) || isExcludedFile(knownFileName)) {
+            removedFiles.push_back(itKnownFile.key());
+        }
+    }
+
+    if (!removedFiles.isEmpty()) {
+        Q_EMIT removedTracksList(removedFiles);
+    }
 }
 
 void AbstractFileListing::setHandleNewFiles(bool handleThem)
@@ -335,28 +991,95 @@ void AbstractFileListing::setHandleNewFiles(bool handleThem)
     d->mHandleNewFiles = handleThem;
 }
 
+void AbstractFileListing::setWatchTrackFiles(bool watchThem)
+{
+    d->mWatchTrackFiles = watchThem;
+}
+
 void AbstractFileListing::emitNewFiles(const QList<MusicAudioTrack> &tracks)
 {
-    Q_EMIT tracksList(tracks, d->mAllAlbumCover, d->mSourceName);
+    Q_EMIT tracksList(tracks, d->takeCovers(tracks), d->mSourceName);
+
+    if (d->mIsResumableScan) {
+        Q_EMIT scanProgressChanged(d->mSourceName, d->mNewlyCompletedDirectories);
+        d->mNewlyCompletedDirectories.clear();
+    }
 }
 
-void AbstractFileListing::addCover(const MusicAudioTrack &newTrack)
+void AbstractFileListing::renameFile(const QUrl &previousFileName, const QUrl &newFileName)
+{
+    const auto previousFileInfo = QFileInfo(previousFileName.toLocalFile());
+    const auto itPreviousDirectory = d->mDiscoveredFiles.find(QUrl::fromLocalFile(previousFileInfo.absolutePath()));
+    if (itPreviousDirectory != d->mDiscoveredFiles.end()) {
+        itPreviousDirectory->remove({previousFileName, true});
+    }
+
+    d->mFileSystemWatcher.removePath(previousFileName.toLocalFile());
+
+    auto fileIdentity = FileIdentity();
+    if (d->forgetFile(previousFileName, fileIdentity) || d->readFileIdentity(newFileName.toLocalFile(), fileIdentity)) {
+        d->rememberFile(newFileName, fileIdentity);
+    }
+
+    const auto newFileInfo = QFileInfo(newFileName.toLocalFile());
+    addFileInDirectory(newFileName, QUrl::fromLocalFile(newFileInfo.absolutePath()), true);
+    if (d->mWatchTrackFiles) {
+        watchPath(newFileName.toLocalFile());
+    }
+
+    auto originalFileName = previousFileName;
+    for (auto itRenamedFile = d->mRenamedFiles.begin(); itRenamedFile != d->mRenamedFiles.end(); ++itRenamedFile) {
+        if (itRenamedFile.value() == previousFileName) {
+            originalFileName = itRenamedFile.key();
+            break;
+        }
+    }
+
+    d->mRenamedFiles[originalFileName] = newFileName;
+}
+
+void AbstractFileListing::emitRenamedFiles()
 {
-    auto itCover = d->mAllAlbumCover.find(newTrack.albumName());
-    if (itCover != d->mAllAlbumCover.end()) {
+    if (d->mRenamedFiles.isEmpty()) {
         return;
     }
 
-    QFileInfo trackFilePath(newTrack.resourceURI().toLocalFile());
-    QFileInfo coverFilePath(trackFilePath.dir().filePath(QStringLiteral("cover.jpg")));
+    Q_EMIT renamedTracksList(d->mRenamedFiles);
+    d->mRenamedFiles.clear();
+}
 
-    if (coverFilePath.exists()) {
-        d->mAllAlbumCover[newTrack.resourceURI().toString()] = QUrl::fromLocalFile(coverFilePath.absoluteFilePath());
+void AbstractFileListing::deferRemovedFiles(const QList<QUrl> &removedFiles)
+{
+    for (const auto &oneRemovedFile : removedFiles) {
+        auto fileIdentity = FileIdentity();
+        if (d->forgetFile(oneRemovedFile, fileIdentity)) {
+            d->mPendingRemovedIdentities[fileIdentity] = oneRemovedFile;
+        }
+
+        d->mPendingRemovedFiles.insert(oneRemovedFile);
+    }
+
+    d->mPendingRemovalTimer->start();
+}
+
+void AbstractFileListing::emitRemovedFiles()
+{
+    d->mPendingRemovedIdentities.clear();
+
+    if (d->mPendingRemovedFiles.isEmpty()) {
         return;
     }
-    coverFilePath.setFile(trackFilePath.dir().filePath(QStringLiteral("cover.png")));
-    if (coverFilePath.exists()) {
-        d->mAllAlbumCover[newTrack.resourceURI().toString()] = QUrl::fromLocalFile(coverFilePath.absoluteFilePath());
+
+    Q_EMIT removedTracksList(d->mPendingRemovedFiles.toList());
+    d->mPendingRemovedFiles.clear();
+}
+
+void AbstractFileListing::addCover(const MusicAudioTrack &newTrack)
+{
+    const auto &cover = d->mArtworkResolver.coverForTrack(newTrack.resourceURI(), newTrack.albumName());
+
+    if (cover.isValid()) {
+        d->mTrackCovers[newTrack.resourceURI().toString()] = cover;
     }
 }
 
@@ -399,5 +1122,46 @@ void AbstractFileListing::increaseImportedTracksCount()
     ++d->mImportedTracksCount;
 }
 
+void AbstractFileListing::setRootPaths(const QStringList &rootPaths)
+{
+    d->mRootPaths = rootPaths;
+}
+
+bool AbstractFileListing::isExcludedFile(const QString &fileName) const
+{
+    if (d->mIndexerFilter.isEmpty()) {
+        return false;
+    }
+
+    /* the deepest root containing this file, the directories above it are not filtered */
+    auto rootPath = QString();
+    for (const auto &oneRootPath : qAsConst(d->mRootPaths)) {
+        auto rootPrefix = oneRootPath;
+        if (!rootPrefix.endsWith(QLatin1Char('/'))) {
+            rootPrefix += QLatin1Char('/');
+        }
+
+        if (fileName.startsWith(rootPrefix) && rootPrefix.size() > rootPath.size()) {
+            rootPath = rootPrefix;
+        }
+    }
+
+    if (d->mIndexerFilter.isExcludedPath(fileName, rootPath)) {
+        return true;
+    }
+
+    if (d->mIndexerFilter.minimumFileSize() > 0) {
+        QFileInfo scanFileInfo(fileName);
+        return d->mIndexerFilter.isTooSmall(scanFileInfo.size());
+    }
+
+    return false;
+}
+
+IndexerThrottle *AbstractFileListing::indexerThrottle() const
+{
+    return d->mIndexerThrottle;
+}
+
 
 #include "moc_abstractfilelisting.cpp"
@@ -21,6 +21,7 @@
 #define ABSTRACTFILELISTING_H
 
 #include "notificationitem.h"
+#include "indexerfilter.h"
 
 #include <QObject>
 #include <QString>
@@ -31,7 +32,9 @@
 #include <memory>
 
 class AbstractFileListingPrivate;
+class IndexerThrottle;
 class MusicAudioTrack;
+struct PendingTrackFile;
 class NotificationItem;
 
 class AbstractFileListing : public QObject
@@ -55,12 +58,57 @@ public:
 
     int importedTracksCount() const;
 
+    const IndexerFilter& indexerFilter() const;
+
+    void setIndexerFilter(const IndexerFilter &filter);
+
+    /**
+     * Directories whose content was completely imported by a previous,
+     * interrupted, run. They are skipped by the next importDirectoryTree call.
+     */
+    void setCompletedDirectories(const QList<QUrl> &completedDirectories);
+
+    /**
+     * Tracks already stored in the database, with the size and modification
+     * time of their file. The next importDirectoryTree call keeps the files
+     * that did not change without reading their tags again, reads the tags
+     * of the other ones and reports the ones that disappeared as removed.
+     */
+    void setKnownFiles(const QList<MusicAudioTrack> &knownFiles);
+
+    /**
+     * Number of threads reading tags while scanning directories. With more
+     * than one thread, tags are read by the default extractors instead of
+     * scanOneFile.
+     */
+    void setExtractionJobs(int jobs);
+
+    /**
+     * Pace the scan according to the playback state. The indexing threads
+     * also get a lower priority. Without throttle, the scan runs at full speed.
+     */
+    void setIndexerThrottle(IndexerThrottle *throttle);
+
+    int skippedKnownFilesCount() const;
+
+    /**
+     * Total size of the files whose tags were read.
+     */
+    qint64 extractedBytes() const;
+
+    /**
+     * Time spent reading tags, in nanoseconds.
+     */
+    qint64 extractionTime() const;
+
 Q_SIGNALS:
 
     void tracksList(const QList<MusicAudioTrack> &tracks, const QHash<QString, QUrl> &covers, const QString &musicSource);
 
     void removedTracksList(const QList<QUrl> &removedTracks);
 
+    void renamedTracksList(const QHash<QUrl, QUrl> &renamedTracks);
+
     void modifyTracksList(const QList<MusicAudioTrack> &modifiedTracks, const QHash<QString, QUrl> &covers, const QString &musicSource);
 
     void indexingStarted();
@@ -73,6 +121,10 @@ Q_SIGNALS:
 
     void closeNotification(QString notificationId);
 
+    void scanProgressChanged(const QString &musicSource, const QList<QUrl> &completedDirectories);
+
+    void scanProgressCompleted(const QString &musicSource);
+
 public Q_SLOTS:
 
     void refreshContent();
@@ -101,12 +153,16 @@ protected:
 
     void watchPath(const QString &pathName);
 
-    void addFileInDirectory(const QUrl &newFile, const QUrl &directoryName);
+    void addFileInDirectory(const QUrl &newFile, const QUrl &directoryName, bool isFile);
 
     void scanDirectoryTree(const QString &path);
 
+    void importDirectoryTree(const QString &path);
+
     void setHandleNewFiles(bool handleThem);
 
+    void setWatchTrackFiles(bool watchThem);
+
     void emitNewFiles(const QList<MusicAudioTrack> &tracks);
 
     void addCover(const MusicAudioTrack &newTrack);
@@ -115,12 +171,45 @@ protected:
 
     void removeFile(const QUrl &oneRemovedTrack, QList<QUrl> &allRemovedFiles);
 
+    /**
+     * Record that a known file was moved. The track keeps its tags and
+     * database entry, only its file name is updated by the next emitRenamedFiles.
+     */
+    void renameFile(const QUrl &previousFileName, const QUrl &newFileName);
+
+    void emitRenamedFiles();
+
+    /**
+     * Account for tags read outside of scanDirectory, in nanoseconds.
+     */
+    void addExtractionTime(qint64 extractionTime);
+
     void setSourceName(const QString &name);
 
     void increaseImportedTracksCount();
 
+    /**
+     * Directories indexed by this listing. Only the part of a file name below
+     * its root is tested by isExcludedFile.
+     */
+    void setRootPaths(const QStringList &rootPaths);
+
+    bool isExcludedFile(const QString &fileName) const;
+
+    IndexerThrottle* indexerThrottle() const;
+
 private:
 
+    void scanDirectoryContent(QList<MusicAudioTrack> &newFiles, const QUrl &path);
+
+    void scanPendingFiles(QList<MusicAudioTrack> &newFiles, const QUrl &path, QVector<PendingTrackFile> &pendingFiles);
+
+    void removeVanishedKnownFiles();
+
+    void deferRemovedFiles(const QList<QUrl> &removedFiles);
+
+    void emitRemovedFiles();
+
     std::unique_ptr<AbstractFileListingPrivate> d;
 
 };
@@ -0,0 +1,223 @@
+/*
+ * Copyright 2017 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "artworkresolver.h"
+
+#include "config-upnp-qt.h"
+
+#if HAVE_KFILEMETADATA_EMBEDDEDIMAGEDATA
+#include <KFileMetaData/EmbeddedImageData>
+#endif
+
+#include <QHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QCryptographicHash>
+#include <QStandardPaths>
+
+#include <utility>
+
+class ArtworkResolverPrivate
+{
+public:
+
+    explicit ArtworkResolverPrivate(QString cacheDirectory) : mCacheDirectory(std::move(cacheDirectory))
+    {
+    }
+
+    QString mCacheDirectory;
+
+    QHash<QString, QUrl> mDirectoryCovers;
+
+    QHash<QString, QHash<QString, QUrl>> mEmbeddedCovers;
+
+    QHash<QByteArray, QUrl> mCoversByContent;
+
+#if HAVE_KFILEMETADATA_EMBEDDEDIMAGEDATA
+    KFileMetaData::EmbeddedImageData mImageData;
+#endif
+
+    QUrl findDirectoryCover(const QString &directoryPath);
+
+    QUrl extractEmbeddedCover(const QString &trackFileName);
+
+    QUrl uniqueCover(const QByteArray &content, const QUrl &cover);
+
+};
+
+static const QStringList &coverBaseNames()
+{
+    static const auto baseNames = QStringList{QStringLiteral("cover"), QStringLiteral("folder"),
+            QStringLiteral("front"), QStringLiteral("album"), QStringLiteral("albumart")};
+
+    return baseNames;
+}
+
+static const QStringList &coverSuffixes()
+{
+    static const auto suffixes = QStringList{QStringLiteral("jpg"), QStringLiteral("jpeg"), QStringLiteral("png")};
+
+    return suffixes;
+}
+
+QUrl ArtworkResolverPrivate::findDirectoryCover(const QString &directoryPath)
+{
+    const auto &baseNames = coverBaseNames();
+    const auto &suffixes = coverSuffixes();
+
+    auto bestRank = baseNames.size() * suffixes.size();
+    auto bestCover = QString();
+
+    const auto allImages = QDir(directoryPath).entryInfoList({QStringLiteral("*.jpg"), QStringLiteral("*.jpeg"), QStringLiteral("*.png")},
+                                                             QDir::Files | QDir::Readable);
+
+    for (const auto &oneImage : allImages) {
+        const auto baseIndex = baseNames.indexOf(oneImage.completeBaseName().toLower());
+        if (baseIndex == -1) {
+            continue;
+        }
+
+        const auto suffixIndex = suffixes.indexOf(oneImage.suffix().toLower());
+        const auto rank = baseIndex * suffixes.size() + suffixIndex;
+        if (rank < bestRank) {
+            bestRank = rank;
+            bestCover = oneImage.absoluteFilePath();
+        }
+    }
+
+    if (bestCover.isEmpty()) {
+        return {};
+    }
+
+    QFile coverFile(bestCover);
+    if (!coverFile.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    return uniqueCover(coverFile.readAll(), QUrl::fromLocalFile(bestCover));
+}
+
+QUrl ArtworkResolverPrivate::extractEmbeddedCover(const QString &trackFileName)
+{
+#if HAVE_KFILEMETADATA_EMBEDDEDIMAGEDATA
+    if (mCacheDirectory.isEmpty()) {
+        return {};
+    }
+
+    const auto &allImages = mImageData.imageData(trackFileName, KFileMetaData::EmbeddedImageData::FrontCover);
+    const auto &frontCover = allImages.value(KFileMetaData::EmbeddedImageData::FrontCover);
+    if (frontCover.isEmpty()) {
+        return {};
+    }
+
+    const auto contentHash = QCryptographicHash::hash(frontCover, QCryptographicHash::Sha1);
+    const auto itCover = mCoversByContent.constFind(contentHash);
+    if (itCover != mCoversByContent.constEnd()) {
+        return itCover.value();
+    }
+
+    const auto suffix = (frontCover.startsWith("\x89PNG") ? QStringLiteral(".png") : QStringLiteral(".jpg"));
+    const auto coverFileName = mCacheDirectory + QLatin1Char('/') + QString::fromLatin1(contentHash.toHex()) + suffix;
+
+    if (!QFileInfo::exists(coverFileName)) {
+        if (!QDir().mkpath(mCacheDirectory)) {
+            return {};
+        }
+
+        QFile coverFile(coverFileName);
+        if (!coverFile.open(QIODevice::WriteOnly) || coverFile.write(frontCover) != frontCover.size()) {
+            coverFile.remove();
+            return {};
+        }
+    }
+
+    const auto cover = QUrl::fromLocalFile(coverFileName);
+    mCoversByContent[contentHash] = cover;
+
+    return cover;
+#else
+    Q_UNUSED(trackFileName);
+
+    return {};
+#endif
+}
+
+QUrl ArtworkResolverPrivate::uniqueCover(const QByteArray &content, const QUrl &cover)
+{
+    const auto contentHash = QCryptographicHash::hash(content, QCryptographicHash::Sha1);
+
+    auto itCover = mCoversByContent.find(contentHash);
+    if (itCover == mCoversByContent.end()) {
+        itCover = mCoversByContent.insert(contentHash, cover);
+    } else if (!QFileInfo::exists(itCover->toLocalFile())) {
+        *itCover = cover;
+    }
+
+    return itCover.value();
+}
+
+ArtworkResolver::ArtworkResolver(QString cacheDirectory) : d(std::make_unique<ArtworkResolverPrivate>(std::move(cacheDirectory)))
+{
+    if (d->mCacheDirectory.isEmpty()) {
+        d->mCacheDirectory = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/embeddedCovers");
+    }
+}
+
+ArtworkResolver::~ArtworkResolver()
+= default;
+
+QUrl ArtworkResolver::coverForTrack(const QUrl &trackFile, const QString &albumName)
+{
+    const auto trackFileName = trackFile.toLocalFile();
+    const auto directoryPath = QFileInfo(trackFileName).absolutePath();
+
+    auto itDirectoryCover = d->mDirectoryCovers.find(directoryPath);
+    if (itDirectoryCover == d->mDirectoryCovers.end()) {
+        itDirectoryCover = d->mDirectoryCovers.insert(directoryPath, d->findDirectoryCover(directoryPath));
+    }
+
+    if (itDirectoryCover->isValid()) {
+        return itDirectoryCover.value();
+    }
+
+    auto &directoryEmbeddedCovers = d->mEmbeddedCovers[directoryPath];
+
+    auto itEmbeddedCover = directoryEmbeddedCovers.find(albumName);
+    if (itEmbeddedCover == directoryEmbeddedCovers.end()) {
+        itEmbeddedCover = directoryEmbeddedCovers.insert(albumName, d->extractEmbeddedCover(trackFileName));
+    }
+
+    return itEmbeddedCover.value();
+}
+
+void ArtworkResolver::forgetDirectory(const QString &directoryPath)
+{
+    const auto cleanedPath = QDir::cleanPath(directoryPath);
+
+    d->mDirectoryCovers.remove(cleanedPath);
+    d->mEmbeddedCovers.remove(cleanedPath);
+}
+
+void ArtworkResolver::clear()
+{
+    d->mDirectoryCovers.clear();
+    d->mEmbeddedCovers.clear();
+    d->mCoversByContent.clear();
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2017 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef ARTWORKRESOLVER_H
+#define ARTWORKRESOLVER_H
+
+#include <QString>
+#include <QUrl>
+
+#include <memory>
+
+class ArtworkResolverPrivate;
+
+/**
+ * Find the cover of the tracks found by a file listing.
+ *
+ * Each directory is listed once to look for a well known image file
+ * (cover.jpg, folder.png, front.jpg...). Tracks living in a directory
+ * without such a file get their embedded artwork, stored in the cache
+ * directory. Identical images are reported with a single url.
+ */
+class ArtworkResolver
+{
+public:
+
+    explicit ArtworkResolver(QString cacheDirectory = {});
+
+    ~ArtworkResolver();
+
+    QUrl coverForTrack(const QUrl &trackFile, const QString &albumName);
+
+    void forgetDirectory(const QString &directoryPath);
+
+    void clear();
+
+private:
+
+    std::unique_ptr<ArtworkResolverPrivate> d;
+
+};
+
+#endif // ARTWORKRESOLVER_H
@@ -0,0 +1,278 @@
+/*
+ * Copyright 2017 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "indexerfilter.h"
+
+#include <QRegularExpression>
+#include <QVector>
+#include <QSet>
+
+#include <algorithm>
+
+class IndexerFilterPrivate
+{
+public:
+
+    QStringList mExcludedPatterns;
+
+    qint64 mMinimumFileSize = 0;
+
+    QSet<QString> mExcludedNames;
+
+    QSet<QString> mExcludedPaths;
+
+    QRegularExpression mNameExpression;
+
+    QRegularExpression mPathExpression;
+
+    QVector<QRegularExpression> mPatternExpressions;
+
+    QVector<bool> mIsPathPattern;
+
+};
+
+static bool isWildcardPattern(const QString &pattern)
+{
+    return pattern.contains(QLatin1Char('*')) || pattern.contains(QLatin1Char('?')) || pattern.contains(QLatin1Char('['));
+}
+
+static QString globToRegularExpression(const QString &pattern)
+{
+    auto result = QString();
+
+    for (int i = 0; i < pattern.size(); ++i) {
+        const auto current = pattern.at(i);
+
+        if (current == QLatin1Char('*')) {
+            if (i + 1 < pattern.size() && pattern.at(i + 1) == QLatin1Char('*')) {
+                result += QStringLiteral(".*");
+                ++i;
+            } else {
+                result += QStringLiteral("[^/]*");
+            }
+        } else if (current == QLatin1Char('?')) {
+            result += QStringLiteral("[^/]");
+        } else if (current == QLatin1Char('[')) {
+            const auto closingBracket = pattern.indexOf(QLatin1Char(']'), i + 2);
+            if (closingBracket == -1) {
+                result += QStringLiteral("\\[");
+                continue;
+            }
+
+            auto content = pattern.mid(i + 1, closingBracket - i - 1);
+            if (content.startsWith(QLatin1Char('!'))) {
+                content[0] = QLatin1Char('^');
+            }
+            content.replace(QLatin1Char('\\'), QStringLiteral("\\\\"));
+
+            result += QLatin1Char('[') + content + QLatin1Char(']');
+            i = closingBracket;
+        } else {
+            result += QRegularExpression::escape(current);
+        }
+    }
+
+    return result;
+}
+
+static QString normalizedPattern(const QString &pattern)
+{
+    auto result = pattern.trimmed();
+
+    while (result.size() > 1 && result.endsWith(QLatin1Char('/'))) {
+        result.chop(1);
+    }
+
+    if (result.contains(QLatin1Char('/')) && !result.startsWith(QLatin1Char('/')) && !result.startsWith(QStringLiteral("**"))) {
+        result = QStringLiteral("**/") + result;
+    }
+
+    return result;
+}
+
+IndexerFilter::IndexerFilter() : d(std::make_unique<IndexerFilterPrivate>())
+{
+}
+
+IndexerFilter::IndexerFilter(const QStringList &excludedPatterns, qint64 minimumFileSize) : d(std::make_unique<IndexerFilterPrivate>())
+{
+    d->mExcludedPatterns = excludedPatterns;
+    d->mMinimumFileSize = std::max(qint64(0), minimumFileSize);
+
+    auto allNameExpressions = QStringList();
+    auto allPathExpressions = QStringList();
+
+    for (const auto &oneRawPattern : excludedPatterns) {
+        const auto onePattern = normalizedPattern(oneRawPattern);
+        const auto isPathPattern = onePattern.contains(QLatin1Char('/'));
+
+        d->mIsPathPattern.push_back(isPathPattern);
+
+        if (onePattern.isEmpty()) {
+            d->mPatternExpressions.push_back(QRegularExpression());
+            continue;
+        }
+
+        const auto oneExpression = globToRegularExpression(onePattern);
+        d->mPatternExpressions.push_back(QRegularExpression(QStringLiteral("\\A(?:") + oneExpression + QStringLiteral(")\\z")));
+
+        if (!isWildcardPattern(onePattern)) {
+            if (isPathPattern) {
+                d->mExcludedPaths.insert(onePattern);
+            } else {
+                d->mExcludedNames.insert(onePattern);
+            }
+            continue;
+        }
+
+        if (isPathPattern) {
+            allPathExpressions.push_back(oneExpression);
+        } else {
+            allNameExpressions.push_back(oneExpression);
+        }
+    }
+
+    if (!allNameExpressions.isEmpty()) {
+        d->mNameExpression.setPattern(QStringLiteral("\\A(?:") + allNameExpressions.join(QLatin1Char('|')) + QStringLiteral(")\\z"));
+        d->mNameExpression.optimize();
+    }
+
+    if (!allPathExpressions.isEmpty()) {
+        d->mPathExpression.setPattern(QStringLiteral("\\A(?:") + allPathExpressions.join(QLatin1Char('|')) + QStringLiteral(")\\z"));
+        d->mPathExpression.optimize();
+    }
+}
+
+IndexerFilter::IndexerFilter(IndexerFilter &&other)
+{
+    d.swap(other.d);
+}
+
+IndexerFilter::IndexerFilter(const IndexerFilter &other) : d(std::make_unique<IndexerFilterPrivate>(*other.d))
+{
+}
+
+IndexerFilter& IndexerFilter::operator=(IndexerFilter &&other)
+{
+    if (&other != this) {
+        d.reset();
+        d.swap(other.d);
+    }
+
+    return *this;
+}
+
+IndexerFilter& IndexerFilter::operator=(const IndexerFilter &other)
+{
+    if (&other != this) {
+        (*d) = (*other.d);
+    }
+
+    return *this;
+}
+
+IndexerFilter::~IndexerFilter()
+= default;
+
+const QStringList &IndexerFilter::excludedPatterns() const
+{
+    return d->mExcludedPatterns;
+}
+
+qint64 IndexerFilter::minimumFileSize() const
+{
+    return d->mMinimumFileSize;
+}
+
+bool IndexerFilter::isEmpty() const
+{
+    return d->mPatternExpressions.isEmpty() && d->mMinimumFileSize == 0;
+}
+
+bool IndexerFilter::isExcludedEntry(const QString &entryName, const QString &entryPath) const
+{
+    if (d->mExcludedNames.contains(entryName) || d->mExcludedPaths.contains(entryPath)) {
+        return true;
+    }
+
+    if (!d->mNameExpression.pattern().isEmpty() && d->mNameExpression.match(entryName).hasMatch()) {
+        return true;
+    }
+
+    if (!d->mPathExpression.pattern().isEmpty() && d->mPathExpression.match(entryPath).hasMatch()) {
+        return true;
+    }
+
+    return false;
+}
+
+bool IndexerFilter::isExcludedPath(const QString &absolutePath, const QString &rootPath) const
+{
+    if (d->mPatternExpressions.isEmpty()) {
+        return false;
+    }
+
+    auto componentStart = 0;
+
+    auto rootPrefix = rootPath;
+    while (rootPrefix.endsWith(QLatin1Char('/'))) {
+        rootPrefix.chop(1);
+    }
+
+    if (!rootPath.isEmpty() && absolutePath.startsWith(rootPrefix) &&
+            (absolutePath.size() == rootPrefix.size() || absolutePath.at(rootPrefix.size()) == QLatin1Char('/'))) {
+        componentStart = rootPrefix.size() + 1;
+    }
+    while (componentStart < absolutePath.size()) {
+        auto componentEnd = absolutePath.indexOf(QLatin1Char('/'), componentStart);
+        if (componentEnd == -1) {
+            componentEnd = absolutePath.size();
+        }
+
+        if (componentEnd > componentStart &&
+                isExcludedEntry(absolutePath.mid(componentStart, componentEnd - componentStart), absolutePath.left(componentEnd))) {
+            return true;
+        }
+
+        componentStart = componentEnd + 1;
+    }
+
+    return false;
+}
+
+bool IndexerFilter::isTooSmall(qint64 fileSize) const
+{
+    return fileSize < d->mMinimumFileSize;
+}
+
+int IndexerFilter::matchingPattern(const QString &entryName, const QString &entryPath) const
+{
+    for (int i = 0; i < d->mPatternExpressions.size(); ++i) {
+        const auto &oneExpression = d->mPatternExpressions.at(i);
+        if (oneExpression.pattern().isEmpty()) {
+            continue;
+        }
+
+        if (oneExpression.match(d->mIsPathPattern.at(i) ? entryPath : entryName).hasMatch()) {
+            return i;
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2017 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INDEXERFILTER_H
+#define INDEXERFILTER_H
+
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+
+class IndexerFilterPrivate;
+
+/**
+ * Exclusion rules applied by the file indexers before descending into a
+ * directory or extracting metadata from a file.
+ *
+ * Patterns without a '/' are matched against the name of each entry, the
+ * other ones against its absolute path. '*' and '?' never match a '/', '**'
+ * does. All patterns are compiled once when the filter is built.
+ */
+class IndexerFilter
+{
+public:
+
+    IndexerFilter();
+
+    IndexerFilter(const QStringList &excludedPatterns, qint64 minimumFileSize);
+
+    IndexerFilter(IndexerFilter &&other);
+
+    IndexerFilter(const IndexerFilter &other);
+
+    IndexerFilter& operator=(IndexerFilter &&other);
+
+    IndexerFilter& operator=(const IndexerFilter &other);
+
+    ~IndexerFilter();
+
+    const QStringList& excludedPatterns() const;
+
+    qint64 minimumFileSize() const;
+
+    bool isEmpty() const;
+
+    bool isExcludedEntry(const QString &entryName, const QString &entryPath) const;
+
+    /**
+     * Test each directory and the file name of absolutePath below rootPath.
+     * The directories containing the indexed root are never tested, a rule
+     * like "music" must not exclude a whole library stored in ~/music. With an
+     * empty rootPath, or a path outside of it, every component is tested.
+     */
+    bool isExcludedPath(const QString &absolutePath, const QString &rootPath) const;
+
+    bool isTooSmall(qint64 fileSize) const;
+
+    /**
+     * Return the index in excludedPatterns() of the first pattern matching
+     * this entry or -1 if none is matching.
+     */
+    int matchingPattern(const QString &entryName, const QString &entryPath) const;
+
+private:
+
+    std::unique_ptr<IndexerFilterPrivate> d;
+
+};
+
+#endif // INDEXERFILTER_H
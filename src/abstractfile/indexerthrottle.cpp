@@ -0,0 +1,167 @@
+/*
+ * Copyright 2017 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "indexerthrottle.h"
+
+#include <QThread>
+#include <QThreadStorage>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include <QAtomicInteger>
+
+#include <QDebug>
+
+#if defined Q_OS_LINUX
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace {
+
+struct IndexingBudget
+{
+    /* time an indexing thread may run before being paused, in milliseconds */
+    qint64 mRunTime;
+
+    unsigned long mPauseTime;
+};
+
+const IndexingBudget playingBudget = {50, 25};
+
+const IndexingBudget bufferingBudget = {10, 250};
+
+#if defined Q_OS_LINUX
+/* from linux/ioprio.h, not exported by the C library */
+const int ioprioWhoProcess = 1;
+
+const int ioprioClassIdle = 3;
+
+const int ioprioClassShift = 13;
+
+const int indexerNiceValue = 10;
+#endif
+
+}
+
+class IndexerThrottlePrivate
+{
+public:
+
+    QAtomicInt mPlaybackState = static_cast<int>(IndexerThrottle::PlaybackState::Stopped);
+
+    QAtomicInt mBufferUnderrunsCount = 0;
+
+    QAtomicInteger<qint64> mThrottledTime = 0;
+
+    QThreadStorage<QElapsedTimer*> mRunningSlices;
+
+};
+
+IndexerThrottle::IndexerThrottle() : d(std::make_unique<IndexerThrottlePrivate>())
+{
+}
+
+IndexerThrottle::~IndexerThrottle()
+= default;
+
+IndexerThrottle::PlaybackState IndexerThrottle::playbackState() const
+{
+    return static_cast<PlaybackState>(d->mPlaybackState.loadAcquire());
+}
+
+void IndexerThrottle::setPlaybackState(PlaybackState state)
+{
+    const auto previousState = static_cast<PlaybackState>(d->mPlaybackState.fetchAndStoreOrdered(static_cast<int>(state)));
+
+    if (previousState == PlaybackState::Playing && state == PlaybackState::Buffering) {
+        d->mBufferUnderrunsCount.ref();
+    }
+}
+
+void IndexerThrottle::pace()
+{
+    if (!d->mRunningSlices.hasLocalData()) {
+        auto runningSlice = new QElapsedTimer;
+        runningSlice->start();
+        d->mRunningSlices.setLocalData(runningSlice);
+    }
+
+    auto runningSlice = d->mRunningSlices.localData();
+
+    const auto state = playbackState();
+    if (state == PlaybackState::Stopped) {
+        runningSlice->restart();
+        return;
+    }
+
+    const auto &budget = (state == PlaybackState::Buffering ? bufferingBudget : playingBudget);
+    if (runningSlice->elapsed() < budget.mRunTime) {
+        return;
+    }
+
+    QThread::msleep(budget.mPauseTime);
+    d->mThrottledTime.fetchAndAddRelaxed(static_cast<qint64>(budget.mPauseTime));
+
+    runningSlice->restart();
+}
+
+void IndexerThrottle::resetStatistics()
+{
+    d->mBufferUnderrunsCount.storeRelease(0);
+    d->mThrottledTime.storeRelease(0);
+}
+
+int IndexerThrottle::bufferUnderrunsCount() const
+{
+    return d->mBufferUnderrunsCount.loadAcquire();
+}
+
+qint64 IndexerThrottle::throttledTime() const
+{
+    return d->mThrottledTime.loadAcquire();
+}
+
+void IndexerThrottle::lowerCurrentThreadPriority()
+{
+    static QThreadStorage<bool> loweredThreads;
+
+    if (loweredThreads.hasLocalData()) {
+        return;
+    }
+    loweredThreads.setLocalData(true);
+
+#if defined Q_OS_LINUX
+    const auto threadId = static_cast<int>(syscall(SYS_gettid));
+
+    if (syscall(SYS_ioprio_set, ioprioWhoProcess, threadId, ioprioClassIdle << ioprioClassShift) != 0) {
+        qDebug() << "IndexerThrottle::lowerCurrentThreadPriority" << "ioprio_set" << strerror(errno);
+    }
+
+    if (getpriority(PRIO_PROCESS, static_cast<id_t>(threadId)) < indexerNiceValue &&
+            setpriority(PRIO_PROCESS, static_cast<id_t>(threadId), indexerNiceValue) != 0) {
+        qDebug() << "IndexerThrottle::lowerCurrentThreadPriority" << "setpriority" << strerror(errno);
+    }
+#else
+    QThread::currentThread()->setPriority(QThread::LowestPriority);
+#endif
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2017 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INDEXERTHROTTLE_H
+#define INDEXERTHROTTLE_H
+
+#include <QtGlobal>
+
+#include <memory>
+
+class IndexerThrottlePrivate;
+
+/**
+ * Share of disk and processor time given to the file indexers while
+ * music is playing.
+ *
+ * Indexing threads call pace() between two files. Without playback it
+ * returns immediately. During playback each thread is paused regularly
+ * and the pauses get much longer while the player is buffering. All
+ * methods can be called from any thread.
+ */
+class IndexerThrottle
+{
+public:
+
+    enum class PlaybackState {
+        Stopped,
+        Playing,
+        Buffering,
+    };
+
+    IndexerThrottle();
+
+    ~IndexerThrottle();
+
+    IndexerThrottle(const IndexerThrottle &other) = delete;
+
+    IndexerThrottle& operator=(const IndexerThrottle &other) = delete;
+
+    PlaybackState playbackState() const;
+
+    /**
+     * Switching from Playing to Buffering is counted as a buffer underrun.
+     */
+    void setPlaybackState(PlaybackState state);
+
+    void pace();
+
+    void resetStatistics();
+
+    int bufferUnderrunsCount() const;
+
+    /**
+     * Time spent paused by pace() since the last resetStatistics, in milliseconds.
+     */
+    qint64 throttledTime() const;
+
+    /**
+     * Give the calling thread idle I/O priority and a lower processor
+     * priority. Only the first call of each thread has an effect.
+     */
+    static void lowerCurrentThreadPriority();
+
+private:
+
+    std::unique_ptr<IndexerThrottlePrivate> d;
+
+};
+
+#endif // INDEXERTHROTTLE_H
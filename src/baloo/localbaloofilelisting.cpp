@@ -22,6 +22,7 @@
 #include "musicaudiotrack.h"
 #include "notificationitem.h"
 #include "elisa_settings.h"
+#include "abstractfile/indexerthrottle.h"
 
 #include "baloo/scheduler.h"
 #include "baloo/fileindexer.h"
@@ -46,12 +47,189 @@
 #include <QDir>
 #include <QAtomicInt>
 #include <QScopedPointer>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QFuture>
+#include <QtConcurrentRun>
 #include <QDebug>
 #include <QGuiApplication>
 
 #include <algorithm>
 #include <memory>
 
+struct LoadedBalooTrack
+{
+    MusicAudioTrack mTrack;
+
+    QUrl mFile;
+
+    QUrl mDirectory;
+};
+
+static LoadedBalooTrack loadBalooTrack(const QString &fileName)
+{
+    auto loadedTrack = LoadedBalooTrack();
+    auto &newTrack = loadedTrack.mTrack;
+
+    auto scanFile = QUrl::fromLocalFile(fileName);
+    loadedTrack.mFile = scanFile;
+
+    auto scanFileInfo = QFileInfo(fileName);
+
+    loadedTrack.mDirectory = QUrl::fromLocalFile(scanFileInfo.absolutePath());
+
+    Baloo::File match(fileName);
+    match.load();
+
+    const auto &allProperties = match.properties();
+
+    auto titleProperty = allProperties.find(KFileMetaData::Property::Title);
+    auto durationProperty = allProperties.find(KFileMetaData::Property::Duration);
+    auto artistProperty = allProperties.find(KFileMetaData::Property::Artist);
+    auto albumProperty = allProperties.find(KFileMetaData::Property::Album);
+    auto albumArtistProperty = allProperties.find(KFileMetaData::Property::AlbumArtist);
+    auto trackNumberProperty = allProperties.find(KFileMetaData::Property::TrackNumber);
+    auto discNumberProperty = allProperties.find(KFileMetaData::Property::DiscNumber);
+    auto genreProperty = allProperties.find(KFileMetaData::Property::Genre);
+    auto yearProperty = allProperties.find(KFileMetaData::Property::ReleaseYear);
+    auto composerProperty = allProperties.find(KFileMetaData::Property::Composer);
+    auto lyricistProperty = allProperties.find(KFileMetaData::Property::Lyricist);
+    auto channelsProperty = allProperties.find(KFileMetaData::Property::Channels);
+    auto bitRateProperty = allProperties.find(KFileMetaData::Property::BitRate);
+    auto sampleRateProperty = allProperties.find(KFileMetaData::Property::SampleRate);
+    auto commentProperty = allProperties.find(KFileMetaData::Property::Comment);
+    auto fileData = KFileMetaData::UserMetaData(fileName);
+
+    if (albumProperty != allProperties.end()) {
+        auto albumValue = albumProperty->toString();
+
+        newTrack.setAlbumName(albumValue);
+
+        if (artistProperty != allProperties.end()) {
+            newTrack.setArtist(artistProperty->toString());
+        }
+
+        if (durationProperty != allProperties.end()) {
+            newTrack.setDuration(QTime::fromMSecsSinceStartOfDay(1000 * durationProperty->toDouble()));
+        }
+
+        if (titleProperty != allProperties.end()) {
+            newTrack.setTitle(titleProperty->toString());
+        }
+
+        if (trackNumberProperty != allProperties.end()) {
+            newTrack.setTrackNumber(trackNumberProperty->toInt());
+        }
+
+        if (discNumberProperty != allProperties.end()) {
+            newTrack.setDiscNumber(discNumberProperty->toInt());
+        } else {
+            newTrack.setDiscNumber(1);
+        }
+
+        if (albumArtistProperty != allProperties.end()) {
+            if (albumArtistProperty->canConvert<QString>()) {
+                newTrack.setAlbumArtist(albumArtistProperty->toString());
+            } else if (albumArtistProperty->canConvert<QStringList>()) {
+                newTrack.setAlbumArtist(albumArtistProperty->toStringList().join(QStringLiteral(", ")));
+            }
+        }
+
+        if (newTrack.artist().isEmpty()) {
+            newTrack.setArtist(newTrack.albumArtist());
+        }
+
+        if (yearProperty != allProperties.end()) {
+            newTrack.setYear(yearProperty->toInt());
+        }
+
+        if (channelsProperty != allProperties.end()) {
+            newTrack.setChannels(channelsProperty->toInt());
+        }
+
+        if (bitRateProperty != allProperties.end()) {
+            newTrack.setBitRate(bitRateProperty->toInt());
+        }
+
+        if (sampleRateProperty != allProperties.end()) {
+            newTrack.setSampleRate(sampleRateProperty->toInt());
+        }
+
+        if (genreProperty != allProperties.end()) {
+            newTrack.setGenre(genreProperty->toString());
+        }
+
+        if (composerProperty != allProperties.end()) {
+            newTrack.setComposer(composerProperty->toString());
+        }
+
+        if (lyricistProperty != allProperties.end()) {
+            newTrack.setLyricist(lyricistProperty->toString());
+        }
+
+        if (commentProperty != allProperties.end()) {
+            newTrack.setComment(commentProperty->toString());
+        }
+
+        newTrack.setRating(fileData.rating());
+
+        newTrack.setResourceURI(scanFile);
+
+        if (newTrack.title().isEmpty()) {
+            return loadedTrack;
+        }
+
+        if (newTrack.artist().isEmpty()) {
+            return loadedTrack;
+        }
+
+        if (newTrack.albumName().isEmpty()) {
+            return loadedTrack;
+        }
+
+        if (!newTrack.duration().isValid()) {
+            return loadedTrack;
+        }
+
+        newTrack.setValid(true);
+    }
+
+    return loadedTrack;
+}
+
+struct LoadedBalooTracks
+{
+    QVector<LoadedBalooTrack> mTracks;
+
+    qint64 mLoadTime = 0;
+};
+
+static LoadedBalooTracks loadBalooTracks(const QStringList &fileNames, IndexerThrottle *throttle)
+{
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+
+    auto loadedTracks = LoadedBalooTracks();
+    loadedTracks.mTracks.reserve(fileNames.size());
+
+    if (throttle) {
+        IndexerThrottle::lowerCurrentThreadPriority();
+    }
+
+    for (const auto &oneFileName : fileNames) {
+        if (throttle) {
+            throttle->pace();
+        }
+
+        loadedTracks.mTracks.push_back(loadBalooTrack(oneFileName));
+    }
+
+    loadedTracks.mLoadTime = loadTimer.nsecsElapsed();
+
+    return loadedTracks;
+}
+
 class LocalBalooFileListingPrivate
 {
 public:
@@ -64,8 +242,6 @@ public:
 
     QList<MusicAudioTrack> mNewTracks;
 
-    QHash<QString, QUrl> mAllAlbumCover;
-
     QAtomicInt mStopRequest = 0;
 
     QDBusServiceWatcher mServiceWatcher;
@@ -78,6 +254,26 @@ public:
 
     QScopedPointer<org::kde::baloo::scheduler> mBalooScheduler;
 
+    QList<MusicAudioTrack> mPendingBalooTracks;
+
+    QTimer *mPendingBalooTracksTimer = nullptr;
+
+    static const int mPendingBalooTracksMaximumCount = 500;
+
+    QThreadPool mLoadingThreadPool;
+
+    QList<QFuture<LoadedBalooTracks>> mPendingLoads;
+
+    QElapsedTimer mLastEmitTimer;
+
+    qint64 mScanTime = 0;
+
+    qint64 mLoadWaitTime = 0;
+
+    static const int mLoadBatchSize = 64;
+
+    static const int mEmitInterval = 1000;
+
 };
 
 LocalBalooFileListing::LocalBalooFileListing(QObject *parent)
@@ -86,6 +282,18 @@ LocalBalooFileListing::LocalBalooFileListing(QObject *parent)
     d->mQuery.addType(QStringLiteral("Audio"));
     setHandleNewFiles(false);
 
+    // Baloo::File::load shares one database instance per process and is not
+    // safe to call from several threads at once: a single loading thread
+    // still overlaps the loading with the query and the database inserts
+    d->mLoadingThreadPool.setMaxThreadCount(1);
+    setWatchTrackFiles(false);
+
+    d->mPendingBalooTracksTimer = new QTimer(this);
+    d->mPendingBalooTracksTimer->setSingleShot(true);
+    d->mPendingBalooTracksTimer->setInterval(1000);
+    connect(d->mPendingBalooTracksTimer, &QTimer::timeout,
+            this, &LocalBalooFileListing::emitPendingBalooTracks);
+
     auto sessionBus = QDBusConnection::sessionBus();
 
     connect(&d->mServiceWatcher, &QDBusServiceWatcher::serviceRegistered,
@@ -114,8 +322,22 @@ void LocalBalooFileListing::applicationAboutToQuit()
     d->mStopRequest = 1;
 }
 
+qint64 LocalBalooFileListing::scanTime() const
+{
+    return d->mScanTime;
+}
+
+qint64 LocalBalooFileListing::loadWaitTime() const
+{
+    return d->mLoadWaitTime;
+}
+
 void LocalBalooFileListing::newBalooFile(const QString &fileName)
 {
+    if (isExcludedFile(fileName)) {
+        return;
+    }
+
     auto newFile = QUrl::fromLocalFile(fileName);
 
     auto newTrack = scanOneFile(newFile);
@@ -123,12 +345,30 @@ void LocalBalooFileListing::newBalooFile(const QString &fileName)
     if (newTrack.isValid()) {
         QFileInfo newFileInfo(fileName);
 
-        addFileInDirectory(newFile, QUrl::fromLocalFile(newFileInfo.absoluteDir().absolutePath()));
+        addFileInDirectory(newFile, QUrl::fromLocalFile(newFileInfo.absoluteDir().absolutePath()), true);
 
-        emitNewFiles({newTrack});
+        d->mPendingBalooTracks.push_back(newTrack);
+
+        if (d->mPendingBalooTracks.size() >= d->mPendingBalooTracksMaximumCount) {
+            emitPendingBalooTracks();
+        } else if (!d->mPendingBalooTracksTimer->isActive()) {
+            d->mPendingBalooTracksTimer->start();
+        }
     }
 }
 
+void LocalBalooFileListing::emitPendingBalooTracks()
+{
+    d->mPendingBalooTracksTimer->stop();
+
+    if (d->mPendingBalooTracks.isEmpty() || d->mStopRequest == 1) {
+        return;
+    }
+
+    emitNewFiles(d->mPendingBalooTracks);
+    d->mPendingBalooTracks.clear();
+}
+
 void LocalBalooFileListing::registeredToBaloo(QDBusPendingCallWatcher *watcher)
 {
     qDebug() << "LocalBalooFileListing::registeredToBaloo";
@@ -200,6 +440,33 @@ void LocalBalooFileListing::registerToBaloo()
 void LocalBalooFileListing::renamedFiles(const QString &from, const QString &to, const QStringList &listFiles)
 {
     qDebug() << "LocalBalooFileListing::renamedFiles" << from << to << listFiles;
+
+    if (listFiles.isEmpty()) {
+        renameFile(QUrl::fromLocalFile(from), QUrl::fromLocalFile(to));
+    }
+
+    auto allRemovedFiles = QList<QUrl>();
+
+    for (const auto &oneRenamedFile : listFiles) {
+        if (!oneRenamedFile.startsWith(to)) {
+            continue;
+        }
+
+        const auto previousFileName = QUrl::fromLocalFile(from + oneRenamedFile.mid(to.size()));
+
+        if (isExcludedFile(oneRenamedFile)) {
+            allRemovedFiles.push_back(previousFileName);
+            continue;
+        }
+
+        renameFile(previousFileName, QUrl::fromLocalFile(oneRenamedFile));
+    }
+
+    emitRenamedFiles();
+
+    if (!allRemovedFiles.isEmpty()) {
+        Q_EMIT removedTracksList(allRemovedFiles);
+    }
 }
 
 void LocalBalooFileListing::serviceOwnerChanged(const QString &serviceName, const QString &oldOwner, const QString &newOwner)
@@ -247,30 +514,47 @@ void LocalBalooFileListing::triggerRefreshOfContent()
 
     AbstractFileListing::triggerRefreshOfContent();
 
+    setRootPaths(Baloo::IndexerConfig().includeFolders());
+
     auto resultIterator = d->mQuery.exec();
     auto newFiles = QList<MusicAudioTrack>();
+    auto pendingFileNames = QStringList();
+    const auto maximumPendingLoads = 2 * d->mLoadingThreadPool.maxThreadCount();
+
+    QElapsedTimer scanTimer;
+    scanTimer.start();
+    d->mLoadWaitTime = 0;
+
+    d->mLastEmitTimer.start();
 
     while(resultIterator.next() && d->mStopRequest == 0) {
-        const auto &newFileUrl = QUrl::fromLocalFile(resultIterator.filePath());
-        auto scanFileInfo = QFileInfo(resultIterator.filePath());
-        const auto currentDirectory = QUrl::fromLocalFile(scanFileInfo.absoluteDir().absolutePath());
+        const auto fileName = resultIterator.filePath();
 
-        addFileInDirectory(newFileUrl, currentDirectory);
+        if (isExcludedFile(fileName)) {
+            continue;
+        }
 
-        const auto &newTrack = scanOneFile(newFileUrl);
+        pendingFileNames.push_back(fileName);
 
-        if (newTrack.isValid()) {
-            newFiles.push_back(newTrack);
-            increaseImportedTracksCount();
-            if (newFiles.size() % 50 == 0) {
-                Q_EMIT importedTracksCountChanged();
-            }
-            if (newFiles.size() > 500 && d->mStopRequest == 0) {
-                Q_EMIT importedTracksCountChanged();
-                emitNewFiles(newFiles);
-                newFiles.clear();
-            }
+        if (pendingFileNames.size() < d->mLoadBatchSize) {
+            continue;
         }
+
+        d->mPendingLoads.push_back(QtConcurrent::run(&d->mLoadingThreadPool, loadBalooTracks, pendingFileNames, indexerThrottle()));
+        pendingFileNames.clear();
+
+        while (d->mPendingLoads.size() >= maximumPendingLoads ||
+               (!d->mPendingLoads.isEmpty() && d->mPendingLoads.first().isFinished())) {
+            ingestLoadedBalooTracks(newFiles);
+        }
+    }
+
+    if (!pendingFileNames.isEmpty() && d->mStopRequest == 0) {
+        d->mPendingLoads.push_back(QtConcurrent::run(&d->mLoadingThreadPool, loadBalooTracks, pendingFileNames, indexerThrottle()));
+    }
+
+    while (!d->mPendingLoads.isEmpty()) {
+        ingestLoadedBalooTracks(newFiles);
     }
 
     if (!newFiles.isEmpty() && d->mStopRequest == 0) {
@@ -278,127 +562,59 @@ void LocalBalooFileListing::triggerRefreshOfContent()
         emitNewFiles(newFiles);
     }
 
+    d->mScanTime = scanTimer.nsecsElapsed();
+
     Q_EMIT indexingFinished(importedTracksCount());
 }
 
-MusicAudioTrack LocalBalooFileListing::scanOneFile(const QUrl &scanFile)
+void LocalBalooFileListing::ingestLoadedBalooTracks(QList<MusicAudioTrack> &newFiles)
 {
-    auto newTrack = MusicAudioTrack();
+    QElapsedTimer waitTimer;
+    waitTimer.start();
 
-    auto fileName = scanFile.toLocalFile();
-    auto scanFileInfo = QFileInfo(fileName);
-
-    if (scanFileInfo.exists()) {
-        watchPath(fileName);
-    }
+    const auto loadedTracks = d->mPendingLoads.takeFirst().result();
 
-    Baloo::File match(fileName);
-    match.load();
+    d->mLoadWaitTime += waitTimer.nsecsElapsed();
+    addExtractionTime(loadedTracks.mLoadTime);
 
-    const auto &allProperties = match.properties();
-
-    auto titleProperty = allProperties.find(KFileMetaData::Property::Title);
-    auto durationProperty = allProperties.find(KFileMetaData::Property::Duration);
-    auto artistProperty = allProperties.find(KFileMetaData::Property::Artist);
-    auto albumProperty = allProperties.find(KFileMetaData::Property::Album);
-    auto albumArtistProperty = allProperties.find(KFileMetaData::Property::AlbumArtist);
-    auto trackNumberProperty = allProperties.find(KFileMetaData::Property::TrackNumber);
-    auto discNumberProperty = allProperties.find(KFileMetaData::Property::DiscNumber);
-    auto genreProperty = allProperties.find(KFileMetaData::Property::Genre);
-    auto yearProperty = allProperties.find(KFileMetaData::Property::ReleaseYear);
-    auto composerProperty = allProperties.find(KFileMetaData::Property::Composer);
-    auto lyricistProperty = allProperties.find(KFileMetaData::Property::Lyricist);
-    auto channelsProperty = allProperties.find(KFileMetaData::Property::Channels);
-    auto bitRateProperty = allProperties.find(KFileMetaData::Property::BitRate);
-    auto sampleRateProperty = allProperties.find(KFileMetaData::Property::SampleRate);
-    auto commentProperty = allProperties.find(KFileMetaData::Property::Comment);
-    auto fileData = KFileMetaData::UserMetaData(fileName);
-
-    if (albumProperty != allProperties.end()) {
-        auto albumValue = albumProperty->toString();
-        auto &allTracks = d->mAllAlbums[albumValue];
-
-        newTrack.setAlbumName(albumValue);
-
-        if (artistProperty != allProperties.end()) {
-            newTrack.setArtist(artistProperty->toString());
-        }
-
-        if (durationProperty != allProperties.end()) {
-            newTrack.setDuration(QTime::fromMSecsSinceStartOfDay(1000 * durationProperty->toDouble()));
-        }
-
-        if (titleProperty != allProperties.end()) {
-            newTrack.setTitle(titleProperty->toString());
-        }
+    if (d->mStopRequest == 1) {
+        return;
+    }
 
-        if (trackNumberProperty != allProperties.end()) {
-            newTrack.setTrackNumber(trackNumberProperty->toInt());
-        }
+    for (const auto &oneLoadedTrack : loadedTracks.mTracks) {
+        addFileInDirectory(oneLoadedTrack.mFile, oneLoadedTrack.mDirectory, true);
 
-        if (discNumberProperty != allProperties.end()) {
-            newTrack.setDiscNumber(discNumberProperty->toInt());
-        } else {
-            newTrack.setDiscNumber(1);
-        }
+        const auto &newTrack = registerBalooTrack(oneLoadedTrack);
 
-        if (albumArtistProperty != allProperties.end()) {
-            if (albumArtistProperty->canConvert<QString>()) {
-                newTrack.setAlbumArtist(albumArtistProperty->toString());
-            } else if (albumArtistProperty->canConvert<QStringList>()) {
-                newTrack.setAlbumArtist(albumArtistProperty->toStringList().join(QStringLiteral(", ")));
+        if (newTrack.isValid()) {
+            newFiles.push_back(newTrack);
+            increaseImportedTracksCount();
+            if (newFiles.size() % 50 == 0) {
+                Q_EMIT importedTracksCountChanged();
             }
         }
+    }
 
-        if (newTrack.artist().isEmpty()) {
-            newTrack.setArtist(newTrack.albumArtist());
-        }
-
-        if (yearProperty != allProperties.end()) {
-            newTrack.setYear(yearProperty->toInt());
-        }
-
-        if (channelsProperty != allProperties.end()) {
-            newTrack.setChannels(channelsProperty->toInt());
-        }
-
-        if (bitRateProperty != allProperties.end()) {
-            newTrack.setBitRate(bitRateProperty->toInt());
-        }
-
-        if (sampleRateProperty != allProperties.end()) {
-            newTrack.setSampleRate(sampleRateProperty->toInt());
-        }
-
-        if (genreProperty != allProperties.end()) {
-            newTrack.setGenre(genreProperty->toString());
-        }
-
-        if (composerProperty != allProperties.end()) {
-            newTrack.setComposer(composerProperty->toString());
-        }
-
-        if (lyricistProperty != allProperties.end()) {
-            newTrack.setLyricist(lyricistProperty->toString());
-        }
-
-        if (commentProperty != allProperties.end()) {
-            newTrack.setComment(commentProperty->toString());
-        }
+    if (newFiles.size() > d->mPendingBalooTracksMaximumCount ||
+            (!newFiles.isEmpty() && d->mLastEmitTimer.elapsed() > d->mEmitInterval)) {
+        Q_EMIT importedTracksCountChanged();
+        emitNewFiles(newFiles);
+        newFiles.clear();
+        d->mLastEmitTimer.restart();
+    }
+}
 
-        newTrack.setRating(fileData.rating());
+MusicAudioTrack LocalBalooFileListing::scanOneFile(const QUrl &scanFile)
+{
+    return registerBalooTrack(loadBalooTrack(scanFile.toLocalFile()));
+}
 
-        newTrack.setResourceURI(scanFile);
+MusicAudioTrack LocalBalooFileListing::registerBalooTrack(const LoadedBalooTrack &loadedTrack)
+{
+    auto newTrack = loadedTrack.mTrack;
 
-        QFileInfo coverFilePath(scanFileInfo.dir().filePath(QStringLiteral("cover.jpg")));
-        if (coverFilePath.exists()) {
-            d->mAllAlbumCover[albumValue] = QUrl::fromLocalFile(coverFilePath.absoluteFilePath());
-        } else {
-            coverFilePath.setFile(scanFileInfo.dir().filePath(QStringLiteral("cover.png")));
-            if (coverFilePath.exists()) {
-                d->mAllAlbumCover[albumValue] = QUrl::fromLocalFile(coverFilePath.absoluteFilePath());
-            }
-        }
+    if (!newTrack.albumName().isEmpty()) {
+        auto &allTracks = d->mAllAlbums[newTrack.albumName()];
 
         auto itTrack = std::find(allTracks.begin(), allTracks.end(), newTrack);
         if (itTrack == allTracks.end()) {
@@ -411,28 +627,10 @@ MusicAudioTrack LocalBalooFileListing::scanOneFile(const QUrl &scanFile)
             std::sort(allTracks.begin(), allTracks.end());
             std::sort(newTracks.begin(), newTracks.end());
         }
-
-        if (newTrack.title().isEmpty()) {
-            return newTrack;
-        }
-
-        if (newTrack.artist().isEmpty()) {
-            return newTrack;
-        }
-
-        if (newTrack.albumName().isEmpty()) {
-            return newTrack;
-        }
-
-        if (!newTrack.duration().isValid()) {
-            return newTrack;
-        }
-
-        newTrack.setValid(true);
     }
 
     if (!newTrack.isValid()) {
-        newTrack = AbstractFileListing::scanOneFile(scanFile);
+        newTrack = AbstractFileListing::scanOneFile(loadedTrack.mFile);
     }
 
     if (newTrack.isValid()) {
@@ -33,6 +33,7 @@
 class LocalBalooFileListingPrivate;
 class MusicAudioTrack;
 class QDBusPendingCallWatcher;
+struct LoadedBalooTrack;
 
 class LocalBalooFileListing : public AbstractFileListing
 {
@@ -47,6 +48,20 @@ public:
 
     void applicationAboutToQuit() override;
 
+    /**
+     * Wall clock time of the last full scan, in nanoseconds. Compared with
+     * extractionTime(), the time the loading thread spent in Baloo, it gives
+     * the share of the property loading hidden behind the query and the
+     * database inserts.
+     */
+    qint64 scanTime() const;
+
+    /**
+     * Time the listing thread spent waiting for loaded properties during the
+     * last full scan, in nanoseconds.
+     */
+    qint64 loadWaitTime() const;
+
 Q_SIGNALS:
 
 public Q_SLOTS:
@@ -67,6 +82,8 @@ private Q_SLOTS:
 
     void newBalooFile(const QString &fileName);
 
+    void emitPendingBalooTracks();
+
     void registeredToBaloo(QDBusPendingCallWatcher *watcher);
 
 private:
@@ -79,6 +96,10 @@ private:
 
     MusicAudioTrack scanOneFile(const QUrl &scanFile) override;
 
+    MusicAudioTrack registerBalooTrack(const LoadedBalooTrack &loadedTrack);
+
+    void ingestLoadedBalooTracks(QList<MusicAudioTrack> &newFiles);
+
     bool checkBalooConfiguration();
 
     std::unique_ptr<LocalBalooFileListingPrivate> d;
@@ -0,0 +1,353 @@
+/*
+ * Copyright 2017 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "coverthumbnailprovider.h"
+
+#include <QQuickImageResponse>
+#include <QQuickTextureFactory>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QCache>
+#include <QImageReader>
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QFile>
+#include <QDir>
+#include <QDirIterator>
+#include <QVector>
+#include <QtGlobal>
+
+#include <QDebug>
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+/* the smallest bucket is used for the small covers of the lists, the others for the album grid and the header bar */
+const int thumbnailBuckets[] = {32, 64, 128, 256, 512};
+
+/* cost of the in-memory cache is counted in KiB */
+const int memoryCacheMaximumCost = 64 * 1024;
+
+QImage readScaledImage(const QString &fileName, const QSize &boundingSize)
+{
+    QImageReader reader(fileName);
+    reader.setAutoTransform(true);
+
+    const auto originalSize = reader.size();
+    if (originalSize.isValid() && boundingSize.isValid() &&
+            (originalSize.width() > boundingSize.width() || originalSize.height() > boundingSize.height())) {
+        reader.setScaledSize(originalSize.scaled(boundingSize, Qt::KeepAspectRatio));
+    }
+
+    auto result = reader.read();
+    if (result.isNull()) {
+        qDebug() << "CoverThumbnailProvider" << "cannot read" << fileName << reader.errorString();
+    }
+
+    return result;
+}
+
+/* the disk cache is pruned down to this fraction of its maximum size, so that it is not pruned on every new thumbnail */
+const int diskCachePrunedPercent = 75;
+
+int imageCost(const QImage &image)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    return static_cast<int>(std::max<qsizetype>(1, image.sizeInBytes() / 1024));
+#else
+    return std::max(1, image.byteCount() / 1024);
+#endif
+}
+
+qint64 storeThumbnail(const QString &thumbnailFileName, const QImage &thumbnail)
+{
+    if (!QDir().mkpath(QFileInfo(thumbnailFileName).absolutePath())) {
+        qDebug() << "CoverThumbnailProvider" << "cannot create directory for" << thumbnailFileName;
+        return 0;
+    }
+
+    QSaveFile thumbnailFile(thumbnailFileName);
+    if (!thumbnailFile.open(QIODevice::WriteOnly)) {
+        qDebug() << "CoverThumbnailProvider" << "cannot write" << thumbnailFileName << thumbnailFile.errorString();
+        return 0;
+    }
+
+    /* opaque covers are photos, keep them small on disk */
+    const auto saveResult = thumbnail.hasAlphaChannel() ?
+                thumbnail.save(&thumbnailFile, "PNG") :
+                thumbnail.save(&thumbnailFile, "JPG", 90);
+
+    if (!saveResult || !thumbnailFile.commit()) {
+        qDebug() << "CoverThumbnailProvider" << "cannot write" << thumbnailFileName << thumbnailFile.errorString();
+        return 0;
+    }
+
+    return QFileInfo(thumbnailFileName).size();
+}
+
+}
+
+class CoverThumbnailResponse : public QQuickImageResponse, public QRunnable
+{
+public:
+
+    CoverThumbnailResponse(CoverThumbnailProvider *provider, QUrl coverUrl, QSize requestedSize)
+        : mProvider(provider), mCoverUrl(std::move(coverUrl)), mRequestedSize(requestedSize)
+    {
+        setAutoDelete(false);
+    }
+
+    QQuickTextureFactory *textureFactory() const override
+    {
+        return QQuickTextureFactory::textureFactoryForImage(mThumbnail);
+    }
+
+    QString errorString() const override
+    {
+        return mErrorString;
+    }
+
+    void cancel() override
+    {
+        mCancelled.storeRelease(1);
+    }
+
+    void run() override
+    {
+        if (!mCancelled.loadAcquire()) {
+            mThumbnail = mProvider->thumbnail(mCoverUrl, mRequestedSize);
+
+            if (mThumbnail.isNull()) {
+                mErrorString = QStringLiteral("cannot load cover ") + mCoverUrl.toString();
+            }
+        }
+
+        Q_EMIT finished();
+    }
+
+private:
+
+    CoverThumbnailProvider *mProvider;
+
+    QUrl mCoverUrl;
+
+    QSize mRequestedSize;
+
+    QImage mThumbnail;
+
+    QString mErrorString;
+
+    QAtomicInt mCancelled;
+
+};
+
+class CoverThumbnailProviderPrivate
+{
+public:
+
+    CoverThumbnailProviderPrivate(QString cacheDirectory, qint64 diskCacheMaximumSize)
+        : mCacheDirectory(std::move(cacheDirectory)), mDiskCacheMaximumSize(diskCacheMaximumSize)
+    {
+    }
+
+    void addToDiskCache(qint64 thumbnailSize);
+
+    QString mCacheDirectory;
+
+    QMutex mDiskCacheMutex;
+
+    qint64 mDiskCacheMaximumSize = 0;
+
+    /* computed from the content of the cache directory when the first thumbnail is stored */
+    qint64 mDiskCacheSize = -1;
+
+    QThreadPool mThreadPool;
+
+    QMutex mMemoryCacheMutex;
+
+    QCache<QString, QImage> mMemoryCache{memoryCacheMaximumCost};
+
+};
+
+void CoverThumbnailProviderPrivate::addToDiskCache(qint64 thumbnailSize)
+{
+    QMutexLocker lock(&mDiskCacheMutex);
+
+    if (mDiskCacheSize < 0) {
+        mDiskCacheSize = 0;
+
+        QDirIterator cacheIterator(mCacheDirectory, QDir::Files, QDirIterator::Subdirectories);
+        while (cacheIterator.hasNext()) {
+            cacheIterator.next();
+            mDiskCacheSize += cacheIterator.fileInfo().size();
+        }
+    } else {
+        mDiskCacheSize += thumbnailSize;
+    }
+
+    if (mDiskCacheSize <= mDiskCacheMaximumSize) {
+        return;
+    }
+
+    auto cachedThumbnails = QVector<QFileInfo>();
+
+    QDirIterator cacheIterator(mCacheDirectory, QDir::Files, QDirIterator::Subdirectories);
+    while (cacheIterator.hasNext()) {
+        cacheIterator.next();
+        cachedThumbnails.push_back(cacheIterator.fileInfo());
+    }
+
+    std::sort(cachedThumbnails.begin(), cachedThumbnails.end(), [](const QFileInfo &first, const QFileInfo &second) {
+        return first.lastModified() < second.lastModified();
+    });
+
+    const auto prunedSize = mDiskCacheMaximumSize / 100 * diskCachePrunedPercent;
+
+    mDiskCacheSize = 0;
+    for (const auto &oneThumbnail : qAsConst(cachedThumbnails)) {
+        mDiskCacheSize += oneThumbnail.size();
+    }
+
+    for (const auto &oneThumbnail : qAsConst(cachedThumbnails)) {
+        if (mDiskCacheSize <= prunedSize) {
+            break;
+        }
+
+        if (QFile::remove(oneThumbnail.absoluteFilePath())) {
+            mDiskCacheSize -= oneThumbnail.size();
+        }
+    }
+}
+
+CoverThumbnailProvider::CoverThumbnailProvider(QString cacheDirectory, qint64 diskCacheMaximumSize)
+    : QQuickAsyncImageProvider(),
+      d(std::make_unique<CoverThumbnailProviderPrivate>(cacheDirectory.isEmpty() ?
+                                                        QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/coverThumbnails") :
+                                                        std::move(cacheDirectory),
+                                                        diskCacheMaximumSize))
+{
+}
+
+CoverThumbnailProvider::~CoverThumbnailProvider()
+{
+    d->mThreadPool.clear();
+    d->mThreadPool.waitForDone();
+}
+
+QQuickImageResponse *CoverThumbnailProvider::requestImageResponse(const QString &id, const QSize &requestedSize)
+{
+    auto response = new CoverThumbnailResponse(this, QUrl(QUrl::fromPercentEncoding(id.toUtf8())), requestedSize);
+
+    d->mThreadPool.start(response);
+
+    return response;
+}
+
+QImage CoverThumbnailProvider::thumbnail(const QUrl &coverUrl, const QSize &requestedSize)
+{
+    if (!coverUrl.isLocalFile()) {
+        return {};
+    }
+
+    const auto coverFileName = coverUrl.toLocalFile();
+    const auto bucket = bucketSize(requestedSize);
+
+    if (bucket == 0) {
+        return readScaledImage(coverFileName, requestedSize);
+    }
+
+    const auto cachedFileName = thumbnailFileName(coverFileName, bucket);
+    if (cachedFileName.isEmpty()) {
+        return {};
+    }
+
+    {
+        QMutexLocker lock(&d->mMemoryCacheMutex);
+        const auto cachedThumbnail = d->mMemoryCache.object(cachedFileName);
+        if (cachedThumbnail) {
+            return *cachedThumbnail;
+        }
+    }
+
+    auto result = QImage{};
+
+    if (QFile::exists(cachedFileName)) {
+        result.load(cachedFileName);
+    }
+
+    if (result.isNull()) {
+        result = readScaledImage(coverFileName, {bucket, bucket});
+
+        if (!result.isNull()) {
+            const auto thumbnailSize = storeThumbnail(cachedFileName, result);
+
+            if (thumbnailSize > 0) {
+                d->addToDiskCache(thumbnailSize);
+            }
+        }
+    }
+
+    if (!result.isNull()) {
+        QMutexLocker lock(&d->mMemoryCacheMutex);
+        d->mMemoryCache.insert(cachedFileName, new QImage(result), imageCost(result));
+    }
+
+    return result;
+}
+
+QString CoverThumbnailProvider::thumbnailFileName(const QString &coverFileName, int bucketSize) const
+{
+    const auto coverInformation = QFileInfo(coverFileName);
+    if (!coverInformation.exists()) {
+        return {};
+    }
+
+    QCryptographicHash coverKey(QCryptographicHash::Sha1);
+    coverKey.addData(coverInformation.absoluteFilePath().toUtf8());
+    coverKey.addData(QByteArray::number(coverInformation.lastModified().toMSecsSinceEpoch()));
+
+    return d->mCacheDirectory + QLatin1Char('/') + QString::number(bucketSize) + QLatin1Char('/') +
+            QString::fromLatin1(coverKey.result().toHex());
+}
+
+int CoverThumbnailProvider::bucketSize(const QSize &requestedSize)
+{
+    const auto largestBucket = *std::prev(std::end(thumbnailBuckets));
+
+    if (requestedSize.width() <= 0 && requestedSize.height() <= 0) {
+        return largestBucket;
+    }
+
+    const auto requestedDimension = std::max(requestedSize.width(), requestedSize.height());
+
+    auto bucket = std::lower_bound(std::begin(thumbnailBuckets), std::end(thumbnailBuckets), requestedDimension);
+    if (bucket == std::end(thumbnailBuckets)) {
+        return 0;
+    }
+
+    return *bucket;
+}
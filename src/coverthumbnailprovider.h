@@ -0,0 +1,67 @@
+/*
+ * Copyright 2017 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef COVERTHUMBNAILPROVIDER_H
+#define COVERTHUMBNAILPROVIDER_H
+
+#include <QQuickAsyncImageProvider>
+
+#include <QString>
+#include <QUrl>
+#include <QSize>
+#include <QImage>
+
+#include <memory>
+
+class CoverThumbnailProviderPrivate;
+
+/**
+ * Serve album covers scaled down to the size they are displayed at.
+ *
+ * Covers are requested as image://cover/<percent encoded url>. Local
+ * covers are decoded and scaled on a pool of worker threads, to the
+ * smallest size bucket holding the requested size. The result is kept
+ * in a bounded in-memory cache and stored in the cache directory, keyed
+ * by the path and modification time of the original file, so that the
+ * full size image is only decoded once. When the thumbnails stored on disk
+ * grow above diskCacheMaximumSize bytes, the oldest ones are removed.
+ */
+class CoverThumbnailProvider : public QQuickAsyncImageProvider
+{
+public:
+
+    explicit CoverThumbnailProvider(QString cacheDirectory = {}, qint64 diskCacheMaximumSize = 100 * 1024 * 1024);
+
+    ~CoverThumbnailProvider() override;
+
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override;
+
+    QImage thumbnail(const QUrl &coverUrl, const QSize &requestedSize);
+
+    QString thumbnailFileName(const QString &coverFileName, int bucketSize) const;
+
+    static int bucketSize(const QSize &requestedSize);
+
+private:
+
+    std::unique_ptr<CoverThumbnailProviderPrivate> d;
+
+};
+
+#endif // COVERTHUMBNAILPROVIDER_H
@@ -34,6 +34,9 @@
 
 #include <algorithm>
 
+/* distance between the positions of two playlist entries written apart, about twenty insertions fit between them */
+static const qlonglong playListEntryPositionGap = 1 << 20;
+
 class DatabaseInterfacePrivate
 {
 public:
@@ -63,7 +66,24 @@ public:
           mSelectAlbumIdFromTitleAndArtistQuery(mTracksDatabase), mSelectAlbumIdFromTitleWithoutArtistQuery(mTracksDatabase),
           mInsertAlbumArtistQuery(mTracksDatabase), mInsertTrackArtistQuery(mTracksDatabase),
           mRemoveTrackArtistQuery(mTracksDatabase), mRemoveAlbumArtistQuery(mTracksDatabase),
-          mSelectTrackIdFromTitleAlbumTrackDiscNumberQuery(mTracksDatabase), mSelectAlbumArtUriFromAlbumIdQuery(mTracksDatabase)
+          mSelectTrackIdFromTitleAlbumTrackDiscNumberQuery(mTracksDatabase), mSelectAlbumArtUriFromAlbumIdQuery(mTracksDatabase),
+          mInsertScanProgressQuery(mTracksDatabase), mRemoveScanProgressQuery(mTracksDatabase),
+          mSelectCompletedScanDirectoriesQuery(mTracksDatabase),
+          mUpdateTracksValidityInDirectoryQuery(mTracksDatabase), mRenameTrackMappingQuery(mTracksDatabase),
+          mUpdateTracksValidityFromSourceQuery(mTracksDatabase), mSelectTracksPageQuery(mTracksDatabase),
+          mSelectAlbumsPageQuery(mTracksDatabase), mSelectArtistsPageQuery(mTracksDatabase),
+          mSelectTracksPageStartQuery(mTracksDatabase), mSelectAlbumsPageStartQuery(mTracksDatabase),
+          mSelectArtistsPageStartQuery(mTracksDatabase), mSelectTracksFromAlbumsRangeQuery(mTracksDatabase),
+          mSelectTracksCountQuery(mTracksDatabase), mSelectAlbumsCountQuery(mTracksDatabase),
+          mSelectArtistsCountQuery(mTracksDatabase), mSelectPlayListIdQuery(mTracksDatabase),
+          mInsertPlayListQuery(mTracksDatabase), mInsertPlayListEntryQuery(mTracksDatabase),
+          mSelectPlayListEntryPositionsQuery(mTracksDatabase), mUpdatePlayListEntryPositionQuery(mTracksDatabase),
+          mRemovePlayListEntriesQuery(mTracksDatabase),
+          mUpdatePlayListEntryQuery(mTracksDatabase), mSelectPlayListEntriesQuery(mTracksDatabase),
+          mSelectKnownTrackFilesFromSourceQuery(mTracksDatabase), mUpdateTrackFileStateQuery(mTracksDatabase),
+          mRemoveTrackFileStateQuery(mTracksDatabase), mRenameTrackFileStateQuery(mTracksDatabase),
+          mSelectAllTracksIdsQuery(mTracksDatabase), mSelectAllAlbumsTracksIdsQuery(mTracksDatabase),
+          mSelectAllArtistsNamesQuery(mTracksDatabase), mSelectAlbumIdsFromAnyArtistQuery(mTracksDatabase)
     {
     }
 
@@ -167,6 +187,70 @@ public:
 
     QSqlQuery mSelectAlbumArtUriFromAlbumIdQuery;
 
+    QSqlQuery mInsertScanProgressQuery;
+
+    QSqlQuery mRemoveScanProgressQuery;
+
+    QSqlQuery mSelectCompletedScanDirectoriesQuery;
+
+    QSqlQuery mUpdateTracksValidityInDirectoryQuery;
+
+    QSqlQuery mRenameTrackMappingQuery;
+
+    QSqlQuery mUpdateTracksValidityFromSourceQuery;
+
+    QSqlQuery mSelectTracksPageQuery;
+
+    QSqlQuery mSelectAlbumsPageQuery;
+
+    QSqlQuery mSelectArtistsPageQuery;
+
+    QSqlQuery mSelectTracksPageStartQuery;
+
+    QSqlQuery mSelectAlbumsPageStartQuery;
+
+    QSqlQuery mSelectArtistsPageStartQuery;
+
+    QSqlQuery mSelectTracksFromAlbumsRangeQuery;
+
+    QSqlQuery mSelectTracksCountQuery;
+
+    QSqlQuery mSelectAlbumsCountQuery;
+
+    QSqlQuery mSelectArtistsCountQuery;
+
+    QSqlQuery mSelectAllTracksIdsQuery;
+
+    QSqlQuery mSelectAllAlbumsTracksIdsQuery;
+
+    QSqlQuery mSelectAllArtistsNamesQuery;
+
+    QSqlQuery mSelectAlbumIdsFromAnyArtistQuery;
+
+    QSqlQuery mSelectPlayListIdQuery;
+
+    QSqlQuery mInsertPlayListQuery;
+
+    QSqlQuery mInsertPlayListEntryQuery;
+
+    QSqlQuery mSelectPlayListEntryPositionsQuery;
+
+    QSqlQuery mUpdatePlayListEntryPositionQuery;
+
+    QSqlQuery mRemovePlayListEntriesQuery;
+
+    QSqlQuery mUpdatePlayListEntryQuery;
+
+    QSqlQuery mSelectPlayListEntriesQuery;
+
+    QSqlQuery mSelectKnownTrackFilesFromSourceQuery;
+
+    QSqlQuery mUpdateTrackFileStateQuery;
+
+    QSqlQuery mRemoveTrackFileStateQuery;
+
+    QSqlQuery mRenameTrackFileStateQuery;
+
     qulonglong mAlbumId = 1;
 
     qulonglong mArtistId = 1;
@@ -177,6 +261,9 @@ public:
 
     bool mInitFinished = false;
 
+    /* models ask for pages of rows instead of receiving the whole collection at startup */
+    bool mPagedCollection = false;
+
     QAtomicInt mStopRequest = 0;
 
 };
@@ -192,7 +279,7 @@ DatabaseInterface::~DatabaseInterface()
     }
 }
 
-void DatabaseInterface::init(const QString &dbName, const QString &databaseFileName)
+void DatabaseInterface::init(const QString &dbName, const QString &databaseFileName, bool pagedCollection)
 {
     QSqlDatabase tracksDatabase = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), dbName);
 
@@ -208,10 +295,12 @@ void DatabaseInterface::init(const QString &dbName, const QString &databaseFileN
         qDebug() << "database open";
     } else {
         qDebug() << "database not open";
+        Q_EMIT databaseError();
     }
     qDebug() << "DatabaseInterface::init" << (tracksDatabase.driver()->hasFeature(QSqlDriver::Transactions) ? "yes" : "no");
 
     d = std::make_unique<DatabaseInterfacePrivate>(tracksDatabase);
+    d->mPagedCollection = pagedCollection;
 
     initDatabase();
     initRequest();
@@ -610,6 +699,33 @@ MusicAudioTrack DatabaseInterface::trackFromDatabaseId(qulonglong id)
     return result;
 }
 
+QList<MusicAudioTrack> DatabaseInterface::tracksFromDatabaseIds(const QList<qulonglong> &ids)
+{
+    auto result = QList<MusicAudioTrack>();
+
+    if (!d) {
+        return result;
+    }
+
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return result;
+    }
+
+    result.reserve(ids.size());
+
+    for (auto oneId : ids) {
+        result.push_back(internalTrackFromDatabaseId(oneId));
+    }
+
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return result;
+    }
+
+    return result;
+}
+
 qulonglong DatabaseInterface::trackIdFromTitleAlbumTrackDiscNumber(const QString &title, const QString &artist, const QString &album,
                                                                    int trackNumber, int discNumber)
 {
@@ -736,6 +852,20 @@ void DatabaseInterface::removeAllTracksFromSource(const QString &sourceName)
 
     internalRemoveTracksList(allFileNames, sourceId);
 
+    d->mRemoveScanProgressQuery.bindValue(QStringLiteral(":discoverId"), sourceId);
+
+    queryResult = d->mRemoveScanProgressQuery.exec();
+
+    if (!queryResult || !d->mRemoveScanProgressQuery.isActive()) {
+        Q_EMIT databaseError();
+
+        qDebug() << "DatabaseInterface::removeAllTracksFromSource" << d->mRemoveScanProgressQuery.lastQuery();
+        qDebug() << "DatabaseInterface::removeAllTracksFromSource" << d->mRemoveScanProgressQuery.boundValues();
+        qDebug() << "DatabaseInterface::removeAllTracksFromSource" << d->mRemoveScanProgressQuery.lastError();
+    }
+
+    d->mRemoveScanProgressQuery.finish();
+
     transactionResult = finishTransaction();
     if (!transactionResult) {
         return;
@@ -761,9 +891,11 @@ void DatabaseInterface::getAlbumFromAlbumId(qulonglong id)
     Q_EMIT sentAlbumData(result);
 }
 
-void DatabaseInterface::cleanInvalidTracks()
+void DatabaseInterface::getTracksPage(int offset, int count, qulonglong afterId, int skippedCount)
 {
-    if (d->mStopRequest == 1) {
+    auto result = QList<MusicAudioTrack>();
+
+    if (!d) {
         return;
     }
 
@@ -772,47 +904,58 @@ void DatabaseInterface::cleanInvalidTracks()
         return;
     }
 
-    auto queryResult = d->mFindInvalidTrackFilesQuery.exec();
+    if (skippedCount > 0) {
+        afterId = internalSkippedRowsLastId(d->mSelectTracksPageStartQuery, afterId, skippedCount);
 
-    if (!queryResult || !d->mFindInvalidTrackFilesQuery.isSelect() || !d->mFindInvalidTrackFilesQuery.isActive()) {
+        /* the page starts after the last row */
+        if (afterId == 0) {
+            finishTransaction();
+
+            Q_EMIT sentTracksPage(offset, result);
+            return;
+        }
+    }
+
+    d->mSelectTracksPageQuery.bindValue(QStringLiteral(":afterId"), afterId);
+    d->mSelectTracksPageQuery.bindValue(QStringLiteral(":count"), count);
+
+    auto queryResult = d->mSelectTracksPageQuery.exec();
+
+    if (!queryResult || !d->mSelectTracksPageQuery.isSelect() || !d->mSelectTracksPageQuery.isActive()) {
         Q_EMIT databaseError();
 
-        qDebug() << "DatabaseInterface::insertMusicSource" << d->mFindInvalidTrackFilesQuery.lastQuery();
-        qDebug() << "DatabaseInterface::insertMusicSource" << d->mFindInvalidTrackFilesQuery.boundValues();
-        qDebug() << "DatabaseInterface::insertMusicSource" << d->mFindInvalidTrackFilesQuery.lastError();
+        qDebug() << "DatabaseInterface::getTracksPage" << d->mSelectTracksPageQuery.lastQuery();
+        qDebug() << "DatabaseInterface::getTracksPage" << d->mSelectTracksPageQuery.boundValues();
+        qDebug() << "DatabaseInterface::getTracksPage" << d->mSelectTracksPageQuery.lastError();
 
-        d->mFindInvalidTrackFilesQuery.finish();
+        d->mSelectTracksPageQuery.finish();
 
-        transactionResult = finishTransaction();
-        if (!transactionResult) {
-            return;
-        }
+        finishTransaction();
 
         return;
     }
 
-    QList<QUrl> allFileNames;
-    auto sourceId = qulonglong();
+    while(d->mSelectTracksPageQuery.next()) {
+        const auto &currentRecord = d->mSelectTracksPageQuery.record();
 
-    while(d->mFindInvalidTrackFilesQuery.next()) {
-        auto fileName = d->mFindInvalidTrackFilesQuery.record().value(0).toUrl();
-        sourceId = d->mFindInvalidTrackFilesQuery.record().value(1).toULongLong();
-        allFileNames.push_back(fileName);
+        result.push_back(buildTrackFromDatabaseRecord(currentRecord));
     }
 
-    d->mFindInvalidTrackFilesQuery.finish();
-
-    internalRemoveTracksList(allFileNames, sourceId);
+    d->mSelectTracksPageQuery.finish();
 
     transactionResult = finishTransaction();
     if (!transactionResult) {
         return;
     }
+
+    Q_EMIT sentTracksPage(offset, result);
 }
 
-void DatabaseInterface::insertTracksList(const QList<MusicAudioTrack> &tracks, const QHash<QString, QUrl> &covers, const QString &musicSource)
+void DatabaseInterface::getAlbumsPage(int offset, int count, qulonglong afterId, int skippedCount)
 {
-    if (d->mStopRequest == 1) {
+    auto result = QList<MusicAlbum>();
+
+    if (!d) {
         return;
     }
 
@@ -821,173 +964,1021 @@ void DatabaseInterface::insertTracksList(const QList<MusicAudioTrack> &tracks, c
         return;
     }
 
-    QSet<qulonglong> modifiedAlbumIds;
-    QList<qulonglong> insertedTracks;
-    QList<qulonglong> insertedAlbums;
+    if (skippedCount > 0) {
+        afterId = internalSkippedRowsLastId(d->mSelectAlbumsPageStartQuery, afterId, skippedCount);
 
-    for(const auto &oneTrack : tracks) {
-        d->mSelectTracksMapping.bindValue(QStringLiteral(":fileName"), oneTrack.resourceURI());
+        /* the page starts after the last row */
+        if (afterId == 0) {
+            finishTransaction();
 
-        auto result = d->mSelectTracksMapping.exec();
+            Q_EMIT sentAlbumsPage(offset, result);
+            return;
+        }
+    }
 
-        if (!result || !d->mSelectTracksMapping.isSelect() || !d->mSelectTracksMapping.isActive()) {
-            Q_EMIT databaseError();
+    d->mSelectAlbumsPageQuery.bindValue(QStringLiteral(":afterId"), afterId);
+    d->mSelectAlbumsPageQuery.bindValue(QStringLiteral(":count"), count);
 
-            qDebug() << "DatabaseInterface::insertTracksList" << d->mSelectTracksMapping.lastQuery();
-            qDebug() << "DatabaseInterface::insertTracksList" << d->mSelectTracksMapping.boundValues();
-            qDebug() << "DatabaseInterface::insertTracksList" << d->mSelectTracksMapping.lastError();
+    auto queryResult = d->mSelectAlbumsPageQuery.exec();
 
-            d->mSelectTracksMapping.finish();
+    if (!queryResult || !d->mSelectAlbumsPageQuery.isSelect() || !d->mSelectAlbumsPageQuery.isActive()) {
+        Q_EMIT databaseError();
 
-            rollBackTransaction();
-            return;
-        }
+        qDebug() << "DatabaseInterface::getAlbumsPage" << d->mSelectAlbumsPageQuery.lastQuery();
+        qDebug() << "DatabaseInterface::getAlbumsPage" << d->mSelectAlbumsPageQuery.boundValues();
+        qDebug() << "DatabaseInterface::getAlbumsPage" << d->mSelectAlbumsPageQuery.lastError();
 
-        bool isNewTrack = !d->mSelectTracksMapping.next();
+        d->mSelectAlbumsPageQuery.finish();
 
-        if (isNewTrack) {
-            insertTrackOrigin(oneTrack.resourceURI(), insertMusicSource(musicSource));
-        } else {
-            updateTrackOrigin(d->mSelectTracksMapping.record().value(0).toULongLong(), oneTrack.resourceURI());
-        }
+        finishTransaction();
 
-        d->mSelectTracksMapping.finish();
+        return;
+    }
 
-        const auto insertedTrackId = internalInsertTrack(oneTrack, covers, 0, modifiedAlbumIds,
-                                                         (isNewTrack ? TrackFileInsertType::NewTrackFileInsert : TrackFileInsertType::ModifiedTrackFileInsert),
-                                                         insertedAlbums);
+    while(d->mSelectAlbumsPageQuery.next()) {
+        auto newAlbum = MusicAlbum();
 
-        if (isNewTrack && insertedTrackId != 0) {
-            insertedTracks.push_back(insertedTrackId);
-        }
+        const auto &currentRecord = d->mSelectAlbumsPageQuery.record();
 
-        if (d->mStopRequest == 1) {
-            transactionResult = finishTransaction();
-            if (!transactionResult) {
-                return;
-            }
-            return;
-        }
-    }
+        newAlbum.setDatabaseId(currentRecord.value(0).toULongLong());
+        newAlbum.setTitle(currentRecord.value(1).toString());
+        newAlbum.setId(currentRecord.value(2).toString());
+        newAlbum.setArtist(currentRecord.value(3).toString());
+        newAlbum.setAlbumArtURI(currentRecord.value(4).toUrl());
+        newAlbum.setTracksCount(currentRecord.value(5).toInt());
+        newAlbum.setIsSingleDiscAlbum(currentRecord.value(6).toBool());
+        newAlbum.setValid(true);
 
-    QList<MusicAlbum> newAlbums;
-    for (auto albumId : qAsConst(insertedAlbums)) {
-        modifiedAlbumIds.remove(albumId);
-        newAlbums.push_back(internalAlbumFromId(albumId));
+        result.push_back(newAlbum);
     }
 
-    if (!newAlbums.isEmpty()) {
-        Q_EMIT albumsAdded(newAlbums);
-    }
+    d->mSelectAlbumsPageQuery.finish();
 
-    const auto &constModifiedAlbumIds = modifiedAlbumIds;
-    for (auto albumId : constModifiedAlbumIds) {
-        Q_EMIT albumModified(internalAlbumFromId(albumId), albumId);
-    }
+    /* the tracks give the rating, artists and duration of each album, the albums of a page have contiguous ids */
+    if (!result.isEmpty()) {
+        d->mSelectTracksFromAlbumsRangeQuery.bindValue(QStringLiteral(":firstAlbumId"), result.first().databaseId());
+        d->mSelectTracksFromAlbumsRangeQuery.bindValue(QStringLiteral(":lastAlbumId"), result.last().databaseId());
 
-    QList<MusicAudioTrack> newTracks;
-    for (auto trackId : qAsConst(insertedTracks)) {
-        newTracks.push_back(internalTrackFromDatabaseId(trackId));
-    }
+        queryResult = d->mSelectTracksFromAlbumsRangeQuery.exec();
 
-    if (!newTracks.isEmpty()) {
-        Q_EMIT tracksAdded(newTracks);
+        if (!queryResult || !d->mSelectTracksFromAlbumsRangeQuery.isSelect() || !d->mSelectTracksFromAlbumsRangeQuery.isActive()) {
+            Q_EMIT databaseError();
+
+            qDebug() << "DatabaseInterface::getAlbumsPage" << d->mSelectTracksFromAlbumsRangeQuery.lastQuery();
+            qDebug() << "DatabaseInterface::getAlbumsPage" << d->mSelectTracksFromAlbumsRangeQuery.boundValues();
+            qDebug() << "DatabaseInterface::getAlbumsPage" << d->mSelectTracksFromAlbumsRangeQuery.lastError();
+        }
+
+        auto tracksByAlbum = QHash<qulonglong, QList<MusicAudioTrack>>();
+
+        while (d->mSelectTracksFromAlbumsRangeQuery.next()) {
+            const auto &currentRecord = d->mSelectTracksFromAlbumsRangeQuery.record();
+
+            tracksByAlbum[currentRecord.value(2).toULongLong()].push_back(buildTrackFromDatabaseRecord(currentRecord));
+        }
+
+        d->mSelectTracksFromAlbumsRangeQuery.finish();
+
+        for (auto &oneAlbum : result) {
+            oneAlbum.setTracks(tracksByAlbum.value(oneAlbum.databaseId()));
+        }
     }
 
     transactionResult = finishTransaction();
     if (!transactionResult) {
         return;
     }
+
+    Q_EMIT sentAlbumsPage(offset, result);
 }
 
-void DatabaseInterface::removeTracksList(const QList<QUrl> &removedTracks)
+void DatabaseInterface::getArtistsPage(int offset, int count, qulonglong afterId, int skippedCount)
 {
-    auto transactionResult = startTransaction();
-    if (!transactionResult) {
-        return;
-    }
-
-    internalRemoveTracksList(removedTracks);
+    auto result = QList<MusicArtist>();
 
-    transactionResult = finishTransaction();
-    if (!transactionResult) {
+    if (!d) {
         return;
     }
-}
 
-void DatabaseInterface::modifyTracksList(const QList<MusicAudioTrack> &modifiedTracks, const QHash<QString, QUrl> &covers,
-                                         const QString &musicSource)
-{
     auto transactionResult = startTransaction();
     if (!transactionResult) {
         return;
     }
 
-    QSet<qulonglong> modifiedAlbumIds;
-    QList<qulonglong> newAlbumIds;
+    if (skippedCount > 0) {
+        afterId = internalSkippedRowsLastId(d->mSelectArtistsPageStartQuery, afterId, skippedCount);
 
-    for (const auto &oneModifiedTrack : modifiedTracks) {
-        if (oneModifiedTrack.albumArtist().isEmpty()) {
-            continue;
+        /* the page starts after the last row */
+        if (afterId == 0) {
+            finishTransaction();
+
+            Q_EMIT sentArtistsPage(offset, result);
+            return;
         }
+    }
 
-        bool modifyExistingTrack = internalTrackFromDatabaseId(oneModifiedTrack.databaseId()).isValid() ||
-                (internalTrackIdFromFileName(oneModifiedTrack.resourceURI()) != 0);
+    d->mSelectArtistsPageQuery.bindValue(QStringLiteral(":afterId"), afterId);
+    d->mSelectArtistsPageQuery.bindValue(QStringLiteral(":count"), count);
 
-        auto originTrackId = oneModifiedTrack.databaseId();
-        if (!originTrackId) {
-            originTrackId = internalTrackIdFromFileName(oneModifiedTrack.resourceURI());
-        }
+    auto queryResult = d->mSelectArtistsPageQuery.exec();
 
-        if (!modifyExistingTrack) {
-            insertTrackOrigin(oneModifiedTrack.resourceURI(), insertMusicSource(musicSource));
-        } else {
-            updateTrackOrigin(originTrackId, oneModifiedTrack.resourceURI());
-        }
+    if (!queryResult || !d->mSelectArtistsPageQuery.isSelect() || !d->mSelectArtistsPageQuery.isActive()) {
+        Q_EMIT databaseError();
 
-        internalInsertTrack(oneModifiedTrack, covers, (modifyExistingTrack ? originTrackId : 0),
-                            modifiedAlbumIds,
-                            (modifyExistingTrack ? TrackFileInsertType::ModifiedTrackFileInsert : TrackFileInsertType::NewTrackFileInsert),
-                            newAlbumIds);
-    }
+        qDebug() << "DatabaseInterface::getArtistsPage" << d->mSelectArtistsPageQuery.lastQuery();
+        qDebug() << "DatabaseInterface::getArtistsPage" << d->mSelectArtistsPageQuery.boundValues();
+        qDebug() << "DatabaseInterface::getArtistsPage" << d->mSelectArtistsPageQuery.lastError();
 
-    QList<MusicAlbum> newAlbums;
-    for (auto albumId : qAsConst(newAlbumIds)) {
-        modifiedAlbumIds.remove(albumId);
-        newAlbums.push_back(internalAlbumFromId(albumId));
-    }
+        d->mSelectArtistsPageQuery.finish();
 
-    if (!newAlbums.isEmpty()) {
-        Q_EMIT albumsAdded(newAlbums);
+        finishTransaction();
+
+        return;
     }
 
-    for (auto albumId : qAsConst(modifiedAlbumIds)) {
-        Q_EMIT albumModified(internalAlbumFromId(albumId), albumId);
+    while(d->mSelectArtistsPageQuery.next()) {
+        auto newArtist = MusicArtist();
+
+        const auto &currentRecord = d->mSelectArtistsPageQuery.record();
+
+        newArtist.setDatabaseId(currentRecord.value(0).toULongLong());
+        newArtist.setName(currentRecord.value(1).toString());
+        newArtist.setAlbumsCount(currentRecord.value(2).toInt());
+        newArtist.setValid(true);
+
+        result.push_back(newArtist);
     }
 
+    d->mSelectArtistsPageQuery.finish();
+
     transactionResult = finishTransaction();
     if (!transactionResult) {
         return;
     }
+
+    Q_EMIT sentArtistsPage(offset, result);
 }
 
-bool DatabaseInterface::startTransaction() const
+void DatabaseInterface::getAllTracksIds()
 {
-    auto result = false;
+    if (!d) {
+        return;
+    }
 
-    auto transactionResult = d->mTracksDatabase.transaction();
+    auto transactionResult = startTransaction();
     if (!transactionResult) {
-        qDebug() << "transaction failed" << d->mTracksDatabase.lastError() << d->mTracksDatabase.lastError().driverText();
-
-        return result;
+        return;
     }
 
-    result = true;
-
-    return result;
-}
+    auto result = internalAllIds(d->mSelectAllTracksIdsQuery);
 
-bool DatabaseInterface::finishTransaction() const
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    Q_EMIT sentAllTracksIds(result);
+}
+
+void DatabaseInterface::getAllAlbumsTracksIds()
+{
+    if (!d) {
+        return;
+    }
+
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    auto result = internalAllIds(d->mSelectAllAlbumsTracksIdsQuery);
+
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    Q_EMIT sentAllAlbumsTracksIds(result);
+}
+
+void DatabaseInterface::getAllArtistsNames()
+{
+    auto result = QStringList();
+
+    if (!d) {
+        return;
+    }
+
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    auto queryResult = d->mSelectAllArtistsNamesQuery.exec();
+
+    if (!queryResult || !d->mSelectAllArtistsNamesQuery.isSelect() || !d->mSelectAllArtistsNamesQuery.isActive()) {
+        Q_EMIT databaseError();
+
+        qDebug() << "DatabaseInterface::getAllArtistsNames" << d->mSelectAllArtistsNamesQuery.lastQuery();
+        qDebug() << "DatabaseInterface::getAllArtistsNames" << d->mSelectAllArtistsNamesQuery.boundValues();
+        qDebug() << "DatabaseInterface::getAllArtistsNames" << d->mSelectAllArtistsNamesQuery.lastError();
+
+        d->mSelectAllArtistsNamesQuery.finish();
+
+        finishTransaction();
+
+        return;
+    }
+
+    while(d->mSelectAllArtistsNamesQuery.next()) {
+        result.push_back(d->mSelectAllArtistsNamesQuery.record().value(0).toString());
+    }
+
+    d->mSelectAllArtistsNamesQuery.finish();
+
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    Q_EMIT sentAllArtistsNames(result);
+}
+
+void DatabaseInterface::getAlbumsFromArtist(const QString &artistName)
+{
+    auto result = QList<MusicAlbum>();
+
+    if (!d) {
+        return;
+    }
+
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    d->mSelectAlbumIdsFromAnyArtistQuery.bindValue(QStringLiteral(":artistName"), artistName);
+
+    auto albumIds = internalAllIds(d->mSelectAlbumIdsFromAnyArtistQuery);
+
+    result.reserve(albumIds.size());
+
+    for (auto oneAlbumId : qAsConst(albumIds)) {
+        auto oneAlbum = internalAlbumFromId(oneAlbumId);
+
+        if (oneAlbum.isValid()) {
+            result.push_back(oneAlbum);
+        }
+    }
+
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    Q_EMIT sentAlbumsFromArtist(result);
+}
+
+void DatabaseInterface::cleanInvalidTracks()
+{
+    if (d->mStopRequest == 1) {
+        return;
+    }
+
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    auto queryResult = d->mFindInvalidTrackFilesQuery.exec();
+
+    if (!queryResult || !d->mFindInvalidTrackFilesQuery.isSelect() || !d->mFindInvalidTrackFilesQuery.isActive()) {
+        Q_EMIT databaseError();
+
+        qDebug() << "DatabaseInterface::insertMusicSource" << d->mFindInvalidTrackFilesQuery.lastQuery();
+        qDebug() << "DatabaseInterface::insertMusicSource" << d->mFindInvalidTrackFilesQuery.boundValues();
+        qDebug() << "DatabaseInterface::insertMusicSource" << d->mFindInvalidTrackFilesQuery.lastError();
+
+        d->mFindInvalidTrackFilesQuery.finish();
+
+        transactionResult = finishTransaction();
+        if (!transactionResult) {
+            return;
+        }
+
+        return;
+    }
+
+    QList<QUrl> allFileNames;
+    auto sourceId = qulonglong();
+
+    while(d->mFindInvalidTrackFilesQuery.next()) {
+        auto fileName = d->mFindInvalidTrackFilesQuery.record().value(0).toUrl();
+        sourceId = d->mFindInvalidTrackFilesQuery.record().value(1).toULongLong();
+        allFileNames.push_back(fileName);
+    }
+
+    d->mFindInvalidTrackFilesQuery.finish();
+
+    internalRemoveTracksList(allFileNames, sourceId);
+
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return;
+    }
+}
+
+QList<QUrl> DatabaseInterface::restoreScanProgress(const QString &musicSource)
+{
+    auto result = QList<QUrl>();
+
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return result;
+    }
+
+    const auto discoverId = insertMusicSource(musicSource);
+
+    d->mSelectCompletedScanDirectoriesQuery.bindValue(QStringLiteral(":discoverId"), discoverId);
+
+    auto queryResult = d->mSelectCompletedScanDirectoriesQuery.exec();
+
+    if (!queryResult || !d->mSelectCompletedScanDirectoriesQuery.isSelect() || !d->mSelectCompletedScanDirectoriesQuery.isActive()) {
+        Q_EMIT databaseError();
+
+        qDebug() << "DatabaseInterface::restoreScanProgress" << d->mSelectCompletedScanDirectoriesQuery.lastQuery();
+        qDebug() << "DatabaseInterface::restoreScanProgress" << d->mSelectCompletedScanDirectoriesQuery.boundValues();
+        qDebug() << "DatabaseInterface::restoreScanProgress" << d->mSelectCompletedScanDirectoriesQuery.lastError();
+
+        d->mSelectCompletedScanDirectoriesQuery.finish();
+
+        rollBackTransaction();
+        return result;
+    }
+
+    while (d->mSelectCompletedScanDirectoriesQuery.next()) {
+        result.push_back(d->mSelectCompletedScanDirectoriesQuery.record().value(0).toUrl());
+    }
+
+    d->mSelectCompletedScanDirectoriesQuery.finish();
+
+    for (const auto &oneDirectory : qAsConst(result)) {
+        auto directoryPrefix = oneDirectory.toString();
+        if (!directoryPrefix.endsWith(QLatin1Char('/'))) {
+            directoryPrefix += QLatin1Char('/');
+        }
+
+        auto directoryPrefixEnd = directoryPrefix;
+        directoryPrefixEnd[directoryPrefixEnd.size() - 1] = QLatin1Char('0');
+
+        d->mUpdateTracksValidityInDirectoryQuery.bindValue(QStringLiteral(":discoverId"), discoverId);
+        d->mUpdateTracksValidityInDirectoryQuery.bindValue(QStringLiteral(":directoryPrefix"), directoryPrefix);
+        d->mUpdateTracksValidityInDirectoryQuery.bindValue(QStringLiteral(":directoryPrefixEnd"), directoryPrefixEnd);
+
+        queryResult = d->mUpdateTracksValidityInDirectoryQuery.exec();
+
+        if (!queryResult || !d->mUpdateTracksValidityInDirectoryQuery.isActive()) {
+            Q_EMIT databaseError();
+
+            qDebug() << "DatabaseInterface::restoreScanProgress" << d->mUpdateTracksValidityInDirectoryQuery.lastQuery();
+            qDebug() << "DatabaseInterface::restoreScanProgress" << d->mUpdateTracksValidityInDirectoryQuery.boundValues();
+            qDebug() << "DatabaseInterface::restoreScanProgress" << d->mUpdateTracksValidityInDirectoryQuery.lastError();
+        }
+
+        d->mUpdateTracksValidityInDirectoryQuery.finish();
+    }
+
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return {};
+    }
+
+    return result;
+}
+
+QList<MusicAudioTrack> DatabaseInterface::restoreKnownTracks(const QString &musicSource)
+{
+    auto result = QList<MusicAudioTrack>();
+
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return result;
+    }
+
+    const auto discoverId = insertMusicSource(musicSource);
+
+    d->mSelectKnownTrackFilesFromSourceQuery.bindValue(QStringLiteral(":discoverId"), discoverId);
+
+    auto queryResult = d->mSelectKnownTrackFilesFromSourceQuery.exec();
+
+    if (!queryResult || !d->mSelectKnownTrackFilesFromSourceQuery.isSelect() || !d->mSelectKnownTrackFilesFromSourceQuery.isActive()) {
+        Q_EMIT databaseError();
+
+        qDebug() << "DatabaseInterface::restoreKnownTracks" << d->mSelectKnownTrackFilesFromSourceQuery.lastQuery();
+        qDebug() << "DatabaseInterface::restoreKnownTracks" << d->mSelectKnownTrackFilesFromSourceQuery.boundValues();
+        qDebug() << "DatabaseInterface::restoreKnownTracks" << d->mSelectKnownTrackFilesFromSourceQuery.lastError();
+
+        d->mSelectKnownTrackFilesFromSourceQuery.finish();
+
+        rollBackTransaction();
+        return result;
+    }
+
+    while (d->mSelectKnownTrackFilesFromSourceQuery.next()) {
+        const auto &currentRecord = d->mSelectKnownTrackFilesFromSourceQuery.record();
+
+        auto knownTrack = MusicAudioTrack();
+        knownTrack.setResourceURI(currentRecord.value(0).toUrl());
+        if (!currentRecord.isNull(1) && !currentRecord.isNull(2)) {
+            knownTrack.setFileSize(currentRecord.value(1).toLongLong());
+            knownTrack.setFileModificationTime(currentRecord.value(2).toLongLong());
+        }
+
+        result.push_back(knownTrack);
+    }
+
+    d->mSelectKnownTrackFilesFromSourceQuery.finish();
+
+    d->mUpdateTracksValidityFromSourceQuery.bindValue(QStringLiteral(":discoverId"), discoverId);
+
+    queryResult = d->mUpdateTracksValidityFromSourceQuery.exec();
+
+    if (!queryResult || !d->mUpdateTracksValidityFromSourceQuery.isActive()) {
+        Q_EMIT databaseError();
+
+        qDebug() << "DatabaseInterface::restoreKnownTracks" << d->mUpdateTracksValidityFromSourceQuery.lastQuery();
+        qDebug() << "DatabaseInterface::restoreKnownTracks" << d->mUpdateTracksValidityFromSourceQuery.boundValues();
+        qDebug() << "DatabaseInterface::restoreKnownTracks" << d->mUpdateTracksValidityFromSourceQuery.lastError();
+    }
+
+    d->mUpdateTracksValidityFromSourceQuery.finish();
+
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return {};
+    }
+
+    return result;
+}
+
+void DatabaseInterface::getScanProgress(const QString &musicSource)
+{
+    Q_EMIT sentScanProgress(musicSource, restoreScanProgress(musicSource));
+}
+
+void DatabaseInterface::updateScanProgress(const QString &musicSource, const QList<QUrl> &completedDirectories)
+{
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    const auto discoverId = insertMusicSource(musicSource);
+
+    /* only completed directories are stored, the walk always starts again from the root */
+    for (const auto &oneDirectory : completedDirectories) {
+        d->mInsertScanProgressQuery.bindValue(QStringLiteral(":discoverId"), discoverId);
+        d->mInsertScanProgressQuery.bindValue(QStringLiteral(":directoryName"), oneDirectory);
+        d->mInsertScanProgressQuery.bindValue(QStringLiteral(":completed"), true);
+
+        auto queryResult = d->mInsertScanProgressQuery.exec();
+
+        if (!queryResult || !d->mInsertScanProgressQuery.isActive()) {
+            Q_EMIT databaseError();
+
+            qDebug() << "DatabaseInterface::updateScanProgress" << d->mInsertScanProgressQuery.lastQuery();
+            qDebug() << "DatabaseInterface::updateScanProgress" << d->mInsertScanProgressQuery.boundValues();
+            qDebug() << "DatabaseInterface::updateScanProgress" << d->mInsertScanProgressQuery.lastError();
+        }
+
+        d->mInsertScanProgressQuery.finish();
+    }
+
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return;
+    }
+}
+
+void DatabaseInterface::clearScanProgress(const QString &musicSource)
+{
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    d->mRemoveScanProgressQuery.bindValue(QStringLiteral(":discoverId"), insertMusicSource(musicSource));
+
+    auto queryResult = d->mRemoveScanProgressQuery.exec();
+
+    if (!queryResult || !d->mRemoveScanProgressQuery.isActive()) {
+        Q_EMIT databaseError();
+
+        qDebug() << "DatabaseInterface::clearScanProgress" << d->mRemoveScanProgressQuery.lastQuery();
+        qDebug() << "DatabaseInterface::clearScanProgress" << d->mRemoveScanProgressQuery.boundValues();
+        qDebug() << "DatabaseInterface::clearScanProgress" << d->mRemoveScanProgressQuery.lastError();
+    }
+
+    d->mRemoveScanProgressQuery.finish();
+
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return;
+    }
+}
+
+void DatabaseInterface::insertPlayListEntries(const QString &playListName, int position, const QList<MusicAudioTrack> &entries)
+{
+    if (!d || entries.isEmpty()) {
+        return;
+    }
+
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    const auto playListId = insertPlayList(playListName);
+
+    /* the new entries take positions between their neighbours, the following entries are not written */
+    auto firstPosition = qlonglong(0);
+    auto positionStep = qlonglong(0);
+
+    if (playListId == 0 || !playListEntriesGap(playListId, position, entries.size(), firstPosition, positionStep)) {
+        rollBackTransaction();
+        return;
+    }
+
+    for (int entryIndex = 0; entryIndex < entries.size(); ++entryIndex) {
+        d->mInsertPlayListEntryQuery.bindValue(QStringLiteral(":playListId"), playListId);
+        d->mInsertPlayListEntryQuery.bindValue(QStringLiteral(":position"), firstPosition + entryIndex * positionStep);
+        bindPlayListEntry(d->mInsertPlayListEntryQuery, entries.at(entryIndex));
+
+        auto queryResult = d->mInsertPlayListEntryQuery.exec();
+
+        if (!queryResult || !d->mInsertPlayListEntryQuery.isActive()) {
+            Q_EMIT databaseError();
+
+            qDebug() << "DatabaseInterface::insertPlayListEntries" << d->mInsertPlayListEntryQuery.lastQuery();
+            qDebug() << "DatabaseInterface::insertPlayListEntries" << d->mInsertPlayListEntryQuery.boundValues();
+            qDebug() << "DatabaseInterface::insertPlayListEntries" << d->mInsertPlayListEntryQuery.lastError();
+
+            d->mInsertPlayListEntryQuery.finish();
+
+            rollBackTransaction();
+            return;
+        }
+
+        d->mInsertPlayListEntryQuery.finish();
+    }
+
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return;
+    }
+}
+
+void DatabaseInterface::removePlayListEntries(const QString &playListName, int position, int count)
+{
+    if (!d || count <= 0) {
+        return;
+    }
+
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    const auto playListId = insertPlayList(playListName);
+
+    if (playListId == 0 || !removePlayListEntryRows(playListId, position, count)) {
+        rollBackTransaction();
+        return;
+    }
+
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return;
+    }
+}
+
+void DatabaseInterface::movePlayListEntries(const QString &playListName, int sourcePosition, int count, int destinationPosition)
+{
+    if (!d || count <= 0 || (destinationPosition >= sourcePosition && destinationPosition <= sourcePosition + count)) {
+        return;
+    }
+
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    const auto playListId = insertPlayList(playListName);
+
+    /* only the moved entries are written, they take positions between their new neighbours */
+    auto movedEntries = QList<std::pair<qulonglong, qlonglong>>();
+    auto firstPosition = qlonglong(0);
+    auto positionStep = qlonglong(0);
+
+    if (playListId == 0 || !playListEntryPositions(playListId, sourcePosition, count, movedEntries) ||
+            !playListEntriesGap(playListId, destinationPosition, movedEntries.size(), firstPosition, positionStep)) {
+        rollBackTransaction();
+        return;
+    }
+
+    for (int entryIndex = 0; entryIndex < movedEntries.size(); ++entryIndex) {
+        if (!updatePlayListEntryPosition(movedEntries.at(entryIndex).first, firstPosition + entryIndex * positionStep)) {
+            rollBackTransaction();
+            return;
+        }
+    }
+
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return;
+    }
+}
+
+void DatabaseInterface::updatePlayListEntry(const QString &playListName, int position, const MusicAudioTrack &entry)
+{
+    if (!d) {
+        return;
+    }
+
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    d->mUpdatePlayListEntryQuery.bindValue(QStringLiteral(":playListId"), insertPlayList(playListName));
+    d->mUpdatePlayListEntryQuery.bindValue(QStringLiteral(":row"), position);
+    bindPlayListEntry(d->mUpdatePlayListEntryQuery, entry);
+
+    auto queryResult = d->mUpdatePlayListEntryQuery.exec();
+
+    if (!queryResult || !d->mUpdatePlayListEntryQuery.isActive()) {
+        Q_EMIT databaseError();
+
+        qDebug() << "DatabaseInterface::updatePlayListEntry" << d->mUpdatePlayListEntryQuery.lastQuery();
+        qDebug() << "DatabaseInterface::updatePlayListEntry" << d->mUpdatePlayListEntryQuery.boundValues();
+        qDebug() << "DatabaseInterface::updatePlayListEntry" << d->mUpdatePlayListEntryQuery.lastError();
+    }
+
+    d->mUpdatePlayListEntryQuery.finish();
+
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return;
+    }
+}
+
+void DatabaseInterface::clearPlayListEntries(const QString &playListName)
+{
+    if (!d) {
+        return;
+    }
+
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    const auto playListId = insertPlayList(playListName);
+
+    if (playListId == 0 || !removePlayListEntryRows(playListId, 0, -1)) {
+        rollBackTransaction();
+        return;
+    }
+
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return;
+    }
+}
+
+void DatabaseInterface::getPlayListEntries(const QString &playListName)
+{
+    auto result = QList<MusicAudioTrack>();
+
+    if (!d) {
+        return;
+    }
+
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    d->mSelectPlayListEntriesQuery.bindValue(QStringLiteral(":playListId"), insertPlayList(playListName));
+
+    auto queryResult = d->mSelectPlayListEntriesQuery.exec();
+
+    if (!queryResult || !d->mSelectPlayListEntriesQuery.isSelect() || !d->mSelectPlayListEntriesQuery.isActive()) {
+        Q_EMIT databaseError();
+
+        qDebug() << "DatabaseInterface::getPlayListEntries" << d->mSelectPlayListEntriesQuery.lastQuery();
+        qDebug() << "DatabaseInterface::getPlayListEntries" << d->mSelectPlayListEntriesQuery.boundValues();
+        qDebug() << "DatabaseInterface::getPlayListEntries" << d->mSelectPlayListEntriesQuery.lastError();
+
+        d->mSelectPlayListEntriesQuery.finish();
+
+        finishTransaction();
+
+        return;
+    }
+
+    while(d->mSelectPlayListEntriesQuery.next()) {
+        const auto &currentRecord = d->mSelectPlayListEntriesQuery.record();
+
+        auto oneEntry = MusicAudioTrack();
+
+        oneEntry.setDatabaseId(currentRecord.value(0).toULongLong());
+        oneEntry.setTitle(currentRecord.value(1).toString());
+        oneEntry.setArtist(currentRecord.value(2).toString());
+        oneEntry.setAlbumName(currentRecord.value(3).toString());
+        oneEntry.setTrackNumber(currentRecord.value(4).toInt());
+        oneEntry.setDiscNumber(currentRecord.value(5).toInt());
+        oneEntry.setResourceURI(currentRecord.value(6).toUrl());
+
+        result.push_back(oneEntry);
+    }
+
+    d->mSelectPlayListEntriesQuery.finish();
+
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    Q_EMIT sentPlayListEntries(playListName, result);
+}
+
+void DatabaseInterface::insertTracksList(const QList<MusicAudioTrack> &tracks, const QHash<QString, QUrl> &covers, const QString &musicSource)
+{
+    if (d->mStopRequest == 1) {
+        return;
+    }
+
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    QSet<qulonglong> modifiedAlbumIds;
+    QList<qulonglong> insertedTracks;
+    QList<qulonglong> insertedAlbums;
+    QList<MusicAudioTrack> modifiedTracks;
+
+    for(const auto &oneTrack : tracks) {
+        d->mSelectTracksMapping.bindValue(QStringLiteral(":fileName"), oneTrack.resourceURI());
+
+        auto result = d->mSelectTracksMapping.exec();
+
+        if (!result || !d->mSelectTracksMapping.isSelect() || !d->mSelectTracksMapping.isActive()) {
+            Q_EMIT databaseError();
+
+            qDebug() << "DatabaseInterface::insertTracksList" << d->mSelectTracksMapping.lastQuery();
+            qDebug() << "DatabaseInterface::insertTracksList" << d->mSelectTracksMapping.boundValues();
+            qDebug() << "DatabaseInterface::insertTracksList" << d->mSelectTracksMapping.lastError();
+
+            d->mSelectTracksMapping.finish();
+
+            rollBackTransaction();
+            return;
+        }
+
+        bool isNewTrack = !d->mSelectTracksMapping.next();
+
+        if (isNewTrack) {
+            insertTrackOrigin(oneTrack.resourceURI(), insertMusicSource(musicSource));
+        } else {
+            updateTrackOrigin(d->mSelectTracksMapping.record().value(0).toULongLong(), oneTrack.resourceURI());
+        }
+
+        d->mSelectTracksMapping.finish();
+
+        updateTrackFileState(oneTrack);
+
+        const auto insertedTrackId = internalInsertTrack(oneTrack, covers, 0, modifiedAlbumIds,
+                                                         (isNewTrack ? TrackFileInsertType::NewTrackFileInsert : TrackFileInsertType::ModifiedTrackFileInsert),
+                                                         insertedAlbums, modifiedTracks);
+
+        if (isNewTrack && insertedTrackId != 0) {
+            insertedTracks.push_back(insertedTrackId);
+        }
+
+        if (d->mStopRequest == 1) {
+            transactionResult = finishTransaction();
+            if (!transactionResult) {
+                return;
+            }
+            return;
+        }
+    }
+
+    QList<MusicAlbum> newAlbums;
+    for (auto albumId : qAsConst(insertedAlbums)) {
+        modifiedAlbumIds.remove(albumId);
+        newAlbums.push_back(internalAlbumFromId(albumId));
+    }
+
+    if (!newAlbums.isEmpty()) {
+        Q_EMIT albumsAdded(newAlbums);
+    }
+
+    QList<MusicAlbum> modifiedAlbums;
+    const auto &constModifiedAlbumIds = modifiedAlbumIds;
+    for (auto albumId : constModifiedAlbumIds) {
+        modifiedAlbums.push_back(internalAlbumFromId(albumId));
+        Q_EMIT albumModified(modifiedAlbums.last(), albumId);
+    }
+
+    if (!modifiedAlbums.isEmpty()) {
+        Q_EMIT albumsModified(modifiedAlbums);
+    }
+
+    if (!modifiedTracks.isEmpty()) {
+        Q_EMIT tracksModified(modifiedTracks);
+    }
+
+    QList<MusicAudioTrack> newTracks;
+    for (auto trackId : qAsConst(insertedTracks)) {
+        newTracks.push_back(internalTrackFromDatabaseId(trackId));
+    }
+
+    if (!newTracks.isEmpty()) {
+        Q_EMIT tracksAdded(newTracks);
+    }
+
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return;
+    }
+}
+
+void DatabaseInterface::removeTracksList(const QList<QUrl> &removedTracks)
+{
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    internalRemoveTracksList(removedTracks);
+
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return;
+    }
+}
+
+void DatabaseInterface::renameTracksList(const QHash<QUrl, QUrl> &renamedTracks)
+{
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    QList<MusicAudioTrack> modifiedTracks;
+
+    for (auto itRenamedTrack = renamedTracks.cbegin(); itRenamedTrack != renamedTracks.cend(); ++itRenamedTrack) {
+        const auto trackId = internalTrackIdFromFileName(itRenamedTrack.key());
+
+        d->mRenameTrackMappingQuery.bindValue(QStringLiteral(":previousFileName"), itRenamedTrack.key());
+        d->mRenameTrackMappingQuery.bindValue(QStringLiteral(":fileName"), itRenamedTrack.value());
+
+        auto queryResult = d->mRenameTrackMappingQuery.exec();
+
+        if (!queryResult || !d->mRenameTrackMappingQuery.isActive()) {
+            Q_EMIT databaseError();
+
+            qDebug() << "DatabaseInterface::renameTracksList" << d->mRenameTrackMappingQuery.lastQuery();
+            qDebug() << "DatabaseInterface::renameTracksList" << d->mRenameTrackMappingQuery.boundValues();
+            qDebug() << "DatabaseInterface::renameTracksList" << d->mRenameTrackMappingQuery.lastError();
+
+            d->mRenameTrackMappingQuery.finish();
+
+            continue;
+        }
+
+        d->mRenameTrackMappingQuery.finish();
+
+        d->mRenameTrackFileStateQuery.bindValue(QStringLiteral(":previousFileName"), itRenamedTrack.key());
+        d->mRenameTrackFileStateQuery.bindValue(QStringLiteral(":fileName"), itRenamedTrack.value());
+
+        queryResult = d->mRenameTrackFileStateQuery.exec();
+
+        if (!queryResult || !d->mRenameTrackFileStateQuery.isActive()) {
+            Q_EMIT databaseError();
+
+            qDebug() << "DatabaseInterface::renameTracksList" << d->mRenameTrackFileStateQuery.lastQuery();
+            qDebug() << "DatabaseInterface::renameTracksList" << d->mRenameTrackFileStateQuery.boundValues();
+            qDebug() << "DatabaseInterface::renameTracksList" << d->mRenameTrackFileStateQuery.lastError();
+        }
+
+        d->mRenameTrackFileStateQuery.finish();
+
+        if (trackId != 0) {
+            modifiedTracks.push_back(internalTrackFromDatabaseId(trackId));
+            Q_EMIT trackModified(modifiedTracks.last());
+        }
+    }
+
+    if (!modifiedTracks.isEmpty()) {
+        Q_EMIT tracksModified(modifiedTracks);
+    }
+
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return;
+    }
+}
+
+void DatabaseInterface::modifyTracksList(const QList<MusicAudioTrack> &modifiedTracks, const QHash<QString, QUrl> &covers,
+                                         const QString &musicSource)
+{
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return;
+    }
+
+    QSet<qulonglong> modifiedAlbumIds;
+    QList<qulonglong> newAlbumIds;
+    QList<MusicAudioTrack> changedTracks;
+
+    for (const auto &oneModifiedTrack : modifiedTracks) {
+        if (oneModifiedTrack.albumArtist().isEmpty()) {
+            continue;
+        }
+
+        bool modifyExistingTrack = internalTrackFromDatabaseId(oneModifiedTrack.databaseId()).isValid() ||
+                (internalTrackIdFromFileName(oneModifiedTrack.resourceURI()) != 0);
+
+        auto originTrackId = oneModifiedTrack.databaseId();
+        if (!originTrackId) {
+            originTrackId = internalTrackIdFromFileName(oneModifiedTrack.resourceURI());
+        }
+
+        if (!modifyExistingTrack) {
+            insertTrackOrigin(oneModifiedTrack.resourceURI(), insertMusicSource(musicSource));
+        } else {
+            updateTrackOrigin(originTrackId, oneModifiedTrack.resourceURI());
+        }
+
+        updateTrackFileState(oneModifiedTrack);
+
+        internalInsertTrack(oneModifiedTrack, covers, (modifyExistingTrack ? originTrackId : 0),
+                            modifiedAlbumIds,
+                            (modifyExistingTrack ? TrackFileInsertType::ModifiedTrackFileInsert : TrackFileInsertType::NewTrackFileInsert),
+                            newAlbumIds, changedTracks);
+    }
+
+    QList<MusicAlbum> newAlbums;
+    for (auto albumId : qAsConst(newAlbumIds)) {
+        modifiedAlbumIds.remove(albumId);
+        newAlbums.push_back(internalAlbumFromId(albumId));
+    }
+
+    if (!newAlbums.isEmpty()) {
+        Q_EMIT albumsAdded(newAlbums);
+    }
+
+    QList<MusicAlbum> modifiedAlbums;
+    for (auto albumId : qAsConst(modifiedAlbumIds)) {
+        modifiedAlbums.push_back(internalAlbumFromId(albumId));
+        Q_EMIT albumModified(modifiedAlbums.last(), albumId);
+    }
+
+    if (!modifiedAlbums.isEmpty()) {
+        Q_EMIT albumsModified(modifiedAlbums);
+    }
+
+    if (!changedTracks.isEmpty()) {
+        Q_EMIT tracksModified(changedTracks);
+    }
+
+    transactionResult = finishTransaction();
+    if (!transactionResult) {
+        return;
+    }
+}
+
+bool DatabaseInterface::startTransaction() const
+{
+    auto result = false;
+
+    auto transactionResult = d->mTracksDatabase.transaction();
+    if (!transactionResult) {
+        qDebug() << "transaction failed" << d->mTracksDatabase.lastError() << d->mTracksDatabase.lastError().driverText();
+
+        return result;
+    }
+
+    result = true;
+
+    return result;
+}
+
+bool DatabaseInterface::finishTransaction() const
 {
     auto result = false;
 
@@ -1163,19 +2154,87 @@ void DatabaseInterface::initDatabase() const
         }
     }
 
-    if (!listTables.contains(QStringLiteral("TracksMapping"))) {
+    if (!listTables.contains(QStringLiteral("TracksMapping"))) {
+        QSqlQuery createSchemaQuery(d->mTracksDatabase);
+
+        const auto &result = createSchemaQuery.exec(QStringLiteral("CREATE TABLE `TracksMapping` ("
+                                                                   "`TrackID` INTEGER NULL, "
+                                                                   "`DiscoverID` INTEGER NOT NULL, "
+                                                                   "`FileName` VARCHAR(255) NOT NULL, "
+                                                                   "`Priority` INTEGER NOT NULL, "
+                                                                   "`TrackValid` BOOLEAN NOT NULL, "
+                                                                   "PRIMARY KEY (`FileName`), "
+                                                                   "CONSTRAINT TracksUnique UNIQUE (`TrackID`, `Priority`), "
+                                                                   "CONSTRAINT fk_tracksmapping_trackID FOREIGN KEY (`TrackID`) REFERENCES `Tracks`(`ID`), "
+                                                                   "CONSTRAINT fk_tracksmapping_discoverID FOREIGN KEY (`DiscoverID`) REFERENCES `DiscoverSource`(`ID`))"));
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initDatabase" << createSchemaQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initDatabase" << createSchemaQuery.lastError();
+        }
+    }
+
+    if (!listTables.contains(QStringLiteral("DirectoriesScanProgress"))) {
+        QSqlQuery createSchemaQuery(d->mTracksDatabase);
+
+        const auto &result = createSchemaQuery.exec(QStringLiteral("CREATE TABLE `DirectoriesScanProgress` ("
+                                                                   "`DiscoverID` INTEGER NOT NULL, "
+                                                                   "`DirectoryName` VARCHAR(255) NOT NULL, "
+                                                                   "`Completed` BOOLEAN NOT NULL, "
+                                                                   "PRIMARY KEY (`DiscoverID`, `DirectoryName`), "
+                                                                   "CONSTRAINT fk_directoriesscanprogress_discoverID FOREIGN KEY (`DiscoverID`) REFERENCES `DiscoverSource`(`ID`))"));
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initDatabase" << createSchemaQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initDatabase" << createSchemaQuery.lastError();
+        }
+    }
+
+    if (!listTables.contains(QStringLiteral("TracksFileState"))) {
+        QSqlQuery createSchemaQuery(d->mTracksDatabase);
+
+        /* size and modification time of each file when its tags were read, used by incremental imports */
+        const auto &result = createSchemaQuery.exec(QStringLiteral("CREATE TABLE `TracksFileState` ("
+                                                                   "`FileName` VARCHAR(255) NOT NULL, "
+                                                                   "`FileSize` INTEGER NOT NULL, "
+                                                                   "`FileModifiedTime` INTEGER NOT NULL, "
+                                                                   "PRIMARY KEY (`FileName`))"));
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initDatabase" << createSchemaQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initDatabase" << createSchemaQuery.lastError();
+        }
+    }
+
+    if (!listTables.contains(QStringLiteral("PlayLists"))) {
+        QSqlQuery createSchemaQuery(d->mTracksDatabase);
+
+        const auto &result = createSchemaQuery.exec(QStringLiteral("CREATE TABLE `PlayLists` ("
+                                                                   "`ID` INTEGER PRIMARY KEY NOT NULL, "
+                                                                   "`Name` VARCHAR(255) NOT NULL, "
+                                                                   "UNIQUE (`Name`))"));
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initDatabase" << createSchemaQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initDatabase" << createSchemaQuery.lastError();
+        }
+    }
+
+    if (!listTables.contains(QStringLiteral("PlayListEntries"))) {
         QSqlQuery createSchemaQuery(d->mTracksDatabase);
 
-        const auto &result = createSchemaQuery.exec(QStringLiteral("CREATE TABLE `TracksMapping` ("
+        /* no foreign key on the track: an entry keeps its name to find its track again once removed */
+        const auto &result = createSchemaQuery.exec(QStringLiteral("CREATE TABLE `PlayListEntries` ("
+                                                                   "`PlayListID` INTEGER NOT NULL, "
+                                                                   "`Position` INTEGER NOT NULL, "
                                                                    "`TrackID` INTEGER NULL, "
-                                                                   "`DiscoverID` INTEGER NOT NULL, "
-                                                                   "`FileName` VARCHAR(255) NOT NULL, "
-                                                                   "`Priority` INTEGER NOT NULL, "
-                                                                   "`TrackValid` BOOLEAN NOT NULL, "
-                                                                   "PRIMARY KEY (`FileName`), "
-                                                                   "CONSTRAINT TracksUnique UNIQUE (`TrackID`, `Priority`), "
-                                                                   "CONSTRAINT fk_tracksmapping_trackID FOREIGN KEY (`TrackID`) REFERENCES `Tracks`(`ID`), "
-                                                                   "CONSTRAINT fk_tracksmapping_discoverID FOREIGN KEY (`DiscoverID`) REFERENCES `DiscoverSource`(`ID`))"));
+                                                                   "`Title` VARCHAR(85) NULL, "
+                                                                   "`Artist` VARCHAR(85) NULL, "
+                                                                   "`AlbumTitle` VARCHAR(85) NULL, "
+                                                                   "`TrackNumber` INTEGER NULL, "
+                                                                   "`DiscNumber` INTEGER NULL, "
+                                                                   "`FileName` VARCHAR(255) NULL, "
+                                                                   "CONSTRAINT fk_playlistentries_playListID FOREIGN KEY (`PlayListID`) REFERENCES `PlayLists`(`ID`))"));
 
         if (!result) {
             qDebug() << "DatabaseInterface::initDatabase" << createSchemaQuery.lastQuery();
@@ -1183,6 +2242,20 @@ void DatabaseInterface::initDatabase() const
         }
     }
 
+    {
+        QSqlQuery createTrackIndex(d->mTracksDatabase);
+
+        const auto &result = createTrackIndex.exec(QStringLiteral("CREATE INDEX "
+                                                                  "IF NOT EXISTS "
+                                                                  "`PlayListEntriesPositionIndex` ON `PlayListEntries` "
+                                                                  "(`PlayListID`, `Position`)"));
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initDatabase" << createTrackIndex.lastQuery();
+            qDebug() << "DatabaseInterface::initDatabase" << createTrackIndex.lastError();
+        }
+    }
+
     {
         QSqlQuery createTrackIndex(d->mTracksDatabase);
 
@@ -1321,15 +2394,81 @@ void DatabaseInterface::initRequest()
                                                   "albumArtist.`AlbumID` = album.`ID` "
                                                   "LEFT JOIN `Artists` artist "
                                                   "ON "
-                                                  "albumArtist.`ArtistID` = artist.`ID` "
-                                                  "ORDER BY album.`Title`");
+                                                  "albumArtist.`ArtistID` = artist.`ID` ");
 
-        auto result = d->mSelectAllAlbumsQuery.prepare(selectAllAlbumsText);
+        auto result = d->mSelectAllAlbumsQuery.prepare(selectAllAlbumsText + QStringLiteral("ORDER BY album.`Title`"));
 
         if (!result) {
             qDebug() << "DatabaseInterface::initRequest" << d->mSelectAllAlbumsQuery.lastQuery();
             qDebug() << "DatabaseInterface::initRequest" << d->mSelectAllAlbumsQuery.lastError();
         }
+
+        result = d->mSelectAlbumsPageQuery.prepare(selectAllAlbumsText + QStringLiteral("WHERE album.`ID` > :afterId "
+                                                                                        "ORDER BY album.`ID` "
+                                                                                        "LIMIT :count"));
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectAlbumsPageQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectAlbumsPageQuery.lastError();
+        }
+
+        result = d->mSelectAlbumsCountQuery.prepare(QStringLiteral("SELECT count(*), (SELECT max(`ID`) FROM `Albums`) FROM (") +
+                                                    selectAllAlbumsText + QStringLiteral(")"));
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectAlbumsCountQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectAlbumsCountQuery.lastError();
+        }
+    }
+
+    {
+        auto selectAllAlbumsTracksIdsText = QStringLiteral("SELECT "
+                                                           "tracks.`ID` "
+                                                           "FROM "
+                                                           "`Tracks` tracks, `Albums` album "
+                                                           "WHERE "
+                                                           "tracks.`AlbumID` = album.`ID` "
+                                                           "ORDER BY album.`ID` ASC, "
+                                                           "tracks.`DiscNumber` ASC, "
+                                                           "tracks.`TrackNumber` ASC");
+
+        auto result = d->mSelectAllAlbumsTracksIdsQuery.prepare(selectAllAlbumsTracksIdsText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectAllAlbumsTracksIdsQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectAllAlbumsTracksIdsQuery.lastError();
+        }
+    }
+
+    {
+        auto selectAlbumIdsFromAnyArtistText = QStringLiteral("SELECT "
+                                                              "album.`ID` "
+                                                              "FROM "
+                                                              "`Albums` album, "
+                                                              "`Artists` artist, "
+                                                              "`AlbumsArtists` albumArtist "
+                                                              "WHERE "
+                                                              "album.`ID` = albumArtist.`AlbumID` AND "
+                                                              "artist.`ID` = albumArtist.`ArtistID` AND "
+                                                              "artist.`Name` = :artistName "
+                                                              "UNION "
+                                                              "SELECT "
+                                                              "tracks.`AlbumID` "
+                                                              "FROM "
+                                                              "`Tracks` tracks, "
+                                                              "`Artists` artist, "
+                                                              "`TracksArtists` trackArtist "
+                                                              "WHERE "
+                                                              "tracks.`ID` = trackArtist.`TrackID` AND "
+                                                              "artist.`ID` = trackArtist.`ArtistID` AND "
+                                                              "artist.`Name` = :artistName");
+
+        auto result = d->mSelectAlbumIdsFromAnyArtistQuery.prepare(selectAlbumIdsFromAnyArtistText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectAlbumIdsFromAnyArtistQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectAlbumIdsFromAnyArtistQuery.lastError();
+        }
     }
 
     {
@@ -1345,6 +2484,90 @@ void DatabaseInterface::initRequest()
         }
     }
 
+    {
+        auto selectArtistsPageText = QStringLiteral("SELECT artist.`ID`, "
+                                                    "artist.`Name`, "
+                                                    "(SELECT count(*) FROM `AlbumsArtists` albumArtist WHERE albumArtist.`ArtistID` = artist.`ID`) "
+                                                    "FROM `Artists` artist "
+                                                    "WHERE artist.`ID` > :afterId "
+                                                    "ORDER BY artist.`ID` "
+                                                    "LIMIT :count");
+
+        auto result = d->mSelectArtistsPageQuery.prepare(selectArtistsPageText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectArtistsPageQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectArtistsPageQuery.lastError();
+        }
+    }
+
+    {
+        /* pages whose previous page was never read skip rows on the primary key only */
+        auto selectTracksPageStartText = QStringLiteral("SELECT `ID` "
+                                                        "FROM `Tracks` "
+                                                        "WHERE `ID` > :afterId "
+                                                        "ORDER BY `ID` "
+                                                        "LIMIT 1 OFFSET :skippedCount");
+
+        auto result = d->mSelectTracksPageStartQuery.prepare(selectTracksPageStartText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectTracksPageStartQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectTracksPageStartQuery.lastError();
+        }
+
+        auto selectAlbumsPageStartText = QStringLiteral("SELECT `ID` "
+                                                        "FROM `Albums` "
+                                                        "WHERE `ID` > :afterId "
+                                                        "ORDER BY `ID` "
+                                                        "LIMIT 1 OFFSET :skippedCount");
+
+        result = d->mSelectAlbumsPageStartQuery.prepare(selectAlbumsPageStartText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectAlbumsPageStartQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectAlbumsPageStartQuery.lastError();
+        }
+
+        auto selectArtistsPageStartText = QStringLiteral("SELECT `ID` "
+                                                         "FROM `Artists` "
+                                                         "WHERE `ID` > :afterId "
+                                                         "ORDER BY `ID` "
+                                                         "LIMIT 1 OFFSET :skippedCount");
+
+        result = d->mSelectArtistsPageStartQuery.prepare(selectArtistsPageStartText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectArtistsPageStartQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectArtistsPageStartQuery.lastError();
+        }
+    }
+
+    {
+        auto selectArtistsCountText = QStringLiteral("SELECT count(*), max(`ID`) "
+                                                     "FROM `Artists`");
+
+        auto result = d->mSelectArtistsCountQuery.prepare(selectArtistsCountText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectArtistsCountQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectArtistsCountQuery.lastError();
+        }
+    }
+
+    {
+        auto selectAllArtistsNamesText = QStringLiteral("SELECT `Name` "
+                                                        "FROM `Artists` "
+                                                        "ORDER BY `ID`");
+
+        auto result = d->mSelectAllArtistsNamesQuery.prepare(selectAllArtistsNamesText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectAllArtistsNamesQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectAllArtistsNamesQuery.lastError();
+        }
+    }
+
     {
         auto selectAllTracksText = QStringLiteral("SELECT "
                                                   "tracks.`ID`, "
@@ -1386,6 +2609,32 @@ void DatabaseInterface::initRequest()
             qDebug() << "DatabaseInterface::initRequest" << d->mSelectAllTracksQuery.lastQuery();
             qDebug() << "DatabaseInterface::initRequest" << d->mSelectAllTracksQuery.lastError();
         }
+
+        result = d->mSelectTracksPageQuery.prepare(selectAllTracksText + QStringLiteral(" AND tracks.`ID` > :afterId "
+                                                                                        "ORDER BY tracks.`ID` "
+                                                                                        "LIMIT :count"));
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectTracksPageQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectTracksPageQuery.lastError();
+        }
+
+        result = d->mSelectTracksCountQuery.prepare(QStringLiteral("SELECT count(*), (SELECT max(`ID`) FROM `Tracks`) FROM (") +
+                                                    selectAllTracksText + QStringLiteral(")"));
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectTracksCountQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectTracksCountQuery.lastError();
+        }
+
+        /* same rows and order as the tracks pages */
+        result = d->mSelectAllTracksIdsQuery.prepare(QStringLiteral("SELECT `ID` FROM (") +
+                                                     selectAllTracksText + QStringLiteral(") ORDER BY `ID`"));
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectAllTracksIdsQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectAllTracksIdsQuery.lastError();
+        }
     }
 
     {
@@ -1550,6 +2799,54 @@ void DatabaseInterface::initRequest()
             qDebug() << "DatabaseInterface::initRequest" << d->mSelectTrackQuery.lastError();
         }
     }
+
+    {
+        auto selectTracksFromAlbumsRangeQueryText = QStringLiteral("SELECT "
+                                                                   "tracks.`ID`, "
+                                                                   "tracks.`Title`, "
+                                                                   "tracks.`AlbumID`, "
+                                                                   "artist.`Name`, "
+                                                                   "artistAlbum.`Name`, "
+                                                                   "tracksMapping.`FileName`, "
+                                                                   "tracks.`TrackNumber`, "
+                                                                   "tracks.`DiscNumber`, "
+                                                                   "tracks.`Duration`, "
+                                                                   "album.`Title`, "
+                                                                   "tracks.`Rating`, "
+                                                                   "album.`CoverFileName`, "
+                                                                   "album.`IsSingleDiscAlbum`, "
+                                                                   "tracks.`Genre`, "
+                                                                   "tracks.`Composer`, "
+                                                                   "tracks.`Lyricist`, "
+                                                                   "tracks.`Comment`, "
+                                                                   "tracks.`Year`, "
+                                                                   "tracks.`Channels`, "
+                                                                   "tracks.`BitRate`, "
+                                                                   "tracks.`SampleRate` "
+                                                                   "FROM "
+                                                                   "`Tracks` tracks, `Artists` artist, `TracksArtists` trackArtist, "
+                                                                   "`Albums` album, `TracksMapping` tracksMapping "
+                                                                   "LEFT JOIN `AlbumsArtists` artistAlbumMapping ON artistAlbumMapping.`AlbumID` = album.`ID` "
+                                                                   "LEFT JOIN `Artists` artistAlbum ON artistAlbum.`ID` = artistAlbumMapping.`ArtistID` "
+                                                                   "WHERE "
+                                                                   "tracks.`ID` = trackArtist.`TrackID` AND "
+                                                                   "artist.`ID` = trackArtist.`ArtistID` AND "
+                                                                   "tracksMapping.`TrackID` = tracks.`ID` AND "
+                                                                   "tracks.`AlbumID` >= :firstAlbumId AND "
+                                                                   "tracks.`AlbumID` <= :lastAlbumId AND "
+                                                                   "album.`ID` = tracks.`AlbumID` AND "
+                                                                   "tracksMapping.`Priority` = (SELECT MIN(`Priority`) FROM `TracksMapping` WHERE `TrackID` = tracks.`ID`) "
+                                                                   "ORDER BY tracks.`AlbumID` ASC, "
+                                                                   "tracks.`DiscNumber` ASC, "
+                                                                   "tracks.`TrackNumber` ASC");
+
+        auto result = d->mSelectTracksFromAlbumsRangeQuery.prepare(selectTracksFromAlbumsRangeQueryText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectTracksFromAlbumsRangeQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectTracksFromAlbumsRangeQuery.lastError();
+        }
+    }
     {
         auto selectTrackFromIdQueryText = QStringLiteral("SELECT "
                                                          "tracks.`Id`, "
@@ -2197,76 +3494,361 @@ void DatabaseInterface::initRequest()
                                                                "tracksMapping.`FileName` = :filePath AND "
                                                                "tracksMapping.`Priority` = (SELECT MIN(`Priority`) FROM `TracksMapping` WHERE `TrackID` = tracks.`ID`)");
 
-        auto result = d->mSelectTrackFromFilePathQuery.prepare(selectTrackFromFilePathQueryText);
+        auto result = d->mSelectTrackFromFilePathQuery.prepare(selectTrackFromFilePathQueryText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectTrackFromFilePathQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectTrackFromFilePathQuery.lastError();
+        }
+    }
+
+    {
+        auto removeTrackQueryText = QStringLiteral("DELETE FROM `Tracks` "
+                                                   "WHERE "
+                                                   "`ID` = :trackId");
+
+        auto result = d->mRemoveTrackQuery.prepare(removeTrackQueryText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveTrackQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveTrackQuery.lastError();
+        }
+    }
+
+    {
+        auto removeTrackArtistQueryText = QStringLiteral("DELETE FROM `TracksArtists` "
+                                                         "WHERE "
+                                                         "`TrackID` = :trackId");
+
+        auto result = d->mRemoveTrackArtistQuery.prepare(removeTrackArtistQueryText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveTrackArtistQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveTrackArtistQuery.lastError();
+        }
+    }
+
+    {
+        auto removeAlbumQueryText = QStringLiteral("DELETE FROM `Albums` "
+                                                   "WHERE "
+                                                   "`ID` = :albumId");
+
+        auto result = d->mRemoveAlbumQuery.prepare(removeAlbumQueryText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveAlbumQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveAlbumQuery.lastError();
+        }
+    }
+
+    {
+        auto removeAlbumArtistQueryText = QStringLiteral("DELETE FROM `AlbumsArtists` "
+                                                         "WHERE "
+                                                         "`AlbumID` = :albumId");
+
+        auto result = d->mRemoveAlbumArtistQuery.prepare(removeAlbumArtistQueryText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveAlbumArtistQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveAlbumArtistQuery.lastError();
+        }
+    }
+
+    {
+        auto removeAlbumQueryText = QStringLiteral("DELETE FROM `Artists` "
+                                                   "WHERE "
+                                                   "`ID` = :artistId");
+
+        auto result = d->mRemoveArtistQuery.prepare(removeAlbumQueryText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveArtistQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveArtistQuery.lastError();
+        }
+    }
+
+    {
+        auto insertScanProgressQueryText = QStringLiteral("INSERT OR REPLACE INTO `DirectoriesScanProgress` (`DiscoverID`, `DirectoryName`, `Completed`) "
+                                                          "VALUES (:discoverId, :directoryName, :completed)");
+
+        auto result = d->mInsertScanProgressQuery.prepare(insertScanProgressQueryText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mInsertScanProgressQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mInsertScanProgressQuery.lastError();
+        }
+    }
+
+    {
+        auto removeScanProgressQueryText = QStringLiteral("DELETE FROM `DirectoriesScanProgress` "
+                                                          "WHERE "
+                                                          "`DiscoverID` = :discoverId");
+
+        auto result = d->mRemoveScanProgressQuery.prepare(removeScanProgressQueryText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveScanProgressQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveScanProgressQuery.lastError();
+        }
+    }
+
+    {
+        auto selectCompletedScanDirectoriesQueryText = QStringLiteral("SELECT "
+                                                                      "`DirectoryName` "
+                                                                      "FROM "
+                                                                      "`DirectoriesScanProgress` "
+                                                                      "WHERE "
+                                                                      "`DiscoverID` = :discoverId AND "
+                                                                      "`Completed` = 1");
+
+        auto result = d->mSelectCompletedScanDirectoriesQuery.prepare(selectCompletedScanDirectoriesQueryText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectCompletedScanDirectoriesQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectCompletedScanDirectoriesQuery.lastError();
+        }
+    }
+
+    {
+        auto updateTracksValidityInDirectoryQueryText = QStringLiteral("UPDATE `TracksMapping` "
+                                                                       "SET `TrackValid` = 1 "
+                                                                       "WHERE "
+                                                                       "`DiscoverID` = :discoverId AND "
+                                                                       "`FileName` >= :directoryPrefix AND "
+                                                                       "`FileName` < :directoryPrefixEnd");
+
+        auto result = d->mUpdateTracksValidityInDirectoryQuery.prepare(updateTracksValidityInDirectoryQueryText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mUpdateTracksValidityInDirectoryQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mUpdateTracksValidityInDirectoryQuery.lastError();
+        }
+    }
+
+    {
+        auto renameTrackMappingQueryText = QStringLiteral("UPDATE OR REPLACE `TracksMapping` "
+                                                          "SET `FileName` = :fileName, `TrackValid` = 1 "
+                                                          "WHERE `FileName` = :previousFileName");
+
+        auto result = d->mRenameTrackMappingQuery.prepare(renameTrackMappingQueryText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mRenameTrackMappingQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mRenameTrackMappingQuery.lastError();
+        }
+    }
+
+    {
+        auto selectKnownTrackFilesFromSourceQueryText = QStringLiteral("SELECT "
+                                                                       "tracksMapping.`FileName`, "
+                                                                       "fileState.`FileSize`, "
+                                                                       "fileState.`FileModifiedTime` "
+                                                                       "FROM "
+                                                                       "`TracksMapping` tracksMapping "
+                                                                       "LEFT JOIN `TracksFileState` fileState "
+                                                                       "ON fileState.`FileName` = tracksMapping.`FileName` "
+                                                                       "WHERE "
+                                                                       "tracksMapping.`DiscoverID` = :discoverId");
+
+        auto result = d->mSelectKnownTrackFilesFromSourceQuery.prepare(selectKnownTrackFilesFromSourceQueryText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectKnownTrackFilesFromSourceQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectKnownTrackFilesFromSourceQuery.lastError();
+        }
+    }
+
+    {
+        auto updateTrackFileStateQueryText = QStringLiteral("INSERT OR REPLACE INTO `TracksFileState` "
+                                                            "(`FileName`, `FileSize`, `FileModifiedTime`) "
+                                                            "VALUES (:fileName, :fileSize, :fileModifiedTime)");
+
+        auto result = d->mUpdateTrackFileStateQuery.prepare(updateTrackFileStateQueryText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mUpdateTrackFileStateQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mUpdateTrackFileStateQuery.lastError();
+        }
+    }
+
+    {
+        auto removeTrackFileStateQueryText = QStringLiteral("DELETE FROM `TracksFileState` "
+                                                            "WHERE `FileName` = :fileName");
+
+        auto result = d->mRemoveTrackFileStateQuery.prepare(removeTrackFileStateQueryText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveTrackFileStateQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveTrackFileStateQuery.lastError();
+        }
+    }
+
+    {
+        auto renameTrackFileStateQueryText = QStringLiteral("UPDATE OR REPLACE `TracksFileState` "
+                                                            "SET `FileName` = :fileName "
+                                                            "WHERE `FileName` = :previousFileName");
+
+        auto result = d->mRenameTrackFileStateQuery.prepare(renameTrackFileStateQueryText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mRenameTrackFileStateQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mRenameTrackFileStateQuery.lastError();
+        }
+    }
+
+    {
+        auto updateTracksValidityFromSourceQueryText = QStringLiteral("UPDATE `TracksMapping` "
+                                                                      "SET `TrackValid` = 1 "
+                                                                      "WHERE "
+                                                                      "`DiscoverID` = :discoverId");
+
+        auto result = d->mUpdateTracksValidityFromSourceQuery.prepare(updateTracksValidityFromSourceQueryText);
 
         if (!result) {
-            qDebug() << "DatabaseInterface::initRequest" << d->mSelectTrackFromFilePathQuery.lastQuery();
-            qDebug() << "DatabaseInterface::initRequest" << d->mSelectTrackFromFilePathQuery.lastError();
+            qDebug() << "DatabaseInterface::initRequest" << d->mUpdateTracksValidityFromSourceQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mUpdateTracksValidityFromSourceQuery.lastError();
         }
     }
 
     {
-        auto removeTrackQueryText = QStringLiteral("DELETE FROM `Tracks` "
-                                                   "WHERE "
-                                                   "`ID` = :trackId");
+        auto selectPlayListIdQueryText = QStringLiteral("SELECT "
+                                                        "`ID` "
+                                                        "FROM `PlayLists` "
+                                                        "WHERE "
+                                                        "`Name` = :name");
 
-        auto result = d->mRemoveTrackQuery.prepare(removeTrackQueryText);
+        auto result = d->mSelectPlayListIdQuery.prepare(selectPlayListIdQueryText);
 
         if (!result) {
-            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveTrackQuery.lastQuery();
-            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveTrackQuery.lastError();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectPlayListIdQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectPlayListIdQuery.lastError();
         }
     }
 
     {
-        auto removeTrackArtistQueryText = QStringLiteral("DELETE FROM `TracksArtists` "
-                                                         "WHERE "
-                                                         "`TrackID` = :trackId");
+        auto insertPlayListQueryText = QStringLiteral("INSERT INTO `PlayLists` (`Name`) "
+                                                      "VALUES (:name)");
 
-        auto result = d->mRemoveTrackArtistQuery.prepare(removeTrackArtistQueryText);
+        auto result = d->mInsertPlayListQuery.prepare(insertPlayListQueryText);
 
         if (!result) {
-            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveTrackArtistQuery.lastQuery();
-            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveTrackArtistQuery.lastError();
+            qDebug() << "DatabaseInterface::initRequest" << d->mInsertPlayListQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mInsertPlayListQuery.lastError();
         }
     }
 
     {
-        auto removeAlbumQueryText = QStringLiteral("DELETE FROM `Albums` "
-                                                   "WHERE "
-                                                   "`ID` = :albumId");
+        auto insertPlayListEntryQueryText = QStringLiteral("INSERT INTO `PlayListEntries` "
+                                                           "(`PlayListID`, `Position`, `TrackID`, `Title`, `Artist`, "
+                                                           "`AlbumTitle`, `TrackNumber`, `DiscNumber`, `FileName`) "
+                                                           "VALUES (:playListId, :position, :trackId, :title, :artist, "
+                                                           ":albumTitle, :trackNumber, :discNumber, :fileName)");
 
-        auto result = d->mRemoveAlbumQuery.prepare(removeAlbumQueryText);
+        auto result = d->mInsertPlayListEntryQuery.prepare(insertPlayListEntryQueryText);
 
         if (!result) {
-            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveAlbumQuery.lastQuery();
-            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveAlbumQuery.lastError();
+            qDebug() << "DatabaseInterface::initRequest" << d->mInsertPlayListEntryQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mInsertPlayListEntryQuery.lastError();
         }
     }
 
     {
-        auto removeAlbumArtistQueryText = QStringLiteral("DELETE FROM `AlbumsArtists` "
-                                                         "WHERE "
-                                                         "`AlbumID` = :albumId");
+        auto selectPlayListEntryPositionsQueryText = QStringLiteral("SELECT "
+                                                                    "`rowid`, "
+                                                                    "`Position` "
+                                                                    "FROM `PlayListEntries` "
+                                                                    "WHERE "
+                                                                    "`PlayListID` = :playListId "
+                                                                    "ORDER BY `Position` "
+                                                                    "LIMIT :count OFFSET :firstRow");
 
-        auto result = d->mRemoveAlbumArtistQuery.prepare(removeAlbumArtistQueryText);
+        auto result = d->mSelectPlayListEntryPositionsQuery.prepare(selectPlayListEntryPositionsQueryText);
 
         if (!result) {
-            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveAlbumArtistQuery.lastQuery();
-            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveAlbumArtistQuery.lastError();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectPlayListEntryPositionsQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectPlayListEntryPositionsQuery.lastError();
         }
     }
 
     {
-        auto removeAlbumQueryText = QStringLiteral("DELETE FROM `Artists` "
-                                                   "WHERE "
-                                                   "`ID` = :artistId");
+        auto updatePlayListEntryPositionQueryText = QStringLiteral("UPDATE `PlayListEntries` "
+                                                                   "SET `Position` = :position "
+                                                                   "WHERE "
+                                                                   "`rowid` = :entryId");
 
-        auto result = d->mRemoveArtistQuery.prepare(removeAlbumQueryText);
+        auto result = d->mUpdatePlayListEntryPositionQuery.prepare(updatePlayListEntryPositionQueryText);
 
         if (!result) {
-            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveArtistQuery.lastQuery();
-            qDebug() << "DatabaseInterface::initRequest" << d->mRemoveArtistQuery.lastError();
+            qDebug() << "DatabaseInterface::initRequest" << d->mUpdatePlayListEntryPositionQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mUpdatePlayListEntryPositionQuery.lastError();
+        }
+    }
+
+    {
+        auto removePlayListEntriesQueryText = QStringLiteral("DELETE FROM `PlayListEntries` "
+                                                             "WHERE "
+                                                             "`rowid` IN ("
+                                                             "SELECT `rowid` "
+                                                             "FROM `PlayListEntries` "
+                                                             "WHERE "
+                                                             "`PlayListID` = :playListId "
+                                                             "ORDER BY `Position` "
+                                                             "LIMIT :count OFFSET :firstRow)");
+
+        auto result = d->mRemovePlayListEntriesQuery.prepare(removePlayListEntriesQueryText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mRemovePlayListEntriesQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mRemovePlayListEntriesQuery.lastError();
+        }
+    }
+
+    {
+        auto updatePlayListEntryQueryText = QStringLiteral("UPDATE `PlayListEntries` "
+                                                           "SET "
+                                                           "`TrackID` = :trackId, "
+                                                           "`Title` = :title, "
+                                                           "`Artist` = :artist, "
+                                                           "`AlbumTitle` = :albumTitle, "
+                                                           "`TrackNumber` = :trackNumber, "
+                                                           "`DiscNumber` = :discNumber, "
+                                                           "`FileName` = :fileName "
+                                                           "WHERE "
+                                                           "`rowid` = ("
+                                                           "SELECT `rowid` "
+                                                           "FROM `PlayListEntries` "
+                                                           "WHERE "
+                                                           "`PlayListID` = :playListId "
+                                                           "ORDER BY `Position` "
+                                                           "LIMIT 1 OFFSET :row)");
+
+        auto result = d->mUpdatePlayListEntryQuery.prepare(updatePlayListEntryQueryText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mUpdatePlayListEntryQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mUpdatePlayListEntryQuery.lastError();
+        }
+    }
+
+    {
+        auto selectPlayListEntriesQueryText = QStringLiteral("SELECT "
+                                                             "`TrackID`, "
+                                                             "`Title`, "
+                                                             "`Artist`, "
+                                                             "`AlbumTitle`, "
+                                                             "`TrackNumber`, "
+                                                             "`DiscNumber`, "
+                                                             "`FileName` "
+                                                             "FROM `PlayListEntries` "
+                                                             "WHERE "
+                                                             "`PlayListID` = :playListId "
+                                                             "ORDER BY `Position`");
+
+        auto result = d->mSelectPlayListEntriesQuery.prepare(selectPlayListEntriesQueryText);
+
+        if (!result) {
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectPlayListEntriesQuery.lastQuery();
+            qDebug() << "DatabaseInterface::initRequest" << d->mSelectPlayListEntriesQuery.lastError();
         }
     }
 
@@ -2665,7 +4247,7 @@ int DatabaseInterface::computeTrackPriority(qulonglong trackId, const QUrl &file
 
 qulonglong DatabaseInterface::internalInsertTrack(const MusicAudioTrack &oneTrack, const QHash<QString, QUrl> &covers,
                                                   int originTrackId, QSet<qulonglong> &modifiedAlbumIds, TrackFileInsertType insertType,
-                                                  QList<qulonglong> &newAlbumIds)
+                                                  QList<qulonglong> &newAlbumIds, QList<MusicAudioTrack> &modifiedTracks)
 {
     qulonglong resultId = 0;
 
@@ -2774,7 +4356,8 @@ qulonglong DatabaseInterface::internalInsertTrack(const MusicAudioTrack &oneTrac
             updateTrackOrigin(originTrackId, oneTrack.resourceURI());
 
             if (isModifiedTrack) {
-                Q_EMIT trackModified(internalTrackFromDatabaseId(originTrackId));
+                modifiedTracks.push_back(internalTrackFromDatabaseId(originTrackId));
+                Q_EMIT trackModified(modifiedTracks.last());
                 modifiedAlbumIds.insert(albumId);
                 if (oldAlbumId != 0) {
                     modifiedAlbumIds.insert(oldAlbumId);
@@ -2858,6 +4441,8 @@ void DatabaseInterface::internalRemoveTracksList(const QList<QUrl> &removedTrack
         }
 
         d->mRemoveTracksMapping.finish();
+
+        removeTrackFileState(removedTrackFileName);
     }
 
     internalRemoveTracksWithoutMapping();
@@ -2882,11 +4467,53 @@ void DatabaseInterface::internalRemoveTracksList(const QList<QUrl> &removedTrack
         }
 
         d->mRemoveTracksMappingFromSource.finish();
+
+        removeTrackFileState(removedTrackFileName);
     }
 
     internalRemoveTracksWithoutMapping();
 }
 
+void DatabaseInterface::updateTrackFileState(const MusicAudioTrack &track)
+{
+    if (track.fileSize() < 0 || track.fileModificationTime() < 0) {
+        return;
+    }
+
+    d->mUpdateTrackFileStateQuery.bindValue(QStringLiteral(":fileName"), track.resourceURI());
+    d->mUpdateTrackFileStateQuery.bindValue(QStringLiteral(":fileSize"), track.fileSize());
+    d->mUpdateTrackFileStateQuery.bindValue(QStringLiteral(":fileModifiedTime"), track.fileModificationTime());
+
+    auto queryResult = d->mUpdateTrackFileStateQuery.exec();
+
+    if (!queryResult || !d->mUpdateTrackFileStateQuery.isActive()) {
+        Q_EMIT databaseError();
+
+        qDebug() << "DatabaseInterface::updateTrackFileState" << d->mUpdateTrackFileStateQuery.lastQuery();
+        qDebug() << "DatabaseInterface::updateTrackFileState" << d->mUpdateTrackFileStateQuery.boundValues();
+        qDebug() << "DatabaseInterface::updateTrackFileState" << d->mUpdateTrackFileStateQuery.lastError();
+    }
+
+    d->mUpdateTrackFileStateQuery.finish();
+}
+
+void DatabaseInterface::removeTrackFileState(const QUrl &fileName)
+{
+    d->mRemoveTrackFileStateQuery.bindValue(QStringLiteral(":fileName"), fileName.toString());
+
+    auto queryResult = d->mRemoveTrackFileStateQuery.exec();
+
+    if (!queryResult || !d->mRemoveTrackFileStateQuery.isActive()) {
+        Q_EMIT databaseError();
+
+        qDebug() << "DatabaseInterface::removeTrackFileState" << d->mRemoveTrackFileStateQuery.lastQuery();
+        qDebug() << "DatabaseInterface::removeTrackFileState" << d->mRemoveTrackFileStateQuery.boundValues();
+        qDebug() << "DatabaseInterface::removeTrackFileState" << d->mRemoveTrackFileStateQuery.lastError();
+    }
+
+    d->mRemoveTrackFileStateQuery.finish();
+}
+
 void DatabaseInterface::internalRemoveTracksWithoutMapping()
 {
     auto queryResult = d->mSelectTracksWithoutMappingQuery.exec();
@@ -2914,10 +4541,17 @@ void DatabaseInterface::internalRemoveTracksWithoutMapping()
     d->mSelectTracksWithoutMappingQuery.finish();
 
     QSet<qulonglong> modifiedAlbums;
+    QList<qulonglong> removedTracksIds;
+    QList<MusicArtist> removedArtists;
+    QList<MusicAlbum> removedAlbums;
+    QList<MusicAlbum> changedAlbums;
+
+    removedTracksIds.reserve(willRemoveTrack.size());
 
     for (const auto &oneRemovedTrack : willRemoveTrack) {
         removeTrackInDatabase(oneRemovedTrack.databaseId());
 
+        removedTracksIds.push_back(oneRemovedTrack.databaseId());
         Q_EMIT trackRemoved(oneRemovedTrack.databaseId());
 
         const auto &modifiedAlbumId = internalAlbumIdFromTitleAndArtist(oneRemovedTrack.albumName(), oneRemovedTrack.albumArtist());
@@ -2933,6 +4567,7 @@ void DatabaseInterface::internalRemoveTracksWithoutMapping()
 
         if (allTracksFromArtist.isEmpty() && allAlbumsFromArtist.isEmpty()) {
             removeArtistInDatabase(removedArtistId);
+            removedArtists.push_back(removedArtist);
             Q_EMIT artistRemoved(removedArtist);
         }
     }
@@ -2941,9 +4576,11 @@ void DatabaseInterface::internalRemoveTracksWithoutMapping()
         auto modifiedAlbum = internalAlbumFromId(modifiedAlbumId);
 
         if (modifiedAlbum.isValid() && !modifiedAlbum.isEmpty()) {
+            changedAlbums.push_back(modifiedAlbum);
             Q_EMIT albumModified(modifiedAlbum, modifiedAlbumId);
         } else {
             removeAlbumInDatabase(modifiedAlbum.databaseId());
+            removedAlbums.push_back(modifiedAlbum);
             Q_EMIT albumRemoved(modifiedAlbum, modifiedAlbumId);
 
             const auto &allTracksFromArtist = internalTracksFromAuthor(modifiedAlbum.artist());
@@ -2953,10 +4590,27 @@ void DatabaseInterface::internalRemoveTracksWithoutMapping()
 
             if (allTracksFromArtist.isEmpty() && allAlbumsFromArtist.isEmpty()) {
                 removeArtistInDatabase(removedArtistId);
+                removedArtists.push_back(removedArtist);
                 Q_EMIT artistRemoved(removedArtist);
             }
         }
     }
+
+    if (!removedTracksIds.isEmpty()) {
+        Q_EMIT tracksRemoved(removedTracksIds);
+    }
+
+    if (!changedAlbums.isEmpty()) {
+        Q_EMIT albumsModified(changedAlbums);
+    }
+
+    if (!removedAlbums.isEmpty()) {
+        Q_EMIT albumsRemoved(removedAlbums);
+    }
+
+    if (!removedArtists.isEmpty()) {
+        Q_EMIT artistsRemoved(removedArtists);
+    }
 }
 
 QUrl DatabaseInterface::internalAlbumArtUriFromAlbumId(qulonglong albumId)
@@ -3156,6 +4810,24 @@ void DatabaseInterface::reloadExistingDatabase()
         return;
     }
 
+    if (d->mPagedCollection) {
+        /* the models ask for the pages of rows they show, only the size of the collection is sent now */
+        const auto artistsCount = internalCountAndMaximumId(d->mSelectArtistsCountQuery, d->mArtistId);
+        ++d->mArtistId;
+
+        const auto albumsCount = internalCountAndMaximumId(d->mSelectAlbumsCountQuery, d->mAlbumId);
+        ++d->mAlbumId;
+
+        const auto tracksCount = internalCountAndMaximumId(d->mSelectTracksCountQuery, d->mTrackId);
+        ++d->mTrackId;
+
+        Q_EMIT sentArtistsCount(artistsCount);
+        Q_EMIT sentAlbumsCount(albumsCount);
+        Q_EMIT sentTracksCount(tracksCount);
+
+        return;
+    }
+
     const auto restoredArtists = allArtists();
     for (const auto &oneArtist : restoredArtists) {
         d->mArtistId = std::max(d->mArtistId, oneArtist.databaseId());
@@ -3183,6 +4855,41 @@ void DatabaseInterface::reloadExistingDatabase()
     }
 }
 
+int DatabaseInterface::internalCountAndMaximumId(QSqlQuery &countQuery, qulonglong &maximumId)
+{
+    auto result = 0;
+
+    auto transactionResult = startTransaction();
+    if (!transactionResult) {
+        return result;
+    }
+
+    auto queryResult = countQuery.exec();
+
+    if (!queryResult || !countQuery.isSelect() || !countQuery.isActive() || !countQuery.next()) {
+        Q_EMIT databaseError();
+
+        qDebug() << "DatabaseInterface::internalCountAndMaximumId" << countQuery.lastQuery();
+        qDebug() << "DatabaseInterface::internalCountAndMaximumId" << countQuery.boundValues();
+        qDebug() << "DatabaseInterface::internalCountAndMaximumId" << countQuery.lastError();
+
+        countQuery.finish();
+
+        finishTransaction();
+
+        return result;
+    }
+
+    result = countQuery.record().value(0).toInt();
+    maximumId = std::max(maximumId, countQuery.record().value(1).toULongLong());
+
+    countQuery.finish();
+
+    finishTransaction();
+
+    return result;
+}
+
 qulonglong DatabaseInterface::insertMusicSource(const QString &name)
 {
     qulonglong result = 0;
@@ -3237,6 +4944,210 @@ qulonglong DatabaseInterface::insertMusicSource(const QString &name)
     return d->mDiscoverId - 1;
 }
 
+qulonglong DatabaseInterface::insertPlayList(const QString &name)
+{
+    qulonglong result = 0;
+
+    d->mSelectPlayListIdQuery.bindValue(QStringLiteral(":name"), name);
+
+    auto queryResult = d->mSelectPlayListIdQuery.exec();
+
+    if (!queryResult || !d->mSelectPlayListIdQuery.isSelect() || !d->mSelectPlayListIdQuery.isActive()) {
+        Q_EMIT databaseError();
+
+        qDebug() << "DatabaseInterface::insertPlayList" << d->mSelectPlayListIdQuery.lastQuery();
+        qDebug() << "DatabaseInterface::insertPlayList" << d->mSelectPlayListIdQuery.boundValues();
+        qDebug() << "DatabaseInterface::insertPlayList" << d->mSelectPlayListIdQuery.lastError();
+
+        d->mSelectPlayListIdQuery.finish();
+
+        return result;
+    }
+
+    if (d->mSelectPlayListIdQuery.next()) {
+        result = d->mSelectPlayListIdQuery.record().value(0).toULongLong();
+
+        d->mSelectPlayListIdQuery.finish();
+
+        return result;
+    }
+
+    d->mSelectPlayListIdQuery.finish();
+
+    d->mInsertPlayListQuery.bindValue(QStringLiteral(":name"), name);
+
+    queryResult = d->mInsertPlayListQuery.exec();
+
+    if (!queryResult || !d->mInsertPlayListQuery.isActive()) {
+        Q_EMIT databaseError();
+
+        qDebug() << "DatabaseInterface::insertPlayList" << d->mInsertPlayListQuery.lastQuery();
+        qDebug() << "DatabaseInterface::insertPlayList" << d->mInsertPlayListQuery.boundValues();
+        qDebug() << "DatabaseInterface::insertPlayList" << d->mInsertPlayListQuery.lastError();
+
+        d->mInsertPlayListQuery.finish();
+
+        return result;
+    }
+
+    result = d->mInsertPlayListQuery.lastInsertId().toULongLong();
+
+    d->mInsertPlayListQuery.finish();
+
+    return result;
+}
+
+bool DatabaseInterface::playListEntryPositions(qulonglong playListId, int firstRow, int count, QList<std::pair<qulonglong, qlonglong>> &entries)
+{
+    entries.clear();
+
+    d->mSelectPlayListEntryPositionsQuery.bindValue(QStringLiteral(":playListId"), playListId);
+    d->mSelectPlayListEntryPositionsQuery.bindValue(QStringLiteral(":firstRow"), firstRow);
+    d->mSelectPlayListEntryPositionsQuery.bindValue(QStringLiteral(":count"), count);
+
+    auto queryResult = d->mSelectPlayListEntryPositionsQuery.exec();
+
+    if (!queryResult || !d->mSelectPlayListEntryPositionsQuery.isSelect() || !d->mSelectPlayListEntryPositionsQuery.isActive()) {
+        Q_EMIT databaseError();
+
+        qDebug() << "DatabaseInterface::playListEntryPositions" << d->mSelectPlayListEntryPositionsQuery.lastQuery();
+        qDebug() << "DatabaseInterface::playListEntryPositions" << d->mSelectPlayListEntryPositionsQuery.boundValues();
+        qDebug() << "DatabaseInterface::playListEntryPositions" << d->mSelectPlayListEntryPositionsQuery.lastError();
+
+        d->mSelectPlayListEntryPositionsQuery.finish();
+
+        return false;
+    }
+
+    while(d->mSelectPlayListEntryPositionsQuery.next()) {
+        const auto &currentRecord = d->mSelectPlayListEntryPositionsQuery.record();
+
+        entries.push_back({currentRecord.value(0).toULongLong(), currentRecord.value(1).toLongLong()});
+    }
+
+    d->mSelectPlayListEntryPositionsQuery.finish();
+
+    return true;
+}
+
+bool DatabaseInterface::updatePlayListEntryPosition(qulonglong entryId, qlonglong position)
+{
+    d->mUpdatePlayListEntryPositionQuery.bindValue(QStringLiteral(":entryId"), entryId);
+    d->mUpdatePlayListEntryPositionQuery.bindValue(QStringLiteral(":position"), position);
+
+    auto queryResult = d->mUpdatePlayListEntryPositionQuery.exec();
+
+    if (!queryResult || !d->mUpdatePlayListEntryPositionQuery.isActive()) {
+        Q_EMIT databaseError();
+
+        qDebug() << "DatabaseInterface::updatePlayListEntryPosition" << d->mUpdatePlayListEntryPositionQuery.lastQuery();
+        qDebug() << "DatabaseInterface::updatePlayListEntryPosition" << d->mUpdatePlayListEntryPositionQuery.boundValues();
+        qDebug() << "DatabaseInterface::updatePlayListEntryPosition" << d->mUpdatePlayListEntryPositionQuery.lastError();
+
+        d->mUpdatePlayListEntryPositionQuery.finish();
+
+        return false;
+    }
+
+    d->mUpdatePlayListEntryPositionQuery.finish();
+
+    return true;
+}
+
+bool DatabaseInterface::renumberPlayListEntries(qulonglong playListId, int row, int count)
+{
+    auto allEntries = QList<std::pair<qulonglong, qlonglong>>();
+
+    if (!playListEntryPositions(playListId, 0, -1, allEntries)) {
+        return false;
+    }
+
+    for (int entryRow = 0; entryRow < allEntries.size(); ++entryRow) {
+        const auto newPosition = qlonglong(entryRow < row ? entryRow : entryRow + count) * playListEntryPositionGap;
+
+        if (allEntries.at(entryRow).second == newPosition) {
+            continue;
+        }
+
+        if (!updatePlayListEntryPosition(allEntries.at(entryRow).first, newPosition)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool DatabaseInterface::playListEntriesGap(qulonglong playListId, int row, int count, qlonglong &firstPosition, qlonglong &step)
+{
+    auto neighbours = QList<std::pair<qulonglong, qlonglong>>();
+
+    /* the entry before row when there is one, then the entry at row */
+    if (!playListEntryPositions(playListId, std::max(row - 1, 0), (row > 0 ? 2 : 1), neighbours)) {
+        return false;
+    }
+
+    const auto nextIndex = (row > 0 ? 1 : 0);
+    const auto hasPrevious = (row > 0 && !neighbours.isEmpty());
+    const auto hasNext = (neighbours.size() > nextIndex);
+
+    auto previousPosition = (hasPrevious ? neighbours.at(0).second : qlonglong(0));
+    auto nextPosition = (hasNext ? neighbours.at(nextIndex).second : previousPosition + (count + 1) * playListEntryPositionGap);
+
+    if (!hasPrevious && hasNext) {
+        previousPosition = nextPosition - (count + 1) * playListEntryPositionGap;
+    }
+
+    if (nextPosition - previousPosition <= count) {
+        if (!renumberPlayListEntries(playListId, row, count)) {
+            return false;
+        }
+
+        previousPosition = qlonglong(row - 1) * playListEntryPositionGap;
+        nextPosition = qlonglong(row + count) * playListEntryPositionGap;
+    }
+
+    step = (nextPosition - previousPosition) / (count + 1);
+    firstPosition = previousPosition + step;
+
+    return true;
+}
+
+bool DatabaseInterface::removePlayListEntryRows(qulonglong playListId, int firstRow, int count)
+{
+    d->mRemovePlayListEntriesQuery.bindValue(QStringLiteral(":playListId"), playListId);
+    d->mRemovePlayListEntriesQuery.bindValue(QStringLiteral(":firstRow"), firstRow);
+    d->mRemovePlayListEntriesQuery.bindValue(QStringLiteral(":count"), count);
+
+    auto queryResult = d->mRemovePlayListEntriesQuery.exec();
+
+    if (!queryResult || !d->mRemovePlayListEntriesQuery.isActive()) {
+        Q_EMIT databaseError();
+
+        qDebug() << "DatabaseInterface::removePlayListEntryRows" << d->mRemovePlayListEntriesQuery.lastQuery();
+        qDebug() << "DatabaseInterface::removePlayListEntryRows" << d->mRemovePlayListEntriesQuery.boundValues();
+        qDebug() << "DatabaseInterface::removePlayListEntryRows" << d->mRemovePlayListEntriesQuery.lastError();
+
+        d->mRemovePlayListEntriesQuery.finish();
+
+        return false;
+    }
+
+    d->mRemovePlayListEntriesQuery.finish();
+
+    return true;
+}
+
+void DatabaseInterface::bindPlayListEntry(QSqlQuery &query, const MusicAudioTrack &entry)
+{
+    query.bindValue(QStringLiteral(":trackId"), (entry.databaseId() != 0 ? QVariant(entry.databaseId()) : QVariant()));
+    query.bindValue(QStringLiteral(":title"), entry.title());
+    query.bindValue(QStringLiteral(":artist"), entry.artist());
+    query.bindValue(QStringLiteral(":albumTitle"), entry.albumName());
+    query.bindValue(QStringLiteral(":trackNumber"), entry.trackNumber());
+    query.bindValue(QStringLiteral(":discNumber"), entry.discNumber());
+    query.bindValue(QStringLiteral(":fileName"), (entry.resourceURI().isValid() ? QVariant(entry.resourceURI()) : QVariant()));
+}
+
 QList<MusicAudioTrack> DatabaseInterface::fetchTracks(qulonglong albumId)
 {
     auto allTracks = QList<MusicAudioTrack>();
@@ -3662,5 +5573,62 @@ QList<qulonglong> DatabaseInterface::internalAlbumIdsFromAuthor(const QString &a
     return allAlbumIds;
 }
 
+QList<qulonglong> DatabaseInterface::internalAllIds(QSqlQuery &idsQuery)
+{
+    auto allIds = QList<qulonglong>();
+
+    auto result = idsQuery.exec();
+
+    if (!result || !idsQuery.isSelect() || !idsQuery.isActive()) {
+        Q_EMIT databaseError();
+
+        qDebug() << "DatabaseInterface::internalAllIds" << idsQuery.lastQuery();
+        qDebug() << "DatabaseInterface::internalAllIds" << idsQuery.boundValues();
+        qDebug() << "DatabaseInterface::internalAllIds" << idsQuery.lastError();
+
+        idsQuery.finish();
+
+        return allIds;
+    }
+
+    while (idsQuery.next()) {
+        allIds.push_back(idsQuery.record().value(0).toULongLong());
+    }
+
+    idsQuery.finish();
+
+    return allIds;
+}
+
+qulonglong DatabaseInterface::internalSkippedRowsLastId(QSqlQuery &pageStartQuery, qulonglong afterId, int skippedCount)
+{
+    auto lastId = qulonglong(0);
+
+    pageStartQuery.bindValue(QStringLiteral(":afterId"), afterId);
+    pageStartQuery.bindValue(QStringLiteral(":skippedCount"), skippedCount - 1);
+
+    auto result = pageStartQuery.exec();
+
+    if (!result || !pageStartQuery.isSelect() || !pageStartQuery.isActive()) {
+        Q_EMIT databaseError();
+
+        qDebug() << "DatabaseInterface::internalSkippedRowsLastId" << pageStartQuery.lastQuery();
+        qDebug() << "DatabaseInterface::internalSkippedRowsLastId" << pageStartQuery.boundValues();
+        qDebug() << "DatabaseInterface::internalSkippedRowsLastId" << pageStartQuery.lastError();
+
+        pageStartQuery.finish();
+
+        return lastId;
+    }
+
+    if (pageStartQuery.next()) {
+        lastId = pageStartQuery.record().value(0).toULongLong();
+    }
+
+    pageStartQuery.finish();
+
+    return lastId;
+}
+
 
 #include "moc_databaseinterface.cpp"
@@ -26,16 +26,19 @@
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QHash>
 #include <QList>
 #include <QVariant>
 #include <QUrl>
 
 #include <memory>
+#include <utility>
 
 class DatabaseInterfacePrivate;
 class QMutex;
 class QSqlRecord;
+class QSqlQuery;
 
 class DatabaseInterface : public QObject
 {
@@ -55,7 +58,12 @@ public:
 
     ~DatabaseInterface() override;
 
-    Q_INVOKABLE void init(const QString &dbName, const QString &databaseFileName = {});
+    /**
+     * Open the database. With pagedCollection, an existing database only
+     * sends the count of its tracks, albums and artists; the models then ask
+     * for the pages of rows they show.
+     */
+    Q_INVOKABLE void init(const QString &dbName, const QString &databaseFileName = {}, bool pagedCollection = false);
 
     MusicAlbum albumFromTitleAndArtist(const QString &title, const QString &artist);
 
@@ -63,7 +71,7 @@ public:
 
     QList<MusicAudioTrack> allTracksFromSource(const QString &musicSource);
 
-    QList<MusicAudioTrack> allInvalidTracksFromSource(const QString &musicSource);
+    Q_INVOKABLE QList<MusicAudioTrack> allInvalidTracksFromSource(const QString &musicSource);
 
     QList<MusicAlbum> allAlbums();
 
@@ -73,11 +81,29 @@ public:
 
     MusicAudioTrack trackFromDatabaseId(qulonglong id);
 
+    QList<MusicAudioTrack> tracksFromDatabaseIds(const QList<qulonglong> &ids);
+
     qulonglong trackIdFromTitleAlbumTrackDiscNumber(const QString &title, const QString &artist, const QString &album,
                                                     int trackNumber, int discNumber);
 
     qulonglong trackIdFromFileName(const QUrl &fileName);
 
+    /**
+     * Return the directories already completely scanned by an interrupted
+     * import of this source. Tracks stored below them are marked valid again,
+     * the caller is expected to skip those directories. getScanProgress
+     * sends the same list with sentScanProgress.
+     */
+    Q_INVOKABLE QList<QUrl> restoreScanProgress(const QString &musicSource);
+
+    /**
+     * Return the files already imported from this source and mark them
+     * valid again. Each track only holds the file name with the size and
+     * modification time of the file when its tags were read. Used by
+     * incremental imports that do not read the tags of unchanged files again.
+     */
+    Q_INVOKABLE QList<MusicAudioTrack> restoreKnownTracks(const QString &musicSource);
+
     void applicationAboutToQuit();
 
 Q_SIGNALS:
@@ -102,8 +128,42 @@ Q_SIGNALS:
 
     void trackModified(const MusicAudioTrack &modifiedTrack);
 
+    void artistsRemoved(const QList<MusicArtist> &removedArtists);
+
+    void albumsRemoved(const QList<MusicAlbum> &removedAlbums);
+
+    void tracksRemoved(const QList<qulonglong> &removedTracksIds);
+
+    void albumsModified(const QList<MusicAlbum> &modifiedAlbums);
+
+    void tracksModified(const QList<MusicAudioTrack> &modifiedTracks);
+
     void sentAlbumData(const MusicAlbum albumData);
 
+    void sentTracksCount(int tracksCount);
+
+    void sentAlbumsCount(int albumsCount);
+
+    void sentArtistsCount(int artistsCount);
+
+    void sentScanProgress(const QString &musicSource, const QList<QUrl> &completedDirectories);
+
+    void sentTracksPage(int offset, const QList<MusicAudioTrack> &tracks);
+
+    void sentAlbumsPage(int offset, const QList<MusicAlbum> &albums);
+
+    void sentArtistsPage(int offset, const QList<MusicArtist> &artists);
+
+    void sentAllTracksIds(const QList<qulonglong> &tracksIds);
+
+    void sentAllAlbumsTracksIds(const QList<qulonglong> &tracksIds);
+
+    void sentAllArtistsNames(const QStringList &artistsNames);
+
+    void sentAlbumsFromArtist(const QList<MusicAlbum> &albums);
+
+    void sentPlayListEntries(const QString &playListName, const QList<MusicAudioTrack> &entries);
+
     void requestsInitDone();
 
     void databaseError();
@@ -114,14 +174,66 @@ public Q_SLOTS:
 
     void removeTracksList(const QList<QUrl> &removedTracks);
 
+    void renameTracksList(const QHash<QUrl, QUrl> &renamedTracks);
+
     void modifyTracksList(const QList<MusicAudioTrack> &modifiedTracks, const QHash<QString, QUrl> &covers, const QString &musicSource);
 
     void removeAllTracksFromSource(const QString &sourceName);
 
     void getAlbumFromAlbumId(qulonglong id);
 
+    /*
+     * Rows of the pages are sorted on their database id. A page holds the
+     * count rows following the row whose id is afterId, once skippedCount
+     * rows have been passed: skippedCount is 0 when the last id of the
+     * previous page is known.
+     */
+    void getTracksPage(int offset, int count, qulonglong afterId, int skippedCount);
+
+    void getAlbumsPage(int offset, int count, qulonglong afterId, int skippedCount);
+
+    void getArtistsPage(int offset, int count, qulonglong afterId, int skippedCount);
+
+    /* ids of all the rows of the tracks pages, in the same order */
+    void getAllTracksIds();
+
+    /* ids of the tracks of all the albums, album after album in the order of the albums pages */
+    void getAllAlbumsTracksIds();
+
+    /* names of all the rows of the artists pages, in the same order */
+    void getAllArtistsNames();
+
+    /* albums whose album artist or one of the track artists is artistName */
+    void getAlbumsFromArtist(const QString &artistName);
+
     void cleanInvalidTracks();
 
+    void getScanProgress(const QString &musicSource);
+
+    void updateScanProgress(const QString &musicSource, const QList<QUrl> &completedDirectories);
+
+    void clearScanProgress(const QString &musicSource);
+
+    /*
+     * Playlists are stored by name, one row per entry ordered by a sparse
+     * position: an edit only writes the entries it inserts, moves or removes.
+     * Positions are only renumbered when no gap is left between two entries.
+     * An entry is the track id when it is known, with its name and file
+     * to find the track again. The positions given here are playlist rows.
+     */
+    void insertPlayListEntries(const QString &playListName, int position, const QList<MusicAudioTrack> &entries);
+
+    void removePlayListEntries(const QString &playListName, int position, int count);
+
+    /* same positions as QAbstractItemModel::beginMoveRows */
+    void movePlayListEntries(const QString &playListName, int sourcePosition, int count, int destinationPosition);
+
+    void updatePlayListEntry(const QString &playListName, int position, const MusicAudioTrack &entry);
+
+    void clearPlayListEntries(const QString &playListName);
+
+    void getPlayListEntries(const QString &playListName);
+
 private:
 
     enum class TrackFileInsertType {
@@ -161,10 +273,32 @@ private:
 
     QList<qulonglong> internalAlbumIdsFromAuthor(const QString &artistName);
 
+    QList<qulonglong> internalAllIds(QSqlQuery &idsQuery);
+
+    qulonglong internalSkippedRowsLastId(QSqlQuery &pageStartQuery, qulonglong afterId, int skippedCount);
+
     void initDatabase() const;
 
     void initRequest();
 
+    qulonglong insertPlayList(const QString &name);
+
+    /* id and position of the entries of [firstRow, firstRow + count), a negative count reads up to the last entry */
+    bool playListEntryPositions(qulonglong playListId, int firstRow, int count, QList<std::pair<qulonglong, qlonglong>> &entries);
+
+    bool updatePlayListEntryPosition(qulonglong entryId, qlonglong position);
+
+    /* spreads the positions again, leaving room for count entries before row */
+    bool renumberPlayListEntries(qulonglong playListId, int row, int count);
+
+    /* positions of count entries inserted before row: firstPosition, firstPosition + step... */
+    bool playListEntriesGap(qulonglong playListId, int row, int count, qlonglong &firstPosition, qlonglong &step);
+
+    /* a negative count removes up to the last entry */
+    bool removePlayListEntryRows(qulonglong playListId, int firstRow, int count);
+
+    static void bindPlayListEntry(QSqlQuery &query, const MusicAudioTrack &entry);
+
     qulonglong insertAlbum(const QString &title, const QString &albumArtist, const QString &trackArtist,
                            const QUrl &albumArtURI, int tracksCount, bool isSingleDiscAlbum,
                            QList<qulonglong> &newAlbumIds);
@@ -183,17 +317,23 @@ private:
 
     void reloadExistingDatabase();
 
+    int internalCountAndMaximumId(QSqlQuery &countQuery, qulonglong &maximumId);
+
     qulonglong insertMusicSource(const QString &name);
 
     void insertTrackOrigin(const QUrl &fileNameURI, qulonglong discoverId);
 
     void updateTrackOrigin(qulonglong trackId, const QUrl &fileName);
 
+    void updateTrackFileState(const MusicAudioTrack &track);
+
+    void removeTrackFileState(const QUrl &fileName);
+
     int computeTrackPriority(qulonglong trackId, const QUrl &fileName);
 
     qulonglong internalInsertTrack(const MusicAudioTrack &oneModifiedTrack, const QHash<QString, QUrl> &covers,
                                    int originTrackId, QSet<qulonglong> &modifiedAlbumIds, TrackFileInsertType insertType,
-                                   QList<qulonglong> &newAlbumIds);
+                                   QList<qulonglong> &newAlbumIds, QList<MusicAudioTrack> &modifiedTracks);
 
     MusicAudioTrack buildTrackFromDatabaseRecord(const QSqlRecord &trackRecord) const;
 
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2018 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "displaytextformatter.h"
+
+#include "musicaudiotrack.h"
+
+static void appendTwoDigits(QString &text, int value)
+{
+    text.append(QLatin1Char(static_cast<char>('0' + value / 10)));
+    text.append(QLatin1Char(static_cast<char>('0' + value % 10)));
+}
+
+QString DisplayTextFormatter::durationText(const QTime &duration)
+{
+    auto result = QString();
+
+    if (!duration.isValid()) {
+        return result;
+    }
+
+    result.reserve(8);
+
+    if (duration.hour() != 0) {
+        appendTwoDigits(result, duration.hour());
+        result.append(QLatin1Char(':'));
+    }
+
+    appendTwoDigits(result, duration.minute());
+    result.append(QLatin1Char(':'));
+    appendTwoDigits(result, duration.second());
+
+    return result;
+}
+
+QString DisplayTextFormatter::progressText(const QTime &position)
+{
+    auto result = QString();
+
+    if (!position.isValid()) {
+        return result;
+    }
+
+    result.reserve(7);
+
+    if (position.hour() != 0) {
+        result.append(QString::number(position.hour()));
+        result.append(QLatin1Char(':'));
+        appendTwoDigits(result, position.minute());
+    } else {
+        result.append(QString::number(position.minute()));
+    }
+
+    result.append(QLatin1Char(':'));
+    appendTwoDigits(result, position.second());
+
+    return result;
+}
+
+QString DisplayTextFormatter::trackSecondaryText(const MusicAudioTrack &track)
+{
+    auto result = QStringLiteral("<b>") + QString::number(track.trackNumber()) +
+            QStringLiteral(" - ") + track.title() + QStringLiteral("</b>");
+
+    if (track.artist() != track.albumArtist()) {
+        result += QStringLiteral(" - <i>") + track.artist() + QStringLiteral("</i>");
+    }
+
+    return result;
+}
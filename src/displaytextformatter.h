@@ -0,0 +1,45 @@
+/*
+ * Copyright 2018 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef DISPLAYTEXTFORMATTER_H
+#define DISPLAYTEXTFORMATTER_H
+
+#include <QString>
+#include <QTime>
+
+class MusicAudioTrack;
+
+/* text shown by the views for durations and tracks, built without parsing a format string on each call */
+class DisplayTextFormatter
+{
+
+public:
+
+    /* "mm:ss", or "hh:mm:ss" for a duration of one hour or more */
+    static QString durationText(const QTime &duration);
+
+    /* "m:ss", or "h:mm:ss" for a position of one hour or more */
+    static QString progressText(const QTime &position);
+
+    /* track number and title in bold, followed by the artist when it differs from the album artist */
+    static QString trackSecondaryText(const MusicAudioTrack &track);
+
+};
+
+#endif // DISPLAYTEXTFORMATTER_H
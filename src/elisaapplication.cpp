@@ -271,7 +271,15 @@ void ElisaApplication::initialize()
     d->mAllAlbumsProxyModel->setSourceModel(d->mMusicManager->allAlbumsModel());
     d->mAllArtistsProxyModel->setSourceModel(d->mMusicManager->allArtistsModel());
     d->mAllTracksProxyModel->setSourceModel(d->mMusicManager->allTracksModel());
-    d->mSingleArtistProxyModel->setSourceModel(d->mMusicManager->allAlbumsModel());
+    /* a paged albums model only holds the albums around the visible rows, the albums of the artist are read apart */
+    if (d->mMusicManager->pagedCollection()) {
+        d->mSingleArtistProxyModel->setSourceModel(d->mMusicManager->artistAlbumsModel());
+
+        QObject::connect(d->mSingleArtistProxyModel.get(), &SingleArtistProxyModel::artistFilterTextChanged,
+                         d->mMusicManager.get(), &MusicListenersManager::loadArtistAlbums);
+    } else {
+        d->mSingleArtistProxyModel->setSourceModel(d->mMusicManager->allAlbumsModel());
+    }
     d->mSingleAlbumProxyModel->setSourceModel(d->mMusicManager->albumModel());
 
     QObject::connect(d->mAllAlbumsProxyModel.get(), &AllAlbumsProxyModel::albumToEnqueue,
@@ -279,6 +287,11 @@ void ElisaApplication::initialize()
                                                                          ElisaUtils::PlayListEnqueueMode,
                                                                          ElisaUtils::PlayListEnqueueTriggerPlay)>(&MediaPlayList::enqueue));
 
+    QObject::connect(d->mAllAlbumsProxyModel.get(), &AllAlbumsProxyModel::trackIdsToEnqueue,
+                     d->mMediaPlayList.get(), static_cast<void (MediaPlayList::*)(const QList<qulonglong> &,
+                                                                         ElisaUtils::PlayListEnqueueMode,
+                                                                         ElisaUtils::PlayListEnqueueTriggerPlay)>(&MediaPlayList::enqueue));
+
     QObject::connect(d->mAllArtistsProxyModel.get(), &AllArtistsProxyModel::artistToEnqueue,
                      d->mMediaPlayList.get(), &MediaPlayList::enqueueArtists);
 
@@ -287,6 +300,11 @@ void ElisaApplication::initialize()
                                                                          ElisaUtils::PlayListEnqueueMode,
                                                                          ElisaUtils::PlayListEnqueueTriggerPlay)>(&MediaPlayList::enqueue));
 
+    QObject::connect(d->mAllTracksProxyModel.get(), &AllTracksProxyModel::trackIdsToEnqueue,
+                     d->mMediaPlayList.get(), static_cast<void (MediaPlayList::*)(const QList<qulonglong> &,
+                                                                         ElisaUtils::PlayListEnqueueMode,
+                                                                         ElisaUtils::PlayListEnqueueTriggerPlay)>(&MediaPlayList::enqueue));
+
     QObject::connect(d->mSingleArtistProxyModel.get(), &SingleArtistProxyModel::albumToEnqueue,
                      d->mMediaPlayList.get(), static_cast<void (MediaPlayList::*)(const QList<MusicAlbum> &,
                                                                          ElisaUtils::PlayListEnqueueMode,
@@ -19,23 +19,39 @@
 
 #include "config-upnp-qt.h"
 
-#include "musiclistenersmanager.h"
 #include "elisaimportapplication.h"
+#include "musicaudiotrack.h"
+#include "musicalbum.h"
+#include "musicartist.h"
+#include "notificationitem.h"
+#include "abstractfile/indexerfilter.h"
 #include "elisa_settings.h"
 
+#include <KI18n/KLocalizedString>
+
 #include <QCoreApplication>
 #include <QCommandLineParser>
+#include <QCommandLineOption>
 #include <QtGlobal>
 #include <QStandardPaths>
+#include <QThread>
+#include <QDebug>
 
 int main(int argc, char *argv[])
 {
     QCoreApplication app(argc, argv);
 
+    KLocalizedString::setApplicationDomain("elisa");
+
     qRegisterMetaType<QHash<QString,QUrl>>("QHash<QString,QUrl>");
+    qRegisterMetaType<QList<QUrl>>("QList<QUrl>");
+    qRegisterMetaType<QHash<QUrl,QUrl>>("QHash<QUrl,QUrl>");
     qRegisterMetaType<QList<MusicAudioTrack>>("QList<MusicAudioTrack>");
     qRegisterMetaType<QList<MusicAudioTrack>>("QVector<MusicAudioTrack>");
     qRegisterMetaType<QVector<qulonglong>>("QVector<qulonglong>");
+    qRegisterMetaType<QList<qulonglong>>("QList<qulonglong>");
+    qRegisterMetaType<QList<MusicArtist>>("QList<MusicArtist>");
+    qRegisterMetaType<QList<MusicAlbum>>("QList<MusicAlbum>");
     qRegisterMetaType<QHash<qulonglong,int>>("QHash<qulonglong,int>");
     qRegisterMetaType<MusicAlbum>("MusicAlbum");
     qRegisterMetaType<MusicArtist>("MusicArtist");
@@ -44,22 +60,91 @@ int main(int argc, char *argv[])
     qRegisterMetaType<QMap<QString,int>>("QMap<QString,int>");
 
     QCommandLineParser parser;
+    parser.setApplicationDescription(i18nc("description of the elisaImport command",
+                                           "Import music directories into an Elisa database without user interface."));
     parser.addHelpOption();
     parser.addVersionOption();
-    parser.process(app);
+
+    const QCommandLineOption databaseOption(QStringLiteral("db"),
+                                            i18nc("command line option", "Database file to fill, the one of Elisa by default."),
+                                            QStringLiteral("file"));
+    const QCommandLineOption rootOption(QStringLiteral("root"),
+                                        i18nc("command line option", "Music directory to import, can be repeated. The configured directories by default."),
+                                        QStringLiteral("directory"));
+    const QCommandLineOption jobsOption(QStringLiteral("jobs"),
+                                        i18nc("command line option", "Number of threads reading tags."),
+                                        QStringLiteral("count"), QString::number(QThread::idealThreadCount()));
+    const QCommandLineOption incrementalOption(QStringLiteral("incremental"),
+                                               i18nc("command line option", "Keep the tracks already in the database without reading their tags again."));
+    const QCommandLineOption statisticsOption(QStringLiteral("stats"),
+                                              i18nc("command line option", "Print import statistics on the standard output, only json is supported."),
+                                              QStringLiteral("format"));
+
+    parser.addOption(databaseOption);
+    parser.addOption(rootOption);
+    parser.addOption(jobsOption);
+    parser.addOption(incrementalOption);
+    parser.addOption(statisticsOption);
+
+    if (!parser.parse(app.arguments())) {
+        qCritical().noquote() << parser.errorText();
+        return ElisaImportApplication::InvalidArguments;
+    }
+
+    if (parser.isSet(QStringLiteral("help"))) {
+        parser.showHelp(ElisaImportApplication::Success);
+    }
+
+    if (parser.isSet(QStringLiteral("version"))) {
+        parser.showVersion();
+    }
+
+    if (!parser.positionalArguments().isEmpty()) {
+        qCritical().noquote() << "unexpected arguments:" << parser.positionalArguments().join(QLatin1Char(' '));
+        return ElisaImportApplication::InvalidArguments;
+    }
+
+    auto validJobs = false;
+    const auto jobs = parser.value(jobsOption).toInt(&validJobs);
+    if (!validJobs || jobs < 1) {
+        qCritical().noquote() << "invalid number of jobs:" << parser.value(jobsOption);
+        return ElisaImportApplication::InvalidArguments;
+    }
+
+    if (parser.isSet(statisticsOption) && parser.value(statisticsOption) != QStringLiteral("json")) {
+        qCritical().noquote() << "unsupported statistics format:" << parser.value(statisticsOption);
+        return ElisaImportApplication::InvalidArguments;
+    }
 
     auto configurationFileName = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation);
     configurationFileName += QStringLiteral("/elisarc");
     Elisa::ElisaConfiguration::instance(configurationFileName);
     Elisa::ElisaConfiguration::self()->load();
-    Elisa::ElisaConfiguration::self()->save();
 
-    MusicListenersManager myMusicManager;
+    auto rootPaths = parser.values(rootOption);
+    if (rootPaths.isEmpty()) {
+        rootPaths = Elisa::ElisaConfiguration::rootPath();
+    }
+    if (rootPaths.isEmpty()) {
+        rootPaths = QStandardPaths::standardLocations(QStandardPaths::MusicLocation);
+    }
+
+    auto databaseFileName = parser.value(databaseOption);
+    if (databaseFileName.isEmpty()) {
+        databaseFileName = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QStringLiteral("/elisa/elisaDatabase.db");
+    }
+
     ElisaImportApplication myApplication;
 
-    QObject::connect(&myMusicManager, &MusicListenersManager::indexingRunningChanged,
-            &myApplication, &ElisaImportApplication::indexingChanged);
+    myApplication.setDatabaseFileName(databaseFileName);
+    myApplication.setRootPaths(rootPaths);
+    myApplication.setIndexerFilter(IndexerFilter(Elisa::ElisaConfiguration::excludedPatterns(),
+                                                 1024 * static_cast<qint64>(Elisa::ElisaConfiguration::minimumFileSize())));
+    myApplication.setExtractionJobs(jobs);
+    myApplication.setIncremental(parser.isSet(incrementalOption));
+    myApplication.setJsonStatistics(parser.isSet(statisticsOption));
+
+    QMetaObject::invokeMethod(&myApplication, "start", Qt::QueuedConnection);
 
     return app.exec();
 }
-
@@ -19,21 +19,332 @@
 
 #include "elisaimportapplication.h"
 
+#include "databaseinterface.h"
+#include "musicaudiotrack.h"
+#include "file/localfilelisting.h"
+#include "abstractfile/indexerfilter.h"
+
 #include <QCoreApplication>
+#include <QThread>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDir>
+#include <QList>
+#include <QUrl>
+#include <QHash>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include <QDebug>
+
+#include <cstdio>
+#include <vector>
+
+class ElisaImportApplicationPrivate
+{
+public:
+
+    QString mDatabaseFileName;
+
+    QStringList mRootPaths;
+
+    IndexerFilter mIndexerFilter;
+
+    int mExtractionJobs = 1;
+
+    bool mIncremental = false;
+
+    bool mJsonStatistics = false;
+
+    QThread mDatabaseThread;
+
+    QThread mListingThread;
+
+    DatabaseInterface mDatabaseInterface;
+
+    std::vector<std::unique_ptr<LocalFileListing>> mFileListings;
+
+    int mFinishedListingsCount = 0;
+
+    QAtomicInt mDatabaseErrorsCount;
+
+    /* only updated from the database thread */
+    qint64 mDatabaseTime = 0;
+
+    QElapsedTimer mImportTimer;
+
+    qint64 mInitializationTime = 0;
+
+    qint64 mScanTime = 0;
+
+    qint64 mCleanupTime = 0;
+
+};
+
+ElisaImportApplication::ElisaImportApplication(QObject *parent)
+    : QObject(parent), d(std::make_unique<ElisaImportApplicationPrivate>())
+{
+}
+
+ElisaImportApplication::~ElisaImportApplication()
+{
+    for (const auto &oneListing : d->mFileListings) {
+        oneListing->applicationAboutToQuit();
+    }
+
+    d->mListingThread.quit();
+    d->mListingThread.wait();
+
+    d->mDatabaseThread.quit();
+    d->mDatabaseThread.wait();
+}
+
+void ElisaImportApplication::setDatabaseFileName(const QString &databaseFileName)
+{
+    d->mDatabaseFileName = databaseFileName;
+}
+
+void ElisaImportApplication::setRootPaths(const QStringList &rootPaths)
+{
+    d->mRootPaths = rootPaths;
+}
+
+void ElisaImportApplication::setIndexerFilter(const IndexerFilter &filter)
+{
+    d->mIndexerFilter = filter;
+}
+
+void ElisaImportApplication::setExtractionJobs(int jobs)
+{
+    d->mExtractionJobs = jobs;
+}
+
+void ElisaImportApplication::setIncremental(bool incremental)
+{
+    d->mIncremental = incremental;
+}
+
+void ElisaImportApplication::setJsonStatistics(bool jsonStatistics)
+{
+    d->mJsonStatistics = jsonStatistics;
+}
+
+void ElisaImportApplication::start()
+{
+    d->mImportTimer.start();
+
+    for (auto &oneRootPath : d->mRootPaths) {
+        const auto rootInformation = QFileInfo(oneRootPath);
+
+        if (!rootInformation.isDir() || !rootInformation.isReadable()) {
+            qCritical() << "ElisaImportApplication::start" << oneRootPath << "is not a readable directory";
+            finishImport(InvalidRootPath);
+            return;
+        }
 
-ElisaImportApplication::ElisaImportApplication(QObject *parent) : QObject(parent)
+        oneRootPath = QDir::cleanPath(rootInformation.absoluteFilePath());
+    }
+
+    if (!QDir().mkpath(QFileInfo(d->mDatabaseFileName).absolutePath())) {
+        qCritical() << "ElisaImportApplication::start" << "cannot create the directory of" << d->mDatabaseFileName;
+        finishImport(DatabaseError);
+        return;
+    }
+
+    connect(&d->mDatabaseInterface, &DatabaseInterface::databaseError,
+            this, [this]() { d->mDatabaseErrorsCount.ref(); }, Qt::DirectConnection);
+    connect(&d->mDatabaseInterface, &DatabaseInterface::requestsInitDone,
+            this, &ElisaImportApplication::databaseReady);
+
+    d->mDatabaseInterface.moveToThread(&d->mDatabaseThread);
+    d->mDatabaseThread.start();
+
+    QMetaObject::invokeMethod(&d->mDatabaseInterface, "init", Qt::QueuedConnection,
+                              Q_ARG(QString, QStringLiteral("import")), Q_ARG(QString, d->mDatabaseFileName));
+}
+
+void ElisaImportApplication::databaseReady()
+{
+    if (d->mDatabaseErrorsCount.load() != 0) {
+        qCritical() << "ElisaImportApplication::databaseReady" << "cannot open" << d->mDatabaseFileName;
+        finishImport(DatabaseError);
+        return;
+    }
+
+    d->mListingThread.start();
+
+    for (const auto &oneRootPath : qAsConst(d->mRootPaths)) {
+        d->mFileListings.push_back(std::make_unique<LocalFileListing>());
+        auto listing = d->mFileListings.back().get();
+
+        listing->setRootPath(oneRootPath);
+        listing->setIndexerFilter(d->mIndexerFilter);
+        listing->setExtractionJobs(d->mExtractionJobs);
+
+        connect(listing, &AbstractFileListing::tracksList, &d->mDatabaseInterface,
+                [this](const QList<MusicAudioTrack> &tracks, const QHash<QString, QUrl> &covers, const QString &musicSource) {
+            QElapsedTimer databaseTimer;
+            databaseTimer.start();
+
+            d->mDatabaseInterface.insertTracksList(tracks, covers, musicSource);
+
+            d->mDatabaseTime += databaseTimer.nsecsElapsed();
+        });
+        connect(listing, &AbstractFileListing::modifyTracksList, &d->mDatabaseInterface,
+                [this](const QList<MusicAudioTrack> &tracks, const QHash<QString, QUrl> &covers, const QString &musicSource) {
+            QElapsedTimer databaseTimer;
+            databaseTimer.start();
+
+            d->mDatabaseInterface.modifyTracksList(tracks, covers, musicSource);
+
+            d->mDatabaseTime += databaseTimer.nsecsElapsed();
+        });
+        connect(listing, &AbstractFileListing::removedTracksList, &d->mDatabaseInterface,
+                [this](const QList<QUrl> &removedTracks) {
+            QElapsedTimer databaseTimer;
+            databaseTimer.start();
+
+            d->mDatabaseInterface.removeTracksList(removedTracks);
+
+            d->mDatabaseTime += databaseTimer.nsecsElapsed();
+        });
+        connect(listing, &AbstractFileListing::renamedTracksList, &d->mDatabaseInterface,
+                [this](const QHash<QUrl, QUrl> &renamedTracks) {
+            QElapsedTimer databaseTimer;
+            databaseTimer.start();
+
+            d->mDatabaseInterface.renameTracksList(renamedTracks);
+
+            d->mDatabaseTime += databaseTimer.nsecsElapsed();
+        });
+        connect(listing, &AbstractFileListing::scanProgressChanged,
+                &d->mDatabaseInterface, &DatabaseInterface::updateScanProgress);
+        connect(listing, &AbstractFileListing::scanProgressCompleted,
+                &d->mDatabaseInterface, &DatabaseInterface::clearScanProgress);
+        connect(listing, &AbstractFileListing::indexingFinished,
+                this, &ElisaImportApplication::listingFinished);
+
+        auto completedDirectories = QList<QUrl>();
+        QMetaObject::invokeMethod(&d->mDatabaseInterface, "restoreScanProgress", Qt::BlockingQueuedConnection,
+                                  Q_RETURN_ARG(QList<QUrl>, completedDirectories),
+                                  Q_ARG(QString, listing->sourceName()));
+        listing->setCompletedDirectories(completedDirectories);
+
+        if (d->mIncremental) {
+            auto knownFiles = QList<MusicAudioTrack>();
+            QMetaObject::invokeMethod(&d->mDatabaseInterface, "restoreKnownTracks", Qt::BlockingQueuedConnection,
+                                      Q_RETURN_ARG(QList<MusicAudioTrack>, knownFiles),
+                                      Q_ARG(QString, listing->sourceName()));
+            listing->setKnownFiles(knownFiles);
+        }
+
+        listing->moveToThread(&d->mListingThread);
+    }
+
+    d->mInitializationTime = d->mImportTimer.nsecsElapsed();
+
+    if (d->mFileListings.empty()) {
+        finishImport(d->mDatabaseErrorsCount.load() == 0 ? Success : DatabaseError);
+        return;
+    }
+
+    /* the listings share one thread, roots are scanned one after the other */
+    for (const auto &oneListing : d->mFileListings) {
+        QMetaObject::invokeMethod(oneListing.get(), "refreshContent", Qt::QueuedConnection);
+    }
+}
+
+void ElisaImportApplication::listingFinished()
 {
+    ++d->mFinishedListingsCount;
+
+    if (d->mFinishedListingsCount < static_cast<int>(d->mFileListings.size())) {
+        return;
+    }
+
+    d->mScanTime = d->mImportTimer.nsecsElapsed() - d->mInitializationTime;
+
+    QElapsedTimer cleanupTimer;
+    cleanupTimer.start();
+
+    /* queued requests are handled in order, every track found by the listings is already stored */
+    for (const auto &oneListing : d->mFileListings) {
+        auto invalidTracks = QList<MusicAudioTrack>();
+        QMetaObject::invokeMethod(&d->mDatabaseInterface, "allInvalidTracksFromSource", Qt::BlockingQueuedConnection,
+                                  Q_RETURN_ARG(QList<MusicAudioTrack>, invalidTracks),
+                                  Q_ARG(QString, oneListing->sourceName()));
+
+        auto removedTracks = QList<QUrl>();
+        for (const auto &oneTrack : qAsConst(invalidTracks)) {
+            removedTracks.push_back(oneTrack.resourceURI());
+        }
+
+        if (!removedTracks.isEmpty()) {
+            QMetaObject::invokeMethod(&d->mDatabaseInterface, "removeTracksList", Qt::BlockingQueuedConnection,
+                                      Q_ARG(QList<QUrl>, removedTracks));
+        }
+    }
+
+    d->mCleanupTime = cleanupTimer.nsecsElapsed();
+
+    finishImport(d->mDatabaseErrorsCount.load() == 0 ? Success : DatabaseError);
+}
+
+void ElisaImportApplication::finishImport(ExitCode exitCode)
+{
+    if (d->mJsonStatistics) {
+        printStatistics(exitCode);
+    }
+
+    QCoreApplication::exit(exitCode);
 }
 
-void ElisaImportApplication::indexingChanged()
+void ElisaImportApplication::printStatistics(ExitCode exitCode) const
 {
-    static bool firstCall = true;
+    const auto toSeconds = [](qint64 nanoseconds) {
+        return static_cast<double>(nanoseconds) / 1e9;
+    };
 
-    if (firstCall) {
-        firstCall = false;
-    } else {
-        QCoreApplication::quit();
+    auto importedFilesCount = 0;
+    auto skippedFilesCount = 0;
+    auto extractedBytes = qint64(0);
+    auto extractionTime = qint64(0);
+
+    for (const auto &oneListing : d->mFileListings) {
+        importedFilesCount += oneListing->importedTracksCount();
+        skippedFilesCount += oneListing->skippedKnownFilesCount();
+        extractedBytes += oneListing->extractedBytes();
+        extractionTime += oneListing->extractionTime();
     }
+
+    const auto elapsedTime = d->mImportTimer.isValid() ? d->mImportTimer.nsecsElapsed() : qint64(0);
+
+    QJsonObject phases;
+    phases[QStringLiteral("initialization")] = QJsonObject{{QStringLiteral("seconds"), toSeconds(d->mInitializationTime)}};
+    phases[QStringLiteral("scan")] = QJsonObject{{QStringLiteral("seconds"), toSeconds(d->mScanTime)},
+                                                 {QStringLiteral("extractionSeconds"), toSeconds(extractionTime)},
+                                                 {QStringLiteral("databaseSeconds"), toSeconds(d->mDatabaseTime)}};
+    phases[QStringLiteral("cleanup")] = QJsonObject{{QStringLiteral("seconds"), toSeconds(d->mCleanupTime)}};
+
+    QJsonObject statistics;
+    statistics[QStringLiteral("exitCode")] = static_cast<int>(exitCode);
+    statistics[QStringLiteral("database")] = d->mDatabaseFileName;
+    statistics[QStringLiteral("roots")] = QJsonArray::fromStringList(d->mRootPaths);
+    statistics[QStringLiteral("jobs")] = d->mExtractionJobs;
+    statistics[QStringLiteral("incremental")] = d->mIncremental;
+    statistics[QStringLiteral("importedFiles")] = importedFilesCount;
+    statistics[QStringLiteral("skippedFiles")] = skippedFilesCount;
+    statistics[QStringLiteral("bytesRead")] = static_cast<double>(extractedBytes);
+    statistics[QStringLiteral("elapsedSeconds")] = toSeconds(elapsedTime);
+    statistics[QStringLiteral("filesPerSecond")] = (elapsedTime > 0 ? importedFilesCount / toSeconds(elapsedTime) : 0.);
+    statistics[QStringLiteral("phases")] = phases;
+
+    const auto jsonStatistics = QJsonDocument(statistics).toJson(QJsonDocument::Indented);
+
+    fwrite(jsonStatistics.constData(), 1, static_cast<size_t>(jsonStatistics.size()), stdout);
+    fflush(stdout);
 }
 
 
@@ -21,18 +21,74 @@
 #define ELISAIMPORTAPPLICATION_H
 
 #include <QObject>
+#include <QString>
+#include <QStringList>
 
+#include <memory>
+
+class ElisaImportApplicationPrivate;
+class IndexerFilter;
+
+/**
+ * Headless import of music directories into an Elisa database.
+ *
+ * Each root directory is scanned in turn, tags being read by a pool of
+ * extraction threads. Once every root has been scanned, tracks that were
+ * not found again are removed and the application exits with one of the
+ * ExitCode values.
+ */
 class ElisaImportApplication : public QObject
 {
     Q_OBJECT
+
 public:
+
+    enum ExitCode {
+        Success = 0,
+        InvalidArguments = 1,
+        InvalidRootPath = 2,
+        DatabaseError = 3,
+    };
+
     explicit ElisaImportApplication(QObject *parent = nullptr);
 
-Q_SIGNALS:
+    ~ElisaImportApplication() override;
+
+    void setDatabaseFileName(const QString &databaseFileName);
+
+    void setRootPaths(const QStringList &rootPaths);
+
+    void setIndexerFilter(const IndexerFilter &filter);
+
+    void setExtractionJobs(int jobs);
+
+    /**
+     * Keep the files already in the database without reading their tags again.
+     */
+    void setIncremental(bool incremental);
+
+    /**
+     * Print the import statistics as JSON on the standard output once finished.
+     */
+    void setJsonStatistics(bool jsonStatistics);
 
 public Q_SLOTS:
 
-    void indexingChanged();
+    void start();
+
+private Q_SLOTS:
+
+    void databaseReady();
+
+    void listingFinished();
+
+private:
+
+    void finishImport(ExitCode exitCode);
+
+    void printStatistics(ExitCode exitCode) const;
+
+    std::unique_ptr<ElisaImportApplicationPrivate> d;
 
 };
 
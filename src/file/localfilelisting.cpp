@@ -69,6 +69,7 @@ void LocalFileListing::setRootPath(const QString &rootPath)
     Q_EMIT rootPathChanged();
 
     setSourceName(rootPath);
+    setRootPaths({rootPath});
 }
 
 void LocalFileListing::executeInit()
@@ -81,7 +82,7 @@ void LocalFileListing::triggerRefreshOfContent()
 
     AbstractFileListing::triggerRefreshOfContent();
 
-    scanDirectoryTree(d->mRootPath);
+    importDirectoryTree(d->mRootPath);
 
     Q_EMIT indexingFinished(importedTracksCount());
 }
@@ -21,11 +21,50 @@
 
 #include "elisa_settings.h"
 
+#include "../abstractfile/indexerfilter.h"
+
 #include <KPluginFactory>
 #include <KAboutData>
 #include <KLocalizedString>
 
 #include <QStandardPaths>
+#include <QDir>
+#include <QFileInfo>
+#include <QVariantMap>
+#include <QtConcurrentRun>
+
+static QVector<int> countPrunedPaths(const QStringList &rootPaths, const IndexerFilter &filter)
+{
+    const auto tooSmallFilesIndex = filter.excludedPatterns().size();
+    auto prunedPathsCount = QVector<int>(tooSmallFilesIndex + 1, 0);
+
+    auto pendingDirectories = rootPaths;
+    while (!pendingDirectories.isEmpty()) {
+        const auto currentDirectory = QDir(pendingDirectories.takeLast());
+
+        const auto entryList = currentDirectory.entryInfoList(QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs);
+        for (const auto &oneEntry : entryList) {
+            const auto matchingPattern = filter.matchingPattern(oneEntry.fileName(), oneEntry.absoluteFilePath());
+            if (matchingPattern != -1) {
+                ++prunedPathsCount[matchingPattern];
+                continue;
+            }
+
+            if (oneEntry.isDir()) {
+                if (!oneEntry.isSymLink()) {
+                    pendingDirectories.push_back(oneEntry.absoluteFilePath());
+                }
+                continue;
+            }
+
+            if (filter.minimumFileSize() > 0 && filter.isTooSmall(oneEntry.size())) {
+                ++prunedPathsCount[tooSmallFilesIndex];
+            }
+        }
+    }
+
+    return prunedPathsCount;
+}
 
 K_PLUGIN_FACTORY_WITH_JSON(KCMElisaLocalFileFactory,
                            "kcm_elisa_local_file.json",
@@ -50,36 +89,69 @@ KCMElisaLocalFile::KCMElisaLocalFile(QObject* parent, const QVariantList &args)
             this, &KCMElisaLocalFile::configChanged);
     connect(&mConfigFileWatcher, &QFileSystemWatcher::fileChanged,
             this, &KCMElisaLocalFile::configChanged);
+    connect(&mRulesPreviewWatcher, &QFutureWatcher<QVector<int>>::finished,
+            this, &KCMElisaLocalFile::rulesPreviewFinished);
 
 
     setRootPath(Elisa::ElisaConfiguration::rootPath());
     Elisa::ElisaConfiguration::setRootPath(mRootPath);
     Elisa::ElisaConfiguration::self()->save();
 
+    setExcludedPatterns(Elisa::ElisaConfiguration::excludedPatterns());
+    setMinimumFileSize(Elisa::ElisaConfiguration::minimumFileSize());
+
     mConfigFileWatcher.addPath(Elisa::ElisaConfiguration::self()->config()->name());
 }
 
 KCMElisaLocalFile::~KCMElisaLocalFile()
-= default;
+{
+    mRulesPreviewWatcher.waitForFinished();
+}
 
 QStringList KCMElisaLocalFile::rootPath() const
 {
     return mRootPath;
 }
 
+QStringList KCMElisaLocalFile::excludedPatterns() const
+{
+    return mExcludedPatterns;
+}
+
+int KCMElisaLocalFile::minimumFileSize() const
+{
+    return mMinimumFileSize;
+}
+
+QVariantList KCMElisaLocalFile::rulesPreview() const
+{
+    return mRulesPreview;
+}
+
+bool KCMElisaLocalFile::isComputingRulesPreview() const
+{
+    return mRulesPreviewWatcher.isRunning();
+}
+
 void KCMElisaLocalFile::defaults()
 {
     setRootPath(QStandardPaths::standardLocations(QStandardPaths::MusicLocation));
+    setExcludedPatterns({QStringLiteral("@eaDir"), QStringLiteral("lost+found")});
+    setMinimumFileSize(0);
 }
 
 void KCMElisaLocalFile::load()
 {
     setRootPath(Elisa::ElisaConfiguration::rootPath());
+    setExcludedPatterns(Elisa::ElisaConfiguration::excludedPatterns());
+    setMinimumFileSize(Elisa::ElisaConfiguration::minimumFileSize());
 }
 
 void KCMElisaLocalFile::save()
 {
     Elisa::ElisaConfiguration::setRootPath(mRootPath);
+    Elisa::ElisaConfiguration::setExcludedPatterns(mExcludedPatterns);
+    Elisa::ElisaConfiguration::setMinimumFileSize(mMinimumFileSize);
     Elisa::ElisaConfiguration::self()->save();
 }
 
@@ -113,9 +185,84 @@ void KCMElisaLocalFile::setRootPath(QStringList rootPath)
     Q_EMIT needsSaveChanged();
 }
 
+void KCMElisaLocalFile::setExcludedPatterns(QStringList excludedPatterns)
+{
+    auto cleanedPatterns = QStringList();
+    for (const auto &onePattern : excludedPatterns) {
+        const auto cleanedPattern = onePattern.trimmed();
+        if (!cleanedPattern.isEmpty()) {
+            cleanedPatterns.push_back(cleanedPattern);
+        }
+    }
+
+    if (mExcludedPatterns == cleanedPatterns) {
+        return;
+    }
+
+    mExcludedPatterns = cleanedPatterns;
+    Q_EMIT excludedPatternsChanged(mExcludedPatterns);
+
+    setNeedsSave(true);
+    Q_EMIT needsSaveChanged();
+}
+
+void KCMElisaLocalFile::setMinimumFileSize(int minimumFileSize)
+{
+    if (mMinimumFileSize == minimumFileSize) {
+        return;
+    }
+
+    mMinimumFileSize = minimumFileSize;
+    Q_EMIT minimumFileSizeChanged(mMinimumFileSize);
+
+    setNeedsSave(true);
+    Q_EMIT needsSaveChanged();
+}
+
+void KCMElisaLocalFile::computeRulesPreview()
+{
+    if (mRulesPreviewWatcher.isRunning()) {
+        return;
+    }
+
+    mRulesPreviewPatterns = mExcludedPatterns;
+    mRulesPreviewMinimumFileSize = mMinimumFileSize;
+
+    const auto filter = IndexerFilter(mRulesPreviewPatterns, 1024 * static_cast<qint64>(mRulesPreviewMinimumFileSize));
+    mRulesPreviewWatcher.setFuture(QtConcurrent::run(countPrunedPaths, mRootPath, filter));
+
+    Q_EMIT isComputingRulesPreviewChanged();
+}
+
+void KCMElisaLocalFile::rulesPreviewFinished()
+{
+    const auto prunedPathsCount = mRulesPreviewWatcher.result();
+
+    mRulesPreview.clear();
+
+    for (int i = 0; i < mRulesPreviewPatterns.size(); ++i) {
+        auto oneRule = QVariantMap();
+        oneRule[QStringLiteral("rule")] = mRulesPreviewPatterns.at(i);
+        oneRule[QStringLiteral("prunedPaths")] = prunedPathsCount.at(i);
+        mRulesPreview.push_back(oneRule);
+    }
+
+    if (mRulesPreviewMinimumFileSize > 0) {
+        auto sizeRule = QVariantMap();
+        sizeRule[QStringLiteral("rule")] = i18n("Files smaller than %1 KiB", mRulesPreviewMinimumFileSize);
+        sizeRule[QStringLiteral("prunedPaths")] = prunedPathsCount.last();
+        mRulesPreview.push_back(sizeRule);
+    }
+
+    Q_EMIT rulesPreviewChanged();
+    Q_EMIT isComputingRulesPreviewChanged();
+}
+
 void KCMElisaLocalFile::configChanged()
 {
     setRootPath(Elisa::ElisaConfiguration::rootPath());
+    setExcludedPatterns(Elisa::ElisaConfiguration::excludedPatterns());
+    setMinimumFileSize(Elisa::ElisaConfiguration::minimumFileSize());
 }
 
 
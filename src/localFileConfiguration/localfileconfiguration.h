@@ -22,7 +22,10 @@
 
 #include <KQuickAddons/ConfigModule>
 #include <QStringList>
+#include <QVariantList>
+#include <QVector>
 #include <QFileSystemWatcher>
+#include <QFutureWatcher>
 
 class KCMElisaLocalFile : public KQuickAddons::ConfigModule
 {
@@ -34,6 +37,24 @@ class KCMElisaLocalFile : public KQuickAddons::ConfigModule
                WRITE setRootPath
                NOTIFY rootPathChanged)
 
+    Q_PROPERTY(QStringList excludedPatterns
+               READ excludedPatterns
+               WRITE setExcludedPatterns
+               NOTIFY excludedPatternsChanged)
+
+    Q_PROPERTY(int minimumFileSize
+               READ minimumFileSize
+               WRITE setMinimumFileSize
+               NOTIFY minimumFileSizeChanged)
+
+    Q_PROPERTY(QVariantList rulesPreview
+               READ rulesPreview
+               NOTIFY rulesPreviewChanged)
+
+    Q_PROPERTY(bool isComputingRulesPreview
+               READ isComputingRulesPreview
+               NOTIFY isComputingRulesPreviewChanged)
+
 public:
 
     explicit KCMElisaLocalFile(QObject *parent, const QVariantList &args);
@@ -42,10 +63,26 @@ public:
 
     QStringList rootPath() const;
 
+    QStringList excludedPatterns() const;
+
+    int minimumFileSize() const;
+
+    QVariantList rulesPreview() const;
+
+    bool isComputingRulesPreview() const;
+
 Q_SIGNALS:
 
     void rootPathChanged(QStringList rootPath);
 
+    void excludedPatternsChanged(QStringList excludedPatterns);
+
+    void minimumFileSizeChanged(int minimumFileSize);
+
+    void rulesPreviewChanged();
+
+    void isComputingRulesPreviewChanged();
+
 public Q_SLOTS:
 
     void defaults() override final;
@@ -56,14 +93,34 @@ public Q_SLOTS:
 
     void setRootPath(QStringList rootPath);
 
+    void setExcludedPatterns(QStringList excludedPatterns);
+
+    void setMinimumFileSize(int minimumFileSize);
+
+    void computeRulesPreview();
+
 private Q_SLOTS:
 
     void configChanged();
 
+    void rulesPreviewFinished();
+
 private:
 
     QStringList mRootPath;
 
+    QStringList mExcludedPatterns;
+
+    int mMinimumFileSize = 0;
+
+    QVariantList mRulesPreview;
+
+    QStringList mRulesPreviewPatterns;
+
+    int mRulesPreviewMinimumFileSize = 0;
+
+    QFutureWatcher<QVector<int>> mRulesPreviewWatcher;
+
     QFileSystemWatcher mConfigFileWatcher;
 
 };
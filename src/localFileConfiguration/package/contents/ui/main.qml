@@ -28,7 +28,7 @@ Item {
     //implicitWidth and implicitHeight will be used as initial size
     //when loaded in kcmshell5
     implicitWidth: 400
-    implicitHeight: 200
+    implicitHeight: 450
 
     LayoutMirroring.enabled: Qt.application.layoutDirection == Qt.RightToLeft
     LayoutMirroring.childrenInherit: true
@@ -96,61 +96,143 @@ Item {
         }
     }
 
-    RowLayout {
-        spacing: 0
-
+    ColumnLayout {
         anchors.fill: parent
 
-        ScrollView {
-            flickableItem.boundsBehavior: Flickable.StopAtBounds
+        RowLayout {
+            spacing: 0
 
             Layout.fillWidth: true
             Layout.fillHeight: true
 
-            ListView {
-                id:pathList
+            ScrollView {
+                flickableItem.boundsBehavior: Flickable.StopAtBounds
 
-                anchors.fill: parent
+                Layout.fillWidth: true
+                Layout.fillHeight: true
+
+                ListView {
+                    id:pathList
+
+                    anchors.fill: parent
+
+                    model: DelegateModel {
+                        model: kcm.rootPath
+
+                        delegate: pathDelegate
+                    }
+
+                    highlight: highlightBar
+                }
+            }
+
+            ColumnLayout {
+                Layout.fillHeight: true
+                Layout.leftMargin: !LayoutMirroring.enabled ? (0.3 * 30) : 0
+                Layout.rightMargin: LayoutMirroring.enabled ? (0.3 * 30) : 0
+
+                Button {
+                    text: i18n("Add new path")
+                    onClicked: fileDialog.open()
+
+                    Layout.alignment: Qt.AlignTop | Qt.AlignLeft
+
+                    FileDialog {
+                        id: fileDialog
+                        title: i18n("Choose a Folder")
+                        folder: shortcuts.home
+                        selectFolder: true
 
-                model: DelegateModel {
-                    model: kcm.rootPath
+                        visible: false
 
-                    delegate: pathDelegate
+                        onAccepted: {
+                            var oldPaths = kcm.rootPath
+                            oldPaths.push(fileDialog.fileUrls)
+                            kcm.rootPath = oldPaths
+                        }
+                    }
                 }
 
-                highlight: highlightBar
+                Item {
+                    Layout.fillHeight: true
+                }
             }
         }
 
-        ColumnLayout {
-            Layout.fillHeight: true
-            Layout.leftMargin: !LayoutMirroring.enabled ? (0.3 * 30) : 0
-            Layout.rightMargin: LayoutMirroring.enabled ? (0.3 * 30) : 0
+        GroupBox {
+            title: i18n("Exclusions")
+
+            Layout.fillWidth: true
+
+            ColumnLayout {
+                anchors.fill: parent
+
+                Label {
+                    text: i18n("Files and folders matching one of these patterns are not indexed (one pattern per line):")
+
+                    wrapMode: Text.WordWrap
+                    Layout.fillWidth: true
+                }
 
-            Button {
-                text: i18n("Add new path")
-                onClicked: fileDialog.open()
+                TextArea {
+                    id: excludedPatternsArea
 
-                Layout.alignment: Qt.AlignTop | Qt.AlignLeft
+                    Layout.fillWidth: true
+                    Layout.preferredHeight: 4 * 20
 
-                FileDialog {
-                    id: fileDialog
-                    title: i18n("Choose a Folder")
-                    folder: shortcuts.home
-                    selectFolder: true
+                    Component.onCompleted: text = kcm.excludedPatterns.join('\n')
 
-                    visible: false
+                    onTextChanged: kcm.excludedPatterns = text.split('\n')
 
-                    onAccepted: {
-                        var oldPaths = kcm.rootPath
-                        oldPaths.push(fileDialog.fileUrls)
-                        kcm.rootPath = oldPaths
+                    Connections {
+                        target: kcm
+
+                        onExcludedPatternsChanged: {
+                            if (!excludedPatternsArea.activeFocus) {
+                                excludedPatternsArea.text = excludedPatterns.join('\n')
+                            }
+                        }
                     }
                 }
-            }
 
-            Item {
-                Layout.fillHeight: true
+                RowLayout {
+                    Layout.fillWidth: true
+
+                    Label {
+                        text: i18n("Ignore files smaller than:")
+                    }
+
+                    SpinBox {
+                        minimumValue: 0
+                        maximumValue: 1048576
+                        suffix: i18n(" KiB")
+
+                        value: kcm.minimumFileSize
+
+                        onValueChanged: kcm.minimumFileSize = value
+                    }
+
+                    Item {
+                        Layout.fillWidth: true
+                    }
+
+                    Button {
+                        text: i18n("Preview")
+                        enabled: !kcm.isComputingRulesPreview
+
+                        onClicked: kcm.computeRulesPreview()
+                    }
+                }
+
+                Repeater {
+                    model: kcm.rulesPreview
+
+                    delegate: Label {
+                        text: i18np("%2: %1 path pruned", "%2: %1 paths pruned", modelData.prunedPaths, modelData.rule)
+
+                        Layout.fillWidth: true
+                    }
+                }
             }
         }
     }
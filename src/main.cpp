@@ -61,6 +61,7 @@
 #include "elisa_settings.h"
 #include "trackdatahelper.h"
 #include "elisautils.h"
+#include "coverthumbnailprovider.h"
 
 #if defined Qt5DBus_FOUND && Qt5DBus_FOUND
 #include "mpris2/mpris2.h"
@@ -170,10 +171,14 @@ int main(int argc, char *argv[])
 
     qRegisterMetaType<AbstractMediaProxyModel*>();
     qRegisterMetaType<QHash<QString,QUrl>>("QHash<QString,QUrl>");
+    qRegisterMetaType<QList<QUrl>>("QList<QUrl>");
+    qRegisterMetaType<QHash<QUrl,QUrl>>("QHash<QUrl,QUrl>");
     qRegisterMetaType<QList<MusicAudioTrack>>("QList<MusicAudioTrack>");
     qRegisterMetaType<QList<MusicAudioTrack>>("QVector<MusicAudioTrack>");
     qRegisterMetaType<QList<MusicAlbum>>("QList<MusicAlbum>");
     qRegisterMetaType<QVector<qulonglong>>("QVector<qulonglong>");
+    qRegisterMetaType<QList<qulonglong>>("QList<qulonglong>");
+    qRegisterMetaType<QList<MusicArtist>>("QList<MusicArtist>");
     qRegisterMetaType<QHash<qulonglong,int>>("QHash<qulonglong,int>");
     qRegisterMetaType<MusicAlbum>("MusicAlbum");
     qRegisterMetaType<MusicArtist>("MusicArtist");
@@ -245,6 +250,8 @@ int main(int argc, char *argv[])
     engine.addImportPath(QStringLiteral("qrc:/imports"));
     QQmlFileSelector selector(&engine);
 
+    engine.addImageProvider(QStringLiteral("cover"), new CoverThumbnailProvider);
+
 #if defined KF5Declarative_FOUND && KF5Declarative_FOUND
     KDeclarative::KDeclarative decl;
     decl.setDeclarativeEngine(&engine);
@@ -21,20 +21,349 @@
 #include "databaseinterface.h"
 #include "musicaudiotrack.h"
 #include "musiclistenersmanager.h"
+#include "displaytextformatter.h"
 
 #include <QUrl>
+#include <QHash>
+#include <QVector>
 #include <QPersistentModelIndex>
 #include <QList>
 #include <QMediaPlaylist>
 #include <QFileInfo>
+#include <QDataStream>
+#include <QTimer>
+#include <QSet>
 #include <QDebug>
 
 #include <algorithm>
 
+/* key of the entries restored by name, the fields trackChanged compares them on */
+static QString entryNameKey(const QString &title, const QString &album, int trackNumber, int discNumber)
+{
+    return title + QChar(0x1f) + album + QChar(0x1f) + QString::number(trackNumber) + QChar(0x1f) + QString::number(discNumber);
+}
+
+/* version of the binary playlist stored in the persistent state */
+static const quint32 persistentPlayListVersion = 1;
+
+/* a paged playlist reads the whole tracks again one page of rows at a time, the last pages read by the views keep them */
+static const int pagedTracksPageSize = 100;
+
+static const int pagedTracksRecentPages = 10;
+
+/* whole tracks stored between two releases of the rows far from the views */
+static const int pagedTracksReleaseInterval = 2000;
+
+/* what a paged playlist keeps of a released track: its name, album header, file and duration */
+static MusicAudioTrack partialTrack(const MusicAudioTrack &track)
+{
+    auto result = MusicAudioTrack();
+
+    result.setValid(true);
+    result.setDatabaseId(track.databaseId());
+    result.setTitle(track.title());
+    result.setArtist(track.artist());
+    result.setAlbumName(track.albumName());
+    result.setAlbumArtist(track.albumArtist());
+    result.setTrackNumber(track.trackNumber());
+    result.setDiscNumber(track.discNumber());
+    result.setIsSingleDiscAlbum(track.isSingleDiscAlbum());
+    result.setDuration(track.duration());
+    result.setResourceURI(track.resourceURI());
+
+    return result;
+}
+
+/* entry of a saved track: its database id if known, else its file, else its name */
+static MediaPlayListEntry savedPlayListEntry(qulonglong databaseId, const QUrl &trackUrl, const QString &title, const QString &artist,
+                                             const QString &album, int trackNumber, int discNumber)
+{
+    if (databaseId != 0) {
+        /* the name is kept to find the track again if this id is no longer in the database */
+        auto restoredEntry = MediaPlayListEntry(databaseId);
+        restoredEntry.mTitle = title;
+        restoredEntry.mArtist = artist;
+        restoredEntry.mAlbum = album;
+        restoredEntry.mTrackNumber = trackNumber;
+        restoredEntry.mDiscNumber = discNumber;
+        return restoredEntry;
+    }
+
+    if (trackUrl.isValid()) {
+        return MediaPlayListEntry(trackUrl);
+    }
+
+    if (title.isEmpty() && !artist.isEmpty()) {
+        return MediaPlayListEntry(artist);
+    }
+
+    return {title, artist, album, trackNumber, discNumber};
+}
+
+/* keys a playlist entry is listed under, kept to remove them when the entry changes */
+struct IndexedRowKeys
+{
+    qulonglong mId = 0;
+
+    QUrl mTrackUrl;
+
+    QString mNameKey;
+
+    bool mHasName = false;
+};
+
 class MediaPlayListPrivate
 {
 public:
 
+    /* indexes the rows appended since the last call */
+    void updateRowsIndex()
+    {
+        const auto knownRowsAreCurrent = (mFirstStaleRow >= mIndexedRowsCount);
+
+        mIndexedKeys.reserve(mData.size());
+        mHandleRows.reserve(mData.size());
+        for (int row = mIndexedRowsCount; row < mData.size(); ++row) {
+            const auto handle = mNextIndexHandle++;
+
+            mData[row].mIndexHandle = handle;
+            mHandleRows[handle] = row;
+            mIndexedKeys[handle] = indexEntry(handle, mData.at(row));
+        }
+
+        mIndexedRowsCount = mData.size();
+
+        if (knownRowsAreCurrent) {
+            mFirstStaleRow = mIndexedRowsCount;
+        }
+    }
+
+    void invalidateRowsIndex()
+    {
+        mRowsById.clear();
+        mRowsByUrl.clear();
+        mRowsByName.clear();
+        mIndexedKeys.clear();
+        mHandleRows.clear();
+        mIndexedRowsCount = 0;
+        mFirstStaleRow = 0;
+    }
+
+    /* replaces the keys of an entry whose id or name changed */
+    void reindexRow(int row)
+    {
+        if (row < mIndexedRowsCount) {
+            const auto handle = mData.at(row).mIndexHandle;
+
+            unindexEntry(handle);
+            mIndexedKeys[handle] = indexEntry(handle, mData.at(row));
+        }
+    }
+
+    /* drops the rows about to be removed from the index, the rows following them are found again on the next lookup */
+    void removeRowsFromIndex(int firstRow, int count)
+    {
+        if (firstRow >= mIndexedRowsCount) {
+            return;
+        }
+
+        const auto lastIndexedRow = std::min(firstRow + count, mIndexedRowsCount);
+
+        for (int row = firstRow; row < lastIndexedRow; ++row) {
+            const auto handle = mData.at(row).mIndexHandle;
+
+            unindexEntry(handle);
+            mIndexedKeys.remove(handle);
+            mHandleRows.remove(handle);
+        }
+
+        mIndexedRowsCount -= lastIndexedRow - firstRow;
+        mFirstStaleRow = std::min(mFirstStaleRow, firstRow);
+    }
+
+    /* same positions as QAbstractItemModel::beginMoveRows, called before the rows are moved */
+    void moveRowsInIndex(int sourceRow, int count, int destinationChild)
+    {
+        if (mIndexedRowsCount == 0) {
+            return;
+        }
+
+        /* the moved rows and the ones they cross must be indexed to keep the indexed rows first */
+        if (std::max(sourceRow + count, destinationChild) > mIndexedRowsCount) {
+            updateRowsIndex();
+        }
+
+        mFirstStaleRow = std::min(mFirstStaleRow, std::min(sourceRow, destinationChild));
+    }
+
+    /* rows of the entries listed under this key, in no particular order; callers check the entry itself */
+    template <typename Key>
+    QVector<int> indexedRows(const QHash<Key, QSet<quint64>> &handlesIndex, const Key &key)
+    {
+        auto result = QVector<int>();
+
+        auto itHandles = handlesIndex.constFind(key);
+        if (itHandles == handlesIndex.constEnd()) {
+            return result;
+        }
+
+        result.reserve(itHandles->size());
+        for (auto oneHandle : *itHandles) {
+            result.push_back(handleRow(oneHandle));
+        }
+
+        return result;
+    }
+
+    /* rows of the handles are only read again from the entries after an edit moved them */
+    int handleRow(quint64 handle)
+    {
+        auto itRow = mHandleRows.constFind(handle);
+        if (itRow != mHandleRows.constEnd() && itRow.value() < mFirstStaleRow) {
+            return itRow.value();
+        }
+
+        for (int row = mFirstStaleRow; row < mIndexedRowsCount; ++row) {
+            mHandleRows[mData.at(row).mIndexHandle] = row;
+        }
+
+        mFirstStaleRow = mIndexedRowsCount;
+
+        return mHandleRows.value(handle, -1);
+    }
+
+    IndexedRowKeys indexEntry(quint64 handle, const MediaPlayListEntry &oneEntry)
+    {
+        auto rowKeys = IndexedRowKeys();
+
+        /* entries waiting for their track are found by file or by name */
+        if (oneEntry.mId != 0) {
+            rowKeys.mId = oneEntry.mId;
+            mRowsById[rowKeys.mId].insert(handle);
+        }
+
+        if (oneEntry.mTrackUrl.isValid()) {
+            rowKeys.mTrackUrl = oneEntry.mTrackUrl;
+            mRowsByUrl[rowKeys.mTrackUrl].insert(handle);
+        }
+
+        if (!oneEntry.mIsArtist) {
+            rowKeys.mHasName = true;
+            rowKeys.mNameKey = entryNameKey(oneEntry.mTitle, oneEntry.mAlbum, oneEntry.mTrackNumber, oneEntry.mDiscNumber);
+            mRowsByName[rowKeys.mNameKey].insert(handle);
+        }
+
+        return rowKeys;
+    }
+
+    /* removes an entry from the keys it was indexed under */
+    void unindexEntry(quint64 handle)
+    {
+        const auto &rowKeys = mIndexedKeys[handle];
+
+        if (rowKeys.mId != 0) {
+            removeIndexedHandle(mRowsById, rowKeys.mId, handle);
+        }
+
+        if (rowKeys.mTrackUrl.isValid()) {
+            removeIndexedHandle(mRowsByUrl, rowKeys.mTrackUrl, handle);
+        }
+
+        if (rowKeys.mHasName) {
+            removeIndexedHandle(mRowsByName, rowKeys.mNameKey, handle);
+        }
+    }
+
+    template <typename Key>
+    static void removeIndexedHandle(QHash<Key, QSet<quint64>> &handlesIndex, const Key &key, quint64 handle)
+    {
+        auto itHandles = handlesIndex.find(key);
+        if (itHandles == handlesIndex.end()) {
+            return;
+        }
+
+        itHandles->remove(handle);
+
+        if (itHandles->isEmpty()) {
+            handlesIndex.erase(itHandles);
+        }
+    }
+
+    /* counts a whole track stored in a row, a paged playlist only releases the pages holding one */
+    void trackStored(int row)
+    {
+        ++mStoredTracksCount;
+
+        if (mPaged) {
+            mLoadedPages.insert(row / pagedTracksPageSize);
+        }
+    }
+
+    /* adds the pages the loaded rows of [firstRow, lastRow) land on once moved by delta rows */
+    void addMovedLoadedRows(QSet<int> &movedPages, int firstRow, int lastRow, int delta) const
+    {
+        for (auto onePage : mLoadedPages) {
+            const auto firstLoadedRow = std::max(onePage * pagedTracksPageSize, firstRow);
+            const auto lastLoadedRow = std::min((onePage + 1) * pagedTracksPageSize, lastRow);
+
+            if (firstLoadedRow >= lastLoadedRow) {
+                continue;
+            }
+
+            for (int page = (firstLoadedRow + delta) / pagedTracksPageSize; page <= (lastLoadedRow - 1 + delta) / pagedTracksPageSize; ++page) {
+                movedPages.insert(page);
+            }
+        }
+    }
+
+    /* same positions as removeRowsFromIndex, called before the rows are removed */
+    void removeRowsFromLoadedPages(int firstRow, int count)
+    {
+        if (mLoadedPages.isEmpty()) {
+            return;
+        }
+
+        auto movedPages = QSet<int>();
+        addMovedLoadedRows(movedPages, 0, firstRow, 0);
+        addMovedLoadedRows(movedPages, firstRow + count, mData.size(), -count);
+
+        mLoadedPages = movedPages;
+    }
+
+    /* same positions as QAbstractItemModel::beginMoveRows, called before the rows are moved */
+    void moveRowsInLoadedPages(int sourceRow, int count, int destinationChild)
+    {
+        if (mLoadedPages.isEmpty()) {
+            return;
+        }
+
+        auto movedPages = QSet<int>();
+        if (sourceRow < destinationChild) {
+            addMovedLoadedRows(movedPages, 0, sourceRow, 0);
+            addMovedLoadedRows(movedPages, sourceRow, sourceRow + count, destinationChild - count - sourceRow);
+            addMovedLoadedRows(movedPages, sourceRow + count, destinationChild, -count);
+            addMovedLoadedRows(movedPages, destinationChild, mData.size(), 0);
+        } else {
+            addMovedLoadedRows(movedPages, 0, destinationChild, 0);
+            addMovedLoadedRows(movedPages, destinationChild, sourceRow, count);
+            addMovedLoadedRows(movedPages, sourceRow, sourceRow + count, destinationChild - sourceRow);
+            addMovedLoadedRows(movedPages, sourceRow + count, mData.size(), 0);
+        }
+
+        mLoadedPages = movedPages;
+    }
+
+    /* queues the page of a released row, its whole tracks are asked to the database once the views are laid out */
+    void queueReleasedRow(int row)
+    {
+        const auto page = row / pagedTracksPageSize;
+
+        if (mData.at(row).mHasPartialTrack && !mPendingPages.contains(page)) {
+            mPendingPages.push_back(page);
+            mTrackRequestTimer.start();
+        }
+    }
+
     QList<MediaPlayListEntry> mData;
 
     QList<MusicAudioTrack> mTrackData;
@@ -53,12 +382,60 @@ public:
 
     QMediaPlaylist mLoadPlaylist;
 
+    /* handles of the entries listed under each database id, file url and name key */
+    QHash<qulonglong, QSet<quint64>> mRowsById;
+
+    QHash<QUrl, QSet<quint64>> mRowsByUrl;
+
+    QHash<QString, QSet<quint64>> mRowsByName;
+
+    /* keys of each indexed entry by its handle; the first mIndexedRowsCount rows are indexed */
+    QHash<quint64, IndexedRowKeys> mIndexedKeys;
+
+    int mIndexedRowsCount = 0;
+
+    /* row of each handle, right for the rows before mFirstStaleRow; edits only lower it */
+    QHash<quint64, int> mHandleRows;
+
+    int mFirstStaleRow = 0;
+
+    quint64 mNextIndexHandle = 1;
+
+    QString mStoredPlayListName;
+
+    bool mStoredEntriesPending = false;
+
+    bool mStoredEntriesNeedRewrite = false;
+
+    bool mRestoredFromState = false;
+
+    bool mPaged = false;
+
+    /* may count a row twice, it only spaces the releases out */
+    int mStoredTracksCount = 0;
+
+    /* pages that may hold whole tracks, the only ones a release goes over */
+    QSet<int> mLoadedPages;
+
+    QVector<int> mRecentPages;
+
+    QVector<int> mPendingPages;
+
+    /* released tracks asked to the database, not answered yet */
+    QSet<qulonglong> mRequestedTrackIds;
+
+    /* pages missing during one layout of the views are requested together */
+    QTimer mTrackRequestTimer;
+
 };
 
 MediaPlayList::MediaPlayList(QObject *parent) : QAbstractListModel(parent), d(new MediaPlayListPrivate)
 {
     connect(&d->mLoadPlaylist, &QMediaPlaylist::loaded, this, &MediaPlayList::loadPlayListLoaded);
     connect(&d->mLoadPlaylist, &QMediaPlaylist::loadFailed, this, &MediaPlayList::loadPlayListLoadFailed);
+    d->mTrackRequestTimer.setSingleShot(true);
+    d->mTrackRequestTimer.setInterval(0);
+    connect(&d->mTrackRequestTimer, &QTimer::timeout, this, &MediaPlayList::requestPendingTracks);
     seedRandomGenerator(QTime::currentTime().msec());
 }
 
@@ -121,65 +498,61 @@ QVariant MediaPlayList::data(const QModelIndex &index, int role) const
         return result;
     }
 
-    if (d->mData[index.row()].mIsValid) {
+    const auto &playListEntry = d->mData.at(index.row());
+    const auto &track = d->mTrackData.at(index.row());
+
+    if (playListEntry.mIsValid) {
         switch(role)
         {
         case ColumnsRoles::IsValidRole:
-            result = d->mData[index.row()].mIsValid;
+            result = playListEntry.mIsValid;
             break;
         case ColumnsRoles::TitleRole:
-            if (!d->mTrackData[index.row()].title().isEmpty()) {
-                result = d->mTrackData[index.row()].title();
+            if (!track.title().isEmpty()) {
+                result = track.title();
             } else {
-                if (d->mData[index.row()].mTrackUrl.isLocalFile()) {
-                    auto localFile = QFileInfo(d->mData[index.row()].mTrackUrl.toLocalFile());
+                if (playListEntry.mTrackUrl.isLocalFile()) {
+                    auto localFile = QFileInfo(playListEntry.mTrackUrl.toLocalFile());
                     result = localFile.fileName();
                 } else {
-                    result = d->mData[index.row()].mTrackUrl.toString();
+                    result = playListEntry.mTrackUrl.toString();
                 }
             }
             break;
         case ColumnsRoles::DurationRole:
-        {
-            const QTime &trackDuration = d->mTrackData[index.row()].duration();
-            if (trackDuration.hour() == 0) {
-                result = trackDuration.toString(QStringLiteral("mm:ss"));
-            } else {
-                result = trackDuration.toString();
-            }
+            result = DisplayTextFormatter::durationText(track.duration());
             break;
-        }
         case ColumnsRoles::MilliSecondsDurationRole:
-            result = d->mTrackData[index.row()].duration().msecsSinceStartOfDay();
+            result = track.duration().msecsSinceStartOfDay();
             break;
         case ColumnsRoles::ArtistRole:
-            result = d->mTrackData[index.row()].artist();
+            result = track.artist();
             break;
         case ColumnsRoles::AlbumArtistRole:
-            result = d->mTrackData[index.row()].albumArtist();
+            result = track.albumArtist();
             break;
         case ColumnsRoles::AlbumRole:
-            result = d->mTrackData[index.row()].albumName();
+            result = track.albumName();
             break;
         case ColumnsRoles::TrackNumberRole:
-            result = d->mTrackData[index.row()].trackNumber();
+            result = track.trackNumber();
             break;
         case ColumnsRoles::DiscNumberRole:
-            result = d->mTrackData[index.row()].discNumber();
+            result = track.discNumber();
             break;
         case ColumnsRoles::IsSingleDiscAlbumHeader:
-            result = d->mTrackData[index.row()].isSingleDiscAlbum();
+            result = track.isSingleDiscAlbum();
             break;
         case ColumnsRoles::ResourceRole:
-            if (d->mTrackData[index.row()].resourceURI().isValid()) {
-                result = d->mTrackData[index.row()].resourceURI();
+            if (track.resourceURI().isValid()) {
+                result = track.resourceURI();
             } else {
-                result = d->mData[index.row()].mTrackUrl;
+                result = playListEntry.mTrackUrl;
             }
             break;
         case ColumnsRoles::ImageRole:
         {
-            auto albumArt = d->mTrackData[index.row()].albumCover();
+            auto albumArt = track.albumCover();
             if (albumArt.isValid()) {
                 result = albumArt;
             }
@@ -189,40 +562,39 @@ QVariant MediaPlayList::data(const QModelIndex &index, int role) const
             result = rowHasHeader(index.row());
             break;
         case ColumnsRoles::RatingRole:
-            result = d->mTrackData[index.row()].rating();
+            result = track.rating();
             break;
         case ColumnsRoles::GenreRole:
-            result = d->mTrackData[index.row()].genre();
+            result = track.genre();
             break;
         case ColumnsRoles::LyricistRole:
-            result = d->mTrackData[index.row()].lyricist();
+            result = track.lyricist();
             break;
         case ColumnsRoles::ComposerRole:
-            result = d->mTrackData[index.row()].composer();
+            result = track.composer();
             break;
         case ColumnsRoles::CommentRole:
-            result = d->mTrackData[index.row()].comment();
+            result = track.comment();
             break;
         case ColumnsRoles::YearRole:
-            result = d->mTrackData[index.row()].year();
+            result = track.year();
             break;
         case ColumnsRoles::ChannelsRole:
-            result = d->mTrackData[index.row()].channels();
+            result = track.channels();
             break;
         case ColumnsRoles::BitRateRole:
-            result = d->mTrackData[index.row()].bitRate();
+            result = track.bitRate();
             break;
         case ColumnsRoles::SampleRateRole:
-            result = d->mTrackData[index.row()].sampleRate();
+            result = track.sampleRate();
             break;
         case ColumnsRoles::CountRole:
             break;
         case ColumnsRoles::IsPlayingRole:
-            result = d->mData[index.row()].mIsPlaying;
+            result = playListEntry.mIsPlaying;
             break;
         case Qt::DisplayRole:
         {
-            const auto &track = d->mTrackData[index.row()];
             auto displayText = QString();
             displayText = QStringLiteral("%1 - %2");
 
@@ -243,7 +615,7 @@ QVariant MediaPlayList::data(const QModelIndex &index, int role) const
             break;
         case ColumnsRoles::ImageUrlRole:
         {
-            const auto &albumArt = d->mTrackData[index.row()].albumCover();
+            const auto &albumArt = track.albumCover();
             if (albumArt.isValid()) {
                 result = albumArt;
             } else {
@@ -252,41 +624,41 @@ QVariant MediaPlayList::data(const QModelIndex &index, int role) const
             break;
         }
         case ColumnsRoles::ShadowForImageRole:
-            result = d->mTrackData[index.row()].albumCover().isValid();
+            result = track.albumCover().isValid();
             break;
         case ColumnsRoles::TrackDataRole:
-            result = QVariant::fromValue(d->mTrackData[index.row()]);
+            result = QVariant::fromValue(track);
             break;
         }
     } else {
         switch(role)
         {
         case ColumnsRoles::IsValidRole:
-            result = d->mData[index.row()].mIsValid;
+            result = playListEntry.mIsValid;
             break;
         case ColumnsRoles::TitleRole:
-            if (!d->mData[index.row()].mTitle.isEmpty()) {
-                result = d->mData[index.row()].mTitle;
-            } else if (d->mData[index.row()].mTrackUrl.isValid()) {
-                if (d->mData[index.row()].mTrackUrl.isLocalFile()) {
-                    auto localFile = QFileInfo(d->mData[index.row()].mTrackUrl.toLocalFile());
+            if (!playListEntry.mTitle.isEmpty()) {
+                result = playListEntry.mTitle;
+            } else if (playListEntry.mTrackUrl.isValid()) {
+                if (playListEntry.mTrackUrl.isLocalFile()) {
+                    auto localFile = QFileInfo(playListEntry.mTrackUrl.toLocalFile());
                     result = localFile.fileName();
                 } else {
-                    result = d->mData[index.row()].mTrackUrl.toString();
+                    result = playListEntry.mTrackUrl.toString();
                 }
             }
             break;
         case ColumnsRoles::IsPlayingRole:
-            result = d->mData[index.row()].mIsPlaying;
+            result = playListEntry.mIsPlaying;
             break;
         case ColumnsRoles::ArtistRole:
-            result = d->mData[index.row()].mArtist;
+            result = playListEntry.mArtist;
             break;
         case ColumnsRoles::AlbumArtistRole:
-            result = d->mData[index.row()].mArtist;
+            result = playListEntry.mArtist;
             break;
         case ColumnsRoles::AlbumRole:
-            result = d->mData[index.row()].mAlbum;
+            result = playListEntry.mAlbum;
             break;
         case ColumnsRoles::TrackNumberRole:
             result = -1;
@@ -313,7 +685,7 @@ QVariant MediaPlayList::data(const QModelIndex &index, int role) const
             result = QStringLiteral("");
             break;
         case Qt::DisplayRole:
-            result = d->mTrackData[index.row()].title();
+            result = track.title();
             break;
         case ColumnsRoles::SecondaryTextRole:
             result = QString();
@@ -376,51 +748,11 @@ bool MediaPlayList::setData(const QModelIndex &index, const QVariant &value, int
 
 bool MediaPlayList::removeRows(int row, int count, const QModelIndex &parent)
 {
-    beginRemoveRows(parent, row, row + count - 1);
-
-    bool hadAlbumHeader = false;
-
-    if (rowCount() > row + count) {
-        hadAlbumHeader = rowHasHeader(row + count);
-    }
-
-    for (int i = row, cpt = 0; cpt < count; ++i, ++cpt) {
-        d->mData.removeAt(i);
-        d->mTrackData.removeAt(i);
-    }
-    endRemoveRows();
-
-    if (!d->mCurrentTrack.isValid()) {
-        d->mCurrentTrack = index(d->mCurrentPlayListPosition, 0);
-
-        if (d->mCurrentTrack.isValid()) {
-            notifyCurrentTrackChanged();
-        }
-
-        if (!d->mCurrentTrack.isValid()) {
-            Q_EMIT playListFinished();
-            resetCurrentTrack();
-            if (!d->mCurrentTrack.isValid()) {
-                notifyCurrentTrackChanged();
-            }
-        }
-    }
-
-    if (!d->mCurrentTrack.isValid() && rowCount(parent) <= row) {
-        resetCurrentTrack();
-    }
-
-    Q_EMIT tracksCountChanged();
-
-    if (hadAlbumHeader != rowHasHeader(row)) {
-        Q_EMIT dataChanged(index(row, 0), index(row, 0), {ColumnsRoles::HasAlbumHeader});
-
-        if (!d->mCurrentTrack.isValid()) {
-            resetCurrentTrack();
-        }
+    if (parent.isValid()) {
+        return false;
     }
 
-    Q_EMIT persistentStateChanged();
+    removeRanges({{row, count}});
 
     return false;
 }
@@ -431,87 +763,52 @@ bool MediaPlayList::moveRows(const QModelIndex &sourceParent, int sourceRow, int
         return false;
     }
 
-    if (!beginMoveRows(sourceParent, sourceRow, sourceRow + count - 1, destinationParent, destinationChild)) {
+    if (!moveRange(sourceRow, count, destinationChild)) {
         return false;
     }
 
-    auto firstMovedTrackHasHeader = rowHasHeader(sourceRow);
-    auto nextTrackHasHeader = rowHasHeader(sourceRow + count);
-    auto futureNextTrackHasHeader = rowHasHeader(destinationChild);
-    if (sourceRow < destinationChild) {
-        nextTrackHasHeader = rowHasHeader(sourceRow + count);
-    }
+    Q_EMIT persistentStateChanged();
 
-    for (auto cptItem = 0; cptItem < count; ++cptItem) {
-        if (sourceRow < destinationChild) {
-            d->mData.move(sourceRow, destinationChild - 1);
-            d->mTrackData.move(sourceRow, destinationChild - 1);
-        } else {
-            d->mData.move(sourceRow, destinationChild);
-            d->mTrackData.move(sourceRow, destinationChild);
-        }
-    }
+    return true;
+}
 
-    endMoveRows();
+void MediaPlayList::moveSelection(QList<int> selection, int destinationRow)
+{
+    const auto selectedRanges = contiguousRanges(std::move(selection));
 
-    if (sourceRow < destinationChild) {
-        if (firstMovedTrackHasHeader != rowHasHeader(destinationChild - count)) {
-            Q_EMIT dataChanged(index(destinationChild - count, 0), index(destinationChild - count, 0), {ColumnsRoles::HasAlbumHeader});
+    auto hasMoved = false;
+    auto movedBefore = 0;
+    auto insertionRow = destinationRow;
 
-            if (!d->mCurrentTrack.isValid()) {
-                resetCurrentTrack();
-            }
-        }
-    } else {
-        if (firstMovedTrackHasHeader != rowHasHeader(destinationChild)) {
-            Q_EMIT dataChanged(index(destinationChild, 0), index(destinationChild, 0), {ColumnsRoles::HasAlbumHeader});
+    for (const auto &oneRange : selectedRanges) {
+        auto firstRow = oneRange.first;
+        auto count = oneRange.second;
 
-            if (!d->mCurrentTrack.isValid()) {
-                resetCurrentTrack();
-            }
-        }
-    }
+        /* rows above the destination keep their order when moved one range after the other */
+        if (firstRow < destinationRow) {
+            const auto rowsBeforeDestination = std::min(count, destinationRow - firstRow);
 
-    if (sourceRow < destinationChild) {
-        if (nextTrackHasHeader != rowHasHeader(sourceRow)) {
-            Q_EMIT dataChanged(index(sourceRow, 0), index(sourceRow, 0), {ColumnsRoles::HasAlbumHeader});
+            hasMoved = moveRange(firstRow - movedBefore, rowsBeforeDestination, destinationRow) || hasMoved;
+            movedBefore += rowsBeforeDestination;
 
-            if (!d->mCurrentTrack.isValid()) {
-                resetCurrentTrack();
-            }
-        }
-    } else {
-        if (nextTrackHasHeader != rowHasHeader(sourceRow + count)) {
-            Q_EMIT dataChanged(index(sourceRow + count, 0), index(sourceRow + count, 0), {ColumnsRoles::HasAlbumHeader});
+            firstRow += rowsBeforeDestination;
+            count -= rowsBeforeDestination;
 
-            if (!d->mCurrentTrack.isValid()) {
-                resetCurrentTrack();
+            if (count == 0) {
+                continue;
             }
         }
-    }
-
-    if (sourceRow < destinationChild) {
-        if (futureNextTrackHasHeader != rowHasHeader(destinationChild + count - 1)) {
-            Q_EMIT dataChanged(index(destinationChild + count - 1, 0), index(destinationChild + count - 1, 0), {ColumnsRoles::HasAlbumHeader});
 
-            if (!d->mCurrentTrack.isValid()) {
-                resetCurrentTrack();
-            }
+        if (firstRow != insertionRow) {
+            hasMoved = moveRange(firstRow, count, insertionRow) || hasMoved;
         }
-    } else {
-        if (futureNextTrackHasHeader != rowHasHeader(destinationChild + count)) {
-            Q_EMIT dataChanged(index(destinationChild + count, 0), index(destinationChild + count, 0), {ColumnsRoles::HasAlbumHeader});
+        insertionRow += count;
+    }
 
-            if (!d->mCurrentTrack.isValid()) {
-                resetCurrentTrack();
-            }
-        }
+    if (hasMoved) {
+        Q_EMIT persistentStateChanged();
     }
-
-    Q_EMIT persistentStateChanged();
-
-    return true;
-}
+}
 
 void MediaPlayList::move(int from, int to, int n)
 {
@@ -534,56 +831,24 @@ void MediaPlayList::enqueue(const MusicAudioTrack &newTrack)
 
 void MediaPlayList::enqueue(const MediaPlayListEntry &newEntry, const MusicAudioTrack &audioTrack)
 {
-    beginInsertRows(QModelIndex(), d->mData.size(), d->mData.size());
-    d->mData.push_back(newEntry);
-    if (audioTrack.isValid()) {
-        d->mTrackData.push_back(audioTrack);
-    } else {
-        d->mTrackData.push_back({});
-    }
-    endInsertRows();
-
-    restorePlayListPosition();
-    if (!d->mCurrentTrack.isValid()) {
-        resetCurrentTrack();
-    }
-
-    Q_EMIT tracksCountChanged();
-    Q_EMIT persistentStateChanged();
-
-    if (!newEntry.mIsValid) {
-        if (newEntry.mTrackUrl.isValid()) {
-            qDebug() << "MediaPlayList::enqueue" << "newTrackByFileNameInList" << newEntry.mTrackUrl;
-            if (newEntry.mTrackUrl.isLocalFile()) {
-                QFileInfo newTrackFile(newEntry.mTrackUrl.toLocalFile());
-                if (newTrackFile.exists()) {
-                    d->mData.last().mIsValid = true;
-                }
-                Q_EMIT newTrackByFileNameInList(newEntry.mTrackUrl);
-            }
-        } else {
-            Q_EMIT newTrackByNameInList(newEntry.mTitle, newEntry.mArtist, newEntry.mAlbum, newEntry.mTrackNumber, newEntry.mDiscNumber);
-        }
-    } else {
-        Q_EMIT newTrackByIdInList(newEntry.mId);
-    }
-
-    Q_EMIT trackHasBeenAdded(data(index(d->mData.size() - 1, 0), ColumnsRoles::TitleRole).toString(), data(index(d->mData.size() - 1, 0), ColumnsRoles::ImageRole).toUrl());
-
-    if (!newEntry.mIsValid) {
-        Q_EMIT dataChanged(index(rowCount() - 1, 0), index(rowCount() - 1, 0), {MediaPlayList::HasAlbumHeader});
-
-        if (!d->mCurrentTrack.isValid()) {
-            resetCurrentTrack();
-        }
-    }
+    enqueueEntries({newEntry}, {audioTrack});
 }
 
 void MediaPlayList::enqueue(const MusicAlbum &album)
 {
+    auto newEntries = QList<MediaPlayListEntry>();
+    auto newTracks = QList<MusicAudioTrack>();
+
+    newEntries.reserve(album.tracksCount());
+    newTracks.reserve(album.tracksCount());
+
     for (auto oneTrackIndex = 0; oneTrackIndex < album.tracksCount(); ++oneTrackIndex) {
-        enqueue(album.trackFromIndex(oneTrackIndex));
+        const auto &oneTrack = album.trackFromIndex(oneTrackIndex);
+        newEntries.push_back(MediaPlayListEntry{oneTrack});
+        newTracks.push_back(oneTrack);
     }
+
+    enqueueEntries(newEntries, newTracks);
 }
 
 void MediaPlayList::enqueue(const MusicArtist &artist)
@@ -593,19 +858,7 @@ void MediaPlayList::enqueue(const MusicArtist &artist)
 
 void MediaPlayList::enqueue(const QString &artistName)
 {
-    beginInsertRows(QModelIndex(), d->mData.size(), d->mData.size());
-    d->mData.push_back(MediaPlayListEntry{artistName});
-    d->mTrackData.push_back({});
-    endInsertRows();
-
-    restorePlayListPosition();
-    if (!d->mCurrentTrack.isValid()) {
-        resetCurrentTrack();
-    }
-
-    Q_EMIT tracksCountChanged();
-    Q_EMIT newArtistInList(artistName);
-    Q_EMIT persistentStateChanged();
+    enqueueEntries({MediaPlayListEntry{artistName}}, {});
 }
 
 void MediaPlayList::enqueue(const QUrl &fileName)
@@ -617,9 +870,15 @@ void MediaPlayList::enqueue(const QUrl &fileName)
 void MediaPlayList::enqueue(const QStringList &files)
 {
     qDebug() << "MediaPlayList::enqueue" << files;
+
+    auto newEntries = QList<MediaPlayListEntry>();
+    newEntries.reserve(files.size());
+
     for (const auto &oneFileName : files) {
-        enqueue(QUrl::fromLocalFile(oneFileName));
+        newEntries.push_back(MediaPlayListEntry{QUrl::fromLocalFile(oneFileName)});
     }
+
+    enqueueEntries(newEntries, {});
 }
 
 void MediaPlayList::enqueueAndPlay(const QStringList &files)
@@ -634,23 +893,14 @@ void MediaPlayList::enqueueAndPlay(const QStringList &files)
 
 void MediaPlayList::enqueue(const QList<qulonglong> &newTrackIds)
 {
-    beginInsertRows(QModelIndex(), d->mData.size(), d->mData.size() + newTrackIds.size() - 1);
-    for (auto newTrackId : newTrackIds) {
-        d->mData.push_back(MediaPlayListEntry{newTrackId});
-        d->mTrackData.push_back({});
-        Q_EMIT newTrackByIdInList(newTrackId);
-    }
-    endInsertRows();
+    auto newEntries = QList<MediaPlayListEntry>();
+    newEntries.reserve(newTrackIds.size());
 
-    restorePlayListPosition();
-    if (!d->mCurrentTrack.isValid()) {
-        resetCurrentTrack();
+    for (auto newTrackId : newTrackIds) {
+        newEntries.push_back(MediaPlayListEntry{newTrackId});
     }
 
-    Q_EMIT tracksCountChanged();
-    Q_EMIT persistentStateChanged();
-
-    Q_EMIT dataChanged(index(rowCount() - 1, 0), index(rowCount() - 1, 0), {MediaPlayList::HasAlbumHeader});
+    enqueueEntries(newEntries, {});
 }
 
 void MediaPlayList::enqueue(const QList<MusicAlbum> &albums,
@@ -659,34 +909,28 @@ void MediaPlayList::enqueue(const QList<MusicAlbum> &albums,
 {
     auto tracksCount = 0;
     for (const auto &oneAlbum : albums) {
-        for (auto oneTrackIndex = 0; oneTrackIndex < oneAlbum.tracksCount(); ++oneTrackIndex) {
-            ++tracksCount;
-        }
+        tracksCount += oneAlbum.tracksCount();
     }
 
-    if (enqueueMode == ElisaUtils::ReplacePlayList) {
-        clearPlayList();
-    }
+    auto newEntries = QList<MediaPlayListEntry>();
+    auto newTracks = QList<MusicAudioTrack>();
+
+    newEntries.reserve(tracksCount);
+    newTracks.reserve(tracksCount);
 
-    beginInsertRows(QModelIndex(), d->mData.size(), d->mData.size() + tracksCount - 1);
     for (const auto &oneAlbum : albums) {
         for (auto oneTrackIndex = 0; oneTrackIndex < oneAlbum.tracksCount(); ++oneTrackIndex) {
             const auto &oneTrack = oneAlbum.trackFromIndex(oneTrackIndex);
-            d->mData.push_back(MediaPlayListEntry{oneTrack.databaseId()});
-            d->mTrackData.push_back(oneTrack);
+            newEntries.push_back(MediaPlayListEntry{oneTrack});
+            newTracks.push_back(oneTrack);
         }
     }
-    endInsertRows();
 
-    restorePlayListPosition();
-    if (!d->mCurrentTrack.isValid()) {
-        resetCurrentTrack();
+    if (enqueueMode == ElisaUtils::ReplacePlayList) {
+        clearPlayList();
     }
 
-    Q_EMIT tracksCountChanged();
-    Q_EMIT persistentStateChanged();
-
-    Q_EMIT dataChanged(index(rowCount() - 1, 0), index(rowCount() - 1, 0), {MediaPlayList::HasAlbumHeader});
+    enqueueEntries(newEntries, newTracks);
 
     if (triggerPlay == ElisaUtils::TriggerPlay) {
         Q_EMIT ensurePlay();
@@ -697,26 +941,33 @@ void MediaPlayList::enqueue(const QList<MusicAudioTrack> &tracks,
                             ElisaUtils::PlayListEnqueueMode enqueueMode,
                             ElisaUtils::PlayListEnqueueTriggerPlay triggerPlay)
 {
+    auto newEntries = QList<MediaPlayListEntry>();
+    newEntries.reserve(tracks.size());
+
+    for (const auto &oneTrack : tracks) {
+        newEntries.push_back(MediaPlayListEntry{oneTrack});
+    }
+
     if (enqueueMode == ElisaUtils::ReplacePlayList) {
         clearPlayList();
     }
 
-    beginInsertRows(QModelIndex(), d->mData.size(), d->mData.size() + tracks.size() - 1);
-    for (const auto &oneTrack : tracks) {
-        d->mData.push_back(MediaPlayListEntry{oneTrack.databaseId()});
-        d->mTrackData.push_back(oneTrack);
-    }
-    endInsertRows();
+    enqueueEntries(newEntries, tracks);
 
-    restorePlayListPosition();
-    if (!d->mCurrentTrack.isValid()) {
-        resetCurrentTrack();
+    if (triggerPlay == ElisaUtils::TriggerPlay) {
+        Q_EMIT ensurePlay();
     }
+}
 
-    Q_EMIT tracksCountChanged();
-    Q_EMIT persistentStateChanged();
+void MediaPlayList::enqueue(const QList<qulonglong> &newTrackIds,
+                            ElisaUtils::PlayListEnqueueMode enqueueMode,
+                            ElisaUtils::PlayListEnqueueTriggerPlay triggerPlay)
+{
+    if (enqueueMode == ElisaUtils::ReplacePlayList) {
+        clearPlayList();
+    }
 
-    Q_EMIT dataChanged(index(rowCount() - 1, 0), index(rowCount() - 1, 0), {MediaPlayList::HasAlbumHeader});
+    enqueue(newTrackIds);
 
     if (triggerPlay == ElisaUtils::TriggerPlay) {
         Q_EMIT ensurePlay();
@@ -727,25 +978,18 @@ void MediaPlayList::enqueueArtists(const QList<QString> &artistNames,
                                    ElisaUtils::PlayListEnqueueMode enqueueMode,
                                    ElisaUtils::PlayListEnqueueTriggerPlay triggerPlay)
 {
-    if (enqueueMode == ElisaUtils::ReplacePlayList) {
-        clearPlayList();
-    }
+    auto newEntries = QList<MediaPlayListEntry>();
+    newEntries.reserve(artistNames.size());
 
-    beginInsertRows(QModelIndex(), d->mData.size(), d->mData.size() + artistNames.size() - 1);
     for (const auto &artistName : artistNames) {
-        d->mData.push_back(MediaPlayListEntry{artistName});
-        d->mTrackData.push_back({});
-        Q_EMIT newArtistInList(artistName);
+        newEntries.push_back(MediaPlayListEntry{artistName});
     }
-    endInsertRows();
 
-    restorePlayListPosition();
-    if (!d->mCurrentTrack.isValid()) {
-        resetCurrentTrack();
+    if (enqueueMode == ElisaUtils::ReplacePlayList) {
+        clearPlayList();
     }
 
-    Q_EMIT tracksCountChanged();
-    Q_EMIT persistentStateChanged();
+    enqueueEntries(newEntries, {});
 
     if (triggerPlay == ElisaUtils::TriggerPlay) {
         Q_EMIT ensurePlay();
@@ -803,8 +1047,17 @@ void MediaPlayList::clearPlayList()
     beginRemoveRows({}, 0, d->mData.count() - 1);
     d->mData.clear();
     d->mTrackData.clear();
+    d->invalidateRowsIndex();
+    d->mPendingPages.clear();
+    d->mRequestedTrackIds.clear();
+    d->mStoredTracksCount = 0;
+    d->mLoadedPages.clear();
     endRemoveRows();
 
+    if (storedPlayListIsWritable()) {
+        Q_EMIT storedEntriesCleared(d->mStoredPlayListName);
+    }
+
     Q_EMIT tracksCountChanged();
 }
 
@@ -832,25 +1085,45 @@ bool MediaPlayList::savePlaylist(const QUrl &fileName)
 QVariantMap MediaPlayList::persistentState() const
 {
     auto currentState = QVariantMap();
-    auto result = QList<QVariant>();
 
-    for (int trackIndex = 0; trackIndex < d->mData.size(); ++trackIndex) {
-        auto oneData = QList<QString>();
-        const auto &oneEntry = d->mData[trackIndex];
-        if (oneEntry.mIsValid) {
-            const auto &oneTrack = d->mTrackData[trackIndex];
+    /* a playlist stored in the database is not duplicated in the settings */
+    if (d->mStoredPlayListName.isEmpty()) {
+        auto savedTracksCount = quint32(0);
+        for (const auto &oneEntry : qAsConst(d->mData)) {
+            if (oneEntry.mIsValid) {
+                ++savedTracksCount;
+            }
+        }
+
+        /* each track is saved by its database id, with its file or name to find it again when the id is unknown */
+        auto playListData = QByteArray();
+        QDataStream playListStream(&playListData, QIODevice::WriteOnly);
+        playListStream.setVersion(QDataStream::Qt_5_9);
+
+        playListStream << persistentPlayListVersion << savedTracksCount;
 
-            oneData.push_back(oneTrack.title());
-            oneData.push_back(oneTrack.artist());
-            oneData.push_back(oneTrack.albumName());
-            oneData.push_back(QString::number(oneTrack.trackNumber()));
-            oneData.push_back(QString::number(oneTrack.discNumber()));
+        for (int trackIndex = 0; trackIndex < d->mData.size(); ++trackIndex) {
+            const auto &oneEntry = d->mData[trackIndex];
+            if (!oneEntry.mIsValid) {
+                continue;
+            }
+
+            const auto &oneTrack = d->mTrackData[trackIndex];
 
-            result.push_back(QVariant(oneData));
+            if (oneTrack.isValid()) {
+                playListStream << quint64(oneTrack.databaseId()) << (oneTrack.databaseId() == 0 ? oneTrack.resourceURI() : QUrl())
+                               << oneTrack.title() << oneTrack.artist() << oneTrack.albumName()
+                               << qint32(oneTrack.trackNumber()) << qint32(oneTrack.discNumber());
+            } else {
+                playListStream << quint64(oneEntry.mId) << oneEntry.mTrackUrl
+                               << oneEntry.mTitle << oneEntry.mArtist << oneEntry.mAlbum
+                               << qint32(oneEntry.mTrackNumber) << qint32(oneEntry.mDiscNumber);
+            }
         }
+
+        currentState[QStringLiteral("playList")] = playListData;
     }
 
-    currentState[QStringLiteral("playList")] = result;
     currentState[QStringLiteral("currentTrack")] = d->mCurrentPlayListPosition;
     currentState[QStringLiteral("randomPlay")] = d->mRandomPlay;
     currentState[QStringLiteral("repeatPlay")] = d->mRepeatPlay;
@@ -898,23 +1171,39 @@ void MediaPlayList::setPersistentState(const QVariantMap &persistentStateValue)
 
     d->mPersistentState = persistentStateValue;
 
-    auto persistentState = d->mPersistentState[QStringLiteral("playList")].toList();
+    const auto persistentPlayList = d->mPersistentState[QStringLiteral("playList")];
 
-    for (auto &oneData : persistentState) {
-        auto trackData = oneData.toStringList();
-        if (trackData.size() != 5) {
-            continue;
-        }
+    auto restoredEntries = QList<MediaPlayListEntry>();
+
+    if (persistentPlayList.type() == QVariant::ByteArray) {
+        restoredEntries = restoredPlayListEntries(persistentPlayList.toByteArray());
+    } else {
+        /* playlists saved by older versions list each track as five strings */
+        const auto persistentState = persistentPlayList.toList();
+        restoredEntries.reserve(persistentState.size());
+
+        for (auto &oneData : persistentState) {
+            auto trackData = oneData.toStringList();
+            if (trackData.size() != 5) {
+                continue;
+            }
 
-        auto restoredTitle = trackData[0];
-        auto restoredArtist = trackData[1];
-        auto restoredAlbum = trackData[2];
-        auto restoredTrackNumber = trackData[3].toInt();
-        auto restoredDiscNumber = trackData[4].toInt();
+            auto restoredTitle = trackData[0];
+            auto restoredArtist = trackData[1];
+            auto restoredAlbum = trackData[2];
+            auto restoredTrackNumber = trackData[3].toInt();
+            auto restoredDiscNumber = trackData[4].toInt();
+
+            restoredEntries.push_back({restoredTitle, restoredArtist, restoredAlbum, restoredTrackNumber, restoredDiscNumber});
+        }
+    }
 
-        enqueue({restoredTitle, restoredArtist, restoredAlbum, restoredTrackNumber, restoredDiscNumber});
+    if (!restoredEntries.isEmpty()) {
+        d->mRestoredFromState = true;
     }
 
+    enqueueEntries(restoredEntries, {});
+
     restorePlayListPosition();
     restoreRandomPlay();
     restoreRepeatPlay();
@@ -922,13 +1211,46 @@ void MediaPlayList::setPersistentState(const QVariantMap &persistentStateValue)
     Q_EMIT persistentStateChanged();
 }
 
-void MediaPlayList::removeSelection(QList<int> selection)
+QList<MediaPlayListEntry> MediaPlayList::restoredPlayListEntries(const QByteArray &playListData)
 {
-    std::sort(selection.begin(), selection.end());
-    std::reverse(selection.begin(), selection.end());
-    for (auto oneItem : selection) {
-        removeRow(oneItem);
+    auto result = QList<MediaPlayListEntry>();
+
+    QDataStream playListStream(playListData);
+    playListStream.setVersion(QDataStream::Qt_5_9);
+
+    auto version = quint32(0);
+    auto tracksCount = quint32(0);
+    playListStream >> version >> tracksCount;
+
+    if (playListStream.status() != QDataStream::Ok || version != persistentPlayListVersion) {
+        qDebug() << "MediaPlayList::restoredPlayListEntries" << "unknown playlist format" << version;
+        return result;
+    }
+
+    for (quint32 trackIndex = 0; trackIndex < tracksCount; ++trackIndex) {
+        auto databaseId = quint64(0);
+        auto trackUrl = QUrl();
+        auto title = QString();
+        auto artist = QString();
+        auto album = QString();
+        auto trackNumber = qint32(0);
+        auto discNumber = qint32(0);
+
+        playListStream >> databaseId >> trackUrl >> title >> artist >> album >> trackNumber >> discNumber;
+
+        if (playListStream.status() != QDataStream::Ok) {
+            break;
+        }
+
+        result.push_back(savedPlayListEntry(databaseId, trackUrl, title, artist, album, trackNumber, discNumber));
     }
+
+    return result;
+}
+
+void MediaPlayList::removeSelection(QList<int> selection)
+{
+    removeRanges(contiguousRanges(std::move(selection)));
 }
 
 void MediaPlayList::albumAdded(const QList<MusicAudioTrack> &tracks)
@@ -945,9 +1267,12 @@ void MediaPlayList::albumAdded(const QList<MusicAudioTrack> &tracks)
         }
 
         d->mTrackData[playListIndex] = tracks.first();
+        d->trackStored(playListIndex);
         oneEntry.mId = tracks.first().databaseId();
         oneEntry.mIsValid = true;
         oneEntry.mIsArtist = false;
+        d->reindexRow(playListIndex);
+        storeChangedRow(playListIndex);
 
         Q_EMIT dataChanged(index(playListIndex, 0), index(playListIndex, 0), {});
 
@@ -956,13 +1281,18 @@ void MediaPlayList::albumAdded(const QList<MusicAudioTrack> &tracks)
         }
 
         if (tracks.size() > 1) {
+            const auto firstNewRow = d->mData.size();
+
             beginInsertRows(QModelIndex(), playListIndex + 1, playListIndex - 1 + tracks.size());
             for (int trackIndex = 1; trackIndex < tracks.size(); ++trackIndex) {
                 d->mData.push_back(MediaPlayListEntry{tracks[trackIndex].databaseId()});
                 d->mTrackData.push_back(tracks[trackIndex]);
+                d->trackStored(d->mTrackData.size() - 1);
             }
             endInsertRows();
 
+            storeInsertedRows(firstNewRow, tracks.size() - 1);
+
             restorePlayListPosition();
             if (!d->mCurrentTrack.isValid()) {
                 resetCurrentTrack();
@@ -977,104 +1307,244 @@ void MediaPlayList::albumAdded(const QList<MusicAudioTrack> &tracks)
 
 void MediaPlayList::trackChanged(const MusicAudioTrack &track)
 {
-    for (int i = 0; i < d->mData.size(); ++i) {
-        auto &oneEntry = d->mData[i];
-
-        if (!oneEntry.mIsArtist && oneEntry.mIsValid) {
-            if (oneEntry.mTrackUrl.isValid() && track.resourceURI() != oneEntry.mTrackUrl) {
+    d->updateRowsIndex();
+    d->mRequestedTrackIds.remove(track.databaseId());
+
+    /* valid entries of this track are all updated, one entry waiting for it is resolved */
+    auto updatedRows = QVector<int>();
+    auto resolvedRow = -1;
+    auto mismatchedRows = QVector<int>();
+
+    if (track.databaseId() != 0) {
+        const auto idRows = d->indexedRows(d->mRowsById, track.databaseId());
+        for (auto oneRow : idRows) {
+            const auto &oneEntry = d->mData.at(oneRow);
+            if (oneEntry.mIsArtist || !oneEntry.mIsValid || oneEntry.mTrackUrl.isValid() || oneEntry.mId != track.databaseId()) {
                 continue;
             }
 
-            if (!oneEntry.mTrackUrl.isValid() && (oneEntry.mId == 0 || track.databaseId() != oneEntry.mId)) {
+            /* an entry restored by id whose id now belongs to another track */
+            if (!d->mTrackData[oneRow].isValid() && !oneEntry.mTitle.isEmpty() &&
+                    (track.title() != oneEntry.mTitle || track.albumName() != oneEntry.mAlbum ||
+                     track.trackNumber() != oneEntry.mTrackNumber || track.discNumber() != oneEntry.mDiscNumber)) {
+                mismatchedRows.push_back(oneRow);
                 continue;
             }
 
-            if (d->mTrackData[i] != track) {
-                d->mTrackData[i] = track;
+            updatedRows.push_back(oneRow);
+        }
+    }
 
-                Q_EMIT dataChanged(index(i, 0), index(i, 0), {});
+    std::sort(mismatchedRows.begin(), mismatchedRows.end());
+    mismatchedRows.erase(std::unique(mismatchedRows.begin(), mismatchedRows.end()), mismatchedRows.end());
 
-                if (!d->mCurrentTrack.isValid()) {
-                    resetCurrentTrack();
-                }
-            }
-            continue;
-        } else if (!oneEntry.mIsArtist && !oneEntry.mIsValid && !oneEntry.mTrackUrl.isValid()) {
-            if (track.title() != oneEntry.mTitle) {
-                continue;
-            }
+    for (auto oneRow : qAsConst(mismatchedRows)) {
+        lookUpRestoredEntryByName(oneRow);
+    }
 
-            if (track.albumName() != oneEntry.mAlbum) {
-                continue;
-            }
+    const auto urlRows = d->indexedRows(d->mRowsByUrl, track.resourceURI());
+    for (auto oneRow : urlRows) {
+        const auto &oneEntry = d->mData.at(oneRow);
+        if (oneEntry.mIsArtist || oneEntry.mTrackUrl != track.resourceURI()) {
+            continue;
+        }
 
-            if (track.trackNumber() != oneEntry.mTrackNumber) {
-                continue;
-            }
+        if (oneEntry.mIsValid) {
+            updatedRows.push_back(oneRow);
+        } else if (resolvedRow == -1 || oneRow < resolvedRow) {
+            resolvedRow = oneRow;
+        }
+    }
 
-            if (track.discNumber() != oneEntry.mDiscNumber) {
-                continue;
-            }
+    const auto nameRows = d->indexedRows(d->mRowsByName, entryNameKey(track.title(), track.albumName(), track.trackNumber(), track.discNumber()));
+    for (auto oneRow : nameRows) {
+        const auto &oneEntry = d->mData.at(oneRow);
+        if (oneEntry.mIsArtist || oneEntry.mIsValid || oneEntry.mTrackUrl.isValid()) {
+            continue;
+        }
 
-            d->mTrackData[i] = track;
-            oneEntry.mId = track.databaseId();
-            oneEntry.mIsValid = true;
+        if (track.title() != oneEntry.mTitle || track.albumName() != oneEntry.mAlbum ||
+                track.trackNumber() != oneEntry.mTrackNumber || track.discNumber() != oneEntry.mDiscNumber) {
+            continue;
+        }
 
-            Q_EMIT dataChanged(index(i, 0), index(i, 0), {});
+        if (resolvedRow == -1 || oneRow < resolvedRow) {
+            resolvedRow = oneRow;
+        }
+    }
 
-            if (!d->mCurrentTrack.isValid()) {
-                resetCurrentTrack();
-            }
+    std::sort(updatedRows.begin(), updatedRows.end());
+    updatedRows.erase(std::unique(updatedRows.begin(), updatedRows.end()), updatedRows.end());
 
+    for (auto oneRow : qAsConst(updatedRows)) {
+        /* entries after the resolved one are left to their own notification */
+        if (resolvedRow != -1 && oneRow > resolvedRow) {
             break;
-        } else if (!oneEntry.mIsArtist && !oneEntry.mIsValid && oneEntry.mTrackUrl.isValid()) {
-            qDebug() << "MediaPlayList::trackChanged" << oneEntry << track;
-            qDebug() << "MediaPlayList::trackChanged" << track.resourceURI() << oneEntry.mTrackUrl;
-            if (track.resourceURI() != oneEntry.mTrackUrl) {
-                continue;
-            }
+        }
 
-            d->mTrackData[i] = track;
-            oneEntry.mId = track.databaseId();
-            oneEntry.mIsValid = true;
+        if (d->mTrackData[oneRow] != track || d->mData[oneRow].mHasPartialTrack) {
+            /* an entry enqueued by its id alone is stored again with the name of its track */
+            const auto storeTrackName = !d->mTrackData[oneRow].isValid() && d->mData[oneRow].mTitle.isEmpty();
 
-            Q_EMIT dataChanged(index(i, 0), index(i, 0), {});
+            d->mTrackData[oneRow] = track;
+            d->mData[oneRow].mHasPartialTrack = false;
+            d->trackStored(oneRow);
 
-            restorePlayListPosition();
+            if (storeTrackName) {
+                storeChangedRow(oneRow);
+            }
+
+            Q_EMIT dataChanged(index(oneRow, 0), index(oneRow, 0), {});
 
             if (!d->mCurrentTrack.isValid()) {
                 resetCurrentTrack();
             }
-
-            break;
         }
     }
+
+    if (d->mPaged && d->mStoredTracksCount > pagedTracksReleaseInterval) {
+        releaseFarTracks();
+    }
+
+    if (resolvedRow == -1) {
+        return;
+    }
+
+    auto &resolvedEntry = d->mData[resolvedRow];
+    const auto resolvedByUrl = resolvedEntry.mTrackUrl.isValid();
+
+    if (resolvedByUrl) {
+        qDebug() << "MediaPlayList::trackChanged" << resolvedEntry << track;
+    }
+
+    d->mTrackData[resolvedRow] = track;
+    d->trackStored(resolvedRow);
+    resolvedEntry.mId = track.databaseId();
+    resolvedEntry.mIsValid = true;
+    d->reindexRow(resolvedRow);
+    storeChangedRow(resolvedRow);
+
+    Q_EMIT dataChanged(index(resolvedRow, 0), index(resolvedRow, 0), {});
+
+    if (resolvedByUrl) {
+        restorePlayListPosition();
+    }
+
+    if (!d->mCurrentTrack.isValid()) {
+        resetCurrentTrack();
+    }
 }
 
 void MediaPlayList::trackRemoved(qulonglong trackId)
 {
-    for (int i = 0; i < d->mData.size(); ++i) {
-        auto &oneEntry = d->mData[i];
+    d->updateRowsIndex();
+    d->mRequestedTrackIds.remove(trackId);
 
-        if (oneEntry.mIsValid) {
-            if (oneEntry.mId == trackId) {
-                oneEntry.mIsValid = false;
-                oneEntry.mTitle = d->mTrackData[i].title();
-                oneEntry.mArtist = d->mTrackData[i].artist();
-                oneEntry.mAlbum = d->mTrackData[i].albumName();
-                oneEntry.mTrackNumber = d->mTrackData[i].trackNumber();
-                oneEntry.mDiscNumber = d->mTrackData[i].discNumber();
-
-                Q_EMIT dataChanged(index(i, 0), index(i, 0), {});
-
-                if (!d->mCurrentTrack.isValid()) {
-                    resetCurrentTrack();
-                }
+    auto removedRows = d->indexedRows(d->mRowsById, trackId);
+    if (removedRows.isEmpty()) {
+        return;
+    }
+
+    std::sort(removedRows.begin(), removedRows.end());
+    removedRows.erase(std::unique(removedRows.begin(), removedRows.end()), removedRows.end());
+
+    for (auto oneRow : qAsConst(removedRows)) {
+        auto &oneEntry = d->mData[oneRow];
+
+        if (oneEntry.mIsValid && oneEntry.mId == trackId && !d->mTrackData[oneRow].isValid()) {
+            /* this entry was restored by an id the database does not know */
+            lookUpRestoredEntryByName(oneRow);
+        } else if (oneEntry.mIsValid && oneEntry.mId == trackId) {
+            oneEntry.mIsValid = false;
+            oneEntry.mHasPartialTrack = false;
+            oneEntry.mTitle = d->mTrackData[oneRow].title();
+            oneEntry.mArtist = d->mTrackData[oneRow].artist();
+            oneEntry.mAlbum = d->mTrackData[oneRow].albumName();
+            oneEntry.mTrackNumber = d->mTrackData[oneRow].trackNumber();
+            oneEntry.mDiscNumber = d->mTrackData[oneRow].discNumber();
+            d->reindexRow(oneRow);
+
+            Q_EMIT dataChanged(index(oneRow, 0), index(oneRow, 0), {});
+
+            if (!d->mCurrentTrack.isValid()) {
+                resetCurrentTrack();
             }
         }
     }
 }
 
+void MediaPlayList::lookUpRestoredEntryByName(int row)
+{
+    auto &oneEntry = d->mData[row];
+
+    oneEntry.mId = 0;
+    oneEntry.mIsValid = false;
+    d->reindexRow(row);
+    storeChangedRow(row);
+
+    Q_EMIT dataChanged(index(row, 0), index(row, 0), {});
+
+    if (!oneEntry.mTitle.isEmpty()) {
+        Q_EMIT newTrackByNameInList(oneEntry.mTitle, oneEntry.mArtist, oneEntry.mAlbum, oneEntry.mTrackNumber, oneEntry.mDiscNumber);
+    }
+}
+
+void MediaPlayList::setStoredPlayListName(const QString &playListName)
+{
+    if (d->mStoredPlayListName == playListName) {
+        return;
+    }
+
+    d->mStoredPlayListName = playListName;
+    d->mStoredEntriesPending = !playListName.isEmpty();
+    d->mStoredEntriesNeedRewrite = false;
+
+    Q_EMIT persistentStateChanged();
+}
+
+void MediaPlayList::storedEntriesLoaded(const QString &playListName, const QList<MusicAudioTrack> &entries)
+{
+    if (playListName != d->mStoredPlayListName || !d->mStoredEntriesPending) {
+        return;
+    }
+
+    /* a playlist restored from the settings of an older version replaces the stored one */
+    if (d->mRestoredFromState) {
+        d->mStoredEntriesPending = false;
+        d->mStoredEntriesNeedRewrite = false;
+        rewriteStoredEntries();
+        return;
+    }
+
+    auto storedEntries = QList<MediaPlayListEntry>();
+    storedEntries.reserve(entries.size());
+
+    for (const auto &oneEntry : entries) {
+        storedEntries.push_back(savedPlayListEntry(oneEntry.databaseId(), oneEntry.resourceURI(), oneEntry.title(), oneEntry.artist(),
+                                                   oneEntry.albumName(), oneEntry.trackNumber(), oneEntry.discNumber()));
+    }
+
+    /* tracks enqueued before the stored ones were loaded follow them */
+    const auto previousRowsCount = d->mData.size();
+
+    enqueueEntries(storedEntries, {});
+
+    if (previousRowsCount > 0 && !storedEntries.isEmpty()) {
+        moveRange(previousRowsCount, storedEntries.size(), 0);
+    }
+
+    const auto needRewrite = d->mStoredEntriesNeedRewrite && previousRowsCount > 0;
+
+    d->mStoredEntriesPending = false;
+    d->mStoredEntriesNeedRewrite = false;
+
+    if (needRewrite) {
+        rewriteStoredEntries();
+    }
+
+    restorePlayListPosition();
+}
+
 void MediaPlayList::setMusicListenersManager(MusicListenersManager *musicListenersManager)
 {
     if (d->mMusicListenersManager == musicListenersManager) {
@@ -1240,10 +1710,15 @@ void MediaPlayList::loadPlayListLoaded()
 {
     clearPlayList();
 
+    auto loadedEntries = QList<MediaPlayListEntry>();
+    loadedEntries.reserve(d->mLoadPlaylist.mediaCount());
+
     for (int i = 0; i < d->mLoadPlaylist.mediaCount(); ++i) {
-        enqueue(d->mLoadPlaylist.media(i).canonicalUrl());
+        loadedEntries.push_back(MediaPlayListEntry{d->mLoadPlaylist.media(i).canonicalUrl()});
     }
 
+    enqueueEntries(loadedEntries, {});
+
     restorePlayListPosition();
     restoreRandomPlay();
     restoreRepeatPlay();
@@ -1260,13 +1735,486 @@ void MediaPlayList::loadPlayListLoadFailed()
     Q_EMIT playListLoadFailed();
 }
 
-void MediaPlayList::resetCurrentTrack()
+QVector<std::pair<int, int>> MediaPlayList::contiguousRanges(QList<int> rows) const
+{
+    auto result = QVector<std::pair<int, int>>();
+
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    for (auto oneRow : qAsConst(rows)) {
+        if (oneRow < 0 || oneRow >= d->mData.size()) {
+            continue;
+        }
+
+        if (!result.isEmpty() && result.last().first + result.last().second == oneRow) {
+            ++result.last().second;
+        } else {
+            result.push_back({oneRow, 1});
+        }
+    }
+
+    return result;
+}
+
+void MediaPlayList::removeRanges(const QVector<std::pair<int, int>> &ranges)
+{
+    if (ranges.isEmpty()) {
+        return;
+    }
+
+    /* header of the row following each range, read before any row is removed */
+    auto hadAlbumHeader = QVector<bool>(ranges.size(), false);
+    for (int rangeIndex = 0; rangeIndex < ranges.size(); ++rangeIndex) {
+        const auto nextRow = ranges[rangeIndex].first + ranges[rangeIndex].second;
+        if (rowCount() > nextRow) {
+            hadAlbumHeader[rangeIndex] = rowHasHeader(nextRow);
+        }
+    }
+
+    /* the last range first, the rows of the previous ones keep their position */
+    for (int rangeIndex = ranges.size() - 1; rangeIndex >= 0; --rangeIndex) {
+        const auto firstRow = ranges[rangeIndex].first;
+        const auto lastRow = firstRow + ranges[rangeIndex].second;
+
+        beginRemoveRows({}, firstRow, lastRow - 1);
+        d->removeRowsFromIndex(firstRow, lastRow - firstRow);
+        d->removeRowsFromLoadedPages(firstRow, lastRow - firstRow);
+        d->mData.erase(d->mData.begin() + firstRow, d->mData.begin() + lastRow);
+        d->mTrackData.erase(d->mTrackData.begin() + firstRow, d->mTrackData.begin() + lastRow);
+        endRemoveRows();
+
+        if (storedPlayListIsWritable()) {
+            Q_EMIT storedEntriesRemoved(d->mStoredPlayListName, firstRow, lastRow - firstRow);
+        }
+    }
+
+    const auto firstRemovedRow = ranges.first().first;
+
+    if (!d->mCurrentTrack.isValid()) {
+        d->mCurrentTrack = index(d->mCurrentPlayListPosition, 0);
+
+        if (d->mCurrentTrack.isValid()) {
+            notifyCurrentTrackChanged();
+        }
+
+        if (!d->mCurrentTrack.isValid()) {
+            Q_EMIT playListFinished();
+            resetCurrentTrack();
+            if (!d->mCurrentTrack.isValid()) {
+                notifyCurrentTrackChanged();
+            }
+        }
+    }
+
+    if (!d->mCurrentTrack.isValid() && rowCount() <= firstRemovedRow) {
+        resetCurrentTrack();
+    }
+
+    Q_EMIT tracksCountChanged();
+
+    auto removedRowsCount = 0;
+    for (int rangeIndex = 0; rangeIndex < ranges.size(); ++rangeIndex) {
+        const auto row = ranges[rangeIndex].first - removedRowsCount;
+        removedRowsCount += ranges[rangeIndex].second;
+
+        if (hadAlbumHeader[rangeIndex] != rowHasHeader(row)) {
+            Q_EMIT dataChanged(index(row, 0), index(row, 0), {ColumnsRoles::HasAlbumHeader});
+
+            if (!d->mCurrentTrack.isValid()) {
+                resetCurrentTrack();
+            }
+        }
+    }
+
+    Q_EMIT persistentStateChanged();
+}
+
+bool MediaPlayList::moveRange(int sourceRow, int count, int destinationChild)
+{
+    if (!beginMoveRows({}, sourceRow, sourceRow + count - 1, {}, destinationChild)) {
+        return false;
+    }
+
+    auto firstMovedTrackHasHeader = rowHasHeader(sourceRow);
+    auto nextTrackHasHeader = rowHasHeader(sourceRow + count);
+    auto futureNextTrackHasHeader = rowHasHeader(destinationChild);
+
+    d->moveRowsInIndex(sourceRow, count, destinationChild);
+    d->moveRowsInLoadedPages(sourceRow, count, destinationChild);
+
+    /* the whole range is moved in one pass over both lists */
+    if (sourceRow < destinationChild) {
+        std::rotate(d->mData.begin() + sourceRow, d->mData.begin() + sourceRow + count, d->mData.begin() + destinationChild);
+        std::rotate(d->mTrackData.begin() + sourceRow, d->mTrackData.begin() + sourceRow + count, d->mTrackData.begin() + destinationChild);
+    } else {
+        std::rotate(d->mData.begin() + destinationChild, d->mData.begin() + sourceRow, d->mData.begin() + sourceRow + count);
+        std::rotate(d->mTrackData.begin() + destinationChild, d->mTrackData.begin() + sourceRow, d->mTrackData.begin() + sourceRow + count);
+    }
+
+    endMoveRows();
+
+    if (storedPlayListIsWritable()) {
+        Q_EMIT storedEntriesMoved(d->mStoredPlayListName, sourceRow, count, destinationChild);
+    }
+
+    if (sourceRow < destinationChild) {
+        if (firstMovedTrackHasHeader != rowHasHeader(destinationChild - count)) {
+            Q_EMIT dataChanged(index(destinationChild - count, 0), index(destinationChild - count, 0), {ColumnsRoles::HasAlbumHeader});
+
+            if (!d->mCurrentTrack.isValid()) {
+                resetCurrentTrack();
+            }
+        }
+    } else {
+        if (firstMovedTrackHasHeader != rowHasHeader(destinationChild)) {
+            Q_EMIT dataChanged(index(destinationChild, 0), index(destinationChild, 0), {ColumnsRoles::HasAlbumHeader});
+
+            if (!d->mCurrentTrack.isValid()) {
+                resetCurrentTrack();
+            }
+        }
+    }
+
+    if (sourceRow < destinationChild) {
+        if (nextTrackHasHeader != rowHasHeader(sourceRow)) {
+            Q_EMIT dataChanged(index(sourceRow, 0), index(sourceRow, 0), {ColumnsRoles::HasAlbumHeader});
+
+            if (!d->mCurrentTrack.isValid()) {
+                resetCurrentTrack();
+            }
+        }
+    } else {
+        if (nextTrackHasHeader != rowHasHeader(sourceRow + count)) {
+            Q_EMIT dataChanged(index(sourceRow + count, 0), index(sourceRow + count, 0), {ColumnsRoles::HasAlbumHeader});
+
+            if (!d->mCurrentTrack.isValid()) {
+                resetCurrentTrack();
+            }
+        }
+    }
+
+    if (sourceRow < destinationChild) {
+        if (futureNextTrackHasHeader != rowHasHeader(destinationChild + count - 1)) {
+            Q_EMIT dataChanged(index(destinationChild + count - 1, 0), index(destinationChild + count - 1, 0), {ColumnsRoles::HasAlbumHeader});
+
+            if (!d->mCurrentTrack.isValid()) {
+                resetCurrentTrack();
+            }
+        }
+    } else {
+        if (futureNextTrackHasHeader != rowHasHeader(destinationChild + count)) {
+            Q_EMIT dataChanged(index(destinationChild + count, 0), index(destinationChild + count, 0), {ColumnsRoles::HasAlbumHeader});
+
+            if (!d->mCurrentTrack.isValid()) {
+                resetCurrentTrack();
+            }
+        }
+    }
+
+    return true;
+}
+
+void MediaPlayList::enqueueEntries(const QList<MediaPlayListEntry> &newEntries, const QList<MusicAudioTrack> &audioTracks)
+{
+    if (newEntries.isEmpty()) {
+        return;
+    }
+
+    const auto firstNewRow = d->mData.size();
+    const auto lastNewRow = firstNewRow + newEntries.size() - 1;
+
+    beginInsertRows(QModelIndex(), firstNewRow, lastNewRow);
+    d->mData.reserve(lastNewRow + 1);
+    d->mTrackData.reserve(lastNewRow + 1);
+    for (int entryIndex = 0; entryIndex < newEntries.size(); ++entryIndex) {
+        d->mData.push_back(newEntries.at(entryIndex));
+        if (entryIndex < audioTracks.size() && audioTracks.at(entryIndex).isValid()) {
+            d->mTrackData.push_back(audioTracks.at(entryIndex));
+            d->trackStored(d->mTrackData.size() - 1);
+        } else {
+            d->mTrackData.push_back({});
+        }
+    }
+    endInsertRows();
+
+    if (d->mPaged && d->mStoredTracksCount > pagedTracksReleaseInterval) {
+        releaseFarTracks();
+    }
+
+    storeInsertedRows(firstNewRow, newEntries.size());
+
+    restorePlayListPosition();
+    if (!d->mCurrentTrack.isValid()) {
+        resetCurrentTrack();
+    }
+
+    Q_EMIT tracksCountChanged();
+    Q_EMIT persistentStateChanged();
+
+    /* the database is asked once for all the tracks known by their id */
+    auto newTrackIds = QList<qulonglong>();
+    auto firstTrackRow = -1;
+    auto hasInvalidTrack = false;
+
+    for (int entryIndex = 0; entryIndex < newEntries.size(); ++entryIndex) {
+        const auto &newEntry = newEntries.at(entryIndex);
+
+        if (newEntry.mIsArtist) {
+            Q_EMIT newArtistInList(newEntry.mArtist);
+            continue;
+        }
+
+        if (firstTrackRow == -1) {
+            firstTrackRow = firstNewRow + entryIndex;
+        }
+
+        if (newEntry.mIsValid) {
+            newTrackIds.push_back(newEntry.mId);
+            continue;
+        }
+
+        hasInvalidTrack = true;
+
+        if (newEntry.mTrackUrl.isValid()) {
+            qDebug() << "MediaPlayList::enqueueEntries" << "newTrackByFileNameInList" << newEntry.mTrackUrl;
+            if (newEntry.mTrackUrl.isLocalFile()) {
+                QFileInfo newTrackFile(newEntry.mTrackUrl.toLocalFile());
+                if (newTrackFile.exists()) {
+                    d->mData[firstNewRow + entryIndex].mIsValid = true;
+                }
+                Q_EMIT newTrackByFileNameInList(newEntry.mTrackUrl);
+            }
+        } else {
+            Q_EMIT newTrackByNameInList(newEntry.mTitle, newEntry.mArtist, newEntry.mAlbum, newEntry.mTrackNumber, newEntry.mDiscNumber);
+        }
+    }
+
+    if (newTrackIds.size() == 1) {
+        Q_EMIT newTrackByIdInList(newTrackIds.first());
+    } else if (!newTrackIds.isEmpty()) {
+        Q_EMIT newTracksByIdInList(newTrackIds);
+    }
+
+    if (firstTrackRow != -1) {
+        Q_EMIT trackHasBeenAdded(data(index(firstTrackRow, 0), ColumnsRoles::TitleRole).toString(), data(index(firstTrackRow, 0), ColumnsRoles::ImageRole).toUrl());
+    }
+
+    if (hasInvalidTrack) {
+        Q_EMIT dataChanged(index(firstNewRow, 0), index(lastNewRow, 0), {MediaPlayList::HasAlbumHeader});
+
+        if (!d->mCurrentTrack.isValid()) {
+            resetCurrentTrack();
+        }
+    }
+}
+
+bool MediaPlayList::storedPlayListIsWritable()
+{
+    if (d->mStoredPlayListName.isEmpty()) {
+        return false;
+    }
+
+    if (d->mStoredEntriesPending) {
+        d->mStoredEntriesNeedRewrite = true;
+        return false;
+    }
+
+    return true;
+}
+
+MusicAudioTrack MediaPlayList::storedEntry(int row) const
+{
+    const auto &oneTrack = d->mTrackData.at(row);
+
+    if (oneTrack.isValid()) {
+        return oneTrack;
+    }
+
+    const auto &oneEntry = d->mData.at(row);
+
+    auto result = MusicAudioTrack();
+
+    result.setDatabaseId(oneEntry.mIsValid ? oneEntry.mId : 0);
+    result.setTitle(oneEntry.mTitle);
+    result.setArtist(oneEntry.mArtist);
+    result.setAlbumName(oneEntry.mAlbum);
+    result.setTrackNumber(oneEntry.mTrackNumber);
+    result.setDiscNumber(oneEntry.mDiscNumber);
+    result.setResourceURI(oneEntry.mTrackUrl);
+
+    return result;
+}
+
+void MediaPlayList::storeInsertedRows(int firstRow, int count)
+{
+    if (count <= 0 || !storedPlayListIsWritable()) {
+        return;
+    }
+
+    auto entries = QList<MusicAudioTrack>();
+    entries.reserve(count);
+
+    for (int row = firstRow; row < firstRow + count; ++row) {
+        entries.push_back(storedEntry(row));
+    }
+
+    Q_EMIT storedEntriesInserted(d->mStoredPlayListName, firstRow, entries);
+}
+
+void MediaPlayList::storeChangedRow(int row)
+{
+    if (!storedPlayListIsWritable()) {
+        return;
+    }
+
+    Q_EMIT storedEntryChanged(d->mStoredPlayListName, row, storedEntry(row));
+}
+
+void MediaPlayList::rewriteStoredEntries()
 {
-    for(int row = 0; row < rowCount(); ++row) {
-        auto candidateTrack = index(row, 0);
+    if (!storedPlayListIsWritable()) {
+        return;
+    }
+
+    Q_EMIT storedEntriesCleared(d->mStoredPlayListName);
+
+    storeInsertedRows(0, d->mData.size());
+}
+
+bool MediaPlayList::isPaged() const
+{
+    return d->mPaged;
+}
+
+void MediaPlayList::setPaged(bool paged)
+{
+    if (d->mPaged == paged) {
+        return;
+    }
+
+    d->mPaged = paged;
+    d->mLoadedPages.clear();
+
+    if (d->mPaged) {
+        for (int page = 0; page * pagedTracksPageSize < d->mData.size(); ++page) {
+            d->mLoadedPages.insert(page);
+        }
+
+        releaseFarTracks();
+    }
+}
+
+void MediaPlayList::setVisibleRows(int firstRow, int lastRow)
+{
+    if (!d->mPaged || d->mData.isEmpty()) {
+        return;
+    }
+
+    /* views give -1 for the space below their last row */
+    firstRow = qBound(0, firstRow, d->mData.size() - 1);
+    if (lastRow < firstRow || lastRow >= d->mData.size()) {
+        lastRow = d->mData.size() - 1;
+    }
+
+    for (int page = firstRow / pagedTracksPageSize; page <= lastRow / pagedTracksPageSize; ++page) {
+        d->mRecentPages.removeOne(page);
+        d->mRecentPages.push_back(page);
+
+        if (d->mRecentPages.size() > pagedTracksRecentPages) {
+            d->mRecentPages.removeFirst();
+        }
+    }
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        d->queueReleasedRow(row);
+    }
+}
+
+void MediaPlayList::requestPendingTracks()
+{
+    auto trackIds = QList<qulonglong>();
+
+    for (auto onePage : qAsConst(d->mPendingPages)) {
+        const auto lastRow = std::min((onePage + 1) * pagedTracksPageSize, d->mData.size());
+
+        for (int row = onePage * pagedTracksPageSize; row < lastRow; ++row) {
+            const auto &oneEntry = d->mData.at(row);
+
+            if (!oneEntry.mHasPartialTrack || d->mRequestedTrackIds.contains(oneEntry.mId)) {
+                continue;
+            }
 
-        if (candidateTrack.isValid() && candidateTrack.data(ColumnsRoles::IsValidRole).toBool()) {
-            d->mCurrentTrack = candidateTrack;
+            d->mRequestedTrackIds.insert(oneEntry.mId);
+            trackIds.push_back(oneEntry.mId);
+        }
+    }
+
+    d->mPendingPages.clear();
+
+    if (!trackIds.isEmpty()) {
+        Q_EMIT newTracksByIdInList(trackIds);
+    }
+}
+
+void MediaPlayList::releaseFarTracks()
+{
+    d->mStoredTracksCount = 0;
+
+    auto keptPages = QSet<int>();
+    for (auto onePage : qAsConst(d->mRecentPages)) {
+        keptPages.insert(onePage);
+    }
+
+    const auto currentRow = d->mCurrentTrack.row();
+
+    for (auto itPage = d->mLoadedPages.begin(); itPage != d->mLoadedPages.end(); ) {
+        if (keptPages.contains(*itPage)) {
+            ++itPage;
+            continue;
+        }
+
+        const auto firstRow = *itPage * pagedTracksPageSize;
+        const auto lastRow = std::min(firstRow + pagedTracksPageSize, d->mData.size());
+        auto keepsCurrentTrack = false;
+
+        for (int row = firstRow; row < lastRow; ++row) {
+            auto &oneEntry = d->mData[row];
+            const auto &oneTrack = d->mTrackData.at(row);
+
+            if (oneEntry.mHasPartialTrack || !oneTrack.isValid()) {
+                continue;
+            }
+
+            if (row == currentRow) {
+                keepsCurrentTrack = true;
+                continue;
+            }
+
+            /* only the tracks the database sends again by their id are released */
+            if (!oneEntry.mIsValid || oneEntry.mIsArtist || oneEntry.mTrackUrl.isValid() || oneEntry.mId == 0 || oneEntry.mId != oneTrack.databaseId()) {
+                continue;
+            }
+
+            auto releasedTrack = partialTrack(oneTrack);
+
+            d->mTrackData[row] = std::move(releasedTrack);
+            oneEntry.mHasPartialTrack = true;
+        }
+
+        if (keepsCurrentTrack) {
+            ++itPage;
+        } else {
+            itPage = d->mLoadedPages.erase(itPage);
+        }
+    }
+}
+
+void MediaPlayList::resetCurrentTrack()
+{
+    for(int row = 0; row < d->mData.size(); ++row) {
+        if (d->mData.at(row).mIsValid) {
+            d->mCurrentTrack = index(row, 0);
             notifyCurrentTrackChanged();
             break;
         }
@@ -1280,6 +2228,9 @@ void MediaPlayList::notifyCurrentTrackChanged()
     bool currentTrackIsValid = d->mCurrentTrack.isValid();
     if (currentTrackIsValid) {
         d->mCurrentPlayListPosition = d->mCurrentTrack.row();
+
+        /* the player reads the whole current track even when no view shows it */
+        d->queueReleasedRow(d->mCurrentTrack.row());
     }
 }
 
@@ -133,6 +133,9 @@ public:
 
     Q_INVOKABLE void move(int from, int to, int n);
 
+    /* moves the selected rows, in their order, to form one block before destinationRow */
+    Q_INVOKABLE void moveSelection(QList<int> selection, int destinationRow);
+
     Q_INVOKABLE void clearPlayList();
 
     Q_INVOKABLE bool savePlaylist(const QUrl &fileName);
@@ -151,6 +154,14 @@ public:
 
     bool repeatPlay() const;
 
+    bool isPaged() const;
+
+    /* rows far from the ones shown by the views keep only their name, file and album, their whole track is read again by id */
+    void setPaged(bool paged);
+
+    /* rows shown by a view, their pages keep their whole tracks and the released ones are read again */
+    Q_INVOKABLE void setVisibleRows(int firstRow, int lastRow);
+
 Q_SIGNALS:
 
     void newTrackByNameInList(const QString &title, const QString &artist, const QString &album, int trackNumber, int discNumber);
@@ -159,6 +170,8 @@ Q_SIGNALS:
 
     void newTrackByIdInList(qulonglong newTrackId);
 
+    void newTracksByIdInList(const QList<qulonglong> &newTrackIds);
+
     void newArtistInList(const QString &artist);
 
     void trackHasBeenAdded(const QString &title, const QUrl &image);
@@ -185,6 +198,16 @@ Q_SIGNALS:
 
     void ensurePlay();
 
+    void storedEntriesInserted(const QString &playListName, int position, const QList<MusicAudioTrack> &entries);
+
+    void storedEntriesRemoved(const QString &playListName, int position, int count);
+
+    void storedEntriesMoved(const QString &playListName, int sourcePosition, int count, int destinationPosition);
+
+    void storedEntryChanged(const QString &playListName, int position, const MusicAudioTrack &entry);
+
+    void storedEntriesCleared(const QString &playListName);
+
 public Q_SLOTS:
 
     void setPersistentState(const QVariantMap &persistentState);
@@ -239,6 +262,10 @@ public Q_SLOTS:
                  ElisaUtils::PlayListEnqueueMode enqueueMode,
                  ElisaUtils::PlayListEnqueueTriggerPlay triggerPlay);
 
+    void enqueue(const QList<qulonglong> &newTrackIds,
+                 ElisaUtils::PlayListEnqueueMode enqueueMode,
+                 ElisaUtils::PlayListEnqueueTriggerPlay triggerPlay);
+
     void enqueueArtists(const QList<QString> &artistName,
                         ElisaUtils::PlayListEnqueueMode enqueueMode,
                         ElisaUtils::PlayListEnqueueTriggerPlay triggerPlay);
@@ -259,16 +286,53 @@ public Q_SLOTS:
 
     void trackInError(QUrl sourceInError, QMediaPlayer::Error playerError);
 
+    /* the playlist is kept in the database under this name, each edit is written as it happens */
+    void setStoredPlayListName(const QString &playListName);
+
+    void storedEntriesLoaded(const QString &playListName, const QList<MusicAudioTrack> &entries);
+
 private Q_SLOTS:
 
     void loadPlayListLoaded();
 
     void loadPlayListLoadFailed();
 
+    void requestPendingTracks();
+
 private:
 
     bool rowHasHeader(int row) const;
 
+    /* sorted, deduplicated rows grouped as (first row, count) ranges */
+    QVector<std::pair<int, int>> contiguousRanges(QList<int> rows) const;
+
+    /* removes each range with one notification, then updates headers and the current track once */
+    void removeRanges(const QVector<std::pair<int, int>> &ranges);
+
+    bool moveRange(int sourceRow, int count, int destinationChild);
+
+    /* appends all entries as one row range, then asks once for the data of the tracks known by their id */
+    void enqueueEntries(const QList<MediaPlayListEntry> &newEntries, const QList<MusicAudioTrack> &audioTracks);
+
+    static QList<MediaPlayListEntry> restoredPlayListEntries(const QByteArray &playListData);
+
+    /* an entry restored by id that the database does not match waits for its track by name */
+    void lookUpRestoredEntryByName(int row);
+
+    /* false while the stored entries are not loaded, the whole playlist is then written once they are */
+    bool storedPlayListIsWritable();
+
+    MusicAudioTrack storedEntry(int row) const;
+
+    void storeInsertedRows(int firstRow, int count);
+
+    void storeChangedRow(int row);
+
+    void rewriteStoredEntries();
+
+    /* keeps the whole track of the rows of the last pages shown by the views and of the current track */
+    void releaseFarTracks();
+
     void resetCurrentTrack();
 
     void notifyCurrentTrackChanged();
@@ -327,8 +391,13 @@ public:
 
     bool mIsArtist = false;
 
+    bool mHasPartialTrack = false;
+
     MediaPlayList::PlayState mIsPlaying = MediaPlayList::NotPlaying;
 
+    /* identifies the entry in the indexes of its playlist, 0 until it is indexed */
+    quint64 mIndexHandle = 0;
+
 };
 
 QDebug operator<<(QDebug stream, const MediaPlayListEntry &data);
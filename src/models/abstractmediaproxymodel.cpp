@@ -21,11 +21,60 @@
 #include "abstractmediaproxymodel.h"
 
 #include <QWriteLocker>
+#include <QtConcurrentRun>
+#include <QFutureWatcher>
+
+#include <algorithm>
+#include <numeric>
+
+/* delay between the last keystroke and the filtering pass */
+static const int filterDebounceInterval = 120;
+
+static bool matchesSearchEntry(const SearchKeyMatcher &filterMatcher, int filterRating, const SearchKeyEntry &searchEntry)
+{
+    return searchEntry.mRating >= filterRating && filterMatcher.matches(searchEntry.mSearchKey);
+}
+
+static bool sortEntryLessThan(AbstractMediaProxyModel::SortCriterion sortCriterion, const SortKeyEntry &left, const SortKeyEntry &right)
+{
+    auto result = 0;
+
+    switch (sortCriterion)
+    {
+    case AbstractMediaProxyModel::SortByArtist:
+        result = left.mArtistKey.compare(right.mArtistKey);
+        break;
+    case AbstractMediaProxyModel::SortByYear:
+        result = left.mYear - right.mYear;
+        break;
+    case AbstractMediaProxyModel::SortByDuration:
+        result = left.mDuration - right.mDuration;
+        break;
+    case AbstractMediaProxyModel::SortByTitle:
+    case AbstractMediaProxyModel::SortByDateAdded:
+        break;
+    }
+
+    if (result == 0 && sortCriterion != AbstractMediaProxyModel::SortByDateAdded) {
+        result = left.mTitleKey.compare(right.mTitleKey);
+    }
+
+    /* database ids grow as tracks are added, they order rows by date added and keep equal keys in a stable order */
+    if (result == 0) {
+        return left.mDatabaseId < right.mDatabaseId;
+    }
+
+    return result < 0;
+}
 
 AbstractMediaProxyModel::AbstractMediaProxyModel(QObject *parent) : QSortFilterProxyModel(parent)
 {
     setFilterCaseSensitivity(Qt::CaseInsensitive);
     mThreadPool.setMaxThreadCount(1);
+
+    mFilterTimer.setSingleShot(true);
+    mFilterTimer.setInterval(filterDebounceInterval);
+    connect(&mFilterTimer, &QTimer::timeout, this, &AbstractMediaProxyModel::applyFilter);
 }
 
 AbstractMediaProxyModel::~AbstractMediaProxyModel()
@@ -41,37 +90,281 @@ int AbstractMediaProxyModel::filterRating() const
     return mFilterRating;
 }
 
-void AbstractMediaProxyModel::setFilterText(const QString &filterText)
+AbstractMediaProxyModel::SortCriterion AbstractMediaProxyModel::sortCriterion() const
 {
-    QWriteLocker writeLocker(&mDataLock);
+    return mSortCriterion;
+}
+
+void AbstractMediaProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    for (const auto &oneConnection : qAsConst(mSourceConnections)) {
+        disconnect(oneConnection);
+    }
+    mSourceConnections.clear();
+
+    sourceRowsChanged();
+
+    /* connected before the proxy's own handlers so that they never see stale filter results */
+    if (sourceModel) {
+        mSourceConnections.push_back(connect(sourceModel, &QAbstractItemModel::dataChanged,
+                                             this, &AbstractMediaProxyModel::sourceRowsChanged));
+        mSourceConnections.push_back(connect(sourceModel, &QAbstractItemModel::rowsAboutToBeInserted,
+                                             this, &AbstractMediaProxyModel::sourceRowsChanged));
+        mSourceConnections.push_back(connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved,
+                                             this, &AbstractMediaProxyModel::sourceRowsChanged));
+        mSourceConnections.push_back(connect(sourceModel, &QAbstractItemModel::rowsAboutToBeMoved,
+                                             this, &AbstractMediaProxyModel::sourceRowsChanged));
+        mSourceConnections.push_back(connect(sourceModel, &QAbstractItemModel::layoutAboutToBeChanged,
+                                             this, &AbstractMediaProxyModel::sourceRowsChanged));
+        mSourceConnections.push_back(connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset,
+                                             this, &AbstractMediaProxyModel::sourceRowsChanged));
+    }
+
+    if (sortColumn() == 0) {
+        buildSortRanks();
+    }
+
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+}
+
+void AbstractMediaProxyModel::sort(int column, Qt::SortOrder order)
+{
+    if (column == 0 && !mSortRanksValid) {
+        buildSortRanks();
+    }
 
+    QSortFilterProxyModel::sort(column, order);
+}
+
+void AbstractMediaProxyModel::setFilterText(const QString &filterText)
+{
     if (mFilterText == filterText)
         return;
 
     mFilterText = filterText;
 
-    mFilterExpression.setPattern(mFilterText);
-    mFilterExpression.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
-    mFilterExpression.optimize();
-
-    invalidate();
+    mFilterTimer.start();
 
     Q_EMIT filterTextChanged(mFilterText);
 }
 
 void AbstractMediaProxyModel::setFilterRating(int filterRating)
 {
-    QWriteLocker writeLocker(&mDataLock);
-
     if (mFilterRating == filterRating) {
         return;
     }
 
     mFilterRating = filterRating;
 
-    invalidate();
+    mFilterTimer.stop();
+    applyFilter();
 
     Q_EMIT filterRatingChanged(filterRating);
 }
 
+void AbstractMediaProxyModel::setSortCriterion(SortCriterion sortCriterion)
+{
+    if (mSortCriterion == sortCriterion) {
+        return;
+    }
+
+    mSortCriterion = sortCriterion;
+
+    buildSortRanks();
+
+    if (sortColumn() == 0) {
+        QWriteLocker writeLocker(&mDataLock);
+
+        invalidate();
+    }
+
+    Q_EMIT sortCriterionChanged(mSortCriterion);
+}
+
+bool AbstractMediaProxyModel::sourceSearchEntries(QVector<SearchKeyEntry> &searchEntries) const
+{
+    Q_UNUSED(searchEntries);
+
+    return false;
+}
+
+bool AbstractMediaProxyModel::filterOnRating() const
+{
+    return true;
+}
+
+bool AbstractMediaProxyModel::acceptsSearchEntry(int sourceRow, const SearchKeyEntry &searchEntry) const
+{
+    if (mAcceptedRowsValid && sourceRow < mAcceptedRowsMask.size()) {
+        return mAcceptedRowsMask.testBit(sourceRow);
+    }
+
+    return matchesSearchEntry(mFilterMatcher, mAppliedFilterRating, searchEntry);
+}
+
+bool AbstractMediaProxyModel::lessThan(const QModelIndex &source_left, const QModelIndex &source_right) const
+{
+    const auto *sortEntries = sourceSortEntries();
+
+    if (!sortEntries) {
+        return QSortFilterProxyModel::lessThan(source_left, source_right);
+    }
+
+    const auto leftRow = source_left.row();
+    const auto rightRow = source_right.row();
+
+    /* rows inserted or modified since the ranks were built are compared on their keys */
+    if (mSortRanksValid && leftRow < mSortRanks.size() && rightRow < mSortRanks.size()) {
+        return mSortRanks.at(leftRow) < mSortRanks.at(rightRow);
+    }
+
+    return sortEntryLessThan(mSortCriterion, (*sortEntries)[leftRow], (*sortEntries)[rightRow]);
+}
+
+const std::vector<SortKeyEntry> *AbstractMediaProxyModel::sourceSortEntries() const
+{
+    return nullptr;
+}
+
+void AbstractMediaProxyModel::applyFilter()
+{
+    {
+        QWriteLocker writeLocker(&mDataLock);
+
+        mFilterExpression.setPattern(mFilterText);
+        mFilterExpression.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+        mFilterExpression.optimize();
+    }
+
+    startFilterPass();
+}
+
+void AbstractMediaProxyModel::startFilterPass()
+{
+    if (mFilterPassRunning) {
+        mFilterPassPending = true;
+        return;
+    }
+
+    auto searchEntries = QVector<SearchKeyEntry>();
+
+    if (!sourceSearchEntries(searchEntries)) {
+        QWriteLocker writeLocker(&mDataLock);
+
+        invalidate();
+
+        Q_EMIT filterApplied();
+
+        return;
+    }
+
+    const auto filterMatcher = SearchKeyMatcher(mFilterText);
+    const auto filterRating = (filterOnRating() ? mFilterRating : 0);
+    const auto sourceGeneration = mSourceGeneration;
+
+    /* a filter extending the published one can only accept rows that are already accepted */
+    const auto isRefinement = mAcceptedRowsValid && mAcceptedRowsGeneration == sourceGeneration &&
+            filterMatcher.refines(mFilterMatcher) && filterRating >= mAppliedFilterRating;
+    const auto candidateRows = (isRefinement ? mAcceptedRows : QVector<int>());
+
+    mFilterPassRunning = true;
+
+    auto watcher = new QFutureWatcher<QVector<int>>(this);
+
+    connect(watcher, &QFutureWatcher<QVector<int>>::finished, this, [=] () {
+        mFilterPassRunning = false;
+
+        publishFilterPass(filterMatcher, filterRating, sourceGeneration, searchEntries.size(), watcher->result());
+
+        watcher->deleteLater();
+
+        if (mFilterPassPending) {
+            mFilterPassPending = false;
+            startFilterPass();
+        }
+    });
+
+    watcher->setFuture(QtConcurrent::run(&mThreadPool, [=] () {
+        auto acceptedRows = QVector<int>();
+
+        if (isRefinement) {
+            acceptedRows.reserve(candidateRows.size());
+
+            for (auto oneRow : candidateRows) {
+                if (matchesSearchEntry(filterMatcher, filterRating, searchEntries.at(oneRow))) {
+                    acceptedRows.push_back(oneRow);
+                }
+            }
+        } else {
+            for (int oneRow = 0; oneRow < searchEntries.size(); ++oneRow) {
+                if (matchesSearchEntry(filterMatcher, filterRating, searchEntries.at(oneRow))) {
+                    acceptedRows.push_back(oneRow);
+                }
+            }
+        }
+
+        return acceptedRows;
+    }));
+}
+
+void AbstractMediaProxyModel::publishFilterPass(const SearchKeyMatcher &filterMatcher, int filterRating, quint64 sourceGeneration,
+                                                int sourceRowsCount, const QVector<int> &acceptedRows)
+{
+    QWriteLocker writeLocker(&mDataLock);
+
+    mFilterMatcher = filterMatcher;
+    mAppliedFilterRating = filterRating;
+
+    /* rows changed while filtering: fall back to matching each row when the proxy asks for it */
+    if (sourceGeneration == mSourceGeneration) {
+        mAcceptedRows = acceptedRows;
+        mAcceptedRowsMask.fill(false, sourceRowsCount);
+        for (auto oneRow : acceptedRows) {
+            mAcceptedRowsMask.setBit(oneRow);
+        }
+        mAcceptedRowsGeneration = sourceGeneration;
+        mAcceptedRowsValid = true;
+    } else {
+        mAcceptedRowsValid = false;
+    }
+
+    invalidateFilter();
+
+    Q_EMIT filterApplied();
+}
+
+void AbstractMediaProxyModel::sourceRowsChanged()
+{
+    ++mSourceGeneration;
+    mAcceptedRowsValid = false;
+    mSortRanksValid = false;
+}
+
+void AbstractMediaProxyModel::buildSortRanks()
+{
+    const auto *sortEntries = sourceSortEntries();
+
+    if (!sortEntries) {
+        mSortRanksValid = false;
+        return;
+    }
+
+    const auto rowsCount = static_cast<int>(sortEntries->size());
+    const auto sortCriterion = mSortCriterion;
+
+    auto sortedRows = QVector<int>(rowsCount);
+    std::iota(sortedRows.begin(), sortedRows.end(), 0);
+
+    std::sort(sortedRows.begin(), sortedRows.end(), [sortEntries, sortCriterion] (int leftRow, int rightRow) {
+        return sortEntryLessThan(sortCriterion, (*sortEntries)[leftRow], (*sortEntries)[rightRow]);
+    });
+
+    mSortRanks.resize(rowsCount);
+    for (int rank = 0; rank < rowsCount; ++rank) {
+        mSortRanks[sortedRows.at(rank)] = rank;
+    }
+
+    mSortRanksValid = true;
+}
+
 #include "moc_abstractmediaproxymodel.cpp"
@@ -22,11 +22,20 @@
 #define ABSTRACTMEDIAPROXYMODEL_H
 
 #include "mediaplaylist.h"
+#include "searchkeymatcher.h"
+#include "sortkeybuilder.h"
 
 #include <QSortFilterProxyModel>
 #include <QRegularExpression>
 #include <QReadWriteLock>
 #include <QThreadPool>
+#include <QTimer>
+#include <QBitArray>
+#include <QVector>
+#include <QList>
+#include <QPair>
+
+#include <vector>
 
 class MediaPlayList;
 
@@ -45,8 +54,23 @@ class AbstractMediaProxyModel : public QSortFilterProxyModel
                WRITE setFilterRating
                NOTIFY filterRatingChanged)
 
+    Q_PROPERTY(SortCriterion sortCriterion
+               READ sortCriterion
+               WRITE setSortCriterion
+               NOTIFY sortCriterionChanged)
+
 public:
 
+    enum SortCriterion {
+        SortByTitle,
+        SortByArtist,
+        SortByYear,
+        SortByDateAdded,
+        SortByDuration,
+    };
+
+    Q_ENUM(SortCriterion)
+
     explicit AbstractMediaProxyModel(QObject *parent = nullptr);
 
     ~AbstractMediaProxyModel() override;
@@ -55,22 +79,47 @@ public:
 
     int filterRating() const;
 
+    SortCriterion sortCriterion() const;
+
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
 public Q_SLOTS:
 
     void setFilterText(const QString &filterText);
 
     void setFilterRating(int filterRating);
 
+    void setSortCriterion(SortCriterion sortCriterion);
+
 Q_SIGNALS:
 
     void filterTextChanged(const QString &filterText);
 
     void filterRatingChanged(int filterRating);
 
+    void filterApplied();
+
+    void sortCriterionChanged(SortCriterion sortCriterion);
+
 protected:
 
     virtual bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const override = 0;
 
+    /* search entries of all source rows, false when the proxy filters through data() instead */
+    virtual bool sourceSearchEntries(QVector<SearchKeyEntry> &searchEntries) const;
+
+    /* false when the rows of the source model carry no rating */
+    virtual bool filterOnRating() const;
+
+    bool acceptsSearchEntry(int sourceRow, const SearchKeyEntry &searchEntry) const;
+
+    bool lessThan(const QModelIndex &source_left, const QModelIndex &source_right) const override;
+
+    /* sort entries of all source rows, nullptr when the proxy sorts through data() instead */
+    virtual const std::vector<SortKeyEntry> *sourceSortEntries() const;
+
     QString mFilterText;
 
     int mFilterRating = 0;
@@ -81,6 +130,51 @@ protected:
 
     QThreadPool mThreadPool;
 
+    /* enqueue requests waiting for the rows of a paged source model to be read from the database, in request order */
+    QList<QPair<ElisaUtils::PlayListEnqueueMode, ElisaUtils::PlayListEnqueueTriggerPlay>> mPendingEnqueues;
+
+private:
+
+    void applyFilter();
+
+    void startFilterPass();
+
+    void publishFilterPass(const SearchKeyMatcher &filterMatcher, int filterRating, quint64 sourceGeneration,
+                           int sourceRowsCount, const QVector<int> &acceptedRows);
+
+    void sourceRowsChanged();
+
+    void buildSortRanks();
+
+    QTimer mFilterTimer;
+
+    SearchKeyMatcher mFilterMatcher;
+
+    int mAppliedFilterRating = 0;
+
+    QVector<int> mAcceptedRows;
+
+    QBitArray mAcceptedRowsMask;
+
+    bool mAcceptedRowsValid = false;
+
+    quint64 mAcceptedRowsGeneration = 0;
+
+    quint64 mSourceGeneration = 0;
+
+    bool mFilterPassRunning = false;
+
+    bool mFilterPassPending = false;
+
+    SortCriterion mSortCriterion = SortByTitle;
+
+    /* position of each source row once sorted on mSortCriterion, turns each comparison into an integer one */
+    QVector<int> mSortRanks;
+
+    bool mSortRanksValid = false;
+
+    QVector<QMetaObject::Connection> mSourceConnections;
+
 };
 
 #endif // ABSTRACTMEDIAPROXYMODEL_H
@@ -19,6 +19,7 @@
 
 #include "albummodel.h"
 #include "databaseinterface.h"
+#include "displaytextformatter.h"
 
 #include <QUrl>
 #include <QTimer>
@@ -142,15 +143,8 @@ QVariant AlbumModel::internalDataTrack(const MusicAudioTrack &track, int role, i
         result = track.duration().msecsSinceStartOfDay();
         break;
     case ColumnsRoles::DurationRole:
-    {
-        QTime trackDuration = track.duration();
-        if (trackDuration.hour() == 0) {
-            result = trackDuration.toString(QStringLiteral("mm:ss"));
-        } else {
-            result = trackDuration.toString();
-        }
+        result = DisplayTextFormatter::durationText(track.duration());
         break;
-    }
     case ColumnsRoles::ArtistRole:
         result = track.artist();
         break;
@@ -170,7 +164,7 @@ QVariant AlbumModel::internalDataTrack(const MusicAudioTrack &track, int role, i
         if (rowIndex == 0) {
             result = true;
         } else {
-            auto previousTrack = d->mCurrentAlbum.trackFromIndex(rowIndex - 1);
+            const auto &previousTrack = d->mCurrentAlbum.trackFromIndex(rowIndex - 1);
             result = (previousTrack.discNumber() != track.discNumber());
         }
         break;
@@ -221,25 +215,8 @@ QVariant AlbumModel::internalDataTrack(const MusicAudioTrack &track, int role, i
         result = track.title();
         break;
     case ColumnsRoles::SecondaryTextRole:
-    {
-        auto secondaryText = QString();
-        secondaryText = QStringLiteral("<b>%1 - %2</b>%3");
-
-        secondaryText = secondaryText.arg(track.trackNumber());
-        secondaryText = secondaryText.arg(track.title());
-
-        if (track.artist() == track.albumArtist()) {
-            secondaryText = secondaryText.arg(QString());
-        } else {
-            auto artistText = QString();
-            artistText = QStringLiteral(" - <i>%1</i>");
-            artistText = artistText.arg(track.artist());
-            secondaryText = secondaryText.arg(artistText);
-        }
-
-        result = secondaryText;
+        result = DisplayTextFormatter::trackSecondaryText(track);
         break;
-    }
     case ColumnsRoles::ImageUrlRole:
     {
         const auto &albumArtUri = d->mCurrentAlbum.albumArtURI();
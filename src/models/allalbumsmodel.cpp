@@ -22,18 +22,96 @@
 #include "databaseinterface.h"
 #include "allartistsmodel.h"
 #include "albummodel.h"
+#include "pagedmodelwindow.h"
 
 #include <QUrl>
 #include <QTimer>
 #include <QPointer>
 #include <QVector>
-#include <QReadWriteLock>
-#include <QReadLocker>
-#include <QWriteLocker>
+#include <QSet>
 #include <QtConcurrentRun>
+#include <QFutureWatcher>
 #include <QThreadPool>
+#include <QThread>
 
 #include <algorithm>
+#include <functional>
+
+/* a batch of albums prepared off the owner thread, ready to be committed in one range */
+struct AllAlbumsModelPreparedAlbums
+{
+
+    QVector<MusicAlbum> mAlbums;
+
+    QVector<SearchKeyEntry> mSearchEntries;
+
+    std::vector<SortKeyEntry> mSortEntries;
+
+};
+
+static SortKeyEntry albumSortEntry(const SortKeyBuilder &sortKeyBuilder, const MusicAlbum &album)
+{
+    auto result = sortKeyBuilder.sortEntry(album.title(), album.artist());
+
+    for (int trackIndex = 0; trackIndex < album.tracksCount(); ++trackIndex) {
+        const auto &oneTrack = album.trackFromIndex(trackIndex);
+
+        if (result.mYear == 0) {
+            result.mYear = oneTrack.year();
+        }
+        result.mDuration += oneTrack.duration().msecsSinceStartOfDay();
+    }
+
+    result.mDatabaseId = album.databaseId();
+
+    return result;
+}
+
+/* album artist and track artists, the artist pages showing this album */
+static QStringList albumArtists(const MusicAlbum &album)
+{
+    auto result = album.allArtists();
+
+    if (!album.artist().isEmpty() && !result.contains(album.artist())) {
+        result.push_back(album.artist());
+    }
+
+    return result;
+}
+
+static AllAlbumsModelPreparedAlbums prepareAlbums(const QList<MusicAlbum> &albums, const QStringList &ignoredArticles)
+{
+    const auto sortKeyBuilder = SortKeyBuilder(ignoredArticles);
+
+    auto preparedAlbums = AllAlbumsModelPreparedAlbums();
+    preparedAlbums.mAlbums.reserve(albums.size());
+    preparedAlbums.mSearchEntries.reserve(albums.size());
+    preparedAlbums.mSortEntries.reserve(albums.size());
+
+    auto preparedIds = QSet<qulonglong>();
+    preparedIds.reserve(albums.size());
+
+    for (const auto &oneAlbum : albums) {
+        if (!oneAlbum.isValid() || preparedIds.contains(oneAlbum.databaseId())) {
+            continue;
+        }
+
+        auto searchFields = oneAlbum.allArtists();
+        searchFields.push_front(oneAlbum.artist());
+        searchFields.push_front(oneAlbum.title());
+
+        auto searchEntry = SearchKeyEntry();
+        searchEntry.mSearchKey = SearchKeyMatcher::searchKey(searchFields);
+        searchEntry.mRating = oneAlbum.highestTrackRating();
+
+        preparedIds.insert(oneAlbum.databaseId());
+        preparedAlbums.mAlbums.push_back(oneAlbum);
+        preparedAlbums.mSearchEntries.push_back(searchEntry);
+        preparedAlbums.mSortEntries.push_back(albumSortEntry(sortKeyBuilder, oneAlbum));
+    }
+
+    return preparedAlbums;
+}
 
 class AllAlbumsModelPrivate
 {
@@ -44,20 +122,96 @@ public:
         mThreadPool.setMaxThreadCount(1);
     }
 
+    /* nullptr for a row of a page not loaded yet, the page is then requested */
+    const MusicAlbum *rowAlbum(const QObject *model, int row)
+    {
+        if (!mAlbumsWindow.isEnabled()) {
+            return &mAlbumsData[mAllAlbums.at(row)];
+        }
+
+        if (QThread::currentThread() == model->thread() && mAlbumsWindow.touch(row)) {
+            mPageRequestTimer.start();
+        }
+
+        return mAlbumsWindow.item(row);
+    }
+
+    void addToArtistIndex(const MusicAlbum &album)
+    {
+        const auto artists = albumArtists(album);
+
+        for (const auto &oneArtist : artists) {
+            mArtistAlbums[oneArtist].insert(album.databaseId());
+        }
+    }
+
+    void removeFromArtistIndex(const MusicAlbum &album)
+    {
+        const auto artists = albumArtists(album);
+
+        for (const auto &oneArtist : artists) {
+            auto itArtist = mArtistAlbums.find(oneArtist);
+            if (itArtist == mArtistAlbums.end()) {
+                continue;
+            }
+
+            itArtist->remove(album.databaseId());
+
+            if (itArtist->isEmpty()) {
+                mArtistAlbums.erase(itArtist);
+            }
+        }
+    }
+
+    /* runs preparation on the serial pool and commit on the thread owning the model, in submission order */
+    template <typename Result, typename Commit>
+    void prepareAndCommit(QObject *owner, std::function<Result()> preparation, Commit commit)
+    {
+        auto watcher = new QFutureWatcher<Result>(owner);
+
+        QObject::connect(watcher, &QFutureWatcher<Result>::finished, owner, [watcher, commit] () {
+            commit(watcher->result());
+            watcher->deleteLater();
+        });
+
+        watcher->setFuture(QtConcurrent::run(&mThreadPool, preparation));
+    }
+
     QVector<qulonglong> mAllAlbums;
 
     QHash<qulonglong, MusicAlbum> mAlbumsData;
 
-    AllArtistsModel *mAllArtistsModel = nullptr;
+    /* search key and highest track rating of each row of mAllAlbums */
+    QVector<SearchKeyEntry> mSearchEntries;
+
+    /* collation keys of title and artist of each row of mAllAlbums, used by the proxy models to sort */
+    std::vector<SortKeyEntry> mSortEntries;
 
-    QReadWriteLock mDataLock;
+    /* articles ignored by the sort keys of the batches submitted from now on */
+    QStringList mIgnoredSortArticles;
+
+    /* database id of an album to its row in mAllAlbums */
+    QHash<qulonglong, int> mAlbumRows;
+
+    /* name of an artist to the database ids of its albums, as album artist or track artist */
+    QHash<QString, QSet<qulonglong>> mArtistAlbums;
+
+    AllArtistsModel *mAllArtistsModel = nullptr;
 
     QThreadPool mThreadPool;
 
+    /* albums of the loaded pages when the model is paged, the containers above then stay empty */
+    PagedModelWindow<MusicAlbum> mAlbumsWindow;
+
+    QTimer mPageRequestTimer;
+
 };
 
 AllAlbumsModel::AllAlbumsModel(QObject *parent) : QAbstractItemModel(parent), d(std::make_unique<AllAlbumsModelPrivate>())
 {
+    d->mPageRequestTimer.setSingleShot(true);
+    d->mPageRequestTimer.setInterval(0);
+    connect(&d->mPageRequestTimer, &QTimer::timeout, this, &AllAlbumsModel::requestPendingPages);
 }
 
 AllAlbumsModel::~AllAlbumsModel()
@@ -65,7 +219,10 @@ AllAlbumsModel::~AllAlbumsModel()
 
 int AllAlbumsModel::albumCount() const
 {
-    QReadLocker locker(&d->mDataLock);
+    if (d->mAlbumsWindow.isEnabled()) {
+        return d->mAlbumsWindow.totalCount();
+    }
+
     return d->mAllAlbums.size();
 }
 
@@ -77,9 +234,11 @@ int AllAlbumsModel::rowCount(const QModelIndex &parent) const
         return albumCount;
     }
 
-    QReadLocker locker(&d->mDataLock);
-
-    albumCount = d->mAllAlbums.size();
+    if (d->mAlbumsWindow.isEnabled()) {
+        albumCount = d->mAlbumsWindow.fetchedCount();
+    } else {
+        albumCount = d->mAllAlbums.size();
+    }
 
     return albumCount;
 }
@@ -120,9 +279,7 @@ QVariant AllAlbumsModel::data(const QModelIndex &index, int role) const
 {
     auto result = QVariant();
 
-    QReadLocker locker(&d->mDataLock);
-
-    const auto albumCount = d->mAllAlbums.size();
+    const auto albumCount = rowCount();
 
     if (!index.isValid()) {
         return result;
@@ -148,63 +305,69 @@ QVariant AllAlbumsModel::data(const QModelIndex &index, int role) const
         return result;
     }
 
-    result = internalDataAlbum(index.row(), role);
+    const auto *rowAlbum = d->rowAlbum(this, index.row());
+
+    if (!rowAlbum) {
+        return result;
+    }
+
+    result = internalDataAlbum(*rowAlbum, role);
     return result;
 }
 
-QVariant AllAlbumsModel::internalDataAlbum(int albumIndex, int role) const
+QVariant AllAlbumsModel::internalDataAlbum(const MusicAlbum &album, int role) const
 {
     auto result = QVariant();
 
     switch(role)
     {
     case ColumnsRoles::TitleRole:
-        result = d->mAlbumsData[d->mAllAlbums[albumIndex]].title();
+        result = album.title();
         break;
     case ColumnsRoles::AllTracksTitleRole:
-        result = d->mAlbumsData[d->mAllAlbums[albumIndex]].allTracksTitle();
+        result = album.allTracksTitle();
         break;
     case ColumnsRoles::ArtistRole:
-        result = d->mAlbumsData[d->mAllAlbums[albumIndex]].artist();
+        result = album.artist();
         break;
     case ColumnsRoles::AllArtistsRole:
-        result = d->mAlbumsData[d->mAllAlbums[albumIndex]].allArtists().join(QStringLiteral(", "));
+        result = album.allArtists().join(QStringLiteral(", "));
         break;
     case ColumnsRoles::ImageRole:
     {
-        auto albumArt = d->mAlbumsData[d->mAllAlbums[albumIndex]].albumArtURI();
+        auto albumArt = album.albumArtURI();
         if (albumArt.isValid()) {
             result = albumArt;
         }
         break;
     }
     case ColumnsRoles::CountRole:
-        result = d->mAlbumsData[d->mAllAlbums[albumIndex]].tracksCount();
+        result = album.tracksCount();
         break;
     case ColumnsRoles::IdRole:
-        result = d->mAlbumsData[d->mAllAlbums[albumIndex]].id();
+        result = album.id();
         break;
     case ColumnsRoles::IsSingleDiscAlbumRole:
-        result = d->mAlbumsData[d->mAllAlbums[albumIndex]].isSingleDiscAlbum();
+        result = album.isSingleDiscAlbum();
         break;
     case ColumnsRoles::ContainerDataRole:
-        result = QVariant::fromValue(d->mAlbumsData[d->mAllAlbums[albumIndex]]);
+        result = QVariant::fromValue(album);
         break;
     case ColumnsRoles::AlbumDatabaseIdRole:
-        result = QVariant::fromValue(d->mAlbumsData[d->mAllAlbums[albumIndex]].databaseId());
+        result = QVariant::fromValue(album.databaseId());
         break;
     case ColumnsRoles::HighestTrackRating:
-        result = d->mAlbumsData[d->mAllAlbums[albumIndex]].highestTrackRating();
+        result = album.highestTrackRating();
         break;
     case Qt::DisplayRole:
-        result = d->mAlbumsData[d->mAllAlbums[albumIndex]].title();
+        result = album.title();
         break;
     case ColumnsRoles::SecondaryTextRole:
-        result = d->mAlbumsData[d->mAllAlbums[albumIndex]].artist();
+        result = album.artist();
         break;
     case ColumnsRoles::ImageUrlRole:
     {
-        auto albumArt = d->mAlbumsData[d->mAllAlbums[albumIndex]].albumArtURI();
+        auto albumArt = album.albumArtURI();
         if (albumArt.isValid()) {
             result = albumArt;
         } else {
@@ -213,12 +376,11 @@ QVariant AllAlbumsModel::internalDataAlbum(int albumIndex, int role) const
         break;
     }
     case ColumnsRoles::ShadowForImageRole:
-        result = d->mAlbumsData[d->mAllAlbums[albumIndex]].albumArtURI().isValid();
+        result = album.albumArtURI().isValid();
         break;
     case ColumnsRoles::ChildModelRole:
     {
-        auto albumData = d->mAlbumsData[d->mAllAlbums[albumIndex]];
-        result = QVariant::fromValue(albumData);
+        result = QVariant::fromValue(album);
         break;
     }
     case ColumnsRoles::IsTracksContainerRole:
@@ -262,91 +424,381 @@ int AllAlbumsModel::columnCount(const QModelIndex &parent) const
     return 1;
 }
 
+bool AllAlbumsModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return false;
+    }
+
+    return d->mAlbumsWindow.canFetchMore();
+}
+
+void AllAlbumsModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+
+    const auto newFetchedCount = d->mAlbumsWindow.nextFetchedCount();
+
+    beginInsertRows({}, d->mAlbumsWindow.fetchedCount(), newFetchedCount - 1);
+    d->mAlbumsWindow.setFetchedCount(newFetchedCount);
+    endInsertRows();
+}
+
+bool AllAlbumsModel::isPaged() const
+{
+    return d->mAlbumsWindow.isEnabled();
+}
+
+void AllAlbumsModel::setPaged(bool paged)
+{
+    if (d->mAlbumsWindow.isEnabled() == paged) {
+        return;
+    }
+
+    beginResetModel();
+
+    d->mAllAlbums.clear();
+    d->mAlbumsData.clear();
+    d->mSearchEntries.clear();
+    d->mSortEntries.clear();
+    d->mAlbumRows.clear();
+    d->mArtistAlbums.clear();
+
+    d->mAlbumsWindow.setEnabled(paged);
+    d->mAlbumsWindow.reset(0);
+
+    endResetModel();
+
+    Q_EMIT albumCountChanged();
+}
+
 AllArtistsModel *AllAlbumsModel::allArtists() const
 {
     return d->mAllArtistsModel;
 }
 
+QVector<int> AllAlbumsModel::albumRowsOfArtist(const QString &artist) const
+{
+    auto result = QVector<int>();
+
+    auto itArtist = d->mArtistAlbums.constFind(artist);
+    if (itArtist == d->mArtistAlbums.constEnd()) {
+        return result;
+    }
+
+    result.reserve(itArtist->size());
+
+    for (auto oneAlbumId : *itArtist) {
+        auto itAlbumRow = d->mAlbumRows.constFind(oneAlbumId);
+        if (itAlbumRow != d->mAlbumRows.constEnd()) {
+            result.push_back(itAlbumRow.value());
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
+
+const QVector<SearchKeyEntry> &AllAlbumsModel::searchEntries() const
+{
+    return d->mSearchEntries;
+}
+
+const std::vector<SortKeyEntry> &AllAlbumsModel::sortEntries() const
+{
+    return d->mSortEntries;
+}
+
 void AllAlbumsModel::albumsAdded(const QList<MusicAlbum> &newAlbums)
 {
-    QtConcurrent::run(&d->mThreadPool, [=] () {
-        for (const auto &newAlbum : newAlbums) {
-            if (newAlbum.isValid()) {
-                beginInsertRows({}, d->mAllAlbums.size(), d->mAllAlbums.size());
+    if (d->mAlbumsWindow.isEnabled()) {
+        const auto newAlbumsCount = std::count_if(newAlbums.begin(), newAlbums.end(), [] (const MusicAlbum &oneAlbum) {
+            return oneAlbum.isValid();
+        });
 
-                {
-                    QWriteLocker locker(&d->mDataLock);
+        if (newAlbumsCount == 0) {
+            return;
+        }
 
-                    d->mAllAlbums.push_back(newAlbum.databaseId());
-                    d->mAlbumsData[newAlbum.databaseId()] = newAlbum;
-                }
+        /* new albums get the highest ids, they are the last rows in database order */
+        const auto allRowsFetched = !d->mAlbumsWindow.canFetchMore();
 
-                endInsertRows();
+        d->mAlbumsWindow.append(static_cast<int>(newAlbumsCount));
 
-                Q_EMIT albumCountChanged();
-            }
+        /* views only fetch more rows when they reach the end, that already happened */
+        if (allRowsFetched) {
+            beginInsertRows({}, d->mAlbumsWindow.fetchedCount(), d->mAlbumsWindow.totalCount() - 1);
+            d->mAlbumsWindow.setFetchedCount(d->mAlbumsWindow.totalCount());
+            endInsertRows();
         }
+
+        Q_EMIT albumCountChanged();
+
+        return;
+    }
+
+    const auto ignoredArticles = d->mIgnoredSortArticles;
+
+    d->prepareAndCommit<AllAlbumsModelPreparedAlbums>(this, [newAlbums, ignoredArticles] () {
+        return prepareAlbums(newAlbums, ignoredArticles);
+    }, [this] (const AllAlbumsModelPreparedAlbums &preparedAlbums) {
+        insertPreparedAlbums(preparedAlbums);
     });
 }
 
 void AllAlbumsModel::albumRemoved(const MusicAlbum &removedAlbum)
 {
-    QtConcurrent::run(&d->mThreadPool, [=] () {
-        auto removedAlbumIterator = d->mAllAlbums.end();
+    albumsRemoved({removedAlbum});
+}
+
+void AllAlbumsModel::albumModified(const MusicAlbum &modifiedAlbum)
+{
+    albumsModified({modifiedAlbum});
+}
+
+void AllAlbumsModel::albumsRemoved(const QList<MusicAlbum> &removedAlbums)
+{
+    if (d->mAlbumsWindow.isEnabled()) {
+        if (removedAlbums.isEmpty()) {
+            return;
+        }
 
-        {
-            QReadLocker locker(&d->mDataLock);
+        /* rows of the removed albums are only known inside the loaded pages, all pages are read again */
+        beginResetModel();
+        d->mAlbumsWindow.reset(std::max(0, d->mAlbumsWindow.totalCount() - removedAlbums.size()));
+        endResetModel();
 
-            removedAlbumIterator = std::find(d->mAllAlbums.begin(), d->mAllAlbums.end(), removedAlbum.databaseId());
+        Q_EMIT albumCountChanged();
 
-            if (removedAlbumIterator == d->mAllAlbums.end()) {
-                return;
-            }
+        return;
+    }
+
+    d->prepareAndCommit<QVector<qulonglong>>(this, [removedAlbums] () {
+        auto removedIds = QVector<qulonglong>();
+        removedIds.reserve(removedAlbums.size());
+
+        for (const auto &oneAlbum : removedAlbums) {
+            removedIds.push_back(oneAlbum.databaseId());
+        }
+
+        return removedIds;
+    }, [this] (const QVector<qulonglong> &removedIds) {
+        removeAlbumsRows(removedIds);
+    });
+}
+
+void AllAlbumsModel::albumsModified(const QList<MusicAlbum> &modifiedAlbums)
+{
+    if (d->mAlbumsWindow.isEnabled()) {
+        updatePagedAlbums(modifiedAlbums);
+
+        return;
+    }
+
+    const auto ignoredArticles = d->mIgnoredSortArticles;
+
+    d->prepareAndCommit<AllAlbumsModelPreparedAlbums>(this, [modifiedAlbums, ignoredArticles] () {
+        return prepareAlbums(modifiedAlbums, ignoredArticles);
+    }, [this] (const AllAlbumsModelPreparedAlbums &preparedAlbums) {
+        updateAlbumsRows(preparedAlbums);
+    });
+}
+
+void AllAlbumsModel::insertPreparedAlbums(const AllAlbumsModelPreparedAlbums &preparedAlbums)
+{
+    auto insertedIndexes = QVector<int>();
+    insertedIndexes.reserve(preparedAlbums.mAlbums.size());
+
+    for (int albumIndex = 0; albumIndex < preparedAlbums.mAlbums.size(); ++albumIndex) {
+        if (!d->mAlbumRows.contains(preparedAlbums.mAlbums.at(albumIndex).databaseId())) {
+            insertedIndexes.push_back(albumIndex);
+        }
+    }
+
+    if (insertedIndexes.isEmpty()) {
+        return;
+    }
+
+    const auto firstNewRow = d->mAllAlbums.size();
+
+    beginInsertRows({}, firstNewRow, firstNewRow + insertedIndexes.size() - 1);
+
+    d->mAllAlbums.reserve(firstNewRow + insertedIndexes.size());
+    d->mSearchEntries.reserve(firstNewRow + insertedIndexes.size());
+    d->mSortEntries.reserve(firstNewRow + insertedIndexes.size());
+    d->mAlbumRows.reserve(firstNewRow + insertedIndexes.size());
+    d->mAlbumsData.reserve(firstNewRow + insertedIndexes.size());
+
+    for (auto albumIndex : qAsConst(insertedIndexes)) {
+        const auto &newAlbum = preparedAlbums.mAlbums.at(albumIndex);
+
+        d->mAlbumRows[newAlbum.databaseId()] = d->mAllAlbums.size();
+        d->mAllAlbums.push_back(newAlbum.databaseId());
+        d->mSearchEntries.push_back(preparedAlbums.mSearchEntries.at(albumIndex));
+        d->mSortEntries.push_back(preparedAlbums.mSortEntries.at(albumIndex));
+        d->mAlbumsData[newAlbum.databaseId()] = newAlbum;
+        d->addToArtistIndex(newAlbum);
+    }
+
+    endInsertRows();
 
-            int albumIndex = removedAlbumIterator - d->mAllAlbums.begin();
+    Q_EMIT albumCountChanged();
+}
+
+void AllAlbumsModel::removeAlbumsRows(const QVector<qulonglong> &removedIds)
+{
+    auto removedRows = QVector<int>();
+    removedRows.reserve(removedIds.size());
+
+    for (auto oneId : removedIds) {
+        auto itAlbumRow = d->mAlbumRows.find(oneId);
+        if (itAlbumRow == d->mAlbumRows.end()) {
+            continue;
+        }
+
+        removedRows.push_back(itAlbumRow.value());
+        d->mAlbumRows.erase(itAlbumRow);
+    }
+
+    if (removedRows.isEmpty()) {
+        return;
+    }
 
-            beginRemoveRows({}, albumIndex, albumIndex);
+    std::sort(removedRows.begin(), removedRows.end());
 
+    auto runEnd = removedRows.size() - 1;
+    while (runEnd >= 0) {
+        auto runStart = runEnd;
+        while (runStart > 0 && removedRows[runStart - 1] == removedRows[runStart] - 1) {
+            --runStart;
         }
 
-        {
-            QWriteLocker writeLocker(&d->mDataLock);
-            d->mAlbumsData.remove(removedAlbum.databaseId());
-            d->mAllAlbums.erase(removedAlbumIterator);
+        beginRemoveRows({}, removedRows[runStart], removedRows[runEnd]);
+
+        const auto firstAlbum = d->mAllAlbums.begin() + removedRows[runStart];
+        const auto lastAlbum = d->mAllAlbums.begin() + removedRows[runEnd] + 1;
+
+        for (auto itAlbum = firstAlbum; itAlbum != lastAlbum; ++itAlbum) {
+            d->removeFromArtistIndex(d->mAlbumsData[*itAlbum]);
+            d->mAlbumsData.remove(*itAlbum);
         }
 
+        d->mAllAlbums.erase(firstAlbum, lastAlbum);
+        d->mSearchEntries.erase(d->mSearchEntries.begin() + removedRows[runStart], d->mSearchEntries.begin() + removedRows[runEnd] + 1);
+        d->mSortEntries.erase(d->mSortEntries.begin() + removedRows[runStart], d->mSortEntries.begin() + removedRows[runEnd] + 1);
+
         endRemoveRows();
 
-        Q_EMIT albumCountChanged();
-    });
+        runEnd = runStart - 1;
+    }
+
+    for (int oneRow = removedRows.first(); oneRow < d->mAllAlbums.size(); ++oneRow) {
+        d->mAlbumRows[d->mAllAlbums.at(oneRow)] = oneRow;
+    }
+
+    Q_EMIT albumCountChanged();
 }
 
-void AllAlbumsModel::albumModified(const MusicAlbum &modifiedAlbum)
+void AllAlbumsModel::updateAlbumsRows(const AllAlbumsModelPreparedAlbums &preparedAlbums)
 {
-    QtConcurrent::run(&d->mThreadPool, [=] () {
-        auto modifiedAlbumIterator = d->mAllAlbums.end();
+    auto modifiedRows = QVector<int>();
+    modifiedRows.reserve(preparedAlbums.mAlbums.size());
 
-        {
-            QReadLocker locker(&d->mDataLock);
+    for (int albumIndex = 0; albumIndex < preparedAlbums.mAlbums.size(); ++albumIndex) {
+        const auto &oneAlbum = preparedAlbums.mAlbums.at(albumIndex);
 
-            modifiedAlbumIterator = std::find(d->mAllAlbums.begin(), d->mAllAlbums.end(), modifiedAlbum.databaseId());
+        auto itAlbumRow = d->mAlbumRows.constFind(oneAlbum.databaseId());
+        if (itAlbumRow == d->mAlbumRows.constEnd()) {
+            continue;
         }
 
-        int albumIndex = 0;
+        d->removeFromArtistIndex(d->mAlbumsData[oneAlbum.databaseId()]);
+        d->mAlbumsData[oneAlbum.databaseId()] = oneAlbum;
+        d->addToArtistIndex(oneAlbum);
+        d->mSearchEntries[itAlbumRow.value()] = preparedAlbums.mSearchEntries.at(albumIndex);
+        d->mSortEntries[itAlbumRow.value()] = preparedAlbums.mSortEntries.at(albumIndex);
+        modifiedRows.push_back(itAlbumRow.value());
+    }
 
-        {
-            QWriteLocker writeLocker(&d->mDataLock);
+    if (modifiedRows.isEmpty()) {
+        return;
+    }
 
-            if (modifiedAlbumIterator == d->mAllAlbums.end()) {
-                return;
-            }
+    std::sort(modifiedRows.begin(), modifiedRows.end());
+    modifiedRows.erase(std::unique(modifiedRows.begin(), modifiedRows.end()), modifiedRows.end());
+
+    auto runStart = 0;
+    while (runStart < modifiedRows.size()) {
+        auto runEnd = runStart;
+        while (runEnd + 1 < modifiedRows.size() && modifiedRows[runEnd + 1] == modifiedRows[runEnd] + 1) {
+            ++runEnd;
+        }
+
+        Q_EMIT dataChanged(index(modifiedRows[runStart], 0), index(modifiedRows[runEnd], 0));
+
+        runStart = runEnd + 1;
+    }
+}
+
+void AllAlbumsModel::updatePagedAlbums(const QList<MusicAlbum> &modifiedAlbums)
+{
+    auto modifiedAlbumsById = QHash<qulonglong, const MusicAlbum*>();
+    modifiedAlbumsById.reserve(modifiedAlbums.size());
 
-            albumIndex = modifiedAlbumIterator - d->mAllAlbums.begin();
+    for (const auto &oneAlbum : modifiedAlbums) {
+        modifiedAlbumsById[oneAlbum.databaseId()] = &oneAlbum;
+    }
+
+    auto modifiedRows = QVector<int>();
 
-            d->mAlbumsData[modifiedAlbum.databaseId()] = modifiedAlbum;
+    /* albums outside of the loaded pages are read again with their page */
+    d->mAlbumsWindow.forEachLoadedItem([&modifiedAlbumsById, &modifiedRows] (int row, MusicAlbum &loadedAlbum) {
+        auto itModifiedAlbum = modifiedAlbumsById.constFind(loadedAlbum.databaseId());
+        if (itModifiedAlbum == modifiedAlbumsById.constEnd()) {
+            return;
         }
 
-        Q_EMIT dataChanged(index(albumIndex, 0), index(albumIndex, 0));
+        loadedAlbum = *itModifiedAlbum.value();
+        modifiedRows.push_back(row);
+    });
+
+    for (auto oneRow : qAsConst(modifiedRows)) {
+        if (oneRow < d->mAlbumsWindow.fetchedCount()) {
+            Q_EMIT dataChanged(index(oneRow, 0), index(oneRow, 0));
+        }
+    }
+}
+
+void AllAlbumsModel::updateSortEntries(const QStringList &ignoredArticles)
+{
+    const auto sortKeyBuilder = SortKeyBuilder(ignoredArticles);
+
+    /* rows do not move but every proxy model has to sort them again */
+    Q_EMIT layoutAboutToBeChanged();
+
+    for (int oneRow = 0; oneRow < d->mAllAlbums.size(); ++oneRow) {
+        d->mSortEntries[oneRow] = albumSortEntry(sortKeyBuilder, d->mAlbumsData[d->mAllAlbums.at(oneRow)]);
+    }
+
+    Q_EMIT layoutChanged();
+}
+
+void AllAlbumsModel::setIgnoredSortArticles(const QStringList &ignoredArticles)
+{
+    if (d->mIgnoredSortArticles == ignoredArticles) {
+        return;
+    }
+
+    d->mIgnoredSortArticles = ignoredArticles;
+
+    /* batches submitted before still carry keys built with the previous articles, so this is queued after them */
+    d->prepareAndCommit<QStringList>(this, [ignoredArticles] () {
+        return ignoredArticles;
+    }, [this] (const QStringList &appliedArticles) {
+        updateSortEntries(appliedArticles);
     });
 }
 
@@ -360,4 +812,52 @@ void AllAlbumsModel::setAllArtists(AllArtistsModel *model)
     Q_EMIT allArtistsChanged();
 }
 
+void AllAlbumsModel::setAlbumsCount(int albumsCount)
+{
+    if (!d->mAlbumsWindow.isEnabled()) {
+        return;
+    }
+
+    beginResetModel();
+    d->mAlbumsWindow.reset(albumsCount);
+    endResetModel();
+
+    Q_EMIT albumCountChanged();
+}
+
+void AllAlbumsModel::setAlbumsPage(int offset, const QList<MusicAlbum> &albums)
+{
+    if (!d->mAlbumsWindow.storePage(offset, albums)) {
+        return;
+    }
+
+    const auto lastRow = std::min(offset + albums.size(), d->mAlbumsWindow.fetchedCount()) - 1;
+
+    if (lastRow >= offset) {
+        Q_EMIT dataChanged(index(offset, 0), index(lastRow, 0));
+    }
+}
+
+void AllAlbumsModel::fetchAllAlbumsTracksIds()
+{
+    Q_EMIT requestAllAlbumsTracksIds();
+}
+
+void AllAlbumsModel::setAllAlbumsTracksIds(const QList<qulonglong> &tracksIds)
+{
+    Q_EMIT allAlbumsTracksIdsFetched(tracksIds);
+}
+
+void AllAlbumsModel::requestPendingPages()
+{
+    const auto pendingPages = d->mAlbumsWindow.takePendingPages();
+
+    for (auto onePage : pendingPages) {
+        const auto pageStart = d->mAlbumsWindow.pageStart(onePage);
+
+        Q_EMIT requestAlbumsPage(onePage * d->mAlbumsWindow.pageSize(), d->mAlbumsWindow.pageSize(),
+                                 pageStart.mAfterKey, pageStart.mSkippedCount);
+    }
+}
+
 #include "moc_allalbumsmodel.cpp"
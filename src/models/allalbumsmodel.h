@@ -26,11 +26,15 @@
 #include <QString>
 
 #include "musicalbum.h"
+#include "searchkeymatcher.h"
+#include "sortkeybuilder.h"
 #include "musicaudiotrack.h"
 
 #include <memory>
+#include <vector>
 
 class AllAlbumsModelPrivate;
+struct AllAlbumsModelPreparedAlbums;
 class MusicStatistics;
 class AllArtistsModel;
 
@@ -90,8 +94,27 @@ public:
 
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
 
+    bool canFetchMore(const QModelIndex &parent) const override;
+
+    void fetchMore(const QModelIndex &parent) override;
+
+    /* only the albums around the rows asked by the views are kept, they are read from the database page by page */
+    bool isPaged() const;
+
+    void setPaged(bool paged);
+
     AllArtistsModel *allArtists() const;
 
+    /* rows of the albums of this artist, in O(number of its albums); always empty when the model is paged */
+    QVector<int> albumRowsOfArtist(const QString &artist) const;
+
+    const QVector<SearchKeyEntry> &searchEntries() const;
+
+    const std::vector<SortKeyEntry> &sortEntries() const;
+
+    /* ids of the tracks of all the albums, read from the database when the model is paged; answered by allAlbumsTracksIdsFetched */
+    void fetchAllAlbumsTracksIds();
+
 public Q_SLOTS:
 
     void albumsAdded(const QList<MusicAlbum> &newAlbums);
@@ -100,17 +123,47 @@ public Q_SLOTS:
 
     void albumModified(const MusicAlbum &modifiedAlbum);
 
+    void albumsRemoved(const QList<MusicAlbum> &removedAlbums);
+
+    void albumsModified(const QList<MusicAlbum> &modifiedAlbums);
+
     void setAllArtists(AllArtistsModel *model);
 
+    void setIgnoredSortArticles(const QStringList &ignoredArticles);
+
+    void setAlbumsCount(int albumsCount);
+
+    void setAlbumsPage(int offset, const QList<MusicAlbum> &albums);
+
+    void setAllAlbumsTracksIds(const QList<qulonglong> &tracksIds);
+
 Q_SIGNALS:
 
     void albumCountChanged();
 
     void allArtistsChanged();
 
+    void requestAlbumsPage(int offset, int count, qulonglong afterId, int skippedCount);
+
+    void requestAllAlbumsTracksIds();
+
+    void allAlbumsTracksIdsFetched(const QList<qulonglong> &tracksIds);
+
 private:
 
-    QVariant internalDataAlbum(int albumIndex, int role) const;
+    QVariant internalDataAlbum(const MusicAlbum &album, int role) const;
+
+    void requestPendingPages();
+
+    void insertPreparedAlbums(const AllAlbumsModelPreparedAlbums &preparedAlbums);
+
+    void removeAlbumsRows(const QVector<qulonglong> &removedIds);
+
+    void updateAlbumsRows(const AllAlbumsModelPreparedAlbums &preparedAlbums);
+
+    void updatePagedAlbums(const QList<MusicAlbum> &modifiedAlbums);
+
+    void updateSortEntries(const QStringList &ignoredArticles);
 
     std::unique_ptr<AllAlbumsModelPrivate> d;
 
@@ -27,67 +27,85 @@
 
 AllAlbumsProxyModel::AllAlbumsProxyModel(QObject *parent) : AbstractMediaProxyModel(parent)
 {
+    sort(0);
 }
 
 AllAlbumsProxyModel::~AllAlbumsProxyModel()
 {
 }
 
-bool AllAlbumsProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
+void AllAlbumsProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
 {
-    bool result = false;
+    if (mAlbumsModel) {
+        disconnect(mAlbumsModel, &AllAlbumsModel::allAlbumsTracksIdsFetched, this, &AllAlbumsProxyModel::enqueueFetchedTracksIds);
+    }
 
-    for (int column = 0, columnCount = sourceModel()->columnCount(source_parent); column < columnCount; ++column) {
-        auto currentIndex = sourceModel()->index(source_row, column, source_parent);
+    mAlbumsModel = qobject_cast<AllAlbumsModel*>(sourceModel);
 
-        const auto &titleValue = sourceModel()->data(currentIndex, AllAlbumsModel::TitleRole).toString();
-        const auto &artistValue = sourceModel()->data(currentIndex, AllAlbumsModel::ArtistRole).toString();
-        const auto &allArtistsValue = sourceModel()->data(currentIndex, AllAlbumsModel::AllArtistsRole).toStringList();
-        const auto maximumRatingValue = sourceModel()->data(currentIndex, AllAlbumsModel::HighestTrackRating).toInt();
+    if (mAlbumsModel) {
+        connect(mAlbumsModel, &AllAlbumsModel::allAlbumsTracksIdsFetched, this, &AllAlbumsProxyModel::enqueueFetchedTracksIds);
+    }
 
-        if (maximumRatingValue < mFilterRating) {
-            result = false;
-            continue;
-        }
+    AbstractMediaProxyModel::setSourceModel(sourceModel);
 
-        if (mFilterExpression.match(titleValue).hasMatch()) {
-            result = true;
-            continue;
-        }
+    /* a paged source model has no sort key, its rows stay in database order */
+    if (mAlbumsModel && mAlbumsModel->isPaged()) {
+        sort(-1);
+    }
+}
 
-        if (mFilterExpression.match(artistValue).hasMatch()) {
-            result = true;
-            continue;
-        }
+bool AllAlbumsProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
+{
+    if (source_parent.isValid() || !mAlbumsModel) {
+        return false;
+    }
 
-        for (const auto &oneArtist : allArtistsValue) {
-            if (mFilterExpression.match(oneArtist).hasMatch()) {
-                result = true;
-                break;
-            }
-        }
+    const auto &searchEntries = mAlbumsModel->searchEntries();
 
-        if (result) {
-            continue;
-        }
+    /* a paged source model has no search key, all its rows are shown */
+    if (source_row >= searchEntries.size()) {
+        return true;
+    }
 
-        if (!result) {
-            break;
-        }
+    return acceptsSearchEntry(source_row, searchEntries.at(source_row));
+}
+
+bool AllAlbumsProxyModel::sourceSearchEntries(QVector<SearchKeyEntry> &searchEntries) const
+{
+    if (!mAlbumsModel || mAlbumsModel->isPaged()) {
+        return false;
     }
 
-    return result;
+    searchEntries = mAlbumsModel->searchEntries();
+
+    return true;
+}
+
+const std::vector<SortKeyEntry> *AllAlbumsProxyModel::sourceSortEntries() const
+{
+    if (!mAlbumsModel || mAlbumsModel->isPaged()) {
+        return nullptr;
+    }
+
+    return &mAlbumsModel->sortEntries();
 }
 
 void AllAlbumsProxyModel::enqueueToPlayList()
 {
+    /* the rows of a paged source model are not all loaded, their tracks are read from the database */
+    if (mAlbumsModel && mAlbumsModel->isPaged()) {
+        mPendingEnqueues.push_back({ElisaUtils::AppendPlayList, ElisaUtils::DoNotTriggerPlay});
+        mAlbumsModel->fetchAllAlbumsTracksIds();
+        return;
+    }
+
     QtConcurrent::run(&mThreadPool, [=] () {
         QReadLocker locker(&mDataLock);
         auto allAlbums = QList<MusicAlbum>();
         allAlbums.reserve(rowCount());
         for (int rowIndex = 0, maxRowCount = rowCount(); rowIndex < maxRowCount; ++rowIndex) {
             auto currentIndex = index(rowIndex, 0);
-            allAlbums.push_back(data(currentIndex, AllAlbumsModel::ContainerDataRole). value<MusicAlbum>());
+            allAlbums.push_back(data(currentIndex, AllAlbumsModel::ContainerDataRole).value<MusicAlbum>());
         }
         Q_EMIT albumToEnqueue(allAlbums,
                               ElisaUtils::AppendPlayList,
@@ -97,13 +115,19 @@ void AllAlbumsProxyModel::enqueueToPlayList()
 
 void AllAlbumsProxyModel::replaceAndPlayOfPlayList()
 {
+    if (mAlbumsModel && mAlbumsModel->isPaged()) {
+        mPendingEnqueues.push_back({ElisaUtils::ReplacePlayList, ElisaUtils::TriggerPlay});
+        mAlbumsModel->fetchAllAlbumsTracksIds();
+        return;
+    }
+
     QtConcurrent::run(&mThreadPool, [=] () {
         QReadLocker locker(&mDataLock);
         auto allAlbums = QList<MusicAlbum>();
         allAlbums.reserve(rowCount());
         for (int rowIndex = 0, maxRowCount = rowCount(); rowIndex < maxRowCount; ++rowIndex) {
             auto currentIndex = index(rowIndex, 0);
-            allAlbums.push_back(data(currentIndex, AllAlbumsModel::ContainerDataRole). value<MusicAlbum>());
+            allAlbums.push_back(data(currentIndex, AllAlbumsModel::ContainerDataRole).value<MusicAlbum>());
         }
         Q_EMIT albumToEnqueue(allAlbums,
                               ElisaUtils::ReplacePlayList,
@@ -111,5 +135,16 @@ void AllAlbumsProxyModel::replaceAndPlayOfPlayList()
     });
 }
 
+void AllAlbumsProxyModel::enqueueFetchedTracksIds(const QList<qulonglong> &tracksIds)
+{
+    if (mPendingEnqueues.isEmpty()) {
+        return;
+    }
+
+    const auto pendingEnqueue = mPendingEnqueues.takeFirst();
+
+    Q_EMIT trackIdsToEnqueue(tracksIds, pendingEnqueue.first, pendingEnqueue.second);
+}
+
 
 #include "moc_allalbumsproxymodel.cpp"
@@ -24,6 +24,8 @@
 #include "abstractmediaproxymodel.h"
 #include "elisautils.h"
 
+class AllAlbumsModel;
+
 class AllAlbumsProxyModel : public AbstractMediaProxyModel
 {
 
@@ -35,12 +37,18 @@ public:
 
     ~AllAlbumsProxyModel() override;
 
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
 Q_SIGNALS:
 
     void albumToEnqueue(QList<MusicAlbum> newAlbums,
                         ElisaUtils::PlayListEnqueueMode enqueueMode,
                         ElisaUtils::PlayListEnqueueTriggerPlay triggerPlay);
 
+    void trackIdsToEnqueue(QList<qulonglong> newTrackIds,
+                           ElisaUtils::PlayListEnqueueMode enqueueMode,
+                           ElisaUtils::PlayListEnqueueTriggerPlay triggerPlay);
+
 public Q_SLOTS:
 
     void enqueueToPlayList();
@@ -51,6 +59,16 @@ protected:
 
     bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const override;
 
+    bool sourceSearchEntries(QVector<SearchKeyEntry> &searchEntries) const override;
+
+    const std::vector<SortKeyEntry> *sourceSortEntries() const override;
+
+private:
+
+    void enqueueFetchedTracksIds(const QList<qulonglong> &tracksIds);
+
+    AllAlbumsModel *mAlbumsModel = nullptr;
+
 };
 
 #endif // ALLALBUMSPROXYMODEL_H
@@ -21,11 +21,16 @@
 #include "databaseinterface.h"
 #include "musicartist.h"
 #include "allalbumsmodel.h"
+#include "pagedmodelwindow.h"
 
 #include <QUrl>
 #include <QTimer>
 #include <QPointer>
 #include <QVector>
+#include <QHash>
+#include <QThread>
+
+#include <algorithm>
 
 class AllArtistsModelPrivate
 {
@@ -35,14 +40,47 @@ public:
     {
     }
 
+    /* nullptr for a row of a page not loaded yet, the page is then requested */
+    const MusicArtist *rowArtist(const QObject *model, int row)
+    {
+        if (!mArtistsWindow.isEnabled()) {
+            return &mAllArtists.at(row);
+        }
+
+        if (QThread::currentThread() == model->thread() && mArtistsWindow.touch(row)) {
+            mPageRequestTimer.start();
+        }
+
+        return mArtistsWindow.item(row);
+    }
+
     QVector<MusicArtist> mAllArtists;
 
+    /* folded name of each row, used by the proxy models to filter without going through data() */
+    QVector<SearchKeyEntry> mSearchEntries;
+
+    /* collation key of the name of each row, used by the proxy models to sort */
+    std::vector<SortKeyEntry> mSortEntries;
+
+    SortKeyBuilder mSortKeyBuilder;
+
+    /* database id of an artist to its row in mAllArtists */
+    QHash<qulonglong, int> mArtistRows;
+
     AllAlbumsModel *mAllAlbumsModel = nullptr;
 
+    /* artists of the loaded pages when the model is paged, the vectors above then stay empty */
+    PagedModelWindow<MusicArtist> mArtistsWindow;
+
+    QTimer mPageRequestTimer;
+
 };
 
 AllArtistsModel::AllArtistsModel(QObject *parent) : QAbstractItemModel(parent), d(std::make_unique<AllArtistsModelPrivate>())
 {
+    d->mPageRequestTimer.setSingleShot(true);
+    d->mPageRequestTimer.setInterval(0);
+    connect(&d->mPageRequestTimer, &QTimer::timeout, this, &AllArtistsModel::requestPendingPages);
 }
 
 AllArtistsModel::~AllArtistsModel()
@@ -56,7 +94,11 @@ int AllArtistsModel::rowCount(const QModelIndex &parent) const
         return artistCount;
     }
 
-    artistCount = d->mAllArtists.size();
+    if (d->mArtistsWindow.isEnabled()) {
+        artistCount = d->mArtistsWindow.fetchedCount();
+    } else {
+        artistCount = d->mAllArtists.size();
+    }
 
     return artistCount;
 }
@@ -92,7 +134,7 @@ QVariant AllArtistsModel::data(const QModelIndex &index, int role) const
 {
     auto result = QVariant();
 
-    const auto artistsCount = d->mAllArtists.size();
+    const auto artistsCount = rowCount();
 
     if (!index.isValid()) {
         return result;
@@ -118,13 +160,21 @@ QVariant AllArtistsModel::data(const QModelIndex &index, int role) const
         return result;
     }
 
+    const auto *rowArtist = d->rowArtist(this, index.row());
+
+    if (!rowArtist) {
+        return result;
+    }
+
+    const auto &artist = *rowArtist;
+
     switch(role)
     {
     case ColumnsRoles::NameRole:
-        result = d->mAllArtists[index.row()].name();
+        result = artist.name();
         break;
     case ColumnsRoles::ArtistsCountRole:
-        result = d->mAllArtists[index.row()].albumsCount();
+        result = artist.albumsCount();
         break;
     case ColumnsRoles::ImageRole:
         break;
@@ -134,7 +184,7 @@ QVariant AllArtistsModel::data(const QModelIndex &index, int role) const
         result = QString();
         break;
     case Qt::DisplayRole:
-        result = d->mAllArtists[index.row()].name();
+        result = artist.name();
         break;
     case ColumnsRoles::ImageUrlRole:
         result = QUrl(QStringLiteral("image://icon/view-media-artist"));
@@ -143,10 +193,10 @@ QVariant AllArtistsModel::data(const QModelIndex &index, int role) const
         result = false;
         break;
     case ColumnsRoles::ContainerDataRole:
-        result = QVariant::fromValue(d->mAllArtists[index.row()]);
+        result = QVariant::fromValue(artist);
         break;
     case ColumnsRoles::ChildModelRole:
-        result = d->mAllArtists[index.row()].name();
+        result = artist.name();
         break;
     case ColumnsRoles::IsTracksContainerRole:
         result = false;
@@ -189,38 +239,173 @@ int AllArtistsModel::columnCount(const QModelIndex &parent) const
     return 1;
 }
 
+bool AllArtistsModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return false;
+    }
+
+    return d->mArtistsWindow.canFetchMore();
+}
+
+void AllArtistsModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+
+    const auto newFetchedCount = d->mArtistsWindow.nextFetchedCount();
+
+    beginInsertRows({}, d->mArtistsWindow.fetchedCount(), newFetchedCount - 1);
+    d->mArtistsWindow.setFetchedCount(newFetchedCount);
+    endInsertRows();
+}
+
+bool AllArtistsModel::isPaged() const
+{
+    return d->mArtistsWindow.isEnabled();
+}
+
+void AllArtistsModel::setPaged(bool paged)
+{
+    if (d->mArtistsWindow.isEnabled() == paged) {
+        return;
+    }
+
+    beginResetModel();
+
+    d->mAllArtists.clear();
+    d->mSearchEntries.clear();
+    d->mSortEntries.clear();
+    d->mArtistRows.clear();
+
+    d->mArtistsWindow.setEnabled(paged);
+    d->mArtistsWindow.reset(0);
+
+    endResetModel();
+}
+
 AllAlbumsModel *AllArtistsModel::allAlbums() const
 {
     return d->mAllAlbumsModel;
 }
 
+const QVector<SearchKeyEntry> &AllArtistsModel::searchEntries() const
+{
+    return d->mSearchEntries;
+}
+
+const std::vector<SortKeyEntry> &AllArtistsModel::sortEntries() const
+{
+    return d->mSortEntries;
+}
+
+SortKeyEntry AllArtistsModel::buildSortEntry(const MusicArtist &artist) const
+{
+    auto result = d->mSortKeyBuilder.sortEntry(artist.name(), artist.name());
+
+    result.mDatabaseId = artist.databaseId();
+
+    return result;
+}
+
 void AllArtistsModel::artistAdded(const MusicArtist &newArtist)
 {
+    if (d->mArtistsWindow.isEnabled()) {
+        if (!newArtist.isValid()) {
+            return;
+        }
+
+        /* a new artist gets the highest id, it is the last row in database order */
+        const auto allRowsFetched = !d->mArtistsWindow.canFetchMore();
+
+        d->mArtistsWindow.append(1);
+
+        /* views only fetch more rows when they reach the end, that already happened */
+        if (allRowsFetched) {
+            beginInsertRows({}, d->mArtistsWindow.fetchedCount(), d->mArtistsWindow.totalCount() - 1);
+            d->mArtistsWindow.setFetchedCount(d->mArtistsWindow.totalCount());
+            endInsertRows();
+        }
+
+        return;
+    }
+
     if (newArtist.isValid()) {
         beginInsertRows({}, d->mAllArtists.size(), d->mAllArtists.size());
+        d->mArtistRows[newArtist.databaseId()] = d->mAllArtists.size();
         d->mAllArtists.push_back(newArtist);
+        auto searchEntry = SearchKeyEntry();
+        searchEntry.mSearchKey = SearchKeyMatcher::searchKey({newArtist.name()});
+        d->mSearchEntries.push_back(searchEntry);
+        d->mSortEntries.push_back(buildSortEntry(newArtist));
         endInsertRows();
     }
 }
 
 void AllArtistsModel::artistRemoved(const MusicArtist &removedArtist)
 {
-    auto removedArtistIterator = std::find(d->mAllArtists.begin(), d->mAllArtists.end(), removedArtist);
+    artistsRemoved({removedArtist});
+}
+
+void AllArtistsModel::artistModified(const MusicArtist &modifiedArtist)
+{
+    Q_UNUSED(modifiedArtist);
+}
+
+void AllArtistsModel::artistsRemoved(const QList<MusicArtist> &removedArtists)
+{
+    if (d->mArtistsWindow.isEnabled()) {
+        if (removedArtists.isEmpty()) {
+            return;
+        }
+
+        /* rows of the removed artists are only known inside the loaded pages, all pages are read again */
+        beginResetModel();
+        d->mArtistsWindow.reset(std::max(0, d->mArtistsWindow.totalCount() - removedArtists.size()));
+        endResetModel();
 
-    if (removedArtistIterator == d->mAllArtists.end()) {
         return;
     }
 
-    int artistIndex = removedArtistIterator - d->mAllArtists.begin();
+    auto removedRows = QVector<int>();
+    removedRows.reserve(removedArtists.size());
 
-    beginRemoveRows({}, artistIndex, artistIndex);
-    d->mAllArtists.erase(removedArtistIterator);
-    endRemoveRows();
-}
+    for (const auto &oneArtist : removedArtists) {
+        auto itArtistRow = d->mArtistRows.find(oneArtist.databaseId());
+        if (itArtistRow == d->mArtistRows.end()) {
+            continue;
+        }
 
-void AllArtistsModel::artistModified(const MusicArtist &modifiedArtist)
-{
-    Q_UNUSED(modifiedArtist);
+        removedRows.push_back(itArtistRow.value());
+        d->mArtistRows.erase(itArtistRow);
+    }
+
+    if (removedRows.isEmpty()) {
+        return;
+    }
+
+    std::sort(removedRows.begin(), removedRows.end());
+
+    auto runEnd = removedRows.size() - 1;
+    while (runEnd >= 0) {
+        auto runStart = runEnd;
+        while (runStart > 0 && removedRows[runStart - 1] == removedRows[runStart] - 1) {
+            --runStart;
+        }
+
+        beginRemoveRows({}, removedRows[runStart], removedRows[runEnd]);
+        d->mAllArtists.erase(d->mAllArtists.begin() + removedRows[runStart], d->mAllArtists.begin() + removedRows[runEnd] + 1);
+        d->mSearchEntries.erase(d->mSearchEntries.begin() + removedRows[runStart], d->mSearchEntries.begin() + removedRows[runEnd] + 1);
+        d->mSortEntries.erase(d->mSortEntries.begin() + removedRows[runStart], d->mSortEntries.begin() + removedRows[runEnd] + 1);
+        endRemoveRows();
+
+        runEnd = runStart - 1;
+    }
+
+    for (int oneRow = removedRows.first(); oneRow < d->mAllArtists.size(); ++oneRow) {
+        d->mArtistRows[d->mAllArtists.at(oneRow).databaseId()] = oneRow;
+    }
 }
 
 void AllArtistsModel::setAllAlbums(AllAlbumsModel *model)
@@ -234,4 +419,67 @@ void AllArtistsModel::setAllAlbums(AllAlbumsModel *model)
     Q_EMIT allAlbumsChanged();
 }
 
+void AllArtistsModel::setIgnoredSortArticles(const QStringList &ignoredArticles)
+{
+    if (d->mSortKeyBuilder.ignoredArticles() == ignoredArticles) {
+        return;
+    }
+
+    Q_EMIT layoutAboutToBeChanged();
+
+    d->mSortKeyBuilder = SortKeyBuilder(ignoredArticles);
+
+    for (int oneRow = 0; oneRow < d->mAllArtists.size(); ++oneRow) {
+        d->mSortEntries[oneRow] = buildSortEntry(d->mAllArtists.at(oneRow));
+    }
+
+    Q_EMIT layoutChanged();
+}
+
+void AllArtistsModel::setArtistsCount(int artistsCount)
+{
+    if (!d->mArtistsWindow.isEnabled()) {
+        return;
+    }
+
+    beginResetModel();
+    d->mArtistsWindow.reset(artistsCount);
+    endResetModel();
+}
+
+void AllArtistsModel::setArtistsPage(int offset, const QList<MusicArtist> &artists)
+{
+    if (!d->mArtistsWindow.storePage(offset, artists)) {
+        return;
+    }
+
+    const auto lastRow = std::min(offset + artists.size(), d->mArtistsWindow.fetchedCount()) - 1;
+
+    if (lastRow >= offset) {
+        Q_EMIT dataChanged(index(offset, 0), index(lastRow, 0));
+    }
+}
+
+void AllArtistsModel::fetchAllArtistsNames()
+{
+    Q_EMIT requestAllArtistsNames();
+}
+
+void AllArtistsModel::setAllArtistsNames(const QStringList &artistsNames)
+{
+    Q_EMIT allArtistsNamesFetched(artistsNames);
+}
+
+void AllArtistsModel::requestPendingPages()
+{
+    const auto pendingPages = d->mArtistsWindow.takePendingPages();
+
+    for (auto onePage : pendingPages) {
+        const auto pageStart = d->mArtistsWindow.pageStart(onePage);
+
+        Q_EMIT requestArtistsPage(onePage * d->mArtistsWindow.pageSize(), d->mArtistsWindow.pageSize(),
+                                  pageStart.mAfterKey, pageStart.mSkippedCount);
+    }
+}
+
 #include "moc_allartistsmodel.cpp"
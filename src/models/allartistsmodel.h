@@ -26,8 +26,11 @@
 #include <QString>
 
 #include "musicartist.h"
+#include "searchkeymatcher.h"
+#include "sortkeybuilder.h"
 
 #include <memory>
+#include <vector>
 
 class DatabaseInterface;
 class AllArtistsModelPrivate;
@@ -77,12 +80,34 @@ public:
 
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
 
+    bool canFetchMore(const QModelIndex &parent) const override;
+
+    void fetchMore(const QModelIndex &parent) override;
+
+    /* only the artists around the rows asked by the views are kept, they are read from the database page by page */
+    bool isPaged() const;
+
+    void setPaged(bool paged);
+
     AllAlbumsModel* allAlbums() const;
 
+    const QVector<SearchKeyEntry> &searchEntries() const;
+
+    const std::vector<SortKeyEntry> &sortEntries() const;
+
+    /* names of all the rows, read from the database when the model is paged; answered by allArtistsNamesFetched */
+    void fetchAllArtistsNames();
+
 Q_SIGNALS:
 
     void allAlbumsChanged();
 
+    void requestArtistsPage(int offset, int count, qulonglong afterId, int skippedCount);
+
+    void requestAllArtistsNames();
+
+    void allArtistsNamesFetched(const QStringList &artistsNames);
+
 public Q_SLOTS:
 
     void artistAdded(const MusicArtist &newArtist);
@@ -91,10 +116,24 @@ public Q_SLOTS:
 
     void artistModified(const MusicArtist &modifiedArtist);
 
+    void artistsRemoved(const QList<MusicArtist> &removedArtists);
+
     void setAllAlbums(AllAlbumsModel *model);
 
+    void setIgnoredSortArticles(const QStringList &ignoredArticles);
+
+    void setArtistsCount(int artistsCount);
+
+    void setArtistsPage(int offset, const QList<MusicArtist> &artists);
+
+    void setAllArtistsNames(const QStringList &artistsNames);
+
 private:
 
+    void requestPendingPages();
+
+    SortKeyEntry buildSortEntry(const MusicArtist &artist) const;
+
     std::unique_ptr<AllArtistsModelPrivate> d;
 
 };
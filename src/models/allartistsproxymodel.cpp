@@ -26,40 +26,83 @@
 
 AllArtistsProxyModel::AllArtistsProxyModel(QObject *parent) : AbstractMediaProxyModel(parent)
 {
+    sort(0);
 }
 
 AllArtistsProxyModel::~AllArtistsProxyModel()
 {
 }
 
+void AllArtistsProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    if (mArtistsModel) {
+        disconnect(mArtistsModel, &AllArtistsModel::allArtistsNamesFetched, this, &AllArtistsProxyModel::enqueueFetchedArtistsNames);
+    }
+
+    mArtistsModel = qobject_cast<AllArtistsModel*>(sourceModel);
+
+    if (mArtistsModel) {
+        connect(mArtistsModel, &AllArtistsModel::allArtistsNamesFetched, this, &AllArtistsProxyModel::enqueueFetchedArtistsNames);
+    }
+
+    AbstractMediaProxyModel::setSourceModel(sourceModel);
+
+    /* a paged source model has no sort key, its rows stay in database order */
+    if (mArtistsModel && mArtistsModel->isPaged()) {
+        sort(-1);
+    }
+}
+
 bool AllArtistsProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
 {
-    bool result = false;
+    if (source_parent.isValid() || !mArtistsModel) {
+        return false;
+    }
 
-    for (int column = 0, columnCount = sourceModel()->columnCount(source_parent); column < columnCount; ++column) {
-        auto currentIndex = sourceModel()->index(source_row, column, source_parent);
+    const auto &searchEntries = mArtistsModel->searchEntries();
 
-        const auto &artistValue = sourceModel()->data(currentIndex, AllArtistsModel::NameRole).toString();
+    /* a paged source model has no search key, all its rows are shown */
+    if (source_row >= searchEntries.size()) {
+        return true;
+    }
 
-        if (mFilterExpression.match(artistValue).hasMatch()) {
-            result = true;
-            continue;
-        }
+    return acceptsSearchEntry(source_row, searchEntries.at(source_row));
+}
 
-        if (result) {
-            continue;
-        }
+bool AllArtistsProxyModel::sourceSearchEntries(QVector<SearchKeyEntry> &searchEntries) const
+{
+    if (!mArtistsModel || mArtistsModel->isPaged()) {
+        return false;
+    }
 
-        if (!result) {
-            break;
-        }
+    searchEntries = mArtistsModel->searchEntries();
+
+    return true;
+}
+
+const std::vector<SortKeyEntry> *AllArtistsProxyModel::sourceSortEntries() const
+{
+    if (!mArtistsModel || mArtistsModel->isPaged()) {
+        return nullptr;
     }
 
-    return result;
+    return &mArtistsModel->sortEntries();
+}
+
+bool AllArtistsProxyModel::filterOnRating() const
+{
+    return false;
 }
 
 void AllArtistsProxyModel::enqueueToPlayList()
 {
+    /* the rows of a paged source model are not all loaded, their names are read from the database */
+    if (mArtistsModel && mArtistsModel->isPaged()) {
+        mPendingEnqueues.push_back({ElisaUtils::AppendPlayList, ElisaUtils::DoNotTriggerPlay});
+        mArtistsModel->fetchAllArtistsNames();
+        return;
+    }
+
     QtConcurrent::run(&mThreadPool, [=] () {
         QReadLocker locker(&mDataLock);
         auto allArtists = QStringList();
@@ -76,6 +119,12 @@ void AllArtistsProxyModel::enqueueToPlayList()
 
 void AllArtistsProxyModel::replaceAndPlayOfPlayList()
 {
+    if (mArtistsModel && mArtistsModel->isPaged()) {
+        mPendingEnqueues.push_back({ElisaUtils::ReplacePlayList, ElisaUtils::TriggerPlay});
+        mArtistsModel->fetchAllArtistsNames();
+        return;
+    }
+
     QtConcurrent::run(&mThreadPool, [=] () {
         QReadLocker locker(&mDataLock);
         auto allArtists = QStringList();
@@ -90,5 +139,16 @@ void AllArtistsProxyModel::replaceAndPlayOfPlayList()
     });
 }
 
+void AllArtistsProxyModel::enqueueFetchedArtistsNames(const QStringList &artistsNames)
+{
+    if (mPendingEnqueues.isEmpty()) {
+        return;
+    }
+
+    const auto pendingEnqueue = mPendingEnqueues.takeFirst();
+
+    Q_EMIT artistToEnqueue(artistsNames, pendingEnqueue.first, pendingEnqueue.second);
+}
+
 
 #include "moc_allartistsproxymodel.cpp"
@@ -24,6 +24,8 @@
 #include "abstractmediaproxymodel.h"
 #include "elisautils.h"
 
+class AllArtistsModel;
+
 class AllArtistsProxyModel : public AbstractMediaProxyModel
 {
     Q_OBJECT
@@ -34,6 +36,8 @@ public:
 
     ~AllArtistsProxyModel() override;
 
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
 Q_SIGNALS:
 
     void artistToEnqueue(QList<QString> artistNames,
@@ -50,6 +54,18 @@ protected:
 
     bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const override;
 
+    bool sourceSearchEntries(QVector<SearchKeyEntry> &searchEntries) const override;
+
+    const std::vector<SortKeyEntry> *sourceSortEntries() const override;
+
+    bool filterOnRating() const override;
+
+private:
+
+    void enqueueFetchedArtistsNames(const QStringList &artistsNames);
+
+    AllArtistsModel *mArtistsModel = nullptr;
+
 };
 
 
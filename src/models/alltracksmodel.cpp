@@ -19,22 +19,99 @@
 
 #include "alltracksmodel.h"
 
+#include "displaytextformatter.h"
+#include "pagedmodelwindow.h"
+
 #include <algorithm>
 
 #include <QDebug>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QThread>
+
+/* text of one row that views ask for again and again while scrolling, formatted when the row is stored */
+struct AllTracksModelDisplayData
+{
+
+    QString mDuration;
+
+    QString mSecondaryText;
+
+};
+
+Q_DECLARE_TYPEINFO(AllTracksModelDisplayData, Q_MOVABLE_TYPE);
 
 class AllTracksModelPrivate
 {
 public:
 
-    QHash<qulonglong, MusicAudioTrack> mAllTracks;
+    static AllTracksModelDisplayData buildDisplayData(const MusicAudioTrack &track)
+    {
+        auto result = AllTracksModelDisplayData();
+
+        result.mDuration = DisplayTextFormatter::durationText(track.duration());
+        result.mSecondaryText = DisplayTextFormatter::trackSecondaryText(track);
+
+        return result;
+    }
+
+    AllTracksModelDisplayData displayData(int row, const MusicAudioTrack &track) const
+    {
+        /* paged rows come and go with their page, their text is formatted on each request */
+        if (mTracksWindow.isEnabled()) {
+            return buildDisplayData(track);
+        }
+
+        return mDisplayData.at(row);
+    }
+
+    /* nullptr for a row of a page not loaded yet, the page is then requested */
+    const MusicAudioTrack *rowTrack(const QObject *model, int row)
+    {
+        if (!mTracksWindow.isEnabled()) {
+            return &mAllTracks.at(row);
+        }
+
+        /* views reading the model from other threads, like the ones enqueueing all rows, only see the loaded pages */
+        if (QThread::currentThread() == model->thread() && mTracksWindow.touch(row)) {
+            mPageRequestTimer.start();
+        }
+
+        return mTracksWindow.item(row);
+    }
+
+    /* rows of the model, in display order; new batches are only appended */
+    QVector<MusicAudioTrack> mAllTracks;
+
+    /* folded title and artist plus rating of each row, used by the proxy models to filter without going through data() */
+    QVector<SearchKeyEntry> mSearchEntries;
+
+    /* collation keys of title and artist plus the numeric fields of each row, used by the proxy models to sort */
+    std::vector<SortKeyEntry> mSortEntries;
+
+    /* formatted text of each row, built with the row so that data() only reads it */
+    QVector<AllTracksModelDisplayData> mDisplayData;
 
-    QList<qulonglong> mIds;
+    SortKeyBuilder mSortKeyBuilder;
+
+    /* database id of a track to its row in mAllTracks */
+    QHash<qulonglong, int> mTrackRows;
+
+    /* tracks of the loaded pages when the model is paged, the vectors above then stay empty */
+    PagedModelWindow<MusicAudioTrack> mTracksWindow;
+
+    /* pages missing during one layout of the views are requested together */
+    QTimer mPageRequestTimer;
 
 };
 
 AllTracksModel::AllTracksModel(QObject *parent) : QAbstractItemModel(parent), d(std::make_unique<AllTracksModelPrivate>())
 {
+    d->mPageRequestTimer.setSingleShot(true);
+    d->mPageRequestTimer.setInterval(0);
+    connect(&d->mPageRequestTimer, &QTimer::timeout, this, &AllTracksModel::requestPendingPages);
 }
 
 AllTracksModel::~AllTracksModel()
@@ -48,7 +125,11 @@ int AllTracksModel::rowCount(const QModelIndex &parent) const
         return tracksCount;
     }
 
-    tracksCount = d->mAllTracks.size();
+    if (d->mTracksWindow.isEnabled()) {
+        tracksCount = d->mTracksWindow.fetchedCount();
+    } else {
+        tracksCount = d->mAllTracks.size();
+    }
 
     return tracksCount;
 }
@@ -98,7 +179,7 @@ QVariant AllTracksModel::data(const QModelIndex &index, int role) const
 {
     auto result = QVariant();
 
-    const auto tracksCount = d->mAllTracks.size();
+    const auto tracksCount = rowCount();
 
     if (!index.isValid()) {
         return result;
@@ -124,120 +205,102 @@ QVariant AllTracksModel::data(const QModelIndex &index, int role) const
         return result;
     }
 
-    const auto &track = d->mAllTracks[d->mIds[index.row()]];
+    const auto *rowTrack = d->rowTrack(this, index.row());
+
+    if (!rowTrack) {
+        return result;
+    }
+
+    const auto &track = *rowTrack;
 
     switch(role)
     {
     case ColumnsRoles::TitleRole:
-        if (d->mAllTracks[d->mIds[index.row()]].title().isEmpty()) {
+        if (track.title().isEmpty()) {
             result = {};
         }
-        result = d->mAllTracks[d->mIds[index.row()]].title();
+        result = track.title();
         break;
     case ColumnsRoles::MilliSecondsDurationRole:
-        result = d->mAllTracks[d->mIds[index.row()]].duration().msecsSinceStartOfDay();
+        result = track.duration().msecsSinceStartOfDay();
         break;
     case ColumnsRoles::DurationRole:
-    {
-        QTime trackDuration = d->mAllTracks[d->mIds[index.row()]].duration();
-        if (trackDuration.hour() == 0) {
-            result = trackDuration.toString(QStringLiteral("mm:ss"));
-        } else {
-            result = trackDuration.toString();
-        }
+        result = d->displayData(index.row(), track).mDuration;
         break;
-    }
     case ColumnsRoles::ArtistRole:
-        result = d->mAllTracks[d->mIds[index.row()]].artist();
+        result = track.artist();
         break;
     case ColumnsRoles::AlbumRole:
-        result = d->mAllTracks[d->mIds[index.row()]].albumName();
+        result = track.albumName();
         break;
     case ColumnsRoles::AlbumArtistRole:
-        result = d->mAllTracks[d->mIds[index.row()]].albumArtist();
+        result = track.albumArtist();
         break;
     case ColumnsRoles::TrackNumberRole:
-        result = d->mAllTracks[d->mIds[index.row()]].trackNumber();
+        result = track.trackNumber();
         break;
     case ColumnsRoles::DiscNumberRole:
-        result = d->mAllTracks[d->mIds[index.row()]].discNumber();
+        result = track.discNumber();
         break;
     case ColumnsRoles::IsSingleDiscAlbumRole:
-        result = d->mAllTracks[d->mIds[index.row()]].isSingleDiscAlbum();
+        result = track.isSingleDiscAlbum();
         break;
     case ColumnsRoles::RatingRole:
-        result = d->mAllTracks[d->mIds[index.row()]].rating();
+        result = track.rating();
         break;
     case ColumnsRoles::GenreRole:
-        result = d->mAllTracks[d->mIds[index.row()]].genre();
+        result = track.genre();
         break;
     case ColumnsRoles::LyricistRole:
-        result = d->mAllTracks[d->mIds[index.row()]].lyricist();
+        result = track.lyricist();
         break;
     case ColumnsRoles::ComposerRole:
-        result = d->mAllTracks[d->mIds[index.row()]].composer();
+        result = track.composer();
         break;
     case ColumnsRoles::CommentRole:
-        result = d->mAllTracks[d->mIds[index.row()]].comment();
+        result = track.comment();
         break;
     case ColumnsRoles::YearRole:
-        result = d->mAllTracks[d->mIds[index.row()]].year();
+        result = track.year();
         break;
     case ColumnsRoles::ChannelsRole:
-        result = d->mAllTracks[d->mIds[index.row()]].channels();
+        result = track.channels();
         break;
     case ColumnsRoles::BitRateRole:
-        result = d->mAllTracks[d->mIds[index.row()]].bitRate();
+        result = track.bitRate();
         break;
     case ColumnsRoles::SampleRateRole:
-        result = d->mAllTracks[d->mIds[index.row()]].sampleRate();
+        result = track.sampleRate();
         break;
     case ColumnsRoles::ImageRole:
     {
-        const auto &imageUrl = d->mAllTracks[d->mIds[index.row()]].albumCover();
+        const auto &imageUrl = track.albumCover();
         if (imageUrl.isValid()) {
             result = imageUrl;
         }
         break;
     }
     case ColumnsRoles::ResourceRole:
-        result = d->mAllTracks[d->mIds[index.row()]].resourceURI();
+        result = track.resourceURI();
         break;
     case ColumnsRoles::IdRole:
-        result = d->mAllTracks[d->mIds[index.row()]].title();
+        result = track.title();
         break;
     case ColumnsRoles::DatabaseIdRole:
-        result = d->mAllTracks[d->mIds[index.row()]].databaseId();
+        result = track.databaseId();
         break;
     case ColumnsRoles::ContainerDataRole:
-        result = QVariant::fromValue(d->mAllTracks[d->mIds[index.row()]]);
+        result = QVariant::fromValue(track);
         break;
     case Qt::DisplayRole:
         result = track.title();
         break;
     case ColumnsRoles::SecondaryTextRole:
-    {
-        auto secondaryText = QString();
-        secondaryText = QStringLiteral("<b>%1 - %2</b>%3");
-
-        secondaryText = secondaryText.arg(track.trackNumber());
-        secondaryText = secondaryText.arg(track.title());
-
-        if (track.artist() == track.albumArtist()) {
-            secondaryText = secondaryText.arg(QString());
-        } else {
-            auto artistText = QString();
-            artistText = QStringLiteral(" - <i>%1</i>");
-            artistText = artistText.arg(track.artist());
-            secondaryText = secondaryText.arg(artistText);
-        }
-
-        result = secondaryText;
+        result = d->displayData(index.row(), track).mSecondaryText;
         break;
-    }
     case ColumnsRoles::ImageUrlRole:
     {
-        const auto &imageUrl = d->mAllTracks[d->mIds[index.row()]].albumCover();
+        const auto &imageUrl = track.albumCover();
         if (imageUrl.isValid()) {
             result = imageUrl;
         } else {
@@ -246,7 +309,7 @@ QVariant AllTracksModel::data(const QModelIndex &index, int role) const
         break;
     }
     case ColumnsRoles::ShadowForImageRole:
-        result = d->mAllTracks[d->mIds[index.row()]].albumCover().isValid();
+        result = track.albumCover().isValid();
         break;
     }
 
@@ -265,7 +328,7 @@ QModelIndex AllTracksModel::index(int row, int column, const QModelIndex &parent
         return result;
     }
 
-    if (row > d->mAllTracks.size() - 1) {
+    if (row > rowCount() - 1) {
         return result;
     }
 
@@ -290,63 +353,335 @@ int AllTracksModel::columnCount(const QModelIndex &parent) const
     return 1;
 }
 
+bool AllTracksModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return false;
+    }
+
+    return d->mTracksWindow.canFetchMore();
+}
+
+void AllTracksModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+
+    const auto newFetchedCount = d->mTracksWindow.nextFetchedCount();
+
+    beginInsertRows({}, d->mTracksWindow.fetchedCount(), newFetchedCount - 1);
+    d->mTracksWindow.setFetchedCount(newFetchedCount);
+    endInsertRows();
+}
+
+bool AllTracksModel::isPaged() const
+{
+    return d->mTracksWindow.isEnabled();
+}
+
+void AllTracksModel::setPaged(bool paged)
+{
+    if (d->mTracksWindow.isEnabled() == paged) {
+        return;
+    }
+
+    beginResetModel();
+
+    d->mAllTracks.clear();
+    d->mSearchEntries.clear();
+    d->mSortEntries.clear();
+    d->mDisplayData.clear();
+    d->mTrackRows.clear();
+
+    d->mTracksWindow.setEnabled(paged);
+    d->mTracksWindow.reset(0);
+
+    endResetModel();
+}
+
+const QVector<SearchKeyEntry> &AllTracksModel::searchEntries() const
+{
+    return d->mSearchEntries;
+}
+
+const std::vector<SortKeyEntry> &AllTracksModel::sortEntries() const
+{
+    return d->mSortEntries;
+}
+
+SearchKeyEntry AllTracksModel::buildSearchEntry(const MusicAudioTrack &track)
+{
+    auto result = SearchKeyEntry();
+
+    result.mSearchKey = SearchKeyMatcher::searchKey({track.title(), track.artist()});
+    result.mRating = track.rating();
+
+    return result;
+}
+
+SortKeyEntry AllTracksModel::buildSortEntry(const MusicAudioTrack &track) const
+{
+    auto result = d->mSortKeyBuilder.sortEntry(track.title(), track.artist());
+
+    result.mYear = track.year();
+    result.mDuration = track.duration().msecsSinceStartOfDay();
+    result.mDatabaseId = track.databaseId();
+
+    return result;
+}
+
 void AllTracksModel::tracksAdded(const QList<MusicAudioTrack> &allTracks)
 {
-    auto newAllTracks = d->mAllTracks;
-    auto newTracksIds = QList<qulonglong>();
+    if (d->mTracksWindow.isEnabled()) {
+        if (allTracks.isEmpty()) {
+            return;
+        }
+
+        /* new tracks get the highest ids, they are the last rows in database order */
+        const auto allRowsFetched = !d->mTracksWindow.canFetchMore();
+
+        d->mTracksWindow.append(allTracks.size());
+
+        /* views only fetch more rows when they reach the end, that already happened */
+        if (allRowsFetched) {
+            beginInsertRows({}, d->mTracksWindow.fetchedCount(), d->mTracksWindow.totalCount() - 1);
+            d->mTracksWindow.setFetchedCount(d->mTracksWindow.totalCount());
+            endInsertRows();
+        }
+
+        return;
+    }
+
+    auto newTracks = QVector<const MusicAudioTrack*>();
+    newTracks.reserve(allTracks.size());
 
-    int countNewTracks = 0;
+    auto newTracksIds = QSet<qulonglong>();
 
     for (const auto &oneTrack : allTracks) {
-        if (newAllTracks.find(oneTrack.databaseId()) == newAllTracks.end()) {
-            newAllTracks[oneTrack.databaseId()] = oneTrack;
-            newTracksIds.push_back(oneTrack.databaseId());
-            ++countNewTracks;
+        if (d->mTrackRows.contains(oneTrack.databaseId()) || newTracksIds.contains(oneTrack.databaseId())) {
+            continue;
         }
+
+        newTracksIds.insert(oneTrack.databaseId());
+        newTracks.push_back(&oneTrack);
+    }
+
+    if (newTracks.isEmpty()) {
+        return;
     }
 
-    if (countNewTracks > 0) {
-        beginInsertRows({}, d->mAllTracks.size(), d->mAllTracks.size() + countNewTracks - 1);
+    const auto firstNewRow = d->mAllTracks.size();
 
-        d->mAllTracks = newAllTracks;
-        d->mIds.append(newTracksIds);
+    beginInsertRows({}, firstNewRow, firstNewRow + newTracks.size() - 1);
 
-        endInsertRows();
+    d->mAllTracks.reserve(firstNewRow + newTracks.size());
+    d->mSearchEntries.reserve(firstNewRow + newTracks.size());
+    d->mSortEntries.reserve(firstNewRow + newTracks.size());
+    d->mDisplayData.reserve(firstNewRow + newTracks.size());
+    d->mTrackRows.reserve(firstNewRow + newTracks.size());
+
+    for (const auto *oneTrack : newTracks) {
+        d->mTrackRows[oneTrack->databaseId()] = d->mAllTracks.size();
+        d->mAllTracks.push_back(*oneTrack);
+        d->mSearchEntries.push_back(buildSearchEntry(*oneTrack));
+        d->mSortEntries.push_back(buildSortEntry(*oneTrack));
+        d->mDisplayData.push_back(AllTracksModelPrivate::buildDisplayData(*oneTrack));
     }
+
+    endInsertRows();
 }
 
 void AllTracksModel::trackRemoved(qulonglong removedTrackId)
 {
-    auto itTrack = std::find(d->mIds.begin(), d->mIds.end(), removedTrackId);
-    if (itTrack == d->mIds.end()) {
+    tracksRemoved({removedTrackId});
+}
+
+void AllTracksModel::trackModified(const MusicAudioTrack &modifiedTrack)
+{
+    tracksModified({modifiedTrack});
+}
+
+void AllTracksModel::tracksRemoved(const QList<qulonglong> &removedTracksIds)
+{
+    if (d->mTracksWindow.isEnabled()) {
+        if (removedTracksIds.isEmpty()) {
+            return;
+        }
+
+        /* rows of the removed tracks are only known inside the loaded pages, all pages are read again */
+        beginResetModel();
+        d->mTracksWindow.reset(std::max(0, d->mTracksWindow.totalCount() - removedTracksIds.size()));
+        endResetModel();
+
+        return;
+    }
+
+    auto removedRows = QVector<int>();
+    removedRows.reserve(removedTracksIds.size());
+
+    for (auto oneTrackId : removedTracksIds) {
+        auto itTrackRow = d->mTrackRows.find(oneTrackId);
+        if (itTrackRow == d->mTrackRows.end()) {
+            continue;
+        }
+
+        removedRows.push_back(itTrackRow.value());
+        d->mTrackRows.erase(itTrackRow);
+    }
+
+    if (removedRows.isEmpty()) {
+        return;
+    }
+
+    std::sort(removedRows.begin(), removedRows.end());
+
+    /* remove contiguous runs of rows from the last one so that the rows of the pending runs stay valid */
+    auto runEnd = removedRows.size() - 1;
+    while (runEnd >= 0) {
+        auto runStart = runEnd;
+        while (runStart > 0 && removedRows[runStart - 1] == removedRows[runStart] - 1) {
+            --runStart;
+        }
+
+        const auto firstRow = removedRows[runStart];
+        const auto lastRow = removedRows[runEnd];
+
+        beginRemoveRows({}, firstRow, lastRow);
+        d->mAllTracks.erase(d->mAllTracks.begin() + firstRow, d->mAllTracks.begin() + lastRow + 1);
+        d->mSearchEntries.erase(d->mSearchEntries.begin() + firstRow, d->mSearchEntries.begin() + lastRow + 1);
+        d->mSortEntries.erase(d->mSortEntries.begin() + firstRow, d->mSortEntries.begin() + lastRow + 1);
+        d->mDisplayData.erase(d->mDisplayData.begin() + firstRow, d->mDisplayData.begin() + lastRow + 1);
+        endRemoveRows();
+
+        runEnd = runStart - 1;
+    }
+
+    for (int oneRow = removedRows.first(); oneRow < d->mAllTracks.size(); ++oneRow) {
+        d->mTrackRows[d->mAllTracks.at(oneRow).databaseId()] = oneRow;
+    }
+}
+
+void AllTracksModel::tracksModified(const QList<MusicAudioTrack> &modifiedTracks)
+{
+    auto modifiedRows = QVector<int>();
+    modifiedRows.reserve(modifiedTracks.size());
+
+    if (d->mTracksWindow.isEnabled()) {
+        auto modifiedTracksById = QHash<qulonglong, const MusicAudioTrack*>();
+        modifiedTracksById.reserve(modifiedTracks.size());
+
+        for (const auto &oneTrack : modifiedTracks) {
+            modifiedTracksById[oneTrack.databaseId()] = &oneTrack;
+        }
+
+        /* tracks outside of the loaded pages are read again with their page */
+        d->mTracksWindow.forEachLoadedItem([&modifiedTracksById, &modifiedRows] (int row, MusicAudioTrack &loadedTrack) {
+            auto itModifiedTrack = modifiedTracksById.constFind(loadedTrack.databaseId());
+            if (itModifiedTrack == modifiedTracksById.constEnd()) {
+                return;
+            }
+
+            loadedTrack = *itModifiedTrack.value();
+            modifiedRows.push_back(row);
+        });
+    } else {
+        for (const auto &oneTrack : modifiedTracks) {
+            auto itTrackRow = d->mTrackRows.constFind(oneTrack.databaseId());
+            if (itTrackRow == d->mTrackRows.constEnd()) {
+                continue;
+            }
+
+            d->mAllTracks[itTrackRow.value()] = oneTrack;
+            d->mSearchEntries[itTrackRow.value()] = buildSearchEntry(oneTrack);
+            d->mSortEntries[itTrackRow.value()] = buildSortEntry(oneTrack);
+            d->mDisplayData[itTrackRow.value()] = AllTracksModelPrivate::buildDisplayData(oneTrack);
+            modifiedRows.push_back(itTrackRow.value());
+        }
+    }
+
+    if (modifiedRows.isEmpty()) {
         return;
     }
 
-    auto position = itTrack - d->mIds.begin();
+    std::sort(modifiedRows.begin(), modifiedRows.end());
+    modifiedRows.erase(std::unique(modifiedRows.begin(), modifiedRows.end()), modifiedRows.end());
+
+    auto runStart = 0;
+    while (runStart < modifiedRows.size()) {
+        auto runEnd = runStart;
+        while (runEnd + 1 < modifiedRows.size() && modifiedRows[runEnd + 1] == modifiedRows[runEnd] + 1) {
+            ++runEnd;
+        }
+
+        Q_EMIT dataChanged(index(modifiedRows[runStart], 0), index(modifiedRows[runEnd], 0));
 
-    beginRemoveRows({}, position, position);
-    d->mIds.erase(itTrack);
-    d->mAllTracks.remove(removedTrackId);
-    endRemoveRows();
+        runStart = runEnd + 1;
+    }
 }
 
-void AllTracksModel::trackModified(const MusicAudioTrack &modifiedTrack)
+void AllTracksModel::setIgnoredSortArticles(const QStringList &ignoredArticles)
+{
+    if (d->mSortKeyBuilder.ignoredArticles() == ignoredArticles) {
+        return;
+    }
+
+    /* rows do not move but every proxy model has to sort them again */
+    Q_EMIT layoutAboutToBeChanged();
+
+    d->mSortKeyBuilder = SortKeyBuilder(ignoredArticles);
+
+    for (int oneRow = 0; oneRow < d->mAllTracks.size(); ++oneRow) {
+        d->mSortEntries[oneRow] = buildSortEntry(d->mAllTracks.at(oneRow));
+    }
+
+    Q_EMIT layoutChanged();
+}
+
+void AllTracksModel::setTracksCount(int tracksCount)
 {
-    auto trackExists = (d->mAllTracks.find(modifiedTrack.databaseId()) != d->mAllTracks.end());
-    if (!trackExists) {
+    if (!d->mTracksWindow.isEnabled()) {
         return;
     }
 
-    auto itTrack = std::find(d->mIds.begin(), d->mIds.end(), modifiedTrack.databaseId());
-    if (itTrack == d->mIds.end()) {
+    beginResetModel();
+    d->mTracksWindow.reset(tracksCount);
+    endResetModel();
+}
+
+void AllTracksModel::setTracksPage(int offset, const QList<MusicAudioTrack> &tracks)
+{
+    if (!d->mTracksWindow.storePage(offset, tracks)) {
         return;
     }
 
-    auto position = itTrack - d->mIds.begin();
+    const auto lastRow = std::min(offset + tracks.size(), d->mTracksWindow.fetchedCount()) - 1;
+
+    if (lastRow >= offset) {
+        Q_EMIT dataChanged(index(offset, 0), index(lastRow, 0));
+    }
+}
+
+void AllTracksModel::fetchAllTracksIds()
+{
+    Q_EMIT requestAllTracksIds();
+}
 
-    d->mAllTracks[modifiedTrack.databaseId()] = modifiedTrack;
-    Q_EMIT dataChanged(index(position, 0), index(position, 0));
+void AllTracksModel::setAllTracksIds(const QList<qulonglong> &tracksIds)
+{
+    Q_EMIT allTracksIdsFetched(tracksIds);
 }
 
+void AllTracksModel::requestPendingPages()
+{
+    const auto pendingPages = d->mTracksWindow.takePendingPages();
+
+    for (auto onePage : pendingPages) {
+        const auto pageStart = d->mTracksWindow.pageStart(onePage);
+
+        Q_EMIT requestTracksPage(onePage * d->mTracksWindow.pageSize(), d->mTracksWindow.pageSize(),
+                                 pageStart.mAfterKey, pageStart.mSkippedCount);
+    }
+}
 
 #include "moc_alltracksmodel.cpp"
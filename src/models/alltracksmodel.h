@@ -23,8 +23,11 @@
 #include <QAbstractItemModel>
 
 #include "musicaudiotrack.h"
+#include "searchkeymatcher.h"
+#include "sortkeybuilder.h"
 
 #include <memory>
+#include <vector>
 
 class AllTracksModelPrivate;
 
@@ -83,6 +86,22 @@ public:
 
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
 
+    bool canFetchMore(const QModelIndex &parent) const override;
+
+    void fetchMore(const QModelIndex &parent) override;
+
+    /* only the tracks around the rows asked by the views are kept, they are read from the database page by page */
+    bool isPaged() const;
+
+    void setPaged(bool paged);
+
+    const QVector<SearchKeyEntry> &searchEntries() const;
+
+    const std::vector<SortKeyEntry> &sortEntries() const;
+
+    /* ids of all the rows, read from the database when the model is paged; answered by allTracksIdsFetched */
+    void fetchAllTracksIds();
+
 public Q_SLOTS:
 
     void tracksAdded(const QList<MusicAudioTrack> &allTracks);
@@ -91,8 +110,34 @@ public Q_SLOTS:
 
     void trackModified(const MusicAudioTrack &modifiedTrack);
 
+    void tracksRemoved(const QList<qulonglong> &removedTracksIds);
+
+    void tracksModified(const QList<MusicAudioTrack> &modifiedTracks);
+
+    void setIgnoredSortArticles(const QStringList &ignoredArticles);
+
+    void setTracksCount(int tracksCount);
+
+    void setTracksPage(int offset, const QList<MusicAudioTrack> &tracks);
+
+    void setAllTracksIds(const QList<qulonglong> &tracksIds);
+
+Q_SIGNALS:
+
+    void requestTracksPage(int offset, int count, qulonglong afterId, int skippedCount);
+
+    void requestAllTracksIds();
+
+    void allTracksIdsFetched(const QList<qulonglong> &tracksIds);
+
 private:
 
+    void requestPendingPages();
+
+    static SearchKeyEntry buildSearchEntry(const MusicAudioTrack &track);
+
+    SortKeyEntry buildSortEntry(const MusicAudioTrack &track) const;
+
     std::unique_ptr<AllTracksModelPrivate> d;
 
 };
@@ -26,52 +26,78 @@
 
 AllTracksProxyModel::AllTracksProxyModel(QObject *parent) : AbstractMediaProxyModel(parent)
 {
+    sort(0);
 }
 
 AllTracksProxyModel::~AllTracksProxyModel()
 {
 }
 
+void AllTracksProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    if (mTracksModel) {
+        disconnect(mTracksModel, &AllTracksModel::allTracksIdsFetched, this, &AllTracksProxyModel::enqueueFetchedTracksIds);
+    }
+
+    mTracksModel = qobject_cast<AllTracksModel*>(sourceModel);
+
+    if (mTracksModel) {
+        connect(mTracksModel, &AllTracksModel::allTracksIdsFetched, this, &AllTracksProxyModel::enqueueFetchedTracksIds);
+    }
+
+    AbstractMediaProxyModel::setSourceModel(sourceModel);
+
+    /* a paged source model has no sort key, its rows stay in database order */
+    if (mTracksModel && mTracksModel->isPaged()) {
+        sort(-1);
+    }
+}
+
 bool AllTracksProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
 {
-    bool result = false;
+    if (source_parent.isValid() || !mTracksModel) {
+        return false;
+    }
 
-    for (int column = 0, columnCount = sourceModel()->columnCount(source_parent); column < columnCount; ++column) {
-        auto currentIndex = sourceModel()->index(source_row, column, source_parent);
+    const auto &searchEntries = mTracksModel->searchEntries();
 
-        const auto &titleValue = sourceModel()->data(currentIndex, AllTracksModel::TitleRole).toString();
-        const auto &artistValue = sourceModel()->data(currentIndex, AllTracksModel::ArtistRole).toString();
-        const auto maximumRatingValue = sourceModel()->data(currentIndex, AllTracksModel::RatingRole).toInt();
+    /* a paged source model has no search key, all its rows are shown */
+    if (source_row >= searchEntries.size()) {
+        return true;
+    }
 
-        if (maximumRatingValue < mFilterRating) {
-            result = false;
-            continue;
-        }
+    return acceptsSearchEntry(source_row, searchEntries.at(source_row));
+}
 
-        if (mFilterExpression.match(titleValue).hasMatch()) {
-            result = true;
-            continue;
-        }
+bool AllTracksProxyModel::sourceSearchEntries(QVector<SearchKeyEntry> &searchEntries) const
+{
+    if (!mTracksModel || mTracksModel->isPaged()) {
+        return false;
+    }
 
-        if (mFilterExpression.match(artistValue).hasMatch()) {
-            result = true;
-            continue;
-        }
+    searchEntries = mTracksModel->searchEntries();
 
-        if (result) {
-            continue;
-        }
+    return true;
+}
 
-        if (!result) {
-            break;
-        }
+const std::vector<SortKeyEntry> *AllTracksProxyModel::sourceSortEntries() const
+{
+    if (!mTracksModel || mTracksModel->isPaged()) {
+        return nullptr;
     }
 
-    return result;
+    return &mTracksModel->sortEntries();
 }
 
 void AllTracksProxyModel::enqueueToPlayList()
 {
+    /* the rows of a paged source model are not all loaded, their tracks are read from the database */
+    if (mTracksModel && mTracksModel->isPaged()) {
+        mPendingEnqueues.push_back({ElisaUtils::AppendPlayList, ElisaUtils::DoNotTriggerPlay});
+        mTracksModel->fetchAllTracksIds();
+        return;
+    }
+
     QtConcurrent::run(&mThreadPool, [=] () {
         QReadLocker locker(&mDataLock);
         auto allTracks = QList<MusicAudioTrack>();
@@ -88,6 +114,12 @@ void AllTracksProxyModel::enqueueToPlayList()
 
 void AllTracksProxyModel::replaceAndPlayOfPlayList()
 {
+    if (mTracksModel && mTracksModel->isPaged()) {
+        mPendingEnqueues.push_back({ElisaUtils::ReplacePlayList, ElisaUtils::TriggerPlay});
+        mTracksModel->fetchAllTracksIds();
+        return;
+    }
+
     QtConcurrent::run(&mThreadPool, [=] () {
         QReadLocker locker(&mDataLock);
         auto allTracks = QList<MusicAudioTrack>();
@@ -102,5 +134,16 @@ void AllTracksProxyModel::replaceAndPlayOfPlayList()
     });
 }
 
+void AllTracksProxyModel::enqueueFetchedTracksIds(const QList<qulonglong> &tracksIds)
+{
+    if (mPendingEnqueues.isEmpty()) {
+        return;
+    }
+
+    const auto pendingEnqueue = mPendingEnqueues.takeFirst();
+
+    Q_EMIT trackIdsToEnqueue(tracksIds, pendingEnqueue.first, pendingEnqueue.second);
+}
+
 
 #include "moc_alltracksproxymodel.cpp"
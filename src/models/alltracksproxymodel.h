@@ -25,6 +25,8 @@
 #include "musicaudiotrack.h"
 #include "elisautils.h"
 
+class AllTracksModel;
+
 class AllTracksProxyModel : public AbstractMediaProxyModel
 {
     Q_OBJECT
@@ -35,12 +37,18 @@ public:
 
     ~AllTracksProxyModel() override;
 
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
 Q_SIGNALS:
 
     void trackToEnqueue(QList<MusicAudioTrack> newTracks,
                         ElisaUtils::PlayListEnqueueMode enqueueMode,
                         ElisaUtils::PlayListEnqueueTriggerPlay triggerPlay);
 
+    void trackIdsToEnqueue(QList<qulonglong> newTrackIds,
+                           ElisaUtils::PlayListEnqueueMode enqueueMode,
+                           ElisaUtils::PlayListEnqueueTriggerPlay triggerPlay);
+
 public Q_SLOTS:
 
     void enqueueToPlayList();
@@ -51,6 +59,16 @@ protected:
 
     bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const override;
 
+    bool sourceSearchEntries(QVector<SearchKeyEntry> &searchEntries) const override;
+
+    const std::vector<SortKeyEntry> *sourceSortEntries() const override;
+
+private:
+
+    void enqueueFetchedTracksIds(const QList<qulonglong> &tracksIds);
+
+    AllTracksModel *mTracksModel = nullptr;
+
 };
 
 #endif // ALLTRACKSPROXYMODEL_H
@@ -0,0 +1,291 @@
+/*
+ * Copyright 2018 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef PAGEDMODELWINDOW_H
+#define PAGEDMODELWINDOW_H
+
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+
+#include <algorithm>
+#include <limits>
+
+/*
+ * rows of a model read from the database one page at a time: views see the
+ * rows already fetched, only the pages around the rows they ask for are kept
+ * in memory; rows are sorted on the databaseId() of their items
+ */
+template <typename Item>
+class PagedModelWindow
+{
+
+public:
+
+    /* a page is read from the rows after mAfterKey, once mSkippedCount rows have been passed */
+    struct PageStart
+    {
+
+        qulonglong mAfterKey = 0;
+
+        int mSkippedCount = 0;
+
+    };
+
+    explicit PagedModelWindow(int pageSize = 200, int maximumLoadedPages = 10)
+        : mPageSize(pageSize), mMaximumLoadedPages(maximumLoadedPages)
+    {
+    }
+
+    bool isEnabled() const
+    {
+        return mEnabled;
+    }
+
+    void setEnabled(bool enabled)
+    {
+        mEnabled = enabled;
+    }
+
+    int pageSize() const
+    {
+        return mPageSize;
+    }
+
+    int totalCount() const
+    {
+        return mTotalCount;
+    }
+
+    int fetchedCount() const
+    {
+        return mFetchedCount;
+    }
+
+    void setFetchedCount(int fetchedCount)
+    {
+        mFetchedCount = std::min(fetchedCount, mTotalCount);
+    }
+
+    bool canFetchMore() const
+    {
+        return mEnabled && mFetchedCount < mTotalCount;
+    }
+
+    /* rows shown once one more page has been fetched */
+    int nextFetchedCount() const
+    {
+        return std::min(mTotalCount, mFetchedCount + mPageSize);
+    }
+
+    int loadedPagesCount() const
+    {
+        return mPages.size();
+    }
+
+    /* forgets every page, rows are numbered again from the first one */
+    void reset(int totalCount)
+    {
+        mTotalCount = totalCount;
+        mFetchedCount = std::min(mFetchedCount, mTotalCount);
+        mPages.clear();
+        mRequestedPages.clear();
+        mPendingPages.clear();
+        mPageLastKeys.clear();
+    }
+
+    /* rows added after the last one */
+    void append(int count)
+    {
+        mTotalCount += count;
+    }
+
+    /* nullptr until the page of this row is loaded */
+    const Item *item(int row) const
+    {
+        auto itPage = mPages.constFind(row / mPageSize);
+        if (itPage == mPages.constEnd()) {
+            return nullptr;
+        }
+
+        const auto rowInPage = row % mPageSize;
+        if (rowInPage >= itPage->mItems.size()) {
+            return nullptr;
+        }
+
+        return &itPage->mItems.at(rowInPage);
+    }
+
+    /*
+     * marks the page of this row as used; when it is missing, queues it and
+     * its neighbours, returns true when pages were queued
+     */
+    bool touch(int row)
+    {
+        const auto page = row / mPageSize;
+
+        auto itPage = mPages.find(page);
+        if (itPage != mPages.end()) {
+            itPage->mLastUse = ++mUseCounter;
+
+            /* the last page may have been read before rows were appended to it */
+            if (row % mPageSize < itPage->mItems.size() || mRequestedPages.contains(page) || mPendingPages.contains(page)) {
+                return false;
+            }
+
+            mPendingPages.push_back(page);
+
+            return true;
+        }
+
+        auto newRequest = false;
+
+        for (auto onePage : {page, page + 1, page - 1}) {
+            if (onePage < 0 || onePage * mPageSize >= mFetchedCount) {
+                continue;
+            }
+
+            if (mPages.contains(onePage) || mRequestedPages.contains(onePage) || mPendingPages.contains(onePage)) {
+                continue;
+            }
+
+            mPendingPages.push_back(onePage);
+            newRequest = true;
+        }
+
+        return newRequest;
+    }
+
+    /* starts after the last key of the closest full page read before this one */
+    PageStart pageStart(int page) const
+    {
+        auto result = PageStart();
+
+        auto itLastKey = mPageLastKeys.lowerBound(page);
+        if (itLastKey == mPageLastKeys.constBegin()) {
+            result.mSkippedCount = page * mPageSize;
+
+            return result;
+        }
+
+        --itLastKey;
+
+        result.mAfterKey = itLastKey.value();
+        result.mSkippedCount = (page - itLastKey.key() - 1) * mPageSize;
+
+        return result;
+    }
+
+    /* pages queued since the last call, from now on waiting for their rows */
+    QVector<int> takePendingPages()
+    {
+        auto result = QVector<int>();
+
+        std::swap(result, mPendingPages);
+
+        for (auto onePage : qAsConst(result)) {
+            mRequestedPages.insert(onePage);
+        }
+
+        return result;
+    }
+
+    /* false when nobody waits for this page any more, the least recently used pages are dropped */
+    bool storePage(int offset, const QList<Item> &items)
+    {
+        const auto page = offset / mPageSize;
+
+        if (offset % mPageSize != 0 || !mRequestedPages.remove(page)) {
+            return false;
+        }
+
+        auto &newPage = mPages[page];
+        newPage.mItems = QVector<Item>::fromList(items);
+        newPage.mLastUse = ++mUseCounter;
+
+        /* the last page may still grow, the rows of the next page are not known to follow it */
+        if (items.size() == mPageSize) {
+            mPageLastKeys[page] = items.last().databaseId();
+        }
+
+        while (mPages.size() > mMaximumLoadedPages) {
+            auto evictedPage = mPages.end();
+            auto oldestUse = std::numeric_limits<quint64>::max();
+
+            for (auto itPage = mPages.begin(); itPage != mPages.end(); ++itPage) {
+                if (itPage.key() != page && itPage->mLastUse < oldestUse) {
+                    oldestUse = itPage->mLastUse;
+                    evictedPage = itPage;
+                }
+            }
+
+            mPages.erase(evictedPage);
+        }
+
+        return true;
+    }
+
+    /* visitor is called with the row and a modifiable reference to each loaded item */
+    template <typename Visitor>
+    void forEachLoadedItem(Visitor visitor)
+    {
+        for (auto itPage = mPages.begin(); itPage != mPages.end(); ++itPage) {
+            for (int rowInPage = 0; rowInPage < itPage->mItems.size(); ++rowInPage) {
+                visitor(itPage.key() * mPageSize + rowInPage, itPage->mItems[rowInPage]);
+            }
+        }
+    }
+
+private:
+
+    struct Page
+    {
+
+        QVector<Item> mItems;
+
+        quint64 mLastUse = 0;
+
+    };
+
+    int mPageSize;
+
+    int mMaximumLoadedPages;
+
+    bool mEnabled = false;
+
+    int mTotalCount = 0;
+
+    int mFetchedCount = 0;
+
+    QHash<int, Page> mPages;
+
+    QSet<int> mRequestedPages;
+
+    QVector<int> mPendingPages;
+
+    /* last key of each full page read since the last reset, kept when the page is dropped */
+    QMap<int, qulonglong> mPageLastKeys;
+
+    quint64 mUseCounter = 0;
+
+};
+
+#endif // PAGEDMODELWINDOW_H
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2018 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "searchkeymatcher.h"
+
+#include <QChar>
+
+QString SearchKeyMatcher::searchKey(const QStringList &fields)
+{
+    return foldText(fields.join(QLatin1Char('\n')));
+}
+
+QString SearchKeyMatcher::foldText(const QString &text)
+{
+    const auto decomposedText = text.normalized(QString::NormalizationForm_KD);
+
+    auto result = QString();
+    result.reserve(decomposedText.size());
+
+    for (const auto oneCharacter : decomposedText) {
+        switch (oneCharacter.category())
+        {
+        case QChar::Mark_NonSpacing:
+        case QChar::Mark_SpacingCombining:
+        case QChar::Mark_Enclosing:
+            break;
+        default:
+            result.push_back(oneCharacter);
+        }
+    }
+
+    return result.toCaseFolded();
+}
+
+SearchKeyMatcher::SearchKeyMatcher()
+{
+}
+
+SearchKeyMatcher::SearchKeyMatcher(const QString &filterText) : mPattern(foldText(filterText)), mMatcher(mPattern, Qt::CaseSensitive)
+{
+}
+
+bool SearchKeyMatcher::isEmpty() const
+{
+    return mPattern.isEmpty();
+}
+
+bool SearchKeyMatcher::matches(const QString &searchKey) const
+{
+    if (mPattern.isEmpty()) {
+        return true;
+    }
+
+    if (mPattern.size() == 1) {
+        return searchKey.indexOf(mPattern.at(0)) != -1;
+    }
+
+    return mMatcher.indexIn(searchKey.constData(), searchKey.size()) != -1;
+}
+
+bool SearchKeyMatcher::refines(const SearchKeyMatcher &other) const
+{
+    return mPattern.contains(other.mPattern);
+}
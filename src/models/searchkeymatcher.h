@@ -0,0 +1,69 @@
+/*
+ * Copyright 2018 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef SEARCHKEYMATCHER_H
+#define SEARCHKEYMATCHER_H
+
+#include <QString>
+#include <QStringList>
+#include <QStringMatcher>
+#include <QVector>
+
+/* what a proxy model needs to filter one row of its source model */
+struct SearchKeyEntry
+{
+
+    QString mSearchKey;
+
+    int mRating = 0;
+
+};
+
+Q_DECLARE_TYPEINFO(SearchKeyEntry, Q_MOVABLE_TYPE);
+
+class SearchKeyMatcher
+{
+
+public:
+
+    /* case folded text of all fields without diacritics, separated by a character that cannot be typed in a filter */
+    static QString searchKey(const QStringList &fields);
+
+    static QString foldText(const QString &text);
+
+    SearchKeyMatcher();
+
+    explicit SearchKeyMatcher(const QString &filterText);
+
+    bool isEmpty() const;
+
+    bool matches(const QString &searchKey) const;
+
+    /* true when every key matched by this matcher is also matched by other */
+    bool refines(const SearchKeyMatcher &other) const;
+
+private:
+
+    QString mPattern;
+
+    QStringMatcher mMatcher;
+
+};
+
+#endif // SEARCHKEYMATCHER_H
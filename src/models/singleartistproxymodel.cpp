@@ -38,6 +38,36 @@ QString SingleArtistProxyModel::artistFilter() const
     return mArtistFilter;
 }
 
+void SingleArtistProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    for (const auto &oneConnection : qAsConst(mAlbumsModelConnections)) {
+        disconnect(oneConnection);
+    }
+    mAlbumsModelConnections.clear();
+
+    mAlbumsModel = qobject_cast<AllAlbumsModel*>(sourceModel);
+    mArtistRowsValid = false;
+
+    /* connected before the proxy's own handlers so that they never see stale artist rows */
+    if (sourceModel) {
+        auto artistRowsChanged = [this] () {mArtistRowsValid = false;};
+
+        mAlbumsModelConnections.push_back(connect(sourceModel, &QAbstractItemModel::dataChanged,
+                                                  this, artistRowsChanged));
+        mAlbumsModelConnections.push_back(connect(sourceModel, &QAbstractItemModel::rowsAboutToBeInserted,
+                                                  this, artistRowsChanged));
+        mAlbumsModelConnections.push_back(connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved,
+                                                  this, artistRowsChanged));
+        mAlbumsModelConnections.push_back(connect(sourceModel, &QAbstractItemModel::rowsAboutToBeMoved,
+                                                  this, artistRowsChanged));
+        mAlbumsModelConnections.push_back(connect(sourceModel, &QAbstractItemModel::layoutAboutToBeChanged,
+                                                  this, artistRowsChanged));
+        mAlbumsModelConnections.push_back(connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset,
+                                                  this, artistRowsChanged));
+    }
+
+    AbstractMediaProxyModel::setSourceModel(sourceModel);
+}
 
 void SingleArtistProxyModel::setArtistFilterText(const QString &filterText)
 {
@@ -45,10 +75,7 @@ void SingleArtistProxyModel::setArtistFilterText(const QString &filterText)
         return;
 
     mArtistFilter = filterText;
-
-    mArtistExpression.setPattern(QStringLiteral(".*") + mArtistFilter + QStringLiteral(".*"));
-    mArtistExpression.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
-    mArtistExpression.optimize();
+    mArtistRowsValid = false;
 
     invalidate();
 
@@ -57,38 +84,53 @@ void SingleArtistProxyModel::setArtistFilterText(const QString &filterText)
 
 bool SingleArtistProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
 {
-    bool result = false;
+    if (source_parent.isValid() || !mAlbumsModel) {
+        return false;
+    }
 
-    for (int column = 0, columnCount = sourceModel()->columnCount(source_parent); column < columnCount; ++column) {
-        auto currentIndex = sourceModel()->index(source_row, column, source_parent);
+    auto currentIndex = sourceModel()->index(source_row, 0, source_parent);
 
-        const auto &titleValue = sourceModel()->data(currentIndex, AllAlbumsModel::TitleRole).toString();
-        const auto &artistValue = sourceModel()->data(currentIndex, AllAlbumsModel::AllArtistsRole).toString();
-        const auto maximumRatingValue = sourceModel()->data(currentIndex, AllAlbumsModel::HighestTrackRating).toInt();
+    if (mAlbumsModel->isPaged()) {
+        /* a paged source model keeps no artist index, only the loaded albums can be matched */
+        const auto &album = sourceModel()->data(currentIndex, AllAlbumsModel::ContainerDataRole).value<MusicAlbum>();
 
-        if (maximumRatingValue < mFilterRating) {
-            result = false;
-            continue;
+        if (!album.isValid() || (album.artist() != mArtistFilter && !album.allArtists().contains(mArtistFilter))) {
+            return false;
         }
-
-        if (mArtistExpression.match(artistValue).hasMatch()) {
-            if (mFilterExpression.match(titleValue).hasMatch()) {
-                result = true;
-                continue;
-            }
-
+    } else {
+        if (!mArtistRowsValid) {
+            buildArtistRows();
         }
 
-        if (result) {
-            continue;
+        if (source_row >= mArtistRowsMask.size() || !mArtistRowsMask.testBit(source_row)) {
+            return false;
         }
+    }
+
+    const auto maximumRatingValue = sourceModel()->data(currentIndex, AllAlbumsModel::HighestTrackRating).toInt();
+
+    if (maximumRatingValue < mFilterRating) {
+        return false;
+    }
+
+    const auto &titleValue = sourceModel()->data(currentIndex, AllAlbumsModel::TitleRole).toString();
+
+    return mFilterExpression.match(titleValue).hasMatch();
+}
+
+void SingleArtistProxyModel::buildArtistRows() const
+{
+    mArtistRowsMask.fill(false, sourceModel()->rowCount());
+
+    const auto artistRows = mAlbumsModel->albumRowsOfArtist(mArtistFilter);
 
-        if (!result) {
-            break;
+    for (auto oneRow : artistRows) {
+        if (oneRow < mArtistRowsMask.size()) {
+            mArtistRowsMask.setBit(oneRow);
         }
     }
 
-    return result;
+    mArtistRowsValid = true;
 }
 
 void SingleArtistProxyModel::enqueueToPlayList()
@@ -24,6 +24,11 @@
 #include "abstractmediaproxymodel.h"
 #include "elisautils.h"
 
+#include <QBitArray>
+#include <QVector>
+
+class AllAlbumsModel;
+
 class SingleArtistProxyModel : public AbstractMediaProxyModel
 {
     Q_OBJECT
@@ -41,6 +46,8 @@ public:
 
     QString artistFilter() const;
 
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
 Q_SIGNALS:
 
     void albumToEnqueue(QList<MusicAlbum> newAlbums,
@@ -65,7 +72,18 @@ protected:
 
     QString mArtistFilter;
 
-    QRegularExpression mArtistExpression;
+private:
+
+    void buildArtistRows() const;
+
+    AllAlbumsModel *mAlbumsModel = nullptr;
+
+    /* source rows of the albums of mArtistFilter, rebuilt from the artist index when the source rows change */
+    mutable QBitArray mArtistRowsMask;
+
+    mutable bool mArtistRowsValid = false;
+
+    QVector<QMetaObject::Connection> mAlbumsModelConnections;
 
 };
 
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2018 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "sortkeybuilder.h"
+
+#include <QLocale>
+
+SortKeyBuilder::SortKeyBuilder() : SortKeyBuilder(QStringList())
+{
+}
+
+SortKeyBuilder::SortKeyBuilder(const QStringList &ignoredArticles) : mIgnoredArticles(ignoredArticles), mCollator(QLocale())
+{
+    mCollator.setCaseSensitivity(Qt::CaseInsensitive);
+    mCollator.setNumericMode(true);
+}
+
+const QStringList &SortKeyBuilder::ignoredArticles() const
+{
+    return mIgnoredArticles;
+}
+
+QString SortKeyBuilder::sortText(const QString &text) const
+{
+    const auto trimmedText = text.trimmed();
+
+    for (const auto &oneArticle : mIgnoredArticles) {
+        if (oneArticle.isEmpty() || trimmedText.size() <= oneArticle.size() + 1) {
+            continue;
+        }
+
+        if (trimmedText.startsWith(oneArticle, Qt::CaseInsensitive) && trimmedText.at(oneArticle.size()).isSpace()) {
+            return trimmedText.mid(oneArticle.size() + 1).trimmed();
+        }
+    }
+
+    return trimmedText;
+}
+
+QCollatorSortKey SortKeyBuilder::sortKey(const QString &text) const
+{
+    return mCollator.sortKey(sortText(text));
+}
+
+SortKeyEntry SortKeyBuilder::sortEntry(const QString &title, const QString &artist) const
+{
+    return SortKeyEntry(sortKey(title), sortKey(artist));
+}
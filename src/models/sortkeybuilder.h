@@ -0,0 +1,75 @@
+/*
+ * Copyright 2018 Matthieu Gallien <matthieu_gallien@yahoo.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef SORTKEYBUILDER_H
+#define SORTKEYBUILDER_H
+
+#include <QString>
+#include <QStringList>
+#include <QCollator>
+#include <QCollatorSortKey>
+
+/* what a proxy model needs to sort one row of its source model without going through data() */
+struct SortKeyEntry
+{
+
+    SortKeyEntry(const QCollatorSortKey &titleKey, const QCollatorSortKey &artistKey)
+        : mTitleKey(titleKey), mArtistKey(artistKey)
+    {
+    }
+
+    QCollatorSortKey mTitleKey;
+
+    QCollatorSortKey mArtistKey;
+
+    int mYear = 0;
+
+    int mDuration = 0;
+
+    qulonglong mDatabaseId = 0;
+
+};
+
+class SortKeyBuilder
+{
+
+public:
+
+    SortKeyBuilder();
+
+    explicit SortKeyBuilder(const QStringList &ignoredArticles);
+
+    const QStringList &ignoredArticles() const;
+
+    /* text without a leading ignored article, "The Beatles" sorts as "Beatles" */
+    QString sortText(const QString &text) const;
+
+    QCollatorSortKey sortKey(const QString &text) const;
+
+    SortKeyEntry sortEntry(const QString &title, const QString &artist) const;
+
+private:
+
+    QStringList mIgnoredArticles;
+
+    QCollator mCollator;
+
+};
+
+#endif // SORTKEYBUILDER_H
@@ -87,6 +87,10 @@ public:
 
     bool mIsSingleDiscAlbum = true;
 
+    qint64 mFileSize = -1;
+
+    qint64 mFileModificationTime = -1;
+
 };
 
 MusicAudioTrack::MusicAudioTrack() : d(std::make_unique<MusicAudioTrackPrivate>())
@@ -403,6 +407,26 @@ bool MusicAudioTrack::isSingleDiscAlbum() const
     return d->mIsSingleDiscAlbum;
 }
 
+void MusicAudioTrack::setFileSize(qint64 value)
+{
+    d->mFileSize = value;
+}
+
+qint64 MusicAudioTrack::fileSize() const
+{
+    return d->mFileSize;
+}
+
+void MusicAudioTrack::setFileModificationTime(qint64 value)
+{
+    d->mFileModificationTime = value;
+}
+
+qint64 MusicAudioTrack::fileModificationTime() const
+{
+    return d->mFileModificationTime;
+}
+
 QDebug operator<<(QDebug stream, const MusicAudioTrack &data)
 {
     stream << data.title() << data.artist() << data.albumName() << data.albumArtist() << data.duration();
@@ -151,6 +151,23 @@ public:
 
     bool isSingleDiscAlbum() const;
 
+    /**
+     * Size of the file when its tags were read or -1 if unknown. It is not
+     * compared by operator==.
+     */
+    void setFileSize(qint64 value);
+
+    qint64 fileSize() const;
+
+    /**
+     * Modification time of the file when its tags were read or -1 if
+     * unknown. The unit depends on the listing that read it. It is not
+     * compared by operator==.
+     */
+    void setFileModificationTime(qint64 value);
+
+    qint64 fileModificationTime() const;
+
 private:
 
     std::unique_ptr<MusicAudioTrackPrivate> d;
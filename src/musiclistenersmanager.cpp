@@ -33,6 +33,9 @@
 #include "mediaplaylist.h"
 #include "file/filelistener.h"
 #include "file/localfilelisting.h"
+#include "abstractfile/abstractfilelisting.h"
+#include "abstractfile/indexerfilter.h"
+#include "abstractfile/indexerthrottle.h"
 #include "trackslistener.h"
 #include "notificationitem.h"
 #include "elisaapplication.h"
@@ -59,10 +62,12 @@
 #include <QScopedPointer>
 #include <QPointer>
 #include <QFileSystemWatcher>
+#include <QElapsedTimer>
 
 #include <QAction>
 
 #include <list>
+#include <algorithm>
 
 class MusicListenersManagerPrivate
 {
@@ -104,8 +109,26 @@ public:
 
     AlbumModel mAlbumModel;
 
+    AllAlbumsModel mArtistAlbumsModel;
+
+    bool mPagedCollection = false;
+
     bool mIndexerBusy = false;
 
+    IndexerThrottle mIndexerThrottle;
+
+    QElapsedTimer mIndexingTimer;
+
+    int mIndexingStartTracksCount = 0;
+
+    int mLastIndexedTracksCount = 0;
+
+    qint64 mLastIndexingTime = 0;
+
+    qint64 mLastIndexingThrottledTime = 0;
+
+    int mLastIndexingBufferUnderrunsCount = 0;
+
 };
 
 MusicListenersManager::MusicListenersManager(QObject *parent)
@@ -127,8 +150,18 @@ MusicListenersManager::MusicListenersManager(QObject *parent)
         databaseFileName = localDataPaths.first() + QStringLiteral("/elisaDatabase.db");
     }
 
+    /* read once, the database and the models cannot switch to pages while running */
+    const auto pagedCollection = Elisa::ElisaConfiguration::pagedCollectionModels();
+
+    d->mPagedCollection = pagedCollection;
+
+    d->mAllAlbumsModel.setPaged(pagedCollection);
+    d->mAllArtistsModel.setPaged(pagedCollection);
+    d->mAllTracksModel.setPaged(pagedCollection);
+
     QMetaObject::invokeMethod(&d->mDatabaseInterface, "init", Qt::QueuedConnection,
-                              Q_ARG(QString, QStringLiteral("listeners")), Q_ARG(QString, databaseFileName));
+                              Q_ARG(QString, QStringLiteral("listeners")), Q_ARG(QString, databaseFileName),
+                              Q_ARG(bool, pagedCollection));
 
     connect(&d->mDatabaseInterface, &DatabaseInterface::artistAdded,
             this, &MusicListenersManager::artistAdded);
@@ -176,24 +209,68 @@ MusicListenersManager::MusicListenersManager(QObject *parent)
 
     connect(&d->mDatabaseInterface, &DatabaseInterface::albumsAdded,
             &d->mAllAlbumsModel, &AllAlbumsModel::albumsAdded);
-    connect(&d->mDatabaseInterface, &DatabaseInterface::albumModified,
-            &d->mAllAlbumsModel, &AllAlbumsModel::albumModified);
-    connect(&d->mDatabaseInterface, &DatabaseInterface::albumRemoved,
-            &d->mAllAlbumsModel, &AllAlbumsModel::albumRemoved);
+    connect(&d->mDatabaseInterface, &DatabaseInterface::albumsModified,
+            &d->mAllAlbumsModel, &AllAlbumsModel::albumsModified);
+    connect(&d->mDatabaseInterface, &DatabaseInterface::albumsRemoved,
+            &d->mAllAlbumsModel, &AllAlbumsModel::albumsRemoved);
 
     connect(&d->mDatabaseInterface, &DatabaseInterface::artistAdded,
             &d->mAllArtistsModel, &AllArtistsModel::artistAdded);
     connect(&d->mDatabaseInterface, &DatabaseInterface::artistModified,
             &d->mAllArtistsModel, &AllArtistsModel::artistModified);
-    connect(&d->mDatabaseInterface, &DatabaseInterface::artistRemoved,
-            &d->mAllArtistsModel, &AllArtistsModel::artistRemoved);
+    connect(&d->mDatabaseInterface, &DatabaseInterface::artistsRemoved,
+            &d->mAllArtistsModel, &AllArtistsModel::artistsRemoved);
 
     connect(&d->mDatabaseInterface, &DatabaseInterface::tracksAdded,
             &d->mAllTracksModel, &AllTracksModel::tracksAdded);
-    connect(&d->mDatabaseInterface, &DatabaseInterface::trackModified,
-            &d->mAllTracksModel, &AllTracksModel::trackModified);
-    connect(&d->mDatabaseInterface, &DatabaseInterface::trackRemoved,
-            &d->mAllTracksModel, &AllTracksModel::trackRemoved);
+    connect(&d->mDatabaseInterface, &DatabaseInterface::tracksModified,
+            &d->mAllTracksModel, &AllTracksModel::tracksModified);
+    connect(&d->mDatabaseInterface, &DatabaseInterface::tracksRemoved,
+            &d->mAllTracksModel, &AllTracksModel::tracksRemoved);
+
+    connect(&d->mDatabaseInterface, &DatabaseInterface::sentAlbumsCount,
+            &d->mAllAlbumsModel, &AllAlbumsModel::setAlbumsCount);
+    connect(&d->mAllAlbumsModel, &AllAlbumsModel::requestAlbumsPage,
+            &d->mDatabaseInterface, &DatabaseInterface::getAlbumsPage);
+    connect(&d->mDatabaseInterface, &DatabaseInterface::sentAlbumsPage,
+            &d->mAllAlbumsModel, &AllAlbumsModel::setAlbumsPage);
+
+    connect(&d->mDatabaseInterface, &DatabaseInterface::sentArtistsCount,
+            &d->mAllArtistsModel, &AllArtistsModel::setArtistsCount);
+    connect(&d->mAllArtistsModel, &AllArtistsModel::requestArtistsPage,
+            &d->mDatabaseInterface, &DatabaseInterface::getArtistsPage);
+    connect(&d->mDatabaseInterface, &DatabaseInterface::sentArtistsPage,
+            &d->mAllArtistsModel, &AllArtistsModel::setArtistsPage);
+
+    connect(&d->mDatabaseInterface, &DatabaseInterface::sentTracksCount,
+            &d->mAllTracksModel, &AllTracksModel::setTracksCount);
+    connect(&d->mAllTracksModel, &AllTracksModel::requestTracksPage,
+            &d->mDatabaseInterface, &DatabaseInterface::getTracksPage);
+    connect(&d->mDatabaseInterface, &DatabaseInterface::sentTracksPage,
+            &d->mAllTracksModel, &AllTracksModel::setTracksPage);
+
+    connect(&d->mAllAlbumsModel, &AllAlbumsModel::requestAllAlbumsTracksIds,
+            &d->mDatabaseInterface, &DatabaseInterface::getAllAlbumsTracksIds);
+    connect(&d->mDatabaseInterface, &DatabaseInterface::sentAllAlbumsTracksIds,
+            &d->mAllAlbumsModel, &AllAlbumsModel::setAllAlbumsTracksIds);
+    connect(&d->mAllArtistsModel, &AllArtistsModel::requestAllArtistsNames,
+            &d->mDatabaseInterface, &DatabaseInterface::getAllArtistsNames);
+    connect(&d->mDatabaseInterface, &DatabaseInterface::sentAllArtistsNames,
+            &d->mAllArtistsModel, &AllArtistsModel::setAllArtistsNames);
+    connect(&d->mAllTracksModel, &AllTracksModel::requestAllTracksIds,
+            &d->mDatabaseInterface, &DatabaseInterface::getAllTracksIds);
+    connect(&d->mDatabaseInterface, &DatabaseInterface::sentAllTracksIds,
+            &d->mAllTracksModel, &AllTracksModel::setAllTracksIds);
+
+    /* only the albums of the artists already shown are kept, new albums are read when an artist is shown again */
+    d->mArtistAlbumsModel.setAllArtists(&d->mAllArtistsModel);
+
+    connect(&d->mDatabaseInterface, &DatabaseInterface::sentAlbumsFromArtist,
+            &d->mArtistAlbumsModel, &AllAlbumsModel::albumsAdded);
+    connect(&d->mDatabaseInterface, &DatabaseInterface::albumsModified,
+            &d->mArtistAlbumsModel, &AllAlbumsModel::albumsModified);
+    connect(&d->mDatabaseInterface, &DatabaseInterface::albumsRemoved,
+            &d->mArtistAlbumsModel, &AllAlbumsModel::albumsRemoved);
 
     connect(&d->mDatabaseInterface, &DatabaseInterface::albumModified,
             &d->mAlbumModel, &AlbumModel::albumModified);
@@ -227,9 +304,26 @@ void MusicListenersManager::subscribeForTracks(MediaPlayList *client)
     connect(helper, &TracksListener::trackHasBeenRemoved, client, &MediaPlayList::trackRemoved);
     connect(helper, &TracksListener::albumAdded, client, &MediaPlayList::albumAdded);
     connect(client, &MediaPlayList::newTrackByIdInList, helper, &TracksListener::trackByIdInList);
+    connect(client, &MediaPlayList::newTracksByIdInList, helper, &TracksListener::tracksByIdInList);
     connect(client, &MediaPlayList::newTrackByNameInList, helper, &TracksListener::trackByNameInList);
     connect(client, &MediaPlayList::newTrackByFileNameInList, helper, &TracksListener::trackByFileNameInList);
     connect(client, &MediaPlayList::newArtistInList, helper, &TracksListener::newArtistInList);
+
+    client->setPaged(d->mPagedCollection);
+
+    connect(client, &MediaPlayList::storedEntriesInserted, &d->mDatabaseInterface, &DatabaseInterface::insertPlayListEntries);
+    connect(client, &MediaPlayList::storedEntriesRemoved, &d->mDatabaseInterface, &DatabaseInterface::removePlayListEntries);
+    connect(client, &MediaPlayList::storedEntriesMoved, &d->mDatabaseInterface, &DatabaseInterface::movePlayListEntries);
+    connect(client, &MediaPlayList::storedEntryChanged, &d->mDatabaseInterface, &DatabaseInterface::updatePlayListEntry);
+    connect(client, &MediaPlayList::storedEntriesCleared, &d->mDatabaseInterface, &DatabaseInterface::clearPlayListEntries);
+    connect(&d->mDatabaseInterface, &DatabaseInterface::sentPlayListEntries, client, &MediaPlayList::storedEntriesLoaded);
+
+    const auto playListName = QStringLiteral("current");
+
+    client->setStoredPlayListName(playListName);
+
+    QMetaObject::invokeMethod(&d->mDatabaseInterface, "getPlayListEntries", Qt::QueuedConnection,
+                              Q_ARG(QString, playListName));
 }
 
 int MusicListenersManager::importedTracksCount() const
@@ -267,11 +361,56 @@ QAbstractItemModel *MusicListenersManager::albumModel() const
     return &d->mAlbumModel;
 }
 
+QAbstractItemModel *MusicListenersManager::artistAlbumsModel() const
+{
+    return &d->mArtistAlbumsModel;
+}
+
+bool MusicListenersManager::pagedCollection() const
+{
+    return d->mPagedCollection;
+}
+
+void MusicListenersManager::loadArtistAlbums(const QString &artistName)
+{
+    QMetaObject::invokeMethod(&d->mDatabaseInterface, "getAlbumsFromArtist", Qt::QueuedConnection,
+                              Q_ARG(QString, artistName));
+}
+
 bool MusicListenersManager::indexerBusy() const
 {
     return d->mIndexerBusy;
 }
 
+int MusicListenersManager::lastIndexedTracksCount() const
+{
+    return d->mLastIndexedTracksCount;
+}
+
+qint64 MusicListenersManager::lastIndexingTime() const
+{
+    return d->mLastIndexingTime;
+}
+
+double MusicListenersManager::lastIndexingThroughput() const
+{
+    if (d->mLastIndexingTime <= 0) {
+        return 0.;
+    }
+
+    return 1000. * d->mLastIndexedTracksCount / d->mLastIndexingTime;
+}
+
+qint64 MusicListenersManager::lastIndexingThrottledTime() const
+{
+    return d->mLastIndexingThrottledTime;
+}
+
+int MusicListenersManager::lastIndexingBufferUnderrunsCount() const
+{
+    return d->mLastIndexingBufferUnderrunsCount;
+}
+
 void MusicListenersManager::databaseReady()
 {
     d->mIndexerBusy = true;
@@ -338,6 +477,21 @@ void MusicListenersManager::playBackError(QUrl sourceInError, QMediaPlayer::Erro
     }
 }
 
+void MusicListenersManager::updatePlaybackState(QMediaPlayer::MediaStatus playerStatus, int playerPlaybackState)
+{
+    auto throttleState = IndexerThrottle::PlaybackState::Stopped;
+
+    if (playerPlaybackState == QMediaPlayer::PlayingState) {
+        if (playerStatus == QMediaPlayer::BufferingMedia || playerStatus == QMediaPlayer::StalledMedia) {
+            throttleState = IndexerThrottle::PlaybackState::Buffering;
+        } else {
+            throttleState = IndexerThrottle::PlaybackState::Playing;
+        }
+    }
+
+    d->mIndexerThrottle.setPlaybackState(throttleState);
+}
+
 void MusicListenersManager::configChanged()
 {
     auto currentConfiguration = Elisa::ElisaConfiguration::self();
@@ -346,9 +500,24 @@ void MusicListenersManager::configChanged()
 
     currentConfiguration->load();
 
+    const auto indexerFilter = IndexerFilter(currentConfiguration->excludedPatterns(),
+                                             1024 * static_cast<qint64>(currentConfiguration->minimumFileSize()));
+
+    const auto ignoredSortArticles = currentConfiguration->ignoredSortArticles();
+    d->mAllAlbumsModel.setIgnoredSortArticles(ignoredSortArticles);
+    d->mArtistAlbumsModel.setIgnoredSortArticles(ignoredSortArticles);
+    d->mAllArtistsModel.setIgnoredSortArticles(ignoredSortArticles);
+    d->mAllTracksModel.setIgnoredSortArticles(ignoredSortArticles);
+
 #if defined KF5Baloo_FOUND && KF5Baloo_FOUND
+    if (d->mBalooListener) {
+        d->mBalooListener->fileListing()->setIndexerFilter(indexerFilter);
+    }
+
     if (currentConfiguration->balooIndexer() && !d->mBalooListener) {
         d->mBalooListener.reset(new BalooListener);
+        d->mBalooListener->fileListing()->setIndexerFilter(indexerFilter);
+        d->mBalooListener->fileListing()->setIndexerThrottle(&d->mIndexerThrottle);
         d->mBalooListener->moveToThread(&d->mListenerThread);
         d->mBalooListener->setDatabaseInterface(&d->mDatabaseInterface);
         connect(this, &MusicListenersManager::applicationIsTerminating,
@@ -390,6 +559,7 @@ void MusicListenersManager::configChanged()
                 d->mDatabaseInterface.removeAllTracksFromSource((*itFileListener)->fileListing()->sourceName());
                 itFileListener = d->mFileListener.erase(itFileListener);
             } else {
+                (*itFileListener)->fileListing()->setIndexerFilter(indexerFilter);
                 ++itFileListener;
             }
         }
@@ -416,6 +586,8 @@ void MusicListenersManager::configChanged()
                         this, &MusicListenersManager::closeNotification);
 
                 newFileIndexer->setRootPath(oneRootPath);
+                newFileIndexer->fileListing()->setIndexerFilter(indexerFilter);
+                newFileIndexer->fileListing()->setIndexerThrottle(&d->mIndexerThrottle);
 
                 QMetaObject::invokeMethod(newFileIndexer.get(), "performInitialScan", Qt::QueuedConnection);
 
@@ -458,6 +630,10 @@ void MusicListenersManager::monitorStartingListeners()
     if (d->mActiveMusicListenersCount == 0) {
         d->mIndexingRunning = true;
         Q_EMIT indexingRunningChanged();
+
+        d->mIndexerThrottle.resetStatistics();
+        d->mIndexingStartTracksCount = d->mTotalImportedTracksCount;
+        d->mIndexingTimer.start();
     }
 
     ++d->mActiveMusicListenersCount;
@@ -491,6 +667,12 @@ void MusicListenersManager::monitorEndingListeners(int tracksCount)
         d->mIndexingRunning = false;
         Q_EMIT indexingRunningChanged();
 
+        d->mLastIndexedTracksCount = d->mTotalImportedTracksCount - d->mIndexingStartTracksCount;
+        d->mLastIndexingTime = std::max<qint64>(1, d->mIndexingTimer.elapsed());
+        d->mLastIndexingThrottledTime = d->mIndexerThrottle.throttledTime();
+        d->mLastIndexingBufferUnderrunsCount = d->mIndexerThrottle.bufferUnderrunsCount();
+        Q_EMIT indexingStatisticsChanged();
+
         QMetaObject::invokeMethod(&d->mDatabaseInterface, "cleanInvalidTracks", Qt::QueuedConnection);
     }
 }
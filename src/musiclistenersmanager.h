@@ -78,10 +78,38 @@ class MusicListenersManager : public QObject
                READ albumModel
                CONSTANT)
 
+    Q_PROPERTY(QAbstractItemModel* artistAlbumsModel
+               READ artistAlbumsModel
+               CONSTANT)
+
+    Q_PROPERTY(bool pagedCollection
+               READ pagedCollection
+               CONSTANT)
+
     Q_PROPERTY(bool indexerBusy
                READ indexerBusy
                NOTIFY indexerBusyChanged)
 
+    Q_PROPERTY(int lastIndexedTracksCount
+               READ lastIndexedTracksCount
+               NOTIFY indexingStatisticsChanged)
+
+    Q_PROPERTY(qint64 lastIndexingTime
+               READ lastIndexingTime
+               NOTIFY indexingStatisticsChanged)
+
+    Q_PROPERTY(double lastIndexingThroughput
+               READ lastIndexingThroughput
+               NOTIFY indexingStatisticsChanged)
+
+    Q_PROPERTY(qint64 lastIndexingThrottledTime
+               READ lastIndexingThrottledTime
+               NOTIFY indexingStatisticsChanged)
+
+    Q_PROPERTY(int lastIndexingBufferUnderrunsCount
+               READ lastIndexingBufferUnderrunsCount
+               NOTIFY indexingStatisticsChanged)
+
 public:
 
     explicit MusicListenersManager(QObject *parent = nullptr);
@@ -106,8 +134,45 @@ public:
 
     QAbstractItemModel *albumModel() const;
 
+    /**
+     * Albums of the artists loaded by loadArtistAlbums. The single artist
+     * view reads them from here when the collection models are paged.
+     */
+    QAbstractItemModel *artistAlbumsModel() const;
+
+    /**
+     * Collection models read their rows page by page from the database.
+     * They then keep database order and cannot be searched or sorted.
+     */
+    bool pagedCollection() const;
+
     bool indexerBusy() const;
 
+    /**
+     * Tracks imported by the last completed indexing.
+     */
+    int lastIndexedTracksCount() const;
+
+    /**
+     * Duration of the last completed indexing, in milliseconds.
+     */
+    qint64 lastIndexingTime() const;
+
+    /**
+     * Tracks imported per second by the last completed indexing.
+     */
+    double lastIndexingThroughput() const;
+
+    /**
+     * Time the last completed indexing was paused to let playback run, in milliseconds.
+     */
+    qint64 lastIndexingThrottledTime() const;
+
+    /**
+     * Buffer underruns of the player during the last completed indexing.
+     */
+    int lastIndexingBufferUnderrunsCount() const;
+
 Q_SIGNALS:
 
     void viewDatabaseChanged();
@@ -148,6 +213,8 @@ Q_SIGNALS:
 
     void indexerBusyChanged();
 
+    void indexingStatisticsChanged();
+
 public Q_SLOTS:
 
     void databaseReady();
@@ -162,6 +229,10 @@ public Q_SLOTS:
 
     void playBackError(QUrl sourceInError, QMediaPlayer::Error playerError);
 
+    void updatePlaybackState(QMediaPlayer::MediaStatus playerStatus, int playerPlaybackState);
+
+    void loadArtistAlbums(const QString &artistName);
+
 private Q_SLOTS:
 
     void configChanged();
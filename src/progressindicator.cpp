@@ -19,6 +19,8 @@
 
 #include "progressindicator.h"
 
+#include "displaytextformatter.h"
+
 #include <QTime>
 
 ProgressIndicator::ProgressIndicator(QObject *parent) : QObject(parent)
@@ -43,16 +45,19 @@ void ProgressIndicator::setPosition(int position)
     if (mPosition == position)
         return;
 
+    const auto previousSecond = mPosition / 1000;
+
     mPosition = position;
 
-    QTime currentProgress = QTime::fromMSecsSinceStartOfDay(mPosition);
-    if (currentProgress.hour() == 0) {
-        mProgressDuration = currentProgress.toString(QStringLiteral("m:ss"));
-    } else {
-        mProgressDuration = currentProgress.toString(QStringLiteral("h:mm:ss"));
+    Q_EMIT positionChanged();
+
+    /* the player reports the position many times per second, the text only changes once per second */
+    if (!mProgressDuration.isEmpty() && previousSecond == mPosition / 1000) {
+        return;
     }
 
-    Q_EMIT positionChanged();
+    mProgressDuration = DisplayTextFormatter::progressText(QTime::fromMSecsSinceStartOfDay(mPosition));
+
     Q_EMIT progressDurationChanged();
 }
 
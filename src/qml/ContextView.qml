@@ -45,7 +45,7 @@ Item {
         Image {
             id: albumIcon
 
-            source: albumArtUrl.toString() === '' ? Qt.resolvedUrl(elisaTheme.defaultAlbumImage) : albumArtUrl
+            source: albumArtUrl.toString() === '' ? Qt.resolvedUrl(elisaTheme.defaultAlbumImage) : elisaTheme.coverThumbnail(albumArtUrl)
             Layout.preferredWidth: elisaTheme.coverImageSize
             Layout.preferredHeight: elisaTheme.coverImageSize
             Layout.alignment: Qt.AlignVCenter | Qt.AlignHCenter
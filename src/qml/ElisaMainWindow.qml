@@ -214,6 +214,9 @@ ApplicationWindow {
         }
 
         onDisplayTrackError: messageNotification.showNotification(i18n("Error when playing %1", "" + fileName), 3000)
+
+        onPlayerStatusChanged: if (elisa.musicManager) elisa.musicManager.updatePlaybackState(playerStatus, playerPlaybackState)
+        onPlayerPlaybackStateChanged: if (elisa.musicManager) elisa.musicManager.updatePlaybackState(playerStatus, playerPlaybackState)
     }
 
     ManageMediaPlayerControl {
@@ -450,6 +453,9 @@ ApplicationWindow {
 
                                             contentModel: elisa.allAlbumsProxyModel
 
+                                            /* paged models keep database order and cannot be searched */
+                                            enableSearch: !(elisa.musicManager && elisa.musicManager.pagedCollection)
+
                                             image: elisaTheme.albumIcon
                                             mainTitle: i18nc("Title of the view of all albums", "Albums")
 
@@ -497,6 +503,8 @@ ApplicationWindow {
 
                                             contentModel: elisa.allArtistsProxyModel
 
+                                            enableSearch: !(elisa.musicManager && elisa.musicManager.pagedCollection)
+
                                             image: elisaTheme.artistIcon
                                             mainTitle: i18nc("Title of the view of all artists", "Artists")
 
@@ -543,6 +551,8 @@ ApplicationWindow {
 
                                             contentModel: elisa.allTracksProxyModel
 
+                                            enableSearch: !(elisa.musicManager && elisa.musicManager.pagedCollection)
+
                                             Binding {
                                                 target: allTracksView
                                                 property: 'filterState'
@@ -166,7 +166,7 @@ FocusScope {
                         fillMode: Image.PreserveAspectFit
                         smooth: true
 
-                        source: (gridEntry.imageUrl !== undefined ? gridEntry.imageUrl : "")
+                        source: (gridEntry.imageUrl !== undefined ? elisaTheme.coverThumbnail(gridEntry.imageUrl) : "")
 
                         asynchronous: true
 
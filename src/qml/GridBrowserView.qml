@@ -38,6 +38,7 @@ FocusScope {
     property bool showRating: true
     property bool delegateDisplaySecondaryText: true
     property alias filterState: navigationBar.state
+    property alias enableSearch: navigationBar.enableSearch
 
     signal open(var innerMainTitle, var innerSecondaryTitle, var innerImage, var databaseId)
     signal goBack()
@@ -82,6 +83,12 @@ FocusScope {
                 value: navigationBar.filterRating
             }
 
+            Binding {
+                target: contentModel
+                property: 'sortCriterion'
+                value: navigationBar.sortCriterion
+            }
+
             onEnqueue: contentModel.enqueueToPlayList()
 
             onReplaceAndPlay:contentModel.replaceAndPlayOfPlayList()
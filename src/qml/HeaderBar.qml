@@ -173,7 +173,7 @@ FocusScope {
 
                     asynchronous: true
 
-                    source: (oldImage ? oldImage : Qt.resolvedUrl(elisaTheme.defaultAlbumImage))
+                    source: (oldImage ? elisaTheme.coverThumbnail(oldImage) : Qt.resolvedUrl(elisaTheme.defaultAlbumImage))
 
                     sourceSize {
                         width: contentZone.height * 0.9
@@ -190,7 +190,7 @@ FocusScope {
 
                     asynchronous: true
 
-                    source: (newImage ? newImage : Qt.resolvedUrl(elisaTheme.defaultAlbumImage))
+                    source: (newImage ? elisaTheme.coverThumbnail(newImage) : Qt.resolvedUrl(elisaTheme.defaultAlbumImage))
 
                     visible: false
                     opacity: 0
@@ -328,7 +328,7 @@ FocusScope {
         PropertyAction {
             target: newMainIcon
             property: "source"
-            value: (newImage ? newImage : Qt.resolvedUrl(elisaTheme.defaultAlbumImage))
+            value: (newImage ? elisaTheme.coverThumbnail(newImage) : Qt.resolvedUrl(elisaTheme.defaultAlbumImage))
         }
 
         ParallelAnimation {
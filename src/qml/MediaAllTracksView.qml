@@ -33,6 +33,7 @@ FocusScope {
     property var stackView
     property alias contentModel: contentDirectoryView.model
     property alias filterState: navigationBar.state
+    property alias enableSearch: navigationBar.enableSearch
 
     signal filterViewChanged(string filterState)
 
@@ -75,6 +76,12 @@ FocusScope {
                 value: navigationBar.filterRating
             }
 
+            Binding {
+                target: contentModel
+                property: 'sortCriterion'
+                value: navigationBar.sortCriterion
+            }
+
             onEnqueue: contentModel.enqueueToPlayList()
 
             onFilterViewChanged: rootElement.filterViewChanged(filterState)
@@ -208,6 +208,17 @@ FocusScope {
 
                 focus: true
 
+                /* a paged playlist keeps the whole tracks of the shown rows */
+                function updateVisibleRows() {
+                    if (topItem.playListModel) {
+                        topItem.playListModel.setVisibleRows(indexAt(0, contentY), indexAt(0, contentY + height - 1))
+                    }
+                }
+
+                onContentYChanged: updateVisibleRows()
+                onHeightChanged: updateVisibleRows()
+                onCountChanged: updateVisibleRows()
+
                 TextEdit {
                     readOnly: true
                     visible: playListModelDelegate.count === 0
@@ -182,7 +182,7 @@ FocusScope {
                         fillMode: Image.PreserveAspectFit
                         smooth: true
 
-                        source: (dataHelper.hasValidAlbumCover() ? dataHelper.albumCover : Qt.resolvedUrl(elisaTheme.defaultAlbumImage))
+                        source: (dataHelper.hasValidAlbumCover() ? elisaTheme.coverThumbnail(dataHelper.albumCover) : Qt.resolvedUrl(elisaTheme.defaultAlbumImage))
 
                         asynchronous: true
 
@@ -35,7 +35,9 @@ FocusScope {
     property bool showRating: true
     property alias filterText: filterTextInput.text
     property alias filterRating: ratingFilter.starRating
+    property alias sortCriterion: sortCriterionInput.currentIndex
     property bool enableGoBack: true
+    property bool enableSearch: true
 
     signal enqueue();
     signal replaceAndPlay();
@@ -216,6 +218,8 @@ FocusScope {
                     ToolButton {
                         action: showFilterAction
 
+                        visible: enableSearch
+
                         Layout.alignment: Qt.AlignRight
                         Layout.leftMargin: !LayoutMirroring.enabled ? elisaTheme.layoutHorizontalMargin : 0
                         Layout.rightMargin: LayoutMirroring.enabled ? elisaTheme.layoutHorizontalMargin : 0
@@ -311,6 +315,31 @@ FocusScope {
 
                 Layout.bottomMargin: 0
             }
+
+            LabelWithToolTip {
+                text: i18nc("before the ComboBox choosing the order of the view", "Sort by: ")
+
+                font.bold: true
+
+                color: myPalette.text
+
+                Layout.bottomMargin: 0
+                Layout.leftMargin: !LayoutMirroring.enabled ? (elisaTheme.layoutHorizontalMargin * 2) : 0
+                Layout.rightMargin: LayoutMirroring.enabled ? (elisaTheme.layoutHorizontalMargin * 2) : 0
+            }
+
+            ComboBox {
+                id: sortCriterionInput
+
+                /* same order as AbstractMediaProxyModel::SortCriterion */
+                model: [i18nc("sort the view on the title", "Title"),
+                    i18nc("sort the view on the artist", "Artist"),
+                    i18nc("sort the view on the year", "Year"),
+                    i18nc("sort the view on the date the music was added", "Date Added"),
+                    i18nc("sort the view on the duration", "Duration")]
+
+                Layout.bottomMargin: 0
+            }
         }
     }
 
@@ -330,11 +359,11 @@ FocusScope {
             name: 'expanded'
             PropertyChanges {
                 target: navigationBar
-                height: elisaTheme.navigationBarHeight + elisaTheme.navigationBarFilterHeight
+                height: elisaTheme.navigationBarHeight + (enableSearch ? elisaTheme.navigationBarFilterHeight : 0)
             }
             PropertyChanges {
                 target: filterRow
-                opacity: 1.0
+                opacity: (enableSearch ? 1.0 : 0.0)
             }
         }
     ]
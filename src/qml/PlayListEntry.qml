@@ -141,7 +141,7 @@ FocusScope {
                     Image {
                         id: mainIcon
 
-                        source: (isValid ? (dataHelper.hasValidAlbumCover() ? dataHelper.albumCover : Qt.resolvedUrl(elisaTheme.defaultAlbumImage)) : Qt.resolvedUrl(elisaTheme.errorIcon))
+                        source: (isValid ? (dataHelper.hasValidAlbumCover() ? elisaTheme.coverThumbnail(dataHelper.albumCover) : Qt.resolvedUrl(elisaTheme.defaultAlbumImage)) : Qt.resolvedUrl(elisaTheme.errorIcon))
 
                         Layout.minimumWidth: headerRow.height - 4
                         Layout.maximumWidth: headerRow.height - 4
@@ -26,6 +26,15 @@ Item {
         return Math.round(pixel * logicalDpi / 96);
     }
 
+    function coverThumbnail(coverUrl) {
+        // local covers are served pre-scaled by the cover thumbnail provider
+        var coverUrlString = coverUrl.toString();
+        if (coverUrlString.indexOf('file:') === 0) {
+            return 'image://cover/' + encodeURIComponent(coverUrlString);
+        }
+        return coverUrl;
+    }
+
     property string defaultAlbumImage: 'image://icon/media-optical-audio'
     property string defaultArtistImage: 'image://icon/view-media-artist'
     property string defaultBackgroundImage: 'qrc:///background.png'
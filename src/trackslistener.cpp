@@ -26,21 +26,30 @@
 
 #include <QMimeDatabase>
 #include <QSet>
+#include <QHash>
 #include <QList>
 #include <QDebug>
 
 #include <array>
 #include <algorithm>
 
+/* key of the entries waiting for a track with this title, artist, album, track and disc numbers */
+static QString pendingTrackKey(const QString &title, const QString &artist, const QString &album, int trackNumber, int discNumber)
+{
+    return title + QChar(0x1f) + artist + QChar(0x1f) + album + QChar(0x1f) +
+            QString::number(trackNumber) + QChar(0x1f) + QString::number(discNumber);
+}
+
 class TracksListenerPrivate
 {
 public:
 
     QSet<qulonglong> mTracksByIdSet;
 
-    QList<std::tuple<QString, QString, QString, int, int>> mTracksByNameSet;
+    /* number of playlist entries waiting for each key */
+    QHash<QString, int> mTracksByNameSet;
 
-    QList<QUrl> mTracksByFileNameSet;
+    QHash<QUrl, int> mTracksByFileNameSet;
 
     DatabaseInterface *mDatabase = nullptr;
 
@@ -65,40 +74,26 @@ void TracksListener::tracksAdded(const QList<MusicAudioTrack> &allTracks)
             Q_EMIT trackHasChanged(oneTrack);
         }
 
-        if (d->mTracksByNameSet.isEmpty()) {
-            return;
-        }
-
-        for (auto itTrack = d->mTracksByNameSet.begin(); itTrack != d->mTracksByNameSet.end(); ) {
-            if (std::get<0>(*itTrack) != oneTrack.title()) {
-                ++itTrack;
-                continue;
-            }
+        auto pendingEntries = 0;
 
-            if (std::get<1>(*itTrack) != oneTrack.artist()) {
-                ++itTrack;
-                continue;
-            }
+        if (!d->mTracksByNameSet.isEmpty()) {
+            pendingEntries += d->mTracksByNameSet.take(pendingTrackKey(oneTrack.title(), oneTrack.artist(), oneTrack.albumName(),
+                                                                       oneTrack.trackNumber(), oneTrack.discNumber()));
+        }
 
-            if (std::get<2>(*itTrack) != oneTrack.albumName()) {
-                ++itTrack;
-                continue;
-            }
+        if (!d->mTracksByFileNameSet.isEmpty()) {
+            pendingEntries += d->mTracksByFileNameSet.take(oneTrack.resourceURI());
+        }
 
-            if (std::get<3>(*itTrack) != oneTrack.trackNumber()) {
-                ++itTrack;
-                continue;
-            }
+        if (pendingEntries == 0) {
+            continue;
+        }
 
-            if (std::get<4>(*itTrack) != oneTrack.discNumber()) {
-                ++itTrack;
-                continue;
-            }
+        d->mTracksByIdSet.insert(oneTrack.databaseId());
 
+        /* the playlist resolves one waiting entry per notification */
+        for (int i = 0; i < pendingEntries; ++i) {
             Q_EMIT trackHasChanged(oneTrack);
-
-            d->mTracksByIdSet.insert(oneTrack.databaseId());
-            itTrack = d->mTracksByNameSet.erase(itTrack);
         }
     }
 }
@@ -121,8 +116,7 @@ void TracksListener::trackByNameInList(const QString &title, const QString &arti
 {
     auto newTrackId = d->mDatabase->trackIdFromTitleAlbumTrackDiscNumber(title, artist, album, trackNumber, discNumber);
     if (newTrackId == 0) {
-        auto newTrack = std::tuple<QString, QString, QString, int, int>(title, artist, album, trackNumber, discNumber);
-        d->mTracksByNameSet.push_back(newTrack);
+        ++d->mTracksByNameSet[pendingTrackKey(title, artist, album, trackNumber, discNumber)];
 
         return;
     }
@@ -153,7 +147,7 @@ void TracksListener::trackByFileNameInList(const QUrl &fileName)
             return;
         }
 
-        d->mTracksByFileNameSet.push_back(fileName);
+        ++d->mTracksByFileNameSet[fileName];
 
         return;
     }
@@ -177,6 +171,35 @@ void TracksListener::trackByIdInList(qulonglong newTrackId)
     auto newTrack = d->mDatabase->trackFromDatabaseId(newTrackId);
     if (newTrack.isValid()) {
         Q_EMIT trackHasChanged(newTrack);
+        return;
+    }
+
+    /* ids restored from a saved playlist may no longer exist in the database */
+    d->mTracksByIdSet.remove(newTrackId);
+    Q_EMIT trackHasBeenRemoved(newTrackId);
+}
+
+void TracksListener::tracksByIdInList(const QList<qulonglong> &newTrackIds)
+{
+    for (auto newTrackId : newTrackIds) {
+        d->mTracksByIdSet.insert(newTrackId);
+    }
+
+    const auto newTracks = d->mDatabase->tracksFromDatabaseIds(newTrackIds);
+    for (const auto &oneTrack : newTracks) {
+        if (oneTrack.isValid()) {
+            Q_EMIT trackHasChanged(oneTrack);
+        }
+    }
+
+    /* ids restored from a saved playlist may no longer exist in the database */
+    if (newTracks.size() == newTrackIds.size()) {
+        for (int trackIndex = 0; trackIndex < newTracks.size(); ++trackIndex) {
+            if (!newTracks.at(trackIndex).isValid()) {
+                d->mTracksByIdSet.remove(newTrackIds.at(trackIndex));
+                Q_EMIT trackHasBeenRemoved(newTrackIds.at(trackIndex));
+            }
+        }
     }
 }
 
@@ -61,6 +61,8 @@ public Q_SLOTS:
 
     void trackByIdInList(qulonglong newTrackId);
 
+    void tracksByIdInList(const QList<qulonglong> &newTrackIds);
+
     void newArtistInList(const QString &artist);
 
 private:
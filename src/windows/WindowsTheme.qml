@@ -21,6 +21,15 @@ import QtQuick 2.7
 import QtQuick.Controls 1.4
 
 Item {
+    function coverThumbnail(coverUrl) {
+        // local covers are served pre-scaled by the cover thumbnail provider
+        var coverUrlString = coverUrl.toString();
+        if (coverUrlString.indexOf('file:') === 0) {
+            return 'image://cover/' + encodeURIComponent(coverUrlString);
+        }
+        return coverUrl;
+    }
+
     property string defaultAlbumImage: 'image://icon/media-optical-audio'
     property string defaultArtistImage: 'image://icon/view-media-artist'
     property string defaultBackgroundImage: 'qrc:///background.png'